@@ -51,6 +51,10 @@ enum class BMI270_REGISTERS : uint8_t
 	TMP_DATA_LSB = 0x22,
 	TMP_DATA_MSB = 0x23,
 
+	FIFO_LENGTH_0 = 0x24,
+	FIFO_LENGTH_1 = 0x25,
+	FIFO_DATA = 0x26,
+
 	FEAT_PAGE = 0x2F,
 	FEATURES_START = 0x30,
 	FEATURES_0 = 0x30,
@@ -77,6 +81,11 @@ enum class BMI270_REGISTERS : uint8_t
 	GYR_RANGE = 0x43,
 
 	AUX_CONF = 0x44,
+	FIFO_DOWNS = 0x45,
+	FIFO_WTM_0 = 0x46,
+	FIFO_WTM_1 = 0x47,
+	FIFO_CONFIG_0 = 0x48,
+	FIFO_CONFIG_1 = 0x49,
 	SATURATION = 0x4A,
 	AUX_DEV_ID = 0x4B,
 	AUX_IF_CONF = 0x4C,
@@ -146,6 +155,14 @@ public:
 	std::array<int16_t, 3> readRawGyroscope() const;
 	uint16_t readRawThermometer() const;
 
+	bool configureFifo(bool aux = false) const;
+	uint16_t readFifoLength() const;
+	bool readFifo(uint8_t *rx_buf, uint16_t rx_len) const;
+
+	// raw points to X LSB of a data register block or FIFO frame
+	AccelerationInBodyFrame toAcceleration(const uint8_t *raw) const;
+	AngularVelocityInBodyFrame toAngularVelocity(const uint8_t *raw) const;
+
 public:
 	const Transport &getTransport() const { return transport_; }
 	bool writeRegister(BMI270_REGISTERS reg, uint8_t value) const;
@@ -202,8 +219,12 @@ protected:
 	static constexpr uint8_t BMI270_TMP_EN = 0x08;
 
 	static constexpr uint8_t BMI270_CHIP_ID = 0x24;
+	static constexpr uint8_t BMI270_FIFO_TIME_EN = 0x02;
+	static constexpr uint8_t BMI270_FIFO_HEADER_EN = 0x10;
+	static constexpr uint8_t BMI270_FIFO_AUX_EN = 0x20;
 	static constexpr uint8_t BMI270_FIFO_ACC_EN = 0x40;
 	static constexpr uint8_t BMI270_FIFO_GYR_EN = 0x80;
+	static constexpr uint16_t BMI270_FIFO_LENGTH_MASK = 0x3FFF;
 };
 
 template <typename Transport>
@@ -405,6 +426,13 @@ std::optional<AccelerationInBodyFrame> BMI270<Transport>::readAccelerometer() co
 		return std::nullopt;
 	}
 
+	return toAcceleration(rx + 1);
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+AccelerationInBodyFrame BMI270<Transport>::toAcceleration(const uint8_t *raw) const
+{
 	// Accelerometer is front (+0.91), left/west (+9.81). up (+9.81)
 	// wanted NED (front east down) to have positive +9.81 when oriented
 	// Orientation	Axis Rotation Positive Direction
@@ -413,9 +441,9 @@ std::optional<AccelerationInBodyFrame> BMI270<Transport>::readAccelerometer() co
 	// down			Z	+9.81
 
 	return AccelerationInBodyFrame{
-		-convertAcc(rx[1], rx[2]),
-		convertAcc(rx[3], rx[4]),
-		convertAcc(rx[5], rx[6])};
+		-convertAcc(raw[0], raw[1]),
+		convertAcc(raw[2], raw[3]),
+		convertAcc(raw[4], raw[5])};
 }
 
 template <typename Transport>
@@ -429,6 +457,13 @@ std::optional<AngularVelocityInBodyFrame> BMI270<Transport>::readGyroscope() con
 		return std::nullopt;
 	}
 
+	return toAngularVelocity(rx + 1);
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+AngularVelocityInBodyFrame BMI270<Transport>::toAngularVelocity(const uint8_t *raw) const
+{
 	// Gyroscope is front, left/west. up
 	// wanted
 	// Orientation	Axis Rotation Positive Direction
@@ -437,9 +472,9 @@ std::optional<AngularVelocityInBodyFrame> BMI270<Transport>::readGyroscope() con
 	// down		Z	Yaw		Nose right
 
 	return AngularVelocityInBodyFrame{
-		convertGyr(rx[1], rx[2]),
-		-convertGyr(rx[3], rx[4]),
-		-convertGyr(rx[5], rx[6])};
+		convertGyr(raw[0], raw[1]),
+		-convertGyr(raw[2], raw[3]),
+		-convertGyr(raw[4], raw[5])};
 }
 
 template <typename Transport>
@@ -502,4 +537,60 @@ uint16_t BMI270<Transport>::readRawThermometer() const
 	return toUInt16(rx[1], rx[2]);
 }
 
+/*!
+ * Header mode FIFO with accelerometer, gyroscope and optionally the AUX
+ * magnetometer, a sensortime frame is appended once the FIFO is read empty.
+ */
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+bool BMI270<Transport>::configureFifo(bool aux) const
+{
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::FIFO_CONFIG_0, BMI270_FIFO_TIME_EN))
+	{
+		return false;
+	}
+
+	uint8_t config = BMI270_FIFO_HEADER_EN | BMI270_FIFO_ACC_EN | BMI270_FIFO_GYR_EN;
+	if (aux)
+	{
+		config |= BMI270_FIFO_AUX_EN;
+	}
+	if (!writeRegisterWithCheck(BMI270_REGISTERS::FIFO_CONFIG_1, config))
+	{
+		return false;
+	}
+
+	if (!writeRegister(BMI270_REGISTERS::CMD, BMI270_CMD_FIFO_FLUSH))
+	{
+		return false;
+	}
+	log(LOG_LEVEL_DEBUG, "BMI270 FIFO configured for ACC, GYR%s\r\n", aux ? ", AUX" : "");
+
+	return true;
+}
+
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+uint16_t BMI270<Transport>::readFifoLength() const
+{
+	uint8_t rx[3]{}; // rx[0] is a dummy byte to give the BMI time to respond
+
+	if (!readRegisters(BMI270_REGISTERS::FIFO_LENGTH_0, rx, sizeof(rx)))
+	{
+		return 0;
+	}
+
+	return toUInt16(rx[1], rx[2]) & BMI270_FIFO_LENGTH_MASK;
+}
+
+/*!
+ * Burst read of FIFO_DATA, rx_buf[0] is the dummy byte.
+ */
+template <typename Transport>
+	requires RegisterModeTransport<Transport>
+bool BMI270<Transport>::readFifo(uint8_t *rx_buf, uint16_t rx_len) const
+{
+	return readRegisters(BMI270_REGISTERS::FIFO_DATA, rx_buf, rx_len);
+}
+
 #endif /* INC_BMI270_H_ */
@@ -0,0 +1,270 @@
+#ifndef INC_BMI270FIFO_HPP_
+#define INC_BMI270FIFO_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "au.hpp"
+#include "IMU.hpp"
+#include "BMI270.hpp"
+#include "CircularBuffer.hpp"
+
+// Pointers into a header mode FIFO frame, nullptr for sensors not in the frame
+struct BMI270FifoFrame
+{
+	const uint8_t *aux; // 8 bytes
+	const uint8_t *gyr; // 6 bytes
+	const uint8_t *acc; // 6 bytes
+};
+
+struct BMI270FifoStatus
+{
+	uint16_t frames;
+	uint16_t skipped;		 // frames lost while the FIFO was full
+	uint16_t config_changes; // FIFO input config frames
+	uint16_t used;			 // bytes of complete frames
+	bool has_sensor_time;
+	uint32_t sensor_time;
+};
+
+class BMI270FifoCore
+{
+public:
+	static constexpr uint8_t HEADER_MASK = 0xFC; // bits 1:0 are interrupt tags
+	static constexpr uint8_t HEADER_MODE_MASK = 0xC0;
+	static constexpr uint8_t HEADER_REGULAR = 0x80;
+	static constexpr uint8_t HEADER_ACC = 0x04;
+	static constexpr uint8_t HEADER_GYR = 0x08;
+	static constexpr uint8_t HEADER_AUX = 0x10;
+	static constexpr uint8_t HEADER_SKIP = 0x40;
+	static constexpr uint8_t HEADER_SENSOR_TIME = 0x44;
+	static constexpr uint8_t HEADER_INPUT_CONFIG = 0x48;
+
+	static constexpr uint8_t AUX_SIZE = 8;
+	static constexpr uint8_t GYR_SIZE = 6;
+	static constexpr uint8_t ACC_SIZE = 6;
+	static constexpr uint8_t SKIP_FRAME_SIZE = 2;
+	static constexpr uint8_t SENSOR_TIME_FRAME_SIZE = 4;
+	static constexpr uint8_t INPUT_CONFIG_FRAME_SIZE = 5;
+	static constexpr uint32_t SENSOR_TIME_MASK = 0xFFFFFF;
+
+	// Calls fn(const BMI270FifoFrame&) for every complete data frame, stops at
+	// the over-read pattern, an unknown header or a truncated frame
+	template <typename Fn>
+	static BMI270FifoStatus parse(const uint8_t *data, size_t size, Fn &&fn);
+
+	// Sample period in sensortime ticks for the ODR field of ACC_CONF/GYR_CONF (0x08 = 100 Hz)
+	static constexpr uint32_t periodTicks(uint8_t odr)
+	{
+		return (odr >= 8) ? (256U >> (odr - 8)) : (256U << (8 - odr));
+	}
+
+	// sensortime runs at 25.6 kHz, 39.0625 us = 5/128 ms per tick
+	static constexpr uint64_t ticksToMilliseconds(uint32_t ticks)
+	{
+		return uint64_t{ticks} * 5U / 128U;
+	}
+};
+
+template <typename Fn>
+BMI270FifoStatus BMI270FifoCore::parse(const uint8_t *data, size_t size, Fn &&fn)
+{
+	BMI270FifoStatus status{};
+	size_t pos = 0;
+	while (pos < size)
+	{
+		const uint8_t header = data[pos] & HEADER_MASK;
+		if ((header & HEADER_MODE_MASK) == HEADER_REGULAR)
+		{
+			if ((header & ~(HEADER_MODE_MASK | HEADER_ACC | HEADER_GYR | HEADER_AUX)) != 0 || header == HEADER_REGULAR)
+			{
+				break; // over-read (0x80) or invalid
+			}
+
+			const size_t length = ((header & HEADER_AUX) ? AUX_SIZE : 0U) + ((header & HEADER_GYR) ? GYR_SIZE : 0U) + ((header & HEADER_ACC) ? ACC_SIZE : 0U);
+			if (pos + 1 + length > size)
+			{
+				break;
+			}
+
+			// data order within a frame is AUX, GYR, ACC
+			const uint8_t *p = data + pos + 1;
+			BMI270FifoFrame frame{};
+			if (header & HEADER_AUX)
+			{
+				frame.aux = p;
+				p += AUX_SIZE;
+			}
+			if (header & HEADER_GYR)
+			{
+				frame.gyr = p;
+				p += GYR_SIZE;
+			}
+			if (header & HEADER_ACC)
+			{
+				frame.acc = p;
+			}
+			fn(frame);
+			++status.frames;
+			pos += 1 + length;
+		}
+		else if (header == HEADER_SKIP)
+		{
+			if (pos + SKIP_FRAME_SIZE > size)
+			{
+				break;
+			}
+			status.skipped = static_cast<uint16_t>(status.skipped + data[pos + 1]);
+			pos += SKIP_FRAME_SIZE;
+		}
+		else if (header == HEADER_SENSOR_TIME)
+		{
+			if (pos + SENSOR_TIME_FRAME_SIZE > size)
+			{
+				break;
+			}
+			status.sensor_time = static_cast<uint32_t>(data[pos + 1]) | static_cast<uint32_t>(data[pos + 2]) << 8 | static_cast<uint32_t>(data[pos + 3]) << 16;
+			status.has_sensor_time = true;
+			pos += SENSOR_TIME_FRAME_SIZE;
+		}
+		else if (header == HEADER_INPUT_CONFIG)
+		{
+			if (pos + INPUT_CONFIG_FRAME_SIZE > size)
+			{
+				break;
+			}
+			++status.config_changes;
+			pos += INPUT_CONFIG_FRAME_SIZE;
+		}
+		else
+		{
+			break;
+		}
+	}
+	status.used = static_cast<uint16_t>(pos);
+	return status;
+}
+
+/*!
+ * Batched acquisition: each drain() reads FIFO_LENGTH and then the whole FIFO
+ * in one burst, converts the frames and queues them as timestamped samples.
+ * The trailing sensortime frame dates the last sample, earlier ones are one
+ * ODR period apart. With BMI270_MMC5983 the AUX magnetometer is included.
+ */
+template <typename IMU, size_t CAPACITY = 32, uint16_t BURST = 255>
+class BMI270Fifo
+{
+public:
+	static constexpr bool HAS_AUX = requires(const IMU &imu, const uint8_t *raw) { imu.toMagneticField(raw); };
+
+	BMI270Fifo() = delete;
+	explicit BMI270Fifo(const IMU &imu, uint8_t odr = 0x08) : imu_(imu), period_ticks_(BMI270FifoCore::periodTicks(odr)) {}
+
+	bool configure() const { return imu_.configureFifo(); }
+	size_t drain(au::QuantityU64<au::Milli<au::Seconds>> now);
+
+	bool pop(IMUSample &sample);
+	size_t size() const { return samples_.size(); }
+	uint32_t dropped() const { return dropped_; }
+	uint32_t skipped() const { return skipped_; }
+
+private:
+	void store(const BMI270FifoFrame &frame, uint32_t sensor_time, au::QuantityU64<au::Milli<au::Seconds>> timestamp);
+
+private:
+	const IMU &imu_;
+	uint32_t period_ticks_;
+	SPSCBuffer<IMUSample, CAPACITY> samples_;
+	uint32_t dropped_ = 0;
+	uint32_t skipped_ = 0;
+	uint8_t buffer_[BURST + 1]; // leading dummy byte
+};
+
+template <typename IMU, size_t CAPACITY, uint16_t BURST>
+size_t BMI270Fifo<IMU, CAPACITY, BURST>::drain(au::QuantityU64<au::Milli<au::Seconds>> now)
+{
+	const uint16_t length = imu_.readFifoLength();
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	// FIFO_LENGTH does not count the sensortime frame appended at the end
+	const uint16_t bytes = static_cast<uint16_t>(std::min<uint32_t>(length + BMI270FifoCore::SENSOR_TIME_FRAME_SIZE, BURST));
+	if (!imu_.readFifo(buffer_, static_cast<uint16_t>(bytes + 1)))
+	{
+		return 0;
+	}
+
+	const uint8_t *data = buffer_ + 1;
+	const BMI270FifoStatus status = BMI270FifoCore::parse(data, bytes, [](const BMI270FifoFrame &) {});
+	skipped_ += status.skipped;
+	if (status.frames == 0)
+	{
+		return 0;
+	}
+
+	// Data ready falls on multiples of the period in sensortime, so the last
+	// frame was sampled at the sensortime rounded down to the period. Without
+	// a sensortime frame the last sample is dated now.
+	const uint32_t end = status.has_sensor_time ? status.sensor_time : 0U;
+	const uint32_t last = end & ~(period_ticks_ - 1U);
+
+	const uint64_t now_ms = now.in(au::milli(au::seconds));
+	uint32_t index = 0;
+	BMI270FifoCore::parse(data, status.used, [&](const BMI270FifoFrame &frame)
+	{
+		const uint32_t sensor_time = (last - (status.frames - 1U - index) * period_ticks_) & BMI270FifoCore::SENSOR_TIME_MASK;
+		const uint64_t age = BMI270FifoCore::ticksToMilliseconds((end - sensor_time) & BMI270FifoCore::SENSOR_TIME_MASK);
+		store(frame, sensor_time, au::make_quantity<au::Milli<au::Seconds>>(now_ms > age ? now_ms - age : 0U));
+		++index;
+	});
+
+	return status.frames;
+}
+
+template <typename IMU, size_t CAPACITY, uint16_t BURST>
+void BMI270Fifo<IMU, CAPACITY, BURST>::store(const BMI270FifoFrame &frame, uint32_t sensor_time, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+{
+	if (samples_.is_full())
+	{
+		++dropped_; // oldest sample is overwritten
+	}
+
+	IMUSample &sample = samples_.begin_write();
+	sample = IMUSample{};
+	sample.timestamp = timestamp;
+	sample.sensor_time = sensor_time;
+	if (frame.acc != nullptr)
+	{
+		sample.acceleration = imu_.toAcceleration(frame.acc);
+		sample.flags |= IMUSample::ACC;
+	}
+	if (frame.gyr != nullptr)
+	{
+		sample.angular_velocity = imu_.toAngularVelocity(frame.gyr);
+		sample.flags |= IMUSample::GYR;
+	}
+	if constexpr (HAS_AUX)
+	{
+		if (frame.aux != nullptr)
+		{
+			sample.magnetic_field = imu_.toMagneticField(frame.aux);
+			sample.flags |= IMUSample::MAG;
+		}
+	}
+	samples_.commit_write();
+}
+
+template <typename IMU, size_t CAPACITY, uint16_t BURST>
+bool BMI270Fifo<IMU, CAPACITY, BURST>::pop(IMUSample &sample)
+{
+	if (samples_.is_empty())
+	{
+		return false;
+	}
+	sample = samples_.pop();
+	return true;
+}
+
+#endif /* INC_BMI270FIFO_HPP_ */
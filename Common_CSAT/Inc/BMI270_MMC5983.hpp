@@ -128,9 +128,16 @@ public:
         : BMI270Type(transport), aux_(*this), mag_(aux_, calibration) {}
 
     bool configure() const;
+    bool configureFifo() const { return BMI270Type::configureFifo(true); }
     std::optional<MagneticFieldInBodyFrame> readMagnetometer() const;
     std::array<int32_t, 3> readRawMagnetometer() const;
 
+    // raw is the 8 byte MMC5983 data block as mirrored in AUX_DATA or a FIFO frame
+    MagneticFieldInBodyFrame toMagneticField(const uint8_t *raw) const
+    {
+        return MMC5983Core::convertMag(MMC5983Core::calibrateMagnetometer(raw, mag_.calibration()));
+    }
+
 private:
     bool configureContinuousMode(uint8_t freq_code, uint8_t set_interval_code, bool auto_set) const;
 
@@ -209,7 +216,7 @@ std::optional<MagneticFieldInBodyFrame> BMI270_MMC5983<Transport>::readMagnetome
         memset(rx_buf, 0, sizeof(rx_buf));
     }
 
-    return MMC5983Core::convertMag(MMC5983Core::calibrateMagnetometer(rx_buf, mag_.calibration()));
+    return toMagneticField(rx_buf);
 }
 
 template <typename Transport>
@@ -12,6 +12,16 @@
 #include <array>
 #include <iostream>
 #include <span>
+#include <string>
+#include <memory>
+#include <bitset>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // --------------------
 // 📐 BlobStoreAccess Concept
@@ -95,6 +105,149 @@ private:
     bool is_valid_;
 };
 
+#if defined(__linux__)
+// ------------------------------------
+// 🗺️ Memory-mapped File Backend (Linux)
+// ------------------------------------
+// The file is mapped once, accesses are plain memcpy into the page cache.
+// Unlike FileBlobStoreAccess the existing content is kept, the file is only
+// resized to flash_size. Copies share the mapping.
+class MmapBlobStoreAccess {
+public:
+    MmapBlobStoreAccess(const std::string_view& filename, size_t flash_size)
+        : flash_size_(flash_size), memory_(map_file(std::string(filename), flash_size)) {}
+
+    bool read(size_t offset, uint8_t* buffer, size_t size) const {
+        if (!isValid() || offset + size > flash_size_) return false;
+        std::memcpy(buffer, memory_.get() + offset, size);
+        return true;
+    }
+
+    bool write(size_t offset, const uint8_t* data, size_t size) {
+        if (!isValid() || offset + size > flash_size_) return false;
+        std::memcpy(memory_.get() + offset, data, size);
+        return true;
+    }
+
+    // Blocks until the mapped pages are on disk
+    bool sync() {
+        return isValid() && ::msync(memory_.get(), flash_size_, MS_SYNC) == 0;
+    }
+
+    size_t get_flash_size() const { return flash_size_; }
+    bool isValid() const { return memory_ != nullptr; }
+
+private:
+    static std::shared_ptr<uint8_t> map_file(const std::string& filename, size_t size) {
+        if (size == 0) return nullptr;
+        int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return nullptr;
+
+        void* memory = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(size)) == 0)
+            memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file referenced
+        if (memory == MAP_FAILED) return nullptr;
+
+        return std::shared_ptr<uint8_t>(static_cast<uint8_t*>(memory),
+                                        [size](uint8_t* m) { ::munmap(m, size); });
+    }
+
+    size_t flash_size_;
+    std::shared_ptr<uint8_t> memory_;
+};
+#endif // __linux__
+
+// -------------------------------------
+// 🧊 Write-back RAM Shadow of a Backend
+// -------------------------------------
+// Storage of CachedBlobStoreAccess, owned by the caller like the memory of
+// SPIBlobStoreAccess so that copies of the access share one shadow.
+template <size_t FLASH_SIZE, size_t BLOCK_SIZE = 32>
+struct BlobStoreShadow {
+    static_assert(FLASH_SIZE > 0 && BLOCK_SIZE > 0, "empty shadow");
+    static constexpr size_t BLOCKS = (FLASH_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    std::array<uint8_t, FLASH_SIZE> data{};
+    std::bitset<BLOCKS> dirty{};
+    bool loaded = false;
+};
+
+// Reads are served from RAM, writes only mark the blocks they change and
+// reach the backend on flush(), one backend write per run of dirty blocks.
+// Writing a value that is already stored costs no backend access at all.
+template <BlobStoreAccess Backing, size_t FLASH_SIZE, size_t BLOCK_SIZE = 32>
+class CachedBlobStoreAccess {
+public:
+    using Shadow = BlobStoreShadow<FLASH_SIZE, BLOCK_SIZE>;
+
+    CachedBlobStoreAccess(Backing backing, Shadow& shadow)
+        : backing_(backing), shadow_(&shadow), is_valid_(load()) {}
+
+    bool read(size_t offset, uint8_t* buffer, size_t size) const {
+        if (!is_valid_ || offset + size > FLASH_SIZE) return false;
+        std::memcpy(buffer, shadow_->data.data() + offset, size);
+        return true;
+    }
+
+    bool write(size_t offset, const uint8_t* data, size_t size) {
+        if (!is_valid_ || offset + size > FLASH_SIZE) return false;
+        size_t end = offset + size;
+        while (offset < end) {
+            size_t block = offset / BLOCK_SIZE;
+            size_t chunk = std::min(end, (block + 1) * BLOCK_SIZE) - offset;
+            uint8_t* cached = shadow_->data.data() + offset;
+            if (std::memcmp(cached, data, chunk) != 0) {
+                std::memcpy(cached, data, chunk);
+                shadow_->dirty.set(block);
+            }
+            offset += chunk;
+            data += chunk;
+        }
+        return true;
+    }
+
+    // Writes back all dirty blocks, blocks that fail stay dirty
+    bool flush() {
+        if (!is_valid_) return false;
+        bool ok = true;
+        size_t block = 0;
+        while (block < Shadow::BLOCKS) {
+            if (!shadow_->dirty.test(block)) {
+                ++block;
+                continue;
+            }
+            size_t first = block;
+            while (block < Shadow::BLOCKS && shadow_->dirty.test(block)) ++block;
+
+            size_t offset = first * BLOCK_SIZE;
+            size_t size = std::min(block * BLOCK_SIZE, FLASH_SIZE) - offset;
+            if (backing_.write(offset, shadow_->data.data() + offset, size)) {
+                for (size_t i = first; i < block; ++i) shadow_->dirty.reset(i);
+            } else {
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    size_t dirtyBlocks() const { return shadow_->dirty.count(); }
+    size_t get_flash_size() const { return FLASH_SIZE; }
+    bool isValid() const { return is_valid_; }
+
+private:
+    // The first access sharing a shadow fills it from the backend
+    bool load() {
+        if (!shadow_->loaded && backing_.get_flash_size() >= FLASH_SIZE)
+            shadow_->loaded = backing_.read(0, shadow_->data.data(), FLASH_SIZE);
+        return shadow_->loaded;
+    }
+
+    Backing backing_;
+    Shadow* shadow_;
+    bool is_valid_;
+};
+
 // ------------------------------
 // 📦 Generic BlobStore Interface
 // ------------------------------
@@ -117,6 +270,55 @@ protected:
     AccessType access_;
 };
 
+// -----------------------------------
+// 🗂️ Sorted Name Index
+// -----------------------------------
+// Orders a blob map by name length, then by name, so that lookups are a binary
+// search instead of a scan and most probes are decided by the length alone.
+// Built in the constructor of NamedBlobStore, or at compile time from a static
+// constexpr map.
+template <typename MemberInfo, size_t MapSize>
+class BlobIndex {
+public:
+    constexpr explicit BlobIndex(const std::array<MemberInfo, MapSize>& blob_map)
+        : blob_map_(&blob_map), order_{} {
+        for (size_t i = 0; i < MapSize; ++i) order_[i] = i;
+        std::sort(order_.begin(), order_.end(),
+                  [&blob_map](size_t a, size_t b) { return compare(blob_map[a].name, blob_map[b].name) < 0; });
+    }
+
+    constexpr const MemberInfo* find(const std::string_view& name) const {
+        size_t low = 0;
+        size_t high = MapSize;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            const MemberInfo& entry = (*blob_map_)[order_[mid]];
+            int order = compare(entry.name, name);
+            if (order == 0) return &entry;
+            if (order < 0) low = mid + 1;
+            else high = mid;
+        }
+        return nullptr;
+    }
+
+    // A duplicate name would shadow one of the entries
+    constexpr bool unique() const {
+        for (size_t i = 1; i < MapSize; ++i) {
+            if ((*blob_map_)[order_[i - 1]].name == (*blob_map_)[order_[i]].name) return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr int compare(const std::string_view& a, const std::string_view& b) {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        return a.compare(b);
+    }
+
+    const std::array<MemberInfo, MapSize>* blob_map_;
+    std::array<size_t, MapSize> order_;
+};
+
 // -----------------------------------
 // 🏷️ Named BlobStore 
 // -----------------------------------
@@ -132,28 +334,27 @@ public:
     using BlobStore<AccessType, BlobStruct>::BlobStore;
 
     NamedBlobStore(AccessType access, const std::array<MemberInfo, MapSize>& blob_map)
-        : BlobStore<AccessType, BlobStruct>(access), blob_map_(blob_map) {}
+        : BlobStore<AccessType, BlobStruct>(access), index_(blob_map) {}
+
+    NamedBlobStore(AccessType access, const BlobIndex<MemberInfo, MapSize>& index)
+        : BlobStore<AccessType, BlobStruct>(access), index_(index) {}
+
+    const MemberInfo* find(const std::string_view& name) const {
+        return index_.find(name);
+    }
 
     bool write_blob_by_name(const std::string_view& name, const uint8_t* data, size_t data_size) {
-        for (const auto& entry : blob_map_) {
-            if (entry.name == name) {
-                return this->write_blob(data, data_size, entry.offset, entry.size);
-            }
-        }
-        return false;
+        const MemberInfo* entry = index_.find(name);
+        if (entry == nullptr) return false;
+        return this->write_blob(data, data_size, entry->offset, entry->size);
     }
 
     std::span<uint8_t> read_blob_by_name(const std::string_view& name, uint8_t* buffer, size_t buffer_size) {
-        for (const auto& entry : blob_map_) {
-            if (entry.name == name) {
-                if (this->read_blob(buffer, buffer_size, entry.offset, entry.size)) {
-                    return std::span<uint8_t>(buffer, entry.size);
-                } else {
-                    return std::span<uint8_t>(buffer, 0);
-                }
-            }
+        const MemberInfo* entry = index_.find(name);
+        if (entry == nullptr || !this->read_blob(buffer, buffer_size, entry->offset, entry->size)) {
+            return std::span<uint8_t>(buffer, 0);
         }
-        return std::span<uint8_t>(buffer, 0);
+        return std::span<uint8_t>(buffer, entry->size);
     }
 
     bool direct_read_blob(uint8_t* buffer, size_t buffer_size, size_t offset, size_t array_size) {
@@ -165,7 +366,7 @@ public:
     }
 
 private:
-    const std::array<MemberInfo, MapSize>& blob_map_;
+    BlobIndex<MemberInfo, MapSize> index_;
 };
 
 #endif // __BLOBSTORE_HPP__
\ No newline at end of file
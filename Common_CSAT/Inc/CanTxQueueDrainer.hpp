@@ -7,9 +7,37 @@
 #include "mock_hal.h"
 #endif
 
+#include <cstdint>
+
 // Forward declaration only
 struct CanardAdapter;
 
+// Frames pushed without an explicit deadline may wait this long for a mailbox
+constexpr uint64_t CAN_TX_TIMEOUT_USEC = 1000000ULL;
+
+struct CanTxStatistics
+{
+    uint32_t frames_sent;
+    uint32_t frames_expired;       // dropped because their deadline passed in the queue
+    uint32_t mailbox_full;         // drains that stopped with frames still queued
+    uint32_t irq_refills;          // drains run from the TX mailbox complete interrupt
+    uint32_t frames_per_second;    // rate over the last complete one second window
+    uint32_t max_latency_ms;       // longest push-to-mailbox time
+    uint64_t total_latency_ms;     // sum over frames_sent, for the mean
+};
+
+/**
+ * @brief Moves frames from the canard TX queue into the three bxCAN mailboxes.
+ *
+ * canardTxPeek always yields the highest priority frame, so every refill keeps the
+ * bus arbitration order. While frames remain queued the TX mailbox empty interrupt
+ * is enabled and on_tx_complete() refills from the ISR; once the queue is empty the
+ * interrupt is masked again. Main loop access goes through irq_safe_drain(), and
+ * pushes must hold CanTxIrqLock, so the queue is never modified from both contexts.
+ *
+ * Queue latency is taken from the deadline stamped at push time, which is
+ * now + CAN_TX_TIMEOUT_USEC unless the caller supplies its own.
+ */
 class CanTxQueueDrainer
 {
 public:
@@ -18,8 +46,19 @@ public:
     void drain();
     void irq_safe_drain();
 
+    // call from HAL_CAN_TxMailboxNCompleteCallback / AbortCallback
+    void on_tx_complete();
+
+    const CanTxStatistics& statistics() const { return statistics_; }
+    void reset_statistics();
+
+private:
+    void update_rate(uint32_t now);
+
 private:
     CanardAdapter* adapter_;
     CAN_HandleTypeDef* hcan_;
+    CanTxStatistics statistics_;
+    uint32_t window_start_;
+    uint32_t window_frames_;
 };
-
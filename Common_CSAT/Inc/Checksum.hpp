@@ -1,14 +1,18 @@
 #ifndef CHECKSUM_HPP
 #define CHECKSUM_HPP
 
+#include <array>
 #include <cstdint>
 #include <cstddef>
 #include <cstdio>
 
-#include "ChecksumPolicy.hpp"
-
 typedef uint32_t crc_t;
 
+#include "ChecksumPolicy.hpp"
+
+// -----------------------------------------------------------------------------
+// Reference calculator, one bit per iteration
+// -----------------------------------------------------------------------------
 class ChecksumCalculator
 {
 public:
@@ -34,15 +38,151 @@ private:
 };
 
 // -----------------------------------------------------------------------------
-// Default checksum policy wrapper
+// Lookup tables for the same per-byte recurrence
+//
+//   crc' = (crc >> 1) ^ T[(crc ^ byte) & 0xFF]
+//
+// T is the reflected CRC-32 table, so the recurrence is linear over GF(2).
+// After eight bytes the state is therefore the XOR of the contributions of the
+// four bytes of the incoming state and of each of the eight data bytes, which
+// is what the slicing tables hold (4 + 8 tables of 256 entries).
+// -----------------------------------------------------------------------------
+namespace checksum_tables
+{
+    constexpr std::array<uint32_t, 256> make_byte_table()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            table[i] = c;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint32_t, 256> BYTE_TABLE = make_byte_table();
+
+    constexpr uint32_t step(uint32_t crc, uint8_t byte)
+    {
+        return (crc >> 1) ^ BYTE_TABLE[(crc ^ byte) & 0xFFu];
+    }
+
+    constexpr size_t SLICE = 8;
+    constexpr size_t STATE_TABLES = 4;
+    using SlicingTables = std::array<std::array<uint32_t, 256>, STATE_TABLES + SLICE>;
+
+    constexpr SlicingTables make_slicing_tables()
+    {
+        SlicingTables tables{};
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+            // contribution of byte k of the state, data all zero
+            for (size_t k = 0; k < STATE_TABLES; ++k)
+            {
+                uint32_t crc = v << (8 * k);
+                for (size_t i = 0; i < SLICE; ++i)
+                    crc = step(crc, 0);
+                tables[k][v] = crc;
+            }
+            // contribution of data byte j, state zero
+            for (size_t j = 0; j < SLICE; ++j)
+            {
+                uint32_t crc = 0;
+                for (size_t i = 0; i < SLICE; ++i)
+                    crc = step(crc, i == j ? static_cast<uint8_t>(v) : 0);
+                tables[STATE_TABLES + j][v] = crc;
+            }
+        }
+        return tables;
+    }
+
+    inline constexpr SlicingTables SLICING_TABLES = make_slicing_tables();
+}
+
+// -----------------------------------------------------------------------------
+// Table calculator, one lookup per byte (1 KiB table)
 // -----------------------------------------------------------------------------
-struct DefaultChecksumPolicy
+class TableChecksumCalculator
 {
-    ChecksumCalculator calc;
+public:
+    TableChecksumCalculator() : crc_(0xFFFFFFFFu) {}
+
+    void reset() { crc_ = 0xFFFFFFFFu; }
+
+    void update(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = crc_;
+        for (size_t i = 0; i < size; i++)
+            crc = (crc >> 1) ^ checksum_tables::BYTE_TABLE[(crc ^ data[i]) & 0xFFu];
+        crc_ = crc;
+    }
+
+    crc_t get_checksum() const { return crc_ ^ 0xFFFFFFFFu; }
+
+private:
+    uint32_t crc_;
+};
+
+// -----------------------------------------------------------------------------
+// Slicing-by-8 calculator, twelve independent lookups per 8 bytes (12 KiB tables)
+// -----------------------------------------------------------------------------
+class Slicing8ChecksumCalculator
+{
+public:
+    Slicing8ChecksumCalculator() : crc_(0xFFFFFFFFu) {}
+
+    void reset() { crc_ = 0xFFFFFFFFu; }
+
+    void update(const uint8_t* data, size_t size)
+    {
+        const auto& t = checksum_tables::SLICING_TABLES;
+        uint32_t crc = crc_;
+        while (size >= checksum_tables::SLICE)
+        {
+            crc = t[0][crc & 0xFFu] ^ t[1][(crc >> 8) & 0xFFu] ^ t[2][(crc >> 16) & 0xFFu] ^ t[3][crc >> 24] ^
+                  t[4][data[0]] ^ t[5][data[1]] ^ t[6][data[2]] ^ t[7][data[3]] ^
+                  t[8][data[4]] ^ t[9][data[5]] ^ t[10][data[6]] ^ t[11][data[7]];
+            data += checksum_tables::SLICE;
+            size -= checksum_tables::SLICE;
+        }
+        for (size_t i = 0; i < size; i++)
+            crc = (crc >> 1) ^ checksum_tables::BYTE_TABLE[(crc ^ data[i]) & 0xFFu];
+        crc_ = crc;
+    }
+
+    crc_t get_checksum() const { return crc_ ^ 0xFFFFFFFFu; }
+
+private:
+    uint32_t crc_;
+};
+
+// -----------------------------------------------------------------------------
+// Checksum policy wrappers
+// -----------------------------------------------------------------------------
+template <typename Calculator>
+struct CalculatorChecksumPolicy
+{
+    Calculator calc;
 
     void reset() { calc.reset(); }
     void update(const uint8_t* data, size_t size) { calc.update(data, size); }
     crc_t get() const { return calc.get_checksum(); }
 };
 
-#endif // CHECKSUM_HPP
\ No newline at end of file
+using BitwiseChecksumPolicy = CalculatorChecksumPolicy<ChecksumCalculator>;
+using TableChecksumPolicy = CalculatorChecksumPolicy<TableChecksumCalculator>;
+using Slicing8ChecksumPolicy = CalculatorChecksumPolicy<Slicing8ChecksumCalculator>;
+
+// All software policies produce identical checksums, so the build can pick by speed/size:
+// -DCHECKSUM_POLICY_TABLE trades throughput for 11 KiB less flash.
+#if defined(CHECKSUM_POLICY_BITWISE)
+using DefaultChecksumPolicy = BitwiseChecksumPolicy;
+#elif defined(CHECKSUM_POLICY_TABLE)
+using DefaultChecksumPolicy = TableChecksumPolicy;
+#else
+using DefaultChecksumPolicy = Slicing8ChecksumPolicy;
+#endif
+
+#endif // CHECKSUM_HPP
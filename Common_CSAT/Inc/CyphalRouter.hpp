@@ -0,0 +1,241 @@
+#ifndef INC_CyphalRouter_HPP_
+#define INC_CyphalRouter_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include "ArrayList.hpp"
+#include "cyphal.hpp"
+
+// One forwarding table entry: transfers on port_id whose destination falls in
+// destinations are forwarded on the adapter at index adapter of the tuple
+struct CyphalRoute
+{
+    uint8_t adapter;
+    CyphalPortID port_id;
+    CyphalForwardRange destinations;
+    uint32_t forwarded;
+    uint32_t failed;
+};
+
+/*
+ * Forwarding table for a node bridging several Cyphal links. Only adapters with
+ * a matching route get a copy of a received transfer, never the one it arrived
+ * on, and a transfer seen before (same source, kind, port and transfer-ID) is
+ * not forwarded again, which breaks loops between bridges.
+ */
+template <size_t ROUTES = 16, size_t HISTORY = 16>
+class CyphalRouter
+{
+    // a transfer-ID revisits an entry after 32 transfers on CAN
+    static_assert(HISTORY > 0 && HISTORY < 32, "history must be shorter than the CAN transfer-ID period");
+
+public:
+    static constexpr CyphalPortID ANY_PORT = 0xFFFF;
+    static constexpr uint8_t NO_ADAPTER = 0xFF;
+    static constexpr size_t MAX_ADAPTERS = 32;
+
+    // Messages carry no destination, requests and responses carry one
+    static constexpr CyphalForwardRange BROADCAST{CYPHAL_NODE_ID_UNSET, CYPHAL_NODE_ID_UNSET};
+    static constexpr CyphalForwardRange ANY_NODE{0, CYPHAL_NODE_ID_UNSET};
+
+public:
+    CyphalRouter() = default;
+    CyphalRouter(const CyphalRouter &) = delete;
+    CyphalRouter &operator=(const CyphalRouter &) = delete;
+
+    bool addRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations = BROADCAST);
+    bool removeRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations = BROADCAST);
+    void clear();
+
+    const CyphalRoute *findRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations = BROADCAST) const;
+    const ArrayList<CyphalRoute, ROUTES> &getRoutes() const { return routes_; }
+
+    // Returns false if any forward failed, true also when nothing was forwarded
+    template <typename... Adapters>
+    bool forward(const CyphalTransfer &transfer, std::tuple<Adapters...> &adapters, uint8_t ingress = NO_ADAPTER);
+
+    uint32_t suppressed() const { return suppressed_; }
+    uint32_t unrouted() const { return unrouted_; }
+
+private:
+    struct Seen
+    {
+        CyphalNodeID source_node_id;
+        CyphalTransferKind transfer_kind;
+        CyphalPortID port_id;
+        CyphalTransferID transfer_id;
+    };
+
+    static bool matches(const CyphalRoute &route, const CyphalTransferMetadata &metadata)
+    {
+        return (route.port_id == ANY_PORT || route.port_id == metadata.port_id) &&
+               metadata.destination_node_id >= route.destinations.start_id &&
+               metadata.destination_node_id <= route.destinations.end_id;
+    }
+
+    static bool sameKey(const CyphalRoute &a, uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations)
+    {
+        return a.adapter == adapter && a.port_id == port_id &&
+               a.destinations.start_id == destinations.start_id && a.destinations.end_id == destinations.end_id;
+    }
+
+    bool seen(const CyphalTransferMetadata &metadata) const;
+    void remember(const CyphalTransferMetadata &metadata);
+
+    template <size_t I = 0, typename... Adapters>
+    int32_t forwardOn(size_t index, const CyphalTransfer &transfer, std::tuple<Adapters...> &adapters);
+
+private:
+    ArrayList<CyphalRoute, ROUTES> routes_;
+    std::array<Seen, HISTORY> history_{};
+    size_t history_head_ = 0;
+    size_t history_size_ = 0;
+    uint32_t suppressed_ = 0;
+    uint32_t unrouted_ = 0;
+};
+
+// -----------------------------------------------------------------------------
+// IMPLEMENTATIONS
+// -----------------------------------------------------------------------------
+
+template <size_t ROUTES, size_t HISTORY>
+bool CyphalRouter<ROUTES, HISTORY>::addRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations)
+{
+    if (adapter >= MAX_ADAPTERS || destinations.start_id > destinations.end_id)
+        return false;
+    if (findRoute(adapter, port_id, destinations) != nullptr)
+        return true;
+    if (routes_.full())
+        return false;
+
+    routes_.push(CyphalRoute{adapter, port_id, destinations, 0, 0});
+    return true;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+bool CyphalRouter<ROUTES, HISTORY>::removeRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations)
+{
+    for (size_t i = 0; i < routes_.size(); ++i)
+    {
+        if (sameKey(routes_[i], adapter, port_id, destinations))
+        {
+            routes_.remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+void CyphalRouter<ROUTES, HISTORY>::clear()
+{
+    routes_ = ArrayList<CyphalRoute, ROUTES>();
+    history_head_ = 0;
+    history_size_ = 0;
+    suppressed_ = 0;
+    unrouted_ = 0;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+const CyphalRoute *CyphalRouter<ROUTES, HISTORY>::findRoute(uint8_t adapter, CyphalPortID port_id, CyphalForwardRange destinations) const
+{
+    for (size_t i = 0; i < routes_.size(); ++i)
+    {
+        if (sameKey(routes_[i], adapter, port_id, destinations))
+            return &routes_[i];
+    }
+    return nullptr;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+template <typename... Adapters>
+bool CyphalRouter<ROUTES, HISTORY>::forward(const CyphalTransfer &transfer, std::tuple<Adapters...> &adapters, uint8_t ingress)
+{
+    static_assert(sizeof...(Adapters) <= MAX_ADAPTERS, "too many adapters for the route mask");
+
+    const CyphalTransferMetadata &metadata = transfer.metadata;
+    if (seen(metadata))
+    {
+        ++suppressed_;
+        return true;
+    }
+
+    // the first matching route of an adapter forwards, later ones would duplicate
+    uint32_t done = 0;
+    bool all_successful = true;
+    for (size_t i = 0; i < routes_.size(); ++i)
+    {
+        CyphalRoute &route = routes_[i];
+        const uint32_t bit = uint32_t{1} << route.adapter;
+        if (route.adapter >= sizeof...(Adapters) || route.adapter == ingress || (done & bit) != 0 || !matches(route, metadata))
+            continue;
+
+        done |= bit;
+        if (forwardOn(route.adapter, transfer, adapters) > 0)
+        {
+            ++route.forwarded;
+        }
+        else
+        {
+            ++route.failed;
+            all_successful = false;
+        }
+    }
+
+    if (done == 0)
+        ++unrouted_;
+    else
+        remember(metadata);
+    return all_successful;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+template <size_t I, typename... Adapters>
+int32_t CyphalRouter<ROUTES, HISTORY>::forwardOn(size_t index, const CyphalTransfer &transfer, std::tuple<Adapters...> &adapters)
+{
+    if constexpr (I < sizeof...(Adapters))
+    {
+        if (index == I)
+            return std::get<I>(adapters).cyphalTxForward(static_cast<CyphalMicrosecond>(0), &transfer.metadata, transfer.payload_size, transfer.payload, transfer.metadata.source_node_id);
+        return forwardOn<I + 1>(index, transfer, adapters);
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+// Anonymous transfers cannot be told apart and are never suppressed
+template <size_t ROUTES, size_t HISTORY>
+bool CyphalRouter<ROUTES, HISTORY>::seen(const CyphalTransferMetadata &metadata) const
+{
+    if (metadata.source_node_id == CYPHAL_NODE_ID_UNSET)
+        return false;
+
+    for (size_t i = 0; i < history_size_; ++i)
+    {
+        const Seen &s = history_[i];
+        if (s.source_node_id == metadata.source_node_id && s.transfer_kind == metadata.transfer_kind &&
+            s.port_id == metadata.port_id && s.transfer_id == metadata.transfer_id)
+            return true;
+    }
+    return false;
+}
+
+template <size_t ROUTES, size_t HISTORY>
+void CyphalRouter<ROUTES, HISTORY>::remember(const CyphalTransferMetadata &metadata)
+{
+    if (metadata.source_node_id == CYPHAL_NODE_ID_UNSET)
+        return;
+
+    history_[history_head_] = Seen{metadata.source_node_id, metadata.transfer_kind, metadata.port_id, metadata.transfer_id};
+    history_head_ = (history_head_ + 1) % HISTORY;
+    if (history_size_ < HISTORY)
+        ++history_size_;
+}
+
+#endif // INC_CyphalRouter_HPP_
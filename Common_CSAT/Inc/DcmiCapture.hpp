@@ -2,6 +2,10 @@
 #define __DCMICapture_HPP__
 
 #include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+#include <concepts>
 
 #ifdef __arm__
 #include "stm32l4xx_hal.h"
@@ -11,6 +15,34 @@
 #endif
 
 #include "CameraDriver.hpp"
+#include "ImageBufferConcept.hpp"
+
+// ─────────────────────────────────────────────
+// Streaming capture
+//
+// The DMA runs circular over a small ring split in two halves. The half and
+// full transfer interrupts mark a half as filled, the DCMI frame interrupt
+// marks the end of the frame and how far the last half got. poll() hands the
+// filled halves to the consumer from task context, so slow writes (NAND)
+// never run in the interrupt, and the frame never has to fit in SRAM. With
+// two halves unread the DMA refills the older one; unless the frame ends right
+// on that half boundary, the frame is aborted and reported as Overrun.
+// ─────────────────────────────────────────────
+template <typename T>
+concept DcmiConsumer = requires(T c, const uint8_t *data, size_t size) {
+    { c.onData(data, size) } -> std::same_as<bool>;
+    { c.onFrameEnd() } -> std::same_as<bool>;
+    { c.onAbort() };
+};
+
+enum class DcmiStreamState : uint8_t
+{
+    Idle,      // nothing armed
+    Capturing, // frame in progress
+    FrameDone, // whole frame handed to the consumer
+    Overrun,   // consumer too slow, frame aborted
+    Error      // DMA transfer error or consumer refused data
+};
 
 class DcmiCapture
 {
@@ -48,9 +80,9 @@ public:
     {
         // Configure DMA2 Channel 6
         DMA2_Channel6->CCR = 0;
-        DMA2_Channel6->CPAR = (uint32_t)&DCMI->DR;
-        DMA2_Channel6->CMAR = (uint32_t)buffer;
-        DMA2_Channel6->CNDTR = words;
+        DMA2_Channel6->CPAR = reinterpret_cast<uintptr_t>(&DCMI->DR);
+        DMA2_Channel6->CMAR = reinterpret_cast<uintptr_t>(buffer);
+        DMA2_Channel6->CNDTR = static_cast<uint32_t>(words);
 
         DMA2_Channel6->CCR =
             DMA_CCR_MINC |
@@ -90,8 +122,8 @@ public:
         // 2. Start DMA + DCMI
         start(buffer, words);
 
-        // 3. Wait a short time
-        for (uint32_t i = 0; i < 1000000; ++i) { __asm__ volatile("nop"); }
+        // 3. Give the sensor time for a few lines
+        HAL_Delay(POLARITY_TEST_MS);
 
         // 4. Stop capture
         stop();
@@ -146,9 +178,326 @@ public:
         return false;
     }
 
+    // ─────────────────────────────────────────────
+    // Streaming capture of one frame (snapshot mode) through a ring of
+    // `words` 32-bit words; `words` must be even, each half is one chunk
+    // handed to the consumer
+    // ─────────────────────────────────────────────
+    bool startStream(uint32_t *ring, size_t words)
+    {
+        if (ring == nullptr || words < 2 || (words & 1U) != 0 ||
+            stream_ == DcmiStreamState::Capturing)
+            return false;
+
+        ring_      = ring;
+        ringWords_ = words;
+        produced_  = 0;
+        consumed_  = 0;
+        tailWords_ = 0;
+        frameEnd_  = false;
+        overrun_   = false;
+        dmaError_  = false;
+        stream_    = DcmiStreamState::Capturing;
+
+        DMA2->IFCR = DMA_IFCR_CGIF6 | DMA_IFCR_CTCIF6 | DMA_IFCR_CHTIF6 | DMA_IFCR_CTEIF6;
+
+        DMA2_Channel6->CCR = 0;
+        DMA2_Channel6->CPAR = reinterpret_cast<uintptr_t>(&DCMI->DR);
+        DMA2_Channel6->CMAR = reinterpret_cast<uintptr_t>(ring);
+        DMA2_Channel6->CNDTR = static_cast<uint32_t>(words);
+        DMA2_Channel6->CCR =
+            DMA_CCR_MINC |
+            DMA_CCR_CIRC |
+            DMA_CCR_PSIZE_1 | // 32-bit
+            DMA_CCR_MSIZE_1 | // 32-bit
+            DMA_CCR_HTIE |
+            DMA_CCR_TCIE |
+            DMA_CCR_TEIE;
+        DMA2_Channel6->CCR |= DMA_CCR_EN;
+
+        // snapshot: the DCMI stops by itself after one frame
+        DCMI->ICR = DCMI_ICR_FRAME_ISC | DCMI_ICR_OVR_ISC;
+        DCMI->IER |= DCMI_IER_FRAME_IE | DCMI_IER_OVR_IE;
+        DCMI->CR &= ~DCMI_CR_CM;
+        DCMI->CR |= DCMI_CR_CAPTURE;
+
+        return true;
+    }
+
+    // DMA2_Channel6_IRQHandler
+    void dmaInterrupt()
+    {
+        const uint32_t isr = DMA2->ISR;
+
+        if (isr & DMA_ISR_TEIF6)
+        {
+            DMA2->IFCR = DMA_IFCR_CGIF6 | DMA_IFCR_CTEIF6;
+            dmaError_ = true;
+            stopStream();
+            return;
+        }
+        // a late interrupt can see both; the first half is the older one
+        if (isr & DMA_ISR_HTIF6)
+        {
+            DMA2->IFCR = DMA_IFCR_CHTIF6;
+            halfFilled();
+        }
+        if (isr & DMA_ISR_TCIF6)
+        {
+            DMA2->IFCR = DMA_IFCR_CTCIF6;
+            halfFilled();
+        }
+    }
+
+    // DCMI_IRQHandler
+    void dcmiInterrupt()
+    {
+        const uint32_t mis = DCMI->MISR;
+
+        if (mis & DCMI_MIS_OVR_MIS)
+        {
+            DCMI->ICR = DCMI_ICR_OVR_ISC;
+            overrun_ = true;
+            stopStream();
+        }
+        if (mis & DCMI_MIS_FRAME_MIS)
+        {
+            DCMI->ICR = DCMI_ICR_FRAME_ISC;
+
+            // words the DMA moved into the half it is filling now
+            const size_t half    = ringWords_ / 2;
+            const size_t written = ringWords_ - DMA2_Channel6->CNDTR;
+            tailWords_ = written >= half ? written - half : written;
+
+            // the tail went into a half that was not read yet
+            if (tailWords_ > 0 && produced_ - consumed_ >= 2)
+                overrun_ = true;
+
+            stopStream();
+            frameEnd_ = true;
+        }
+    }
+
+    // Task context: hand filled halves (and the last, partial one) over
+    template <DcmiConsumer Consumer>
+    DcmiStreamState poll(Consumer &consumer)
+    {
+        if (stream_ != DcmiStreamState::Capturing)
+            return stream_;
+
+        const size_t halfWords = ringWords_ / 2;
+        while (!overrun_ && !dmaError_ && consumed_ != produced_)
+        {
+            // the older of two unread halves is only intact once the frame ended
+            if (produced_ - consumed_ >= 2 && !frameEnd_)
+                break;
+            if (!consumer.onData(halfAt(consumed_), halfWords * sizeof(uint32_t)))
+                return abortStream(consumer, DcmiStreamState::Error);
+            consumed_ = consumed_ + 1;
+        }
+
+        // the DMA may have lapped the consumer while it was busy
+        if (overrun_)
+            return abortStream(consumer, DcmiStreamState::Overrun);
+        if (dmaError_)
+            return abortStream(consumer, DcmiStreamState::Error);
+
+        if (frameEnd_ && consumed_ == produced_)
+        {
+            if (tailWords_ > 0 &&
+                !consumer.onData(halfAt(consumed_), tailWords_ * sizeof(uint32_t)))
+                return abortStream(consumer, DcmiStreamState::Error);
+
+            stream_ = consumer.onFrameEnd() ? DcmiStreamState::FrameDone : DcmiStreamState::Error;
+        }
+        return stream_;
+    }
+
+    DcmiStreamState streamState() const { return stream_; }
+
+    void stopStream()
+    {
+        DCMI->CR &= ~DCMI_CR_CAPTURE;
+        DMA2_Channel6->CCR &= ~DMA_CCR_EN;
+    }
+
 public:
     bool workingHsync, workingVsync;
 
+private:
+    void halfFilled()
+    {
+        produced_ = produced_ + 1;
+        // three unread halves: the DMA refilled one of them completely. With
+        // two, the frame end tells whether anything was written into the older
+        if (produced_ - consumed_ > 2)
+        {
+            overrun_ = true;
+            stopStream();
+        }
+    }
+
+    const uint8_t *halfAt(uint32_t index) const
+    {
+        return reinterpret_cast<const uint8_t *>(ring_ + (index & 1U) * (ringWords_ / 2));
+    }
+
+    template <typename Consumer>
+    DcmiStreamState abortStream(Consumer &consumer, DcmiStreamState reason)
+    {
+        stopStream();
+        consumer.onAbort();
+        stream_ = reason;
+        return stream_;
+    }
+
+    static constexpr uint32_t POLARITY_TEST_MS = 10;
+
+    uint32_t *ring_ = nullptr;
+    size_t ringWords_ = 0;
+    DcmiStreamState stream_ = DcmiStreamState::Idle;
+
+    // shared with the interrupts
+    volatile uint32_t produced_ = 0;  // halves filled by the DMA
+    volatile uint32_t consumed_ = 0;  // halves handed to the consumer
+    volatile size_t tailWords_ = 0;   // words of the last, partial half
+    volatile bool frameEnd_ = false;
+    volatile bool overrun_ = false;
+    volatile bool dmaError_ = false;
+};
+
+// ─────────────────────────────────────────────
+// Consumer writing a frame straight into an ImageBuffer. An entry has to be
+// sized when it is opened but the frame length is only known at its end, so
+// the frame is stored as CHNK entries of segment_size payload bytes, numbered
+// in dimensions.n3. Each segment ends in a DcmiSegmentTrailer telling the
+// frame format, how many frame bytes it holds and whether it is the last one;
+// the rest is zero. With
+// segment_size chosen so an entry fills its erase blocks, a frame takes the
+// blocks an entry of its exact size would. Segments of an aborted frame have
+// no last one and are dropped by readers.
+// ─────────────────────────────────────────────
+#pragma pack(push, 1)
+struct DcmiSegmentTrailer
+{
+    uint32_t bytes; // frame bytes at the start of this segment
+    uint16_t index; // same as dimensions.n3
+    uint16_t last;  // 1 for the final segment of the frame
+    METADATA_FORMAT format; // of the frame, the entries are CHNK
+};
+#pragma pack(pop)
+
+template <ImageBufferConcept ImageBufferT>
+class DcmiImageBufferConsumer
+{
+public:
+    DcmiImageBufferConsumer(ImageBufferT &buffer, size_t segment_size)
+        : buffer_(buffer), segmentSize_(segment_size) {}
+
+    // meta.payload_size is the largest frame accepted
+    bool begin(const ImageMetadata &meta)
+    {
+        meta_    = meta;
+        written_ = 0;
+        used_    = 0;
+        index_   = 0;
+        segment_ = false;
+        open_    = segmentSize_ > sizeof(DcmiSegmentTrailer) && buffer_.has_room_for(segmentSize_);
+        return open_;
+    }
+
+    bool onData(const uint8_t *data, size_t size)
+    {
+        if (!open_ || written_ + size > meta_.payload_size)
+            return false;
+
+        while (size > 0)
+        {
+            // a full segment is closed once more data shows it is not the last
+            if (segment_ && used_ == capacity() && !closeSegment(false))
+                return false;
+            if (!segment_ && !openSegment())
+                return false;
+
+            const size_t chunk = std::min(size, capacity() - used_);
+            if (buffer_.add_data_chunk(data, chunk) != ImageBufferError::NO_ERROR)
+                return false;
+            used_    += chunk;
+            written_ += chunk;
+            data     += chunk;
+            size     -= chunk;
+        }
+        return true;
+    }
+
+    bool onFrameEnd()
+    {
+        if (!open_)
+            return false;
+        open_ = false;
+
+        return (segment_ || openSegment()) && closeSegment(true);
+    }
+
+    // An open segment is not pushed; the next add_image() reuses its space
+    void onAbort()
+    {
+        open_    = false;
+        segment_ = false;
+    }
+
+    size_t written() const { return written_; }
+    uint16_t segments() const { return index_; }
+
+private:
+    size_t capacity() const { return segmentSize_ - sizeof(DcmiSegmentTrailer); }
+
+    bool openSegment()
+    {
+        if (index_ == UINT16_MAX)
+            return false;
+
+        ImageMetadata segment = meta_;
+        segment.format        = METADATA_FORMAT::CHNK;
+        segment.payload_size  = static_cast<uint32_t>(segmentSize_);
+        segment.dimensions.n3 = index_;
+        segment_ = buffer_.add_image(segment) == ImageBufferError::NO_ERROR;
+        used_    = 0;
+        return segment_;
+    }
+
+    bool closeSegment(bool last)
+    {
+        const DcmiSegmentTrailer trailer{static_cast<uint32_t>(used_), index_,
+                                         static_cast<uint16_t>(last ? 1U : 0U), meta_.format};
+
+        static constexpr std::array<uint8_t, 64> zeros{};
+        while (used_ < capacity())
+        {
+            const size_t chunk = std::min(zeros.size(), capacity() - used_);
+            if (buffer_.add_data_chunk(zeros.data(), chunk) != ImageBufferError::NO_ERROR)
+                return false;
+            used_ += chunk;
+        }
+
+        if (buffer_.add_data_chunk(reinterpret_cast<const uint8_t *>(&trailer), sizeof(trailer)) !=
+                ImageBufferError::NO_ERROR ||
+            buffer_.push_image() != ImageBufferError::NO_ERROR)
+            return false;
+
+        segment_ = false;
+        ++index_;
+        return true;
+    }
+
+    ImageBufferT &buffer_;
+    const size_t segmentSize_;
+    ImageMetadata meta_{};
+    size_t   written_ = 0; // frame bytes accepted
+    size_t   used_    = 0; // frame bytes in the open segment
+    uint16_t index_   = 0; // segments pushed
+    bool     segment_ = false;
+    bool     open_    = false;
 };
 
 #endif // __DCMICapture_HPP__
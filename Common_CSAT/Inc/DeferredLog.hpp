@@ -0,0 +1,595 @@
+#ifndef INC_DEFERREDLOG_HPP_
+#define INC_DEFERREDLOG_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "Logger.hpp"
+
+//
+// Deferred binary logging
+//
+// LOG_DEFERRED(level, format, args...) stores a pointer to a per call site
+// descriptor, the tick and the raw arguments in a lock-free ring. Nothing is
+// formatted on the calling path. TaskDrainLog formats the entries later from
+// the main loop, or sends them as binary frames for the ground decoder.
+//
+// Calls below LOG_LEVEL are discarded at compile time together with the
+// evaluation of their arguments.
+//
+
+#ifndef LOG_DEFERRED_SLOTS
+#define LOG_DEFERRED_SLOTS 64U
+#endif
+
+#ifndef LOG_DEFERRED_SLOT_SIZE
+#define LOG_DEFERRED_SLOT_SIZE 48U
+#endif
+
+namespace deferred_log
+{
+
+#ifdef LOGGER_ENABLED
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    // Format string ID: 32 bit FNV-1a of the format string
+    constexpr uint32_t fnv1a(const char *str)
+    {
+        uint32_t hash = 2166136261U;
+        for (; *str != '\0'; ++str)
+        {
+            hash ^= static_cast<uint8_t>(*str);
+            hash *= 16777619U;
+        }
+        return hash;
+    }
+
+    enum class ArgType : uint8_t
+    {
+        I32 = 0,
+        U32 = 1,
+        I64 = 2,
+        U64 = 3,
+        F32 = 4,
+        F64 = 5,
+        STR = 6,   // u8 length + characters
+        BYTES = 7, // u8 length + bytes, printed as hex by %s
+    };
+
+    constexpr size_t argSize(ArgType type)
+    {
+        switch (type)
+        {
+        case ArgType::I64:
+        case ArgType::U64:
+        case ArgType::F64:
+            return 8;
+        case ArgType::STR:
+        case ArgType::BYTES:
+            return 1;
+        default:
+            return 4;
+        }
+    }
+
+    // Raw bytes to be printed as hex, replaces uchar_buffer_to_hex on hot paths
+    struct Bytes
+    {
+        const void *data;
+        size_t size;
+    };
+
+    // One per call site, lives in flash
+    struct Site
+    {
+        uint32_t id;
+        uint8_t level;
+        const char *format;
+    };
+
+    template <typename T>
+    constexpr ArgType argType()
+    {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<U, Bytes>)
+            return ArgType::BYTES;
+        else if constexpr (std::is_same_v<U, const char *> || std::is_same_v<U, char *> ||
+                           (std::is_array_v<U> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char>))
+            return ArgType::STR;
+        else if constexpr (std::is_enum_v<U>)
+            return argType<std::underlying_type_t<U>>();
+        else if constexpr (std::is_same_v<U, float>)
+            return ArgType::F32;
+        else if constexpr (std::is_floating_point_v<U>)
+            return ArgType::F64;
+        else if constexpr (std::is_pointer_v<U>)
+            return sizeof(U) > 4 ? ArgType::U64 : ArgType::U32;
+        else if constexpr (std::is_integral_v<U>)
+        {
+            if constexpr (sizeof(U) > 4)
+                return std::is_signed_v<U> ? ArgType::I64 : ArgType::U64;
+            else
+                return std::is_signed_v<U> ? ArgType::I32 : ArgType::U32;
+        }
+        else
+            static_assert(sizeof(U) == 0, "LOG_DEFERRED argument type not supported");
+    }
+
+    template <typename... Args>
+    inline constexpr std::array<ArgType, sizeof...(Args)> ARG_TYPES = {argType<Args>()...};
+
+    // Serializes the arguments into a slot payload, truncates strings to what fits
+    class PayloadWriter
+    {
+    public:
+        PayloadWriter(uint8_t *data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+        template <typename T>
+        void put(const T &value)
+        {
+            using U = std::remove_cvref_t<T>;
+            constexpr ArgType type = argType<U>();
+            if constexpr (type == ArgType::BYTES)
+                putBlock(value.data, value.size);
+            else if constexpr (type == ArgType::STR)
+            {
+                const char *str = value;
+                putBlock(str, str ? strlen(str) : 0);
+            }
+            else if constexpr (std::is_enum_v<U>)
+                put(static_cast<std::underlying_type_t<U>>(value));
+            else if constexpr (std::is_pointer_v<U>)
+                put(reinterpret_cast<uintptr_t>(value));
+            else if constexpr (type == ArgType::I32)
+                putRaw(static_cast<int32_t>(value));
+            else if constexpr (type == ArgType::U32)
+                putRaw(static_cast<uint32_t>(value));
+            else if constexpr (type == ArgType::I64)
+                putRaw(static_cast<int64_t>(value));
+            else if constexpr (type == ArgType::U64)
+                putRaw(static_cast<uint64_t>(value));
+            else if constexpr (type == ArgType::F32)
+                putRaw(static_cast<float>(value));
+            else
+                putRaw(static_cast<double>(value));
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+        template <typename T>
+        void putRaw(T value)
+        {
+            if (size_ + sizeof(T) > capacity_)
+            {
+                size_ = capacity_;
+                return;
+            }
+            std::memcpy(data_ + size_, &value, sizeof(T));
+            size_ += sizeof(T);
+        }
+
+        void putBlock(const void *block, size_t length)
+        {
+            if (size_ >= capacity_)
+                return;
+            const size_t room = capacity_ - size_ - 1;
+            const auto n = static_cast<uint8_t>(length < room ? length : room);
+            data_[size_++] = n;
+            if (n > 0)
+                std::memcpy(data_ + size_, block, n);
+            size_ += n;
+        }
+
+        uint8_t *data_;
+        size_t capacity_;
+        size_t size_ = 0;
+    };
+
+    // A recorded entry, payload points into the ring until pop()
+    struct Entry
+    {
+        const Site *site;
+        const ArgType *types;
+        uint8_t count;
+        uint8_t size;
+        uint32_t tick;
+        const uint8_t *payload;
+    };
+
+    //
+    // Bounded multi producer, single consumer ring with a sequence number per
+    // slot. Producers claim a slot with a CAS on head_ and publish it with a
+    // release store of the sequence, so tasks and interrupts can record
+    // concurrently. The sequence is stored relative to the slot index so the
+    // zero initialized ring is already valid before any constructor runs.
+    //
+    template <size_t SLOTS, size_t SLOT_SIZE>
+    class DeferredLogRing
+    {
+        static_assert(SLOTS > 0 && (SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+        static_assert(SLOT_SIZE <= 255, "payload size is stored in a byte");
+
+    public:
+        template <typename... Args>
+        bool record(const Site &site, Args... args)
+        {
+            uint32_t pos = head_.load(std::memory_order_relaxed);
+            Slot *slot;
+            for (;;)
+            {
+                slot = &slots_[pos & MASK];
+                const uint32_t seq = slot->sequence.load(std::memory_order_acquire) + (pos & MASK);
+                const auto diff = static_cast<int32_t>(seq - pos);
+                if (diff == 0)
+                {
+                    if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                else
+                {
+                    pos = head_.load(std::memory_order_relaxed);
+                }
+            }
+
+            PayloadWriter writer(slot->payload.data(), SLOT_SIZE);
+            (writer.put(args), ...);
+
+            slot->site = &site;
+            slot->types = ARG_TYPES<Args...>.data();
+            slot->count = static_cast<uint8_t>(sizeof...(Args));
+            slot->size = static_cast<uint8_t>(writer.size());
+            slot->tick = HAL_GetTick();
+            slot->sequence.store(pos + 1 - (pos & MASK), std::memory_order_release);
+            return true;
+        }
+
+        // Oldest committed entry, stays valid until pop()
+        bool peek(Entry &entry) const
+        {
+            const uint32_t pos = tail_.load(std::memory_order_relaxed);
+            const Slot &slot = slots_[pos & MASK];
+            if (slot.sequence.load(std::memory_order_acquire) + (pos & MASK) != pos + 1)
+                return false;
+
+            entry = {slot.site, slot.types, slot.count, slot.size, slot.tick, slot.payload.data()};
+            return true;
+        }
+
+        void pop()
+        {
+            const uint32_t pos = tail_.load(std::memory_order_relaxed);
+            slots_[pos & MASK].sequence.store(pos + static_cast<uint32_t>(SLOTS) - (pos & MASK), std::memory_order_release);
+            tail_.store(pos + 1, std::memory_order_relaxed);
+        }
+
+        size_t size() const
+        {
+            return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+        }
+
+        uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+        static constexpr size_t capacity() { return SLOTS; }
+        static constexpr size_t payloadCapacity() { return SLOT_SIZE; }
+
+    private:
+        static constexpr uint32_t MASK = static_cast<uint32_t>(SLOTS - 1);
+
+        struct Slot
+        {
+            std::atomic<uint32_t> sequence{0};
+            const Site *site = nullptr;
+            const ArgType *types = nullptr;
+            uint8_t count = 0;
+            uint8_t size = 0;
+            uint32_t tick = 0;
+            std::array<uint8_t, SLOT_SIZE> payload{};
+        };
+
+        std::array<Slot, SLOTS> slots_{};
+        std::atomic<uint32_t> head_{0};
+        std::atomic<uint32_t> tail_{0};
+        std::atomic<uint32_t> dropped_{0};
+    };
+
+    using Ring = DeferredLogRing<LOG_DEFERRED_SLOTS, LOG_DEFERRED_SLOT_SIZE>;
+
+    inline Ring ring;
+
+    template <typename... Args>
+    inline void record(const Site &site, Args... args)
+    {
+        (void)ring.record(site, args...);
+    }
+
+    //
+    // Formatting: the printf conversions of the format string are applied one
+    // at a time to the stored arguments, length modifiers are taken from the
+    // stored type, so the same code runs on the target and on the ground
+    //
+
+    class PayloadReader
+    {
+    public:
+        PayloadReader(const ArgType *types, size_t count, const uint8_t *data, size_t size)
+            : types_(types), count_(count), data_(data), size_(size) {}
+
+        bool next(ArgType &type, const uint8_t *&value, size_t &length)
+        {
+            if (index_ >= count_)
+                return false;
+            type = types_[index_++];
+            const size_t fixed = argSize(type);
+            if (offset_ + fixed > size_)
+                return false;
+            if (type == ArgType::STR || type == ArgType::BYTES)
+            {
+                length = data_[offset_];
+                if (offset_ + 1 + length > size_)
+                    return false;
+                value = data_ + offset_ + 1;
+                offset_ += 1 + length;
+            }
+            else
+            {
+                length = fixed;
+                value = data_ + offset_;
+                offset_ += fixed;
+            }
+            return true;
+        }
+
+    private:
+        const ArgType *types_;
+        size_t count_;
+        const uint8_t *data_;
+        size_t size_;
+        size_t index_ = 0;
+        size_t offset_ = 0;
+    };
+
+    class TextWriter
+    {
+    public:
+        TextWriter(char *out, size_t capacity) : out_(out), capacity_(capacity)
+        {
+            if (capacity_ > 0)
+                out_[0] = '\0';
+        }
+
+        void put(char c)
+        {
+            if (size_ + 1 < capacity_)
+            {
+                out_[size_++] = c;
+                out_[size_] = '\0';
+            }
+        }
+
+        template <typename T>
+        void print(const char *spec, T value)
+        {
+            if (size_ + 1 >= capacity_)
+                return;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+            const int n = snprintf(out_ + size_, capacity_ - size_, spec, value);
+#pragma GCC diagnostic pop
+            if (n > 0)
+                size_ = std::min(size_ + static_cast<size_t>(n), capacity_ - 1);
+        }
+
+        size_t size() const { return size_; }
+
+    private:
+        char *out_;
+        size_t capacity_;
+        size_t size_ = 0;
+    };
+
+    template <typename T>
+    T loadValue(const uint8_t *value)
+    {
+        T v;
+        std::memcpy(&v, value, sizeof(T));
+        return v;
+    }
+
+    inline int64_t asSigned(ArgType type, const uint8_t *value)
+    {
+        switch (type)
+        {
+        case ArgType::I32: return loadValue<int32_t>(value);
+        case ArgType::U32: return loadValue<uint32_t>(value);
+        case ArgType::I64: return loadValue<int64_t>(value);
+        case ArgType::U64: return static_cast<int64_t>(loadValue<uint64_t>(value));
+        case ArgType::F32: return static_cast<int64_t>(loadValue<float>(value));
+        case ArgType::F64: return static_cast<int64_t>(loadValue<double>(value));
+        default: return 0;
+        }
+    }
+
+    inline double asDouble(ArgType type, const uint8_t *value)
+    {
+        switch (type)
+        {
+        case ArgType::F32: return static_cast<double>(loadValue<float>(value));
+        case ArgType::F64: return loadValue<double>(value);
+        case ArgType::U64: return static_cast<double>(loadValue<uint64_t>(value));
+        default: return static_cast<double>(asSigned(type, value));
+        }
+    }
+
+    // Formats a recorded argument list, returns the length of the text
+    inline size_t format(const char *fmt, const ArgType *types, size_t count, const uint8_t *payload, size_t size,
+                         char *out, size_t capacity)
+    {
+        TextWriter text(out, capacity);
+        PayloadReader args(types, count, payload, size);
+
+        while (*fmt != '\0')
+        {
+            if (*fmt != '%')
+            {
+                text.put(*fmt++);
+                continue;
+            }
+            if (fmt[1] == '%')
+            {
+                text.put('%');
+                fmt += 2;
+                continue;
+            }
+
+            // %[flags][width][.precision][length]conversion, length is dropped
+            char spec[24] = "%";
+            size_t n = 1;
+            ++fmt;
+            while (*fmt != '\0' && std::strchr("-+ #0123456789.", *fmt) != nullptr && n < sizeof(spec) - 4)
+                spec[n++] = *fmt++;
+            while (*fmt != '\0' && std::strchr("hlLqjzt", *fmt) != nullptr)
+                ++fmt;
+            const char conversion = *fmt;
+            if (conversion == '\0')
+                break;
+            ++fmt;
+
+            ArgType type;
+            const uint8_t *value = nullptr;
+            size_t length = 0;
+            if (!args.next(type, value, length))
+            {
+                text.put('?');
+                continue;
+            }
+
+            switch (conversion)
+            {
+            case 'd':
+            case 'i':
+                spec[n++] = 'l';
+                spec[n++] = 'l';
+                spec[n++] = conversion;
+                text.print(spec, static_cast<long long>(asSigned(type, value)));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            {
+                // %x of a negative int32 prints its 32 bit pattern, as printf would
+                const uint64_t v = type == ArgType::I32 ? static_cast<uint32_t>(loadValue<int32_t>(value))
+                                                        : static_cast<uint64_t>(asSigned(type, value));
+                spec[n++] = 'l';
+                spec[n++] = 'l';
+                spec[n++] = conversion;
+                text.print(spec, static_cast<unsigned long long>(v));
+                break;
+            }
+            case 'c':
+                spec[n++] = 'c';
+                text.print(spec, static_cast<int>(asSigned(type, value)));
+                break;
+            case 'p':
+                spec[n++] = 'p';
+                text.print(spec, reinterpret_cast<void *>(static_cast<uintptr_t>(asSigned(type, value))));
+                break;
+            case 's':
+                if (type == ArgType::BYTES)
+                {
+                    // same layout as uchar_buffer_to_hex
+                    for (size_t i = 0; i < length; ++i)
+                    {
+                        if (i > 0)
+                            text.put(' ');
+                        text.print("%02X", static_cast<unsigned>(value[i]));
+                    }
+                }
+                else if (type == ArgType::STR)
+                {
+                    char str[256];
+                    std::memcpy(str, value, length);
+                    str[length] = '\0';
+                    spec[n++] = 's';
+                    text.print(spec, static_cast<const char *>(str));
+                }
+                else
+                {
+                    text.put('?');
+                }
+                break;
+            default:
+                // f F e E g G a A
+                spec[n++] = conversion;
+                text.print(spec, asDouble(type, value));
+                break;
+            }
+        }
+        return text.size();
+    }
+
+    inline size_t format(const Entry &entry, char *out, size_t capacity)
+    {
+        return format(entry.site->format, entry.types, entry.count, entry.payload, entry.size, out, capacity);
+    }
+
+    //
+    // Binary frame, little endian:
+    //   0xA5, length of the rest, id u32, tick u32, level u8, count u8,
+    //   count type bytes, payload
+    //
+    constexpr uint8_t FRAME_SYNC = 0xA5;
+    constexpr size_t FRAME_HEADER = 12;
+
+    inline size_t encode(const Entry &entry, uint8_t *out, size_t capacity)
+    {
+        const size_t total = FRAME_HEADER + entry.count + entry.size;
+        if (total > capacity || total - 2 > 255)
+            return 0;
+
+        out[0] = FRAME_SYNC;
+        out[1] = static_cast<uint8_t>(total - 2);
+        for (size_t i = 0; i < 4; ++i)
+        {
+            out[2 + i] = static_cast<uint8_t>(entry.site->id >> (8 * i));
+            out[6 + i] = static_cast<uint8_t>(entry.tick >> (8 * i));
+        }
+        out[10] = entry.site->level;
+        out[11] = entry.count;
+        for (size_t i = 0; i < entry.count; ++i)
+            out[FRAME_HEADER + i] = static_cast<uint8_t>(entry.types[i]);
+        if (entry.size > 0)
+            std::memcpy(out + FRAME_HEADER + entry.count, entry.payload, entry.size);
+        return total;
+    }
+
+} // namespace deferred_log
+
+#define LOG_DEFERRED(level, format, ...)                                                            \
+    do                                                                                              \
+    {                                                                                               \
+        if constexpr (deferred_log::ENABLED && (level) >= LOG_LEVEL)                                \
+        {                                                                                           \
+            static constexpr deferred_log::Site deferred_log_site_{deferred_log::fnv1a(format),     \
+                                                                   static_cast<uint8_t>(level),     \
+                                                                   format};                         \
+            deferred_log::record(deferred_log_site_ __VA_OPT__(, ) __VA_ARGS__);                    \
+        }                                                                                           \
+    } while (0)
+
+#endif /* INC_DEFERREDLOG_HPP_ */
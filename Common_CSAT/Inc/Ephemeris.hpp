@@ -0,0 +1,389 @@
+#ifndef INC_EPHEMERIS_HPP_
+#define INC_EPHEMERIS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+
+#include "au.hpp"
+#include "PositionService.hpp"
+#include "TimeUtils.hpp"
+#include "sgp4_tle.hpp"
+#include "imagebuffer/accessor.hpp"
+
+#ifdef __arm__
+#include "stm32l4xx_hal.h"
+#endif
+#ifdef __x86_64__
+#include "mock_hal.h"
+#endif
+
+// -----------------------------------------------------------------------------
+// Ephemeris table
+//
+// The current TLE is propagated ahead once (SGP4 + TEME -> ECEF) at a fixed
+// step and the ECEF samples are kept in a table. Position queries inside the
+// table are answered by cubic Hermite interpolation between the two samples
+// around the query time, with the velocities as the end point derivatives.
+//
+// Samples hold what SGP4::predict() returns: the velocity is the TEME velocity
+// rotated into ECEF, without the Earth rotation term. The time derivative of
+// the ECEF position is v - w x r, the interpolation works on that and adds
+// w x r back, so the table answers exactly like SGP4::predict().
+// -----------------------------------------------------------------------------
+
+#pragma pack(push, 1)
+struct EphemerisSample
+{
+    float r[3]; // m, ECEF
+    float v[3]; // m/s, TEME velocity rotated into ECEF
+};
+#pragma pack(pop)
+
+template <typename S>
+concept EphemerisStorage = requires(S s, size_t index, EphemerisSample &out, const EphemerisSample &in) {
+    { s.capacity() } -> std::convertible_to<size_t>;
+    { s.store(index, in) } -> std::same_as<bool>;
+    { s.load(index, out) } -> std::same_as<bool>;
+};
+
+// Propagator the table is built from, SGP4 in TaskSGP4.hpp
+template <typename P>
+concept EphemerisPropagator = requires(P p, std::chrono::system_clock::time_point when,
+                                       std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r,
+                                       std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v) {
+    { p.predict_at(when, r, v) } -> std::same_as<bool>;
+    { p.getSGP4TLE() } -> std::same_as<SGP4TwoLineElement>;
+};
+
+template <size_t N>
+class RamEphemerisStorage
+{
+public:
+    size_t capacity() const { return N; }
+
+    bool store(size_t index, const EphemerisSample &sample)
+    {
+        if (index >= N)
+            return false;
+        samples_[index] = sample;
+        return true;
+    }
+
+    bool load(size_t index, EphemerisSample &sample) const
+    {
+        if (index >= N)
+            return false;
+        sample = samples_[index];
+        return true;
+    }
+
+private:
+    std::array<EphemerisSample, N> samples_{};
+};
+
+// Table in (a region of) any Accessor, e.g. MR25H10Accessor so the table
+// survives a reset and does not take RAM
+template <Accessor AccessorType>
+class AccessorEphemerisStorage
+{
+public:
+    AccessorEphemerisStorage(AccessorType &accessor, size_t address, size_t size)
+        : accessor_(accessor), address_(address), capacity_(size / sizeof(EphemerisSample)) {}
+
+    size_t capacity() const { return capacity_; }
+
+    bool store(size_t index, const EphemerisSample &sample)
+    {
+        if (index >= capacity_)
+            return false;
+        return accessor_.write(address_ + index * sizeof(EphemerisSample),
+                               reinterpret_cast<const uint8_t *>(&sample), sizeof(EphemerisSample)) == AccessorError::NO_ERROR;
+    }
+
+    bool load(size_t index, EphemerisSample &sample) const
+    {
+        if (index >= capacity_)
+            return false;
+        return accessor_.read(address_ + index * sizeof(EphemerisSample),
+                              reinterpret_cast<uint8_t *>(&sample), sizeof(EphemerisSample)) == AccessorError::NO_ERROR;
+    }
+
+private:
+    AccessorType &accessor_;
+    size_t address_;
+    size_t capacity_;
+};
+
+template <EphemerisStorage Storage>
+class Ephemeris
+{
+public:
+    using time_point = std::chrono::system_clock::time_point;
+
+    static constexpr float EARTH_ROTATION_RATE = 7.292115e-5f; // rad/s
+
+    Ephemeris() = delete;
+    explicit Ephemeris(Storage &storage) : storage_(storage) {}
+
+    // Propagates count samples step apart from start. The table is invalid
+    // while it is rebuilt and stays invalid when a prediction fails.
+    template <EphemerisPropagator Propagator>
+    bool build(Propagator &propagator, time_point start, std::chrono::milliseconds step, size_t count);
+
+    void invalidate()
+    {
+        valid_ = false;
+        cached_ = NO_INTERVAL;
+    }
+
+    bool valid() const { return valid_; }
+    time_point start() const { return start_; }
+    time_point end() const { return start_ + step_ * static_cast<int64_t>(count_ - 1); }
+    std::chrono::milliseconds step() const { return step_; }
+    size_t count() const { return count_; }
+    const SGP4TwoLineElement &tle() const { return tle_; }
+
+    bool covers(time_point when) const
+    {
+        return valid_ && when >= start_ && when <= end();
+    }
+
+    // True if the table was built from this TLE
+    bool builtFrom(const SGP4TwoLineElement &tle) const
+    {
+        return valid_ && std::memcmp(&tle, &tle_, sizeof(SGP4TwoLineElement)) == 0;
+    }
+
+    bool interpolate(time_point when,
+                     std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r,
+                     std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v);
+
+private:
+    static constexpr size_t NO_INTERVAL = SIZE_MAX;
+
+    // Samples at both ends of interval index, loaded once while queries stay
+    // inside the interval (two storage reads per step, not per query)
+    bool loadInterval(size_t index);
+
+    Storage &storage_;
+    time_point start_{};
+    std::chrono::milliseconds step_{0};
+    size_t count_ = 0;
+    bool valid_ = false;
+    SGP4TwoLineElement tle_{};
+
+    size_t cached_ = NO_INTERVAL;
+    EphemerisSample first_{};
+    EphemerisSample second_{};
+};
+
+template <EphemerisStorage Storage>
+template <EphemerisPropagator Propagator>
+bool Ephemeris<Storage>::build(Propagator &propagator, time_point start, std::chrono::milliseconds step, size_t count)
+{
+    invalidate();
+    if (count < 2 || count > storage_.capacity() || step.count() <= 0)
+        return false;
+
+    std::array<au::QuantityF<au::MetersInEcefFrame>, 3> r;
+    std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> v;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!propagator.predict_at(start + step * static_cast<int64_t>(i), r, v))
+            return false;
+
+        EphemerisSample sample;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            sample.r[k] = r[k].in(au::meters * au::ecefs);
+            sample.v[k] = v[k].in(au::meters * au::ecefs / au::seconds);
+        }
+        if (!storage_.store(i, sample))
+            return false;
+    }
+
+    start_ = start;
+    step_ = step;
+    count_ = count;
+    tle_ = propagator.getSGP4TLE();
+    valid_ = true;
+    return true;
+}
+
+template <EphemerisStorage Storage>
+bool Ephemeris<Storage>::loadInterval(size_t index)
+{
+    if (index == cached_)
+        return true;
+
+    const size_t previous = cached_;
+    cached_ = NO_INTERVAL;
+    bool ok;
+    if (previous != NO_INTERVAL && index + 1 == previous)
+    {
+        second_ = first_;
+        ok = storage_.load(index, first_);
+    }
+    else if (previous != NO_INTERVAL && index == previous + 1)
+    {
+        first_ = second_;
+        ok = storage_.load(index + 1, second_);
+    }
+    else
+    {
+        ok = storage_.load(index, first_) && storage_.load(index + 1, second_);
+    }
+    if (!ok)
+        return false;
+
+    cached_ = index;
+    return true;
+}
+
+template <EphemerisStorage Storage>
+bool Ephemeris<Storage>::interpolate(time_point when,
+                                     std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r,
+                                     std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v)
+{
+    if (!covers(when))
+        return false;
+
+    const int64_t offset = std::chrono::duration_cast<std::chrono::milliseconds>(when - start_).count();
+    const int64_t stepMs = step_.count();
+    size_t index = static_cast<size_t>(offset / stepMs);
+    if (index + 1 >= count_)
+        index = count_ - 2; // end() itself
+    if (!loadInterval(index))
+        return false;
+
+    const float h = static_cast<float>(stepMs) / 1000.0f;
+    const float s = static_cast<float>(offset - static_cast<int64_t>(index) * stepMs) / static_cast<float>(stepMs);
+    const float s2 = s * s;
+    const float s3 = s2 * s;
+
+    // Hermite basis (h00 = 1 - h01 is folded into the offset form below) and
+    // its derivative per unit of s
+    const float h10 = s3 - 2.0f * s2 + s;
+    const float h01 = 3.0f * s2 - 2.0f * s3;
+    const float h11 = s3 - s2;
+    const float d00 = 6.0f * s2 - 6.0f * s;
+    const float d10 = 3.0f * s2 - 4.0f * s + 1.0f;
+    const float d11 = 3.0f * s2 - 2.0f * s;
+
+    const float w = EARTH_ROTATION_RATE;
+    // ECEF time derivative at both ends: v - w x r, w along z
+    const float dp0[3] = {first_.v[0] + w * first_.r[1], first_.v[1] - w * first_.r[0], first_.v[2]};
+    const float dp1[3] = {second_.v[0] + w * second_.r[1], second_.v[1] - w * second_.r[0], second_.v[2]};
+
+    float rp[3], vp[3];
+    for (size_t k = 0; k < 3; ++k)
+    {
+        // interpolate the offset from the first sample, the positions are
+        // ~7e6 m and the float sum of the full terms would lose the metres
+        const float dr = second_.r[k] - first_.r[k];
+        rp[k] = first_.r[k] + h01 * dr + h * (h10 * dp0[k] + h11 * dp1[k]);
+        vp[k] = -d00 * dr / h + d10 * dp0[k] + d11 * dp1[k];
+    }
+
+    vp[0] -= w * rp[1];
+    vp[1] += w * rp[0];
+
+    for (size_t k = 0; k < 3; ++k)
+    {
+        r[k] = au::make_quantity<au::MetersInEcefFrame>(rp[k]);
+        v[k] = au::make_quantity<au::MetersPerSecondInEcefFrame>(vp[k]);
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Position from the ephemeris table, same interface as SGP4Position.
+//
+// predict() interpolates while the RTC time is inside a table built from the
+// current TLE and falls back to a direct SGP4 prediction otherwise. refresh()
+// rebuilds the table from the RTC time on when it runs out within margin or
+// the TLE changed; call it from a low rate task, the build costs count SGP4
+// predictions.
+// -----------------------------------------------------------------------------
+template <typename SGP4, EphemerisStorage Storage>
+    requires EphemerisPropagator<SGP4>
+class EphemerisPosition
+{
+public:
+    EphemerisPosition() = delete;
+
+    EphemerisPosition(RTC_HandleTypeDef *hrtc, SGP4 &sgp4, Ephemeris<Storage> &ephemeris,
+                      std::chrono::milliseconds step = std::chrono::seconds(60), size_t count = 100,
+                      std::chrono::milliseconds margin = std::chrono::minutes(10))
+        : hrtc_(hrtc), sgp4_(sgp4), ephemeris_(ephemeris), step_(step), count_(count), margin_(margin) {}
+
+    bool refresh();
+    bool predict(std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
+    PositionSolution predict();
+
+private:
+    std::chrono::system_clock::time_point now(au::QuantityU64<au::Milli<au::Seconds>> &timestamp) const
+    {
+        TimeUtils::RTCDateTimeSubseconds rtc;
+        HAL_RTC_GetTime(hrtc_, &rtc.time, RTC_FORMAT_BIN);
+        HAL_RTC_GetDate(hrtc_, &rtc.date, RTC_FORMAT_BIN);
+        const TimeUtils::epoch_duration duration = TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
+        timestamp = duration;
+        return TimeUtils::to_timepoint(duration);
+    }
+
+    RTC_HandleTypeDef *hrtc_;
+    SGP4 &sgp4_;
+    Ephemeris<Storage> &ephemeris_;
+    std::chrono::milliseconds step_;
+    size_t count_;
+    std::chrono::milliseconds margin_;
+};
+
+template <typename SGP4, EphemerisStorage Storage>
+    requires EphemerisPropagator<SGP4>
+bool EphemerisPosition<SGP4, Storage>::refresh()
+{
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+    const auto when = now(timestamp);
+    if (ephemeris_.builtFrom(sgp4_.getSGP4TLE()) && ephemeris_.covers(when) && ephemeris_.covers(when + margin_))
+        return true;
+
+    // start on a whole second so the sample times are easy to compare
+    const auto start = std::chrono::floor<std::chrono::seconds>(when);
+    return ephemeris_.build(sgp4_, start, step_, count_);
+}
+
+template <typename SGP4, EphemerisStorage Storage>
+    requires EphemerisPropagator<SGP4>
+bool EphemerisPosition<SGP4, Storage>::predict(std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
+{
+    const auto when = now(timestamp);
+    if (ephemeris_.builtFrom(sgp4_.getSGP4TLE()) && ephemeris_.interpolate(when, r, v))
+        return true;
+    return sgp4_.predict_at(when, r, v);
+}
+
+template <typename SGP4, EphemerisStorage Storage>
+    requires EphemerisPropagator<SGP4>
+PositionSolution EphemerisPosition<SGP4, Storage>::predict()
+{
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+    std::array<au::QuantityF<au::MetersInEcefFrame>, 3> r;
+    std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> v;
+
+    const bool valid = predict(r, v, timestamp);
+
+    return PositionSolution{
+        .timestamp = timestamp,
+        .position = r,
+        .velocity = v,
+        .acceleration = {},
+        .validity_flags = valid ? static_cast<uint8_t>(static_cast<uint8_t>(PositionSolution::Validity::POSITION) | static_cast<uint8_t>(PositionSolution::Validity::VELOCITY)) : uint8_t{0}};
+}
+
+#endif /* INC_EPHEMERIS_HPP_ */
@@ -30,10 +30,12 @@
 #define INC_GNSS_H_
 
 #include <cstdint>
+#include <cstring>
 #include <optional>
 
 #include "GNSSCore.hpp"
 #include "Transport.hpp"
+#include "UBXParser.hpp"
 
 #ifdef __arm__
 #include "usb_device.h"
@@ -109,8 +111,8 @@ public:
 
 private:
 	void loadConfig();
-	uint8_t *findHeader(UBXClass classID, UBXMessageID messageID);
-	uint8_t *request(const uint8_t *request, uint16_t size, UBXClass classID, UBXMessageID messageID);
+	const uint8_t *findHeader(UBXClass classID, UBXMessageID messageID);
+	const uint8_t *request(const uint8_t *request, uint16_t size, UBXClass classID, UBXMessageID messageID);
 
 private:
 	static constexpr uint16_t GNSS_BUFFER_SIZE = 201U;
@@ -119,6 +121,7 @@ private:
 private:
 	const Transport &transport_;
 	uint8_t uart_buffer[GNSS_BUFFER_SIZE];
+	UBXParser<GNSS_BUFFER_SIZE - UBLOX_HEADER_SIZE - 2U> parser_;
 
 };
 
@@ -144,31 +147,20 @@ private:
 // https://content.u-blox.com/sites/default/files/u-blox-M10-SPG-5.10_InterfaceDescription_UBX-21035062.pdf
 
 /*!
- * Searching for a header in data buffer and matching class and message ID to buffer data.
- * @param GNSS Pointer to main GNSS structure.
+ * Scans the whole receive buffer for a complete frame of the requested class and message ID.
+ * Frames with a bad checksum or of another type are skipped.
  */
 template <typename Transport>
 	requires StreamAccessTransport<Transport>
-uint8_t *GNSS<Transport>::findHeader(UBXClass classID, UBXMessageID messageID)
+const uint8_t *GNSS<Transport>::findHeader(UBXClass classID, UBXMessageID messageID)
 {
-	constexpr uint16_t SIZE = sizeof(uart_buffer) / 2;
-	for (uint16_t var = 0; var <= SIZE; ++var)
+	parser_.reset();
+	UBXFrame frame;
+	for (uint16_t var = 0; var < GNSS_BUFFER_SIZE; ++var)
 	{
-		if (uart_buffer[var] == 0xB5 && uart_buffer[var + 1] == 0x62)
+		if (parser_.feed(uart_buffer[var], frame) && frame.cls == static_cast<uint8_t>(classID) && frame.id == static_cast<uint8_t>(messageID))
 		{
-			uint16_t length = GNSSCore::getUShort(uart_buffer, static_cast<uint16_t>(var + 4));
-			uint8_t cka_message = GNSSCore::getUByte(uart_buffer, static_cast<uint16_t>(var + length + UBLOX_HEADER_SIZE));
-			uint8_t ckb_message = GNSSCore::getUByte(uart_buffer, static_cast<uint16_t>(var + length + UBLOX_HEADER_SIZE + 1));
-			uint8_t cka, ckb;
-			GNSSCore::checksum(length + 4U, &uart_buffer[var + 2], &cka, &ckb);
-			if (cka != cka_message && ckb != ckb_message)
-			{
-				return nullptr;
-			}
-			if (uart_buffer[var + 2] == static_cast<uint8_t>(classID) && uart_buffer[var + 3] == static_cast<uint8_t>(messageID))
-			{
-				return uart_buffer + var + UBLOX_HEADER_SIZE;
-			}
+			return frame.payload;
 		}
 	}
 	return nullptr;
@@ -176,9 +168,10 @@ uint8_t *GNSS<Transport>::findHeader(UBXClass classID, UBXMessageID messageID)
 
 template <typename Transport>
 	requires StreamAccessTransport<Transport>
-uint8_t *GNSS<Transport>::request(const uint8_t *request, uint16_t size, UBXClass classID, UBXMessageID messageID)
+const uint8_t *GNSS<Transport>::request(const uint8_t *request, uint16_t size, UBXClass classID, UBXMessageID messageID)
 {
 	transport_.write(const_cast<uint8_t *>(request), size);
+	memset(uart_buffer, 0, sizeof(uart_buffer));
 	transport_.read(uart_buffer, sizeof(uart_buffer));
 	return findHeader(classID, messageID);
 }
@@ -187,7 +180,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<UniqueID> GNSS<Transport>::getUniqID()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_UNIQUE_ID, sizeof(GNSSCore::GET_UNIQUE_ID), UBXClass::MON, UBXMessageID::UNIQ_ID);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_UNIQUE_ID, sizeof(GNSSCore::GET_UNIQUE_ID), UBXClass::MON, UBXMessageID::UNIQ_ID);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseUniqID(messageBuffer);
@@ -200,7 +193,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<UTCTime> GNSS<Transport>::getNavTimeUTC()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_TIME_UTC, sizeof(GNSSCore::GET_NAV_TIME_UTC), UBXClass::NAV, UBXMessageID::UTC_TIME);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_TIME_UTC, sizeof(GNSSCore::GET_NAV_TIME_UTC), UBXClass::NAV, UBXMessageID::UTC_TIME);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavTimeUTC(messageBuffer);
@@ -213,7 +206,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<PositionLLH> GNSS<Transport>::getNavPosLLH()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_POS_LLH, sizeof(GNSSCore::GET_NAV_POS_LLH), UBXClass::NAV, UBXMessageID::POS_LLH);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_POS_LLH, sizeof(GNSSCore::GET_NAV_POS_LLH), UBXClass::NAV, UBXMessageID::POS_LLH);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavPosLLH(messageBuffer);
@@ -226,7 +219,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<PositionECEF> GNSS<Transport>::getNavPosECEF()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_POS_ECEF, sizeof(GNSSCore::GET_NAV_POS_ECEF), UBXClass::NAV, UBXMessageID::POS_ECEF);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_POS_ECEF, sizeof(GNSSCore::GET_NAV_POS_ECEF), UBXClass::NAV, UBXMessageID::POS_ECEF);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavPosECEF(messageBuffer);
@@ -239,7 +232,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<NavigationPVT> GNSS<Transport>::getNavPVT()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_PVT, sizeof(GNSSCore::GET_NAV_PVT), UBXClass::NAV, UBXMessageID::PVT);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_PVT, sizeof(GNSSCore::GET_NAV_PVT), UBXClass::NAV, UBXMessageID::PVT);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavPVT(messageBuffer);
@@ -252,7 +245,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<VelocityNED> GNSS<Transport>::getNavVelNED()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_VEL_NED, sizeof(GNSSCore::GET_NAV_VEL_NED), UBXClass::NAV, UBXMessageID::VEL_NED);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_VEL_NED, sizeof(GNSSCore::GET_NAV_VEL_NED), UBXClass::NAV, UBXMessageID::VEL_NED);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavVelNED(messageBuffer);
@@ -265,7 +258,7 @@ template <typename Transport>
 	requires StreamAccessTransport<Transport>
 std::optional<VelocityECEF> GNSS<Transport>::getNavVelECEF()
 {
-	uint8_t *messageBuffer = request(GNSSCore::GET_NAV_VEL_ECEF, sizeof(GNSSCore::GET_NAV_VEL_ECEF), UBXClass::NAV, UBXMessageID::VEL_ECEF);
+	const uint8_t *messageBuffer = request(GNSSCore::GET_NAV_VEL_ECEF, sizeof(GNSSCore::GET_NAV_VEL_ECEF), UBXClass::NAV, UBXMessageID::VEL_ECEF);
 	if (messageBuffer == nullptr)
 		return std::nullopt;
 	return GNSSCore::parseNavVelECEF(messageBuffer);
@@ -80,13 +80,13 @@ static constexpr bool ValidateChecksum(const uint8_t (&payload)[Size])
 class GNSSCore
 {
 public:
-	static UniqueID parseUniqID(uint8_t *messageBuffer);
-	static UTCTime parseNavTimeUTC(uint8_t *messageBuffer);
-	static PositionLLH parseNavPosLLH(uint8_t *messageBuffer);
-	static PositionECEF parseNavPosECEF(uint8_t *messageBuffer);
-	static NavigationPVT parseNavPVT(uint8_t *messageBuffer);
-	static VelocityECEF parseNavVelECEF(uint8_t *messageBuffer);
-	static VelocityNED parseNavVelNED(uint8_t *messageBuffer);
+	static UniqueID parseUniqID(const uint8_t *messageBuffer);
+	static UTCTime parseNavTimeUTC(const uint8_t *messageBuffer);
+	static PositionLLH parseNavPosLLH(const uint8_t *messageBuffer);
+	static PositionECEF parseNavPosECEF(const uint8_t *messageBuffer);
+	static NavigationPVT parseNavPVT(const uint8_t *messageBuffer);
+	static VelocityECEF parseNavVelECEF(const uint8_t *messageBuffer);
+	static VelocityNED parseNavVelNED(const uint8_t *messageBuffer);
 
 	static uint8_t getUByte(const uint8_t *uartWorkingBuffer, uint16_t offset);
 	static int8_t getIByte(const uint8_t *uartWorkingBuffer, uint16_t offset);
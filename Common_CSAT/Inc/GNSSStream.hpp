@@ -0,0 +1,299 @@
+#ifndef INC_GNSSSTREAM_HPP_
+#define INC_GNSSSTREAM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "GNSS.hpp"
+#include "GNSSCore.hpp"
+#include "Transport.hpp"
+#include "UBXParser.hpp"
+#include "UartDmaRing.hpp"
+
+#ifdef __arm__
+#include "stm32l4xx_hal.h"
+#elif __x86_64__
+#include "mock_hal.h"
+#endif
+
+// https://content.u-blox.com/sites/default/files/u-blox-M10-SPG-5.10_InterfaceDescription_UBX-21035062.pdf
+
+class UBXSubscriber
+{
+public:
+	virtual ~UBXSubscriber() = default;
+
+	virtual void onNavPVT(const NavigationPVT & /*pvt*/) {}
+	virtual void onNavPosECEF(const PositionECEF & /*pos*/) {}
+	virtual void onNavVelECEF(const VelocityECEF & /*vel*/) {}
+};
+
+enum class UBXAck : uint8_t
+{
+	None,
+	Pending,
+	Ack,
+	Nak
+};
+
+/*!
+ * Event driven front end for the receiver: the module outputs NAV messages
+ * periodically, the UART receives them into a circular DMA ring and the main
+ * loop runs the UBX state machine over whatever arrived since the last call.
+ * Nothing blocks on the UART. The latest solutions are kept so the class can
+ * stand in for GNSS<Transport> where only getNavPosECEF/getNavPVT are used.
+ *
+ * Wiring: the USART RX DMA channel must be in circular mode and the
+ * application's HAL_UARTEx_RxEventCallback forwards Size to onRxEvent().
+ */
+template <typename Transport, uint16_t RX_SIZE = 512, size_t MAX_SUBSCRIBERS = 4>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+class GNSSStream
+{
+public:
+	GNSSStream() = delete;
+	explicit GNSSStream(const Transport &transport) : transport_(transport) {}
+
+	bool start();
+	void onRxEvent(uint16_t pos) { ring_.onRxEvent(pos); }
+	size_t process();
+
+	bool subscribe(UBXSubscriber *subscriber);
+	bool configurePeriodic(UBXMessageID messageID, uint8_t rate);
+	UBXAck configAck() const { return ack_; }
+
+	// Latest solution since the previous call, nullopt if none arrived
+	std::optional<PositionECEF> getNavPosECEF();
+	std::optional<NavigationPVT> getNavPVT();
+	std::optional<VelocityECEF> getNavVelECEF();
+	std::optional<UTCTime> getNavTimeUTC();
+
+	uint32_t frames() const { return parser_.frames(); }
+	uint32_t checksumErrors() const { return parser_.checksumErrors(); }
+	uint32_t overruns() const { return ring_.overruns(); }
+
+	// UBX-CFG-VALSET writing a single U1 key into the RAM layer
+	static constexpr size_t VALSET_SIZE = 6U + 9U + 2U;
+	static void buildValSet(uint32_t key, uint8_t value, uint8_t (&frame)[VALSET_SIZE]);
+
+	static constexpr uint8_t CFG_CLASS = 0x06;
+	static constexpr uint8_t CFG_VALSET = 0x8A;
+	static constexpr uint8_t ACK_CLASS = 0x05;
+	static constexpr uint8_t ACK_ACK = 0x01;
+	static constexpr uint8_t ACK_NAK = 0x00;
+
+	// CFG-MSGOUT-UBX_NAV_xxx_UART1 keys
+	static constexpr uint32_t KEY_NAV_PVT_UART1 = 0x20910007;
+	static constexpr uint32_t KEY_NAV_POSECEF_UART1 = 0x20910025;
+	static constexpr uint32_t KEY_NAV_VELECEF_UART1 = 0x2091003E;
+
+private:
+	void dispatch(const UBXFrame &frame);
+
+private:
+	// NAV-PVT has the longest payload of the messages handled here
+	static constexpr uint16_t MAX_PAYLOAD = 92U;
+
+	const Transport &transport_;
+	UartDmaRing<RX_SIZE> ring_;
+	UBXParser<MAX_PAYLOAD> parser_;
+	uint32_t overruns_seen_ = 0;
+
+	std::array<UBXSubscriber *, MAX_SUBSCRIBERS> subscribers_{};
+	size_t subscriber_count_ = 0;
+
+	std::optional<NavigationPVT> pvt_;
+	std::optional<PositionECEF> pos_ecef_;
+	std::optional<VelocityECEF> vel_ecef_;
+	std::optional<UTCTime> utc_;
+	UBXAck ack_ = UBXAck::None;
+};
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+bool GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::start()
+{
+	return HAL_UARTEx_ReceiveToIdle_DMA(&Transport::config_type::handle(), ring_.buffer(), RX_SIZE) == HAL_OK;
+}
+
+/*!
+ * Parses the bytes received since the last call, returns the number of frames.
+ */
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+size_t GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::process()
+{
+	size_t count = 0;
+	ring_.consume([&](const uint8_t *data, size_t size)
+				  {
+		if (ring_.overruns() != overruns_seen_)
+		{
+			// bytes were lost, a frame in progress cannot complete
+			overruns_seen_ = ring_.overruns();
+			parser_.reset();
+		}
+		count += parser_.feed(data, size, [this](const UBXFrame &frame) { dispatch(frame); }); });
+	return count;
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+void GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::dispatch(const UBXFrame &frame)
+{
+	if (frame.cls == ACK_CLASS && frame.length >= 2 && frame.payload[0] == CFG_CLASS && frame.payload[1] == CFG_VALSET)
+	{
+		ack_ = (frame.id == ACK_ACK) ? UBXAck::Ack : UBXAck::Nak;
+		return;
+	}
+	if (frame.cls != UBXClass::NAV)
+		return;
+
+	switch (frame.id)
+	{
+	case UBXMessageID::PVT:
+		if (frame.length < 92U)
+			return;
+		pvt_ = GNSSCore::parseNavPVT(frame.payload);
+		utc_ = pvt_->utcTime;
+		for (size_t i = 0; i < subscriber_count_; ++i)
+			subscribers_[i]->onNavPVT(*pvt_);
+		break;
+	case UBXMessageID::POS_ECEF:
+		if (frame.length < 20U)
+			return;
+		pos_ecef_ = GNSSCore::parseNavPosECEF(frame.payload);
+		for (size_t i = 0; i < subscriber_count_; ++i)
+			subscribers_[i]->onNavPosECEF(*pos_ecef_);
+		break;
+	case UBXMessageID::VEL_ECEF:
+		if (frame.length < 20U)
+			return;
+		vel_ecef_ = GNSSCore::parseNavVelECEF(frame.payload);
+		for (size_t i = 0; i < subscriber_count_; ++i)
+			subscribers_[i]->onNavVelECEF(*vel_ecef_);
+		break;
+	default:
+		break;
+	}
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+bool GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::subscribe(UBXSubscriber *subscriber)
+{
+	if (subscriber == nullptr || subscriber_count_ >= MAX_SUBSCRIBERS)
+		return false;
+	subscribers_[subscriber_count_++] = subscriber;
+	return true;
+}
+
+/*!
+ * Enables periodic UART1 output of a NAV message, rate is per navigation
+ * solution (0 disables). The receiver's answer shows up in configAck().
+ */
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+bool GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::configurePeriodic(UBXMessageID messageID, uint8_t rate)
+{
+	uint32_t key = 0;
+	switch (messageID)
+	{
+	case UBXMessageID::PVT:
+		key = KEY_NAV_PVT_UART1;
+		break;
+	case UBXMessageID::POS_ECEF:
+		key = KEY_NAV_POSECEF_UART1;
+		break;
+	case UBXMessageID::VEL_ECEF:
+		key = KEY_NAV_VELECEF_UART1;
+		break;
+	default:
+		return false;
+	}
+
+	uint8_t frame[VALSET_SIZE];
+	buildValSet(key, rate, frame);
+	ack_ = UBXAck::Pending;
+	return transport_.write(frame, static_cast<uint16_t>(sizeof(frame)));
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+void GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::buildValSet(uint32_t key, uint8_t value, uint8_t (&frame)[VALSET_SIZE])
+{
+	frame[0] = UBXParser<>::SYNC1;
+	frame[1] = UBXParser<>::SYNC2;
+	frame[2] = CFG_CLASS;
+	frame[3] = CFG_VALSET;
+	frame[4] = 9U; // payload length
+	frame[5] = 0U;
+	frame[6] = 0x00; // version
+	frame[7] = 0x01; // layers: RAM
+	frame[8] = 0x00; // reserved
+	frame[9] = 0x00;
+	frame[10] = static_cast<uint8_t>(key);
+	frame[11] = static_cast<uint8_t>(key >> 8);
+	frame[12] = static_cast<uint8_t>(key >> 16);
+	frame[13] = static_cast<uint8_t>(key >> 24);
+	frame[14] = value;
+	CalculateChecksum(frame, VALSET_SIZE, &frame[15], &frame[16]);
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+std::optional<PositionECEF> GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::getNavPosECEF()
+{
+	process();
+	auto pos = pos_ecef_;
+	pos_ecef_.reset();
+	return pos;
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+std::optional<NavigationPVT> GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::getNavPVT()
+{
+	process();
+	auto pvt = pvt_;
+	pvt_.reset();
+	return pvt;
+}
+
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+std::optional<VelocityECEF> GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::getNavVelECEF()
+{
+	process();
+	auto vel = vel_ecef_;
+	vel_ecef_.reset();
+	return vel;
+}
+
+/*!
+ * UTC time of the latest NAV-PVT, lets TaskSetRTC run on the stream.
+ */
+template <typename Transport, uint16_t RX_SIZE, size_t MAX_SUBSCRIBERS>
+	requires StreamAccessTransport<Transport> &&
+			 std::is_same_v<typename Transport::config_type::transport_tag, uart_tag>
+std::optional<UTCTime> GNSSStream<Transport, RX_SIZE, MAX_SUBSCRIBERS>::getNavTimeUTC()
+{
+	process();
+	auto utc = utc_;
+	utc_.reset();
+	return utc;
+}
+
+#endif /* INC_GNSSSTREAM_HPP_ */
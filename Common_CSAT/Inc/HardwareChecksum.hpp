@@ -0,0 +1,80 @@
+#ifndef HARDWARE_CHECKSUM_HPP
+#define HARDWARE_CHECKSUM_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#ifdef __arm__
+#include "stm32l4xx_hal.h"
+#else
+#include "mock_hal.h"
+#endif
+
+#include "Checksum.hpp"
+
+#if defined(HAL_CRC_MODULE_ENABLED) || defined(__x86_64__)
+
+// -----------------------------------------------------------------------------
+// STM32L4 CRC peripheral as a ChecksumPolicy
+//
+// Produces the same checksums as the software calculators in Checksum.hpp. The
+// unit only supplies the table lookup of their per-byte recurrence
+//
+//   crc' = (crc >> 1) ^ T[(crc ^ byte) & 0xFF]
+//
+// With a zero initial value and input and output reflection, the unit's CRC of
+// the single byte x is the reflected CRC-32 table entry T[x].
+//
+// Each instance keeps its own running value, so interleaved instances (ImageBuffer's
+// header and payload checksums) do not disturb each other. Until configure() has
+// been called the lookup falls back to the software table. Not safe to use from
+// interrupts.
+// -----------------------------------------------------------------------------
+class HardwareChecksumPolicy
+{
+public:
+    HardwareChecksumPolicy() : crc_(0xFFFFFFFFu) {}
+
+    // configures the peripheral for byte table lookups and registers it for all instances
+    static HAL_StatusTypeDef configure(CRC_HandleTypeDef* hcrc)
+    {
+        hcrc->Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_ENABLE;
+        hcrc->Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+        hcrc->Init.InitValue = 0;
+        hcrc->Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_BYTE;
+        hcrc->Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_ENABLE;
+        hcrc->InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+        HAL_StatusTypeDef status = HAL_CRC_Init(hcrc);
+        hcrc_ = (status == HAL_OK) ? hcrc : nullptr;
+        return status;
+    }
+
+    void reset() { crc_ = 0xFFFFFFFFu; }
+
+    void update(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = crc_;
+        for (size_t i = 0; i < size; i++)
+            crc = (crc >> 1) ^ lookup(static_cast<uint8_t>((crc ^ data[i]) & 0xFFu));
+        crc_ = crc;
+    }
+
+    crc_t get() const { return crc_ ^ 0xFFFFFFFFu; }
+
+private:
+    static uint32_t lookup(uint8_t index)
+    {
+        if (hcrc_ == nullptr)
+            return checksum_tables::BYTE_TABLE[index];
+        uint32_t word = index;
+        return HAL_CRC_Calculate(hcrc_, &word, 1);
+    }
+
+private:
+    uint32_t crc_;
+    static inline CRC_HandleTypeDef* hcrc_ = nullptr;
+};
+
+#endif // HAL_CRC_MODULE_ENABLED || __x86_64__
+
+#endif // HARDWARE_CHECKSUM_HPP
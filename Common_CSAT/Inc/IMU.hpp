@@ -16,6 +16,26 @@ typedef std::array<au::QuantityF<au::TeslaInBodyFrame>, 3> MagneticFieldInBodyFr
 typedef std::array<au::QuantityF<au::TeslaInEcefFrame>, 3> MagneticFieldInEcefFrame;
 typedef au::QuantityF<au::Celsius> Temperature;
 
+// One batched IMU reading, fields are valid as flagged
+struct IMUSample
+{
+    enum Flags : uint8_t
+    {
+        ACC = 0x01,
+        GYR = 0x02,
+        MAG = 0x04
+    };
+
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+    uint32_t sensor_time; // sensor clock ticks
+    AccelerationInBodyFrame acceleration;
+    AngularVelocityInBodyFrame angular_velocity;
+    MagneticFieldInBodyFrame magnetic_field;
+    uint8_t flags;
+
+    bool has(Flags f) const { return (flags & f) != 0; }
+};
+
 // Concept for readChipID method
 template<typename T>
 concept ProvidesChipID = requires(T t) {
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <algorithm>
+#include <concepts>
 #include <cstring>
 #include <vector>
 
@@ -12,19 +13,27 @@
 #include "imagebuffer/image.hpp"
 #include "imagebuffer/storageheader.hpp"
 #include "imagebuffer/buffer_state.hpp"
+#include "imagebuffer/checkpoint.hpp"
 #include "Checksum.hpp"
 
-template <typename Accessor, typename ChecksumPolicy = DefaultChecksumPolicy>
+// Checkpoint is optional: with a CheckpointStore the ring state is saved on
+// pop_image (and every checkpoint_interval pushes), and initialize_from_flash
+// only verifies the entries pushed after the newest checkpoint. Without one,
+// or when the checkpoint does not match the flash, it scans the capacity.
+template <typename Accessor,
+          typename ChecksumPolicy = DefaultChecksumPolicy,
+          CheckpointStore Checkpoint = NoCheckpoint>
 class ImageBuffer
 {
 public:
-    ImageBuffer(Accessor &accessor)
+    ImageBuffer(Accessor &accessor, Checkpoint checkpoint = Checkpoint{})
         : buffer_state_(0,
                         0,
                         0,
                         accessor.getFlashStartAddress(),
                         accessor.getFlashMemorySize()),
           accessor_(accessor),
+          checkpoint_(checkpoint),
           next_sequence_id_(0),
           write_state_{},
           read_state_{} {}
@@ -59,6 +68,9 @@ public:
     ImageBufferError pop_image();
     ImageBufferError initialize_from_flash();
 
+    // pushes between checkpoints; pops always save one
+    void set_checkpoint_interval(uint32_t pushes) { checkpoint_interval_ = pushes == 0 ? 1 : pushes; }
+
 protected:
     void test_set_tail(size_t t) { buffer_state_.tail_ = t; }
     ImageBufferError validate_entry(size_t offset,
@@ -66,6 +78,9 @@ protected:
                                     uint32_t &seq_id,
                                     ImageMetadata &meta_out);
 
+    ImageBufferError mount_from_checkpoint();
+    ImageBufferError scan_from_flash();
+
 private:
     // ---------------------------------------------------------------------
     // Per-entry streaming state
@@ -261,13 +276,33 @@ ImageBufferError ring_io(EntryState &s,
         buffer_state_.count_--;
     }
 
+    // ---------------------------------------------------------------------
+    // Checkpoint of the committed ring state
+    // ---------------------------------------------------------------------
+    void save_checkpoint()
+    {
+        pushes_since_checkpoint_ = 0;
+        ImageBufferCheckpoint cp{};
+        cp.capacity         = static_cast<uint32_t>(buffer_state_.TOTAL_BUFFER_CAPACITY_);
+        cp.head             = static_cast<uint32_t>(buffer_state_.head_);
+        cp.tail             = static_cast<uint32_t>(buffer_state_.tail_);
+        cp.size             = static_cast<uint32_t>(buffer_state_.size_);
+        cp.count            = static_cast<uint32_t>(buffer_state_.count_);
+        cp.next_sequence_id = next_sequence_id_;
+        // a stale checkpoint is caught on mount, the image itself is safe
+        (void)checkpoint_.save(cp);
+    }
+
     // ---------------------------------------------------------------------
     // Members
     // ---------------------------------------------------------------------
     BufferState buffer_state_;
     Accessor &accessor_;
+    Checkpoint checkpoint_;
     ChecksumPolicy checksum_; // used for payload CRC and validate_entry payload
     uint32_t next_sequence_id_;
+    uint32_t checkpoint_interval_ = 1;
+    uint32_t pushes_since_checkpoint_ = 0;
 
     EntryState write_state_;
     EntryState read_state_;
@@ -276,8 +311,8 @@ ImageBufferError ring_io(EntryState &s,
 // ==========================================================================
 // add_image
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::add_image(const ImageMetadata &meta)
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::add_image(const ImageMetadata &meta)
 {
     const size_t total = entry_total_size(meta.payload_size);
 
@@ -297,7 +332,8 @@ ImageBufferError ImageBuffer<A, C>::add_image(const ImageMetadata &meta)
     hdr.magic       = STORAGE_MAGIC;
     hdr.version     = STORAGE_HEADER_VERSION;
     hdr.header_size = static_cast<uint16_t>(sizeof(StorageHeader));
-    hdr.sequence_id = next_sequence_id_++;
+    // the id is only taken on push, an abandoned entry leaves no gap
+    hdr.sequence_id = next_sequence_id_;
     hdr.total_size  = static_cast<uint32_t>(total - header_size());
 
     auto err = process_struct(write_state_,
@@ -324,8 +360,8 @@ ImageBufferError ImageBuffer<A, C>::add_image(const ImageMetadata &meta)
 // ==========================================================================
 // push_image
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::push_image()
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::push_image()
 {
     crc_t tag = checksum_.get();
 
@@ -337,9 +373,20 @@ ImageBufferError ImageBuffer<A, C>::push_image()
     if (err != ImageBufferError::NO_ERROR)
         return err;
 
+    // accessors that buffer partial pages program the image tail now
+    if constexpr (requires(A &a) { { a.flush() } -> std::same_as<AccessorError>; })
+    {
+        if (accessor_.flush() != AccessorError::NO_ERROR)
+            return ImageBufferError::WRITE_ERROR;
+    }
+
     buffer_state_.size_ += write_state_.consumed;
     buffer_state_.tail_  = write_state_.offset;
     buffer_state_.count_++;
+    next_sequence_id_++;
+
+    if (++pushes_since_checkpoint_ >= checkpoint_interval_)
+        save_checkpoint();
 
     return ImageBufferError::NO_ERROR;
 }
@@ -347,8 +394,8 @@ ImageBufferError ImageBuffer<A, C>::push_image()
 // ==========================================================================
 // get_image
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::get_image(ImageMetadata &meta)
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::get_image(ImageMetadata &meta)
 {
     if (is_empty())
         return ImageBufferError::EMPTY_BUFFER;
@@ -381,8 +428,8 @@ ImageBufferError ImageBuffer<A, C>::get_image(ImageMetadata &meta)
 // ==========================================================================
 // get_data_chunk
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::get_data_chunk(uint8_t *data, size_t &size)
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::get_data_chunk(uint8_t *data, size_t &size)
 {
     const size_t overhead = overhead_size();
 
@@ -408,8 +455,8 @@ ImageBufferError ImageBuffer<A, C>::get_data_chunk(uint8_t *data, size_t &size)
 // ==========================================================================
 // pop_image
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::pop_image()
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::pop_image()
 {
     if (is_empty())
         return ImageBufferError::EMPTY_BUFFER;
@@ -431,14 +478,96 @@ ImageBufferError ImageBuffer<A, C>::pop_image()
         return ImageBufferError::CHECKSUM_ERROR;
 
     adjust_head(total_sz);
-    return erase_entry_blocks(old_head, total_sz);
+    err = erase_entry_blocks(old_head, total_sz);
+
+    // the popped entry is gone from flash, a checkpoint still pointing at it
+    // would send the next mount to the full scan
+    save_checkpoint();
+    return err;
 }
 
 // ==========================================================================
 // initialize_from_flash
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::initialize_from_flash()
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::initialize_from_flash()
+{
+    pushes_since_checkpoint_ = 0;
+    if (mount_from_checkpoint() == ImageBufferError::NO_ERROR)
+        return ImageBufferError::NO_ERROR;
+
+    // fall back to the full scan and checkpoint its result for the next boot
+    const ImageBufferError err = scan_from_flash();
+    save_checkpoint();
+    return err;
+}
+
+// ==========================================================================
+// mount_from_checkpoint
+//   - restores the ring state of the newest checkpoint
+//   - checks the head entry is still the one the checkpoint expects
+//   - rolls forward over the entries pushed after it, fully validated
+// ==========================================================================
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::mount_from_checkpoint()
+{
+    const size_t cap = buffer_state_.TOTAL_BUFFER_CAPACITY_;
+
+    ImageBufferCheckpoint cp{};
+    if (!checkpoint_.load(cp) ||
+        cp.capacity != cap ||
+        cp.head >= cap || cp.tail >= cap || cp.size > cap ||
+        cp.count > cp.next_sequence_id)
+        return ImageBufferError::DATA_ERROR;
+
+    if (cp.count > 0)
+    {
+        EntryState s{ cp.head, 0, 0, 0 };
+        StorageHeader hdr{};
+        if (process_struct(s, hdr, offsetof(StorageHeader, header_crc), false) != ImageBufferError::NO_ERROR ||
+            hdr.magic != STORAGE_MAGIC ||
+            hdr.sequence_id != cp.next_sequence_id - cp.count)
+            return ImageBufferError::DATA_ERROR;
+    }
+
+    buffer_state_.head_  = cp.head;
+    buffer_state_.tail_  = cp.tail;
+    buffer_state_.size_  = cp.size;
+    buffer_state_.count_ = cp.count;
+    next_sequence_id_    = cp.next_sequence_id;
+
+    for (;;)
+    {
+        const size_t off = align_up_wrapped(buffer_state_.tail_);
+
+        EntryState s{ off, 0, 0, 0 };
+        StorageHeader hdr{};
+        if (process_struct(s, hdr, offsetof(StorageHeader, header_crc), false) != ImageBufferError::NO_ERROR ||
+            hdr.magic != STORAGE_MAGIC ||
+            hdr.sequence_id != next_sequence_id_)
+            break;
+
+        size_t        e_size = 0;
+        uint32_t      sid    = 0;
+        ImageMetadata meta{};
+        if (validate_entry(off, e_size, sid, meta) != ImageBufferError::NO_ERROR ||
+            e_size > buffer_state_.available())
+            break;
+
+        buffer_state_.tail_  = (off + e_size) % cap;
+        buffer_state_.size_ += e_size;
+        buffer_state_.count_++;
+        next_sequence_id_++;
+    }
+
+    return ImageBufferError::NO_ERROR;
+}
+
+// ==========================================================================
+// scan_from_flash
+// ==========================================================================
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::scan_from_flash()
 {
     const size_t cap = buffer_state_.TOTAL_BUFFER_CAPACITY_;
 
@@ -558,8 +687,8 @@ ImageBufferError ImageBuffer<A, C>::initialize_from_flash()
 // ==========================================================================
 // validate_entry
 // ==========================================================================
-template <typename A, typename C>
-ImageBufferError ImageBuffer<A, C>::validate_entry(size_t offset,
+template <typename A, typename C, CheckpointStore K>
+ImageBufferError ImageBuffer<A, C, K>::validate_entry(size_t offset,
                                                    size_t &entry_size,
                                                    uint32_t &seq_id,
                                                    ImageMetadata &meta_out)
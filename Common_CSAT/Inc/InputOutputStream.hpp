@@ -14,6 +14,7 @@
 #include "ImageBuffer.hpp"
 #include "ImageBufferConcept.hpp"
 #include "Logger.hpp"
+#include "DeferredLog.hpp"
 
 //
 //
@@ -130,10 +131,8 @@ public:
             return false;
         }
 
-    	constexpr size_t BUFFER_SIZE = 1024;
-    	char data_hex_string_buffer[BUFFER_SIZE];
-    	uchar_buffer_to_hex(data, size, data_hex_string_buffer, BUFFER_SIZE);
-    	log(LOG_LEVEL_DEBUG, "ImageInputStream::getChunk %s\r\n", data_hex_string_buffer);
+    	// only the first bytes of the chunk fit into a log entry
+    	LOG_DEFERRED(LOG_LEVEL_DEBUG, "ImageInputStream::getChunk %u %s\r\n", static_cast<unsigned>(size), deferred_log::Bytes{data, size});
 
     	return true;
     }
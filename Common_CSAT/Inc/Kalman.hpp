@@ -3,17 +3,33 @@
 #include <cmath>
 #include <iostream>
 #include <array>
+#include <cstdint>
+
+// How the state covariance is corrected after a measurement
+enum class KalmanCovarianceUpdate : uint8_t
+{
+    Standard, // P - K H P, cheapest
+    Joseph    // (I - K H) P (I - K H)^T + K R K^T, positive definite and symmetric in float
+};
 
 // Generic Kalman Filter (Template)
 template <int StateSize, int MeasurementSize>
 class KalmanFilter
 {
 public:
+    using StateMatrix = Eigen::Matrix<float, StateSize, StateSize>;
+    using StateVector = Eigen::Matrix<float, StateSize, 1>;
+    using MeasurementMatrix = Eigen::Matrix<float, MeasurementSize, StateSize>;
+    using MeasurementVector = Eigen::Matrix<float, MeasurementSize, 1>;
+    using InnovationMatrix = Eigen::Matrix<float, MeasurementSize, MeasurementSize>;
+    using GainMatrix = Eigen::Matrix<float, StateSize, MeasurementSize>;
+
     // Matrices for the Kalman Filter calculations
     Eigen::Matrix<float, StateSize, StateSize> processNoiseCovarianceMatrix;
     Eigen::Matrix<float, MeasurementSize, MeasurementSize> measurementNoiseCovarianceMatrix;
     Eigen::Matrix<float, StateSize, StateSize> stateCovarianceMatrix;
     Eigen::Matrix<float, StateSize, 1> stateVector;
+    KalmanCovarianceUpdate covarianceUpdate = KalmanCovarianceUpdate::Standard;
 
     // Constructor for the KalmanFilter
     /**
@@ -81,46 +97,138 @@ public:
      * @param measurementVector The measurement of the current state.
      *
      * @note This method updates the internal state vector and state covariance matrix.
+     * The gain is obtained with a Cholesky solve of the innovation covariance, no inverse is formed.
      */
     void update(const Eigen::Matrix<float, MeasurementSize, StateSize> &measurementMatrix,
                 const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
     {
-
-        // std::cout << "Kalman::update - Before Update" << std::endl;
-        // std::cout << "stateVector:\n"<< stateVector << std::endl;
-        // std::cout << "stateCovarianceMatrix:\n" << stateCovarianceMatrix << std::endl;
-        // std::cout << "measurementMatrix:\n" << measurementMatrix << std::endl;
-        // std::cout << "measurementVector:\n" << measurementVector << std::endl;
-
         // Compute the innovation, which is the difference between the measurement and the predicted state in measurement space
-        Eigen::Matrix<float, MeasurementSize, 1> innovation = measurementVector - (measurementMatrix * stateVector);
+        const MeasurementVector innovation = measurementVector - (measurementMatrix * stateVector);
 
-        // std::cout << "Kalman::update - After Innovation" << std::endl;
-        // std::cout << "innovation:\n" << innovation << std::endl;
-
-        // Calculate the covariance of the innovation
-        Eigen::Matrix<float, MeasurementSize, MeasurementSize> innovationCovariance = measurementMatrix * stateCovarianceMatrix * measurementMatrix.transpose() + measurementNoiseCovarianceMatrix;
-
-        // std::cout << "Kalman::update - After Innovation Covariance" << std::endl;
-        // std::cout << "innovationCovariance:\n" << innovationCovariance << std::endl;
+        // H P, shared by the innovation covariance, the gain and the covariance update
+        const MeasurementMatrix HP = measurementMatrix * stateCovarianceMatrix;
 
         // Calculate the Kalman gain, which determines how much to correct the state based on the measurement
-        Eigen::Matrix<float, StateSize, MeasurementSize> kalmanGain = stateCovarianceMatrix * measurementMatrix.transpose() * innovationCovariance.inverse();
-
-        // std::cout << "Kalman::update - After Kalman Gain" << std::endl;
-        // std::cout << "kalmanGain:\n" << kalmanGain << std::endl;
+        const GainMatrix kalmanGain = gain(HP, HP * measurementMatrix.transpose() + measurementNoiseCovarianceMatrix);
 
         // Update the state estimate using the innovation and the Kalman gain
-        stateVector = stateVector + (kalmanGain * innovation);
-
-        // std::cout << "Kalman::update - After State Vector Update" << std::endl;
-        // std::cout << "stateVector:\n" << stateVector << std::endl;
+        stateVector += kalmanGain * innovation;
 
         // Update the state covariance matrix using the Kalman gain
-        stateCovarianceMatrix = (Eigen::Matrix<float, StateSize, StateSize>::Identity() - kalmanGain * measurementMatrix) * stateCovarianceMatrix;
+        correctCovariance(measurementMatrix, HP, kalmanGain);
+    }
 
-        // std::cout << "Kalman::update - After State Covariance Update" << std::endl;
-        // std::cout << "stateCovarianceMatrix:\n" << stateCovarianceMatrix << std::endl;
+    /**
+     * @brief Update for a selector measurement matrix, row i of H is the unit vector of state index indices[i].
+     *
+     * Equivalent to update() with that H, the products with H reduce to picking rows and columns of P.
+     *
+     * @param indices The measured state index for each measurement row.
+     * @param measurementVector The measurement of the selected states.
+     */
+    void updateSelected(const std::array<int, MeasurementSize> &indices,
+                        const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
+    {
+        MeasurementVector innovation;
+        MeasurementMatrix HP;
+        InnovationMatrix S;
+        for (int i = 0; i < MeasurementSize; ++i)
+        {
+            const int row = indices[static_cast<size_t>(i)];
+            innovation(i) = measurementVector(i) - stateVector(row);
+            HP.row(i) = stateCovarianceMatrix.row(row);
+            for (int j = 0; j < MeasurementSize; ++j)
+            {
+                S(i, j) = stateCovarianceMatrix(row, indices[static_cast<size_t>(j)]) + measurementNoiseCovarianceMatrix(i, j);
+            }
+        }
+
+        const GainMatrix K = gain(HP, S);
+        stateVector += K * innovation;
+        if (covarianceUpdate == KalmanCovarianceUpdate::Joseph)
+        {
+            // Joseph form needs the dense H
+            MeasurementMatrix H = MeasurementMatrix::Zero();
+            for (int i = 0; i < MeasurementSize; ++i)
+            {
+                H(i, indices[static_cast<size_t>(i)]) = 1.f;
+            }
+            correctCovariance(H, HP, K);
+        }
+        else
+        {
+            stateCovarianceMatrix.noalias() -= K * HP;
+        }
+    }
+
+    /**
+     * @brief Sequential update, one scalar measurement at a time.
+     *
+     * Valid when the measurement noise is uncorrelated (diagonal R), the result then matches update()
+     * while every division is by a scalar innovation variance instead of a matrix factorization.
+     *
+     * @param measurementMatrix The matrix to indicate which state variables are measured.
+     * @param measurementVector The measurement of the current state.
+     */
+    void updateSequential(const Eigen::Matrix<float, MeasurementSize, StateSize> &measurementMatrix,
+                          const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
+    {
+        for (int i = 0; i < MeasurementSize; ++i)
+        {
+            const Eigen::Matrix<float, 1, StateSize> h = measurementMatrix.row(i);
+            const float r = measurementNoiseCovarianceMatrix(i, i);
+            const Eigen::Matrix<float, 1, StateSize> hP = h * stateCovarianceMatrix;
+            const float s = hP.dot(h) + r;
+            const StateVector k = hP.transpose() / s;
+
+            stateVector += k * (measurementVector(i) - h.dot(stateVector));
+            if (covarianceUpdate == KalmanCovarianceUpdate::Joseph)
+            {
+                // (I - k h) P (I - k h)^T + r k k^T, A = (I - k h) P
+                const StateMatrix A = stateCovarianceMatrix - k * hP;
+                stateCovarianceMatrix = A - (A * h.transpose()) * k.transpose() + r * k * k.transpose();
+                symmetrize();
+            }
+            else
+            {
+                stateCovarianceMatrix.noalias() -= k * hP;
+            }
+        }
+    }
+
+    /**
+     * @brief Sequential update for a selector measurement matrix with diagonal R.
+     *
+     * Combines updateSelected() and updateSequential(): each scalar measurement of state
+     * indices[i] only reads row indices[i] of P.
+     *
+     * @param indices The measured state index for each measurement row.
+     * @param measurementVector The measurement of the selected states.
+     */
+    void updateSequential(const std::array<int, MeasurementSize> &indices,
+                          const Eigen::Matrix<float, MeasurementSize, 1> &measurementVector)
+    {
+        for (int i = 0; i < MeasurementSize; ++i)
+        {
+            const int row = indices[static_cast<size_t>(i)];
+            const float r = measurementNoiseCovarianceMatrix(i, i);
+            const Eigen::Matrix<float, 1, StateSize> hP = stateCovarianceMatrix.row(row);
+            const float s = hP(row) + r;
+            const StateVector k = hP.transpose() / s;
+
+            stateVector += k * (measurementVector(i) - stateVector(row));
+            if (covarianceUpdate == KalmanCovarianceUpdate::Joseph)
+            {
+                // (I - k e_row^T) P (I - k e_row^T)^T + r k k^T, A = (I - k e_row^T) P
+                const StateMatrix A = stateCovarianceMatrix - k * hP;
+                stateCovarianceMatrix = A - A.col(row) * k.transpose() + r * k * k.transpose();
+                symmetrize();
+            }
+            else
+            {
+                stateCovarianceMatrix.noalias() -= k * hP;
+            }
+        }
     }
 
     /**
@@ -130,38 +238,27 @@ public:
      * @param H_jac  Measurement Jacobian: ∂h/∂x at current x
      * @param z      Actual measurement
      */
+    template <typename MeasurementFunction>
     void updateEKF(
-        const std::function<Eigen::Matrix<float, MeasurementSize, 1>(const Eigen::Matrix<float, StateSize, 1> &)> &h,
+        const MeasurementFunction &h,
         const Eigen::Matrix<float, MeasurementSize, StateSize> &H_jac,
         const Eigen::Matrix<float, MeasurementSize, 1> &z)
     {
-        // std::cout << "Kalman::EKF update - Begin\n";
-        // std::cout << "stateVector:\n" << stateVector << std::endl;
-
         // Nonlinear measurement prediction
-        Eigen::Matrix<float, MeasurementSize, 1> z_pred = h(stateVector);
+        const MeasurementVector z_pred = h(stateVector);
 
         // Innovation
-        Eigen::Matrix<float, MeasurementSize, 1> innovation = z - z_pred;
-        // std::cout << "innovation:\n" << innovation << std::endl;
+        const MeasurementVector innovation = z - z_pred;
 
-        // Innovation covariance
-        Eigen::Matrix<float, MeasurementSize, MeasurementSize> S = H_jac * stateCovarianceMatrix * H_jac.transpose() + measurementNoiseCovarianceMatrix;
-        // std::cout << "innovationCovariance:\n" << S << std::endl;
-
-        // Kalman gain
-        Eigen::Matrix<float, StateSize, MeasurementSize> K = stateCovarianceMatrix * H_jac.transpose() * S.inverse();
-        // std::cout << "kalmanGain:\n" << K << std::endl;
+        // Kalman gain from the innovation covariance
+        const MeasurementMatrix HP = H_jac * stateCovarianceMatrix;
+        const GainMatrix K = gain(HP, HP * H_jac.transpose() + measurementNoiseCovarianceMatrix);
 
         // State update
-        stateVector = stateVector + K * innovation;
-        // std::cout << "updatedStateVector:\n" << stateVector << std::endl;
+        stateVector += K * innovation;
 
         // Covariance update
-        Eigen::Matrix<float, StateSize, StateSize> I = Eigen::Matrix<float, StateSize, StateSize>::Identity();
-        stateCovarianceMatrix = (I - K * H_jac) * stateCovarianceMatrix;
-
-        // std::cout << "updatedStateCovariance:\n" << stateCovarianceMatrix << std::endl;
+        correctCovariance(H_jac, HP, K);
     }
 
     // Method to get the state estimate
@@ -184,4 +281,41 @@ public:
     {
         stateCovarianceMatrix = newCovariance;
     }
-};
\ No newline at end of file
+
+private:
+    // K = P H^T S^-1, solved as K^T = S^-1 H P since P is symmetric. S is positive definite,
+    // LDLT only covers the case where rounding broke the Cholesky factorization.
+    GainMatrix gain(const MeasurementMatrix &HP, const InnovationMatrix &S) const
+    {
+        MeasurementMatrix KT = HP;
+        const Eigen::LLT<InnovationMatrix> llt(S);
+        if (llt.info() == Eigen::Success)
+        {
+            llt.solveInPlace(KT);
+        }
+        else
+        {
+            S.ldlt().solveInPlace(KT);
+        }
+        return KT.transpose();
+    }
+
+    void correctCovariance(const MeasurementMatrix &H, const MeasurementMatrix &HP, const GainMatrix &K)
+    {
+        if (covarianceUpdate == KalmanCovarianceUpdate::Joseph)
+        {
+            const StateMatrix IKH = StateMatrix::Identity() - K * H;
+            stateCovarianceMatrix = IKH * stateCovarianceMatrix * IKH.transpose() + K * measurementNoiseCovarianceMatrix * K.transpose();
+            symmetrize();
+        }
+        else
+        {
+            stateCovarianceMatrix.noalias() -= K * HP;
+        }
+    }
+
+    void symmetrize()
+    {
+        stateCovarianceMatrix = 0.5f * (stateCovarianceMatrix + stateCovarianceMatrix.transpose()).eval();
+    }
+};
@@ -35,6 +35,12 @@ class Logger
 public:
     static void log(uint8_t level, const char* format, va_list args);
 
+    // Sends an already formatted message to all outputs
+    static void write(uint8_t level, const char* str, size_t size);
+
+    // Sends raw bytes to the byte stream outputs (UART, USB, stream), not Cyphal
+    static void writeBinary(const uint8_t* data, size_t size);
+
 #ifdef LOGGER_OUTPUT_UART
     static void setUartHandle(UART_HandleTypeDef* huart);
 #endif
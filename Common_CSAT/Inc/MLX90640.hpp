@@ -11,7 +11,8 @@
 constexpr static uint8_t MLX90640_ID = 0x33;
 constexpr static std::size_t MLX90640_EEPROM_WORDS = 832;
 constexpr static std::size_t MLX90640_EEPROM_SIZE = MLX90640_EEPROM_WORDS * sizeof(uint16_t);
-constexpr static std::size_t MLX90640_SUBPAGE_WORDS = 834;
+constexpr static std::size_t MLX90640_RAM_WORDS = 832;
+constexpr static std::size_t MLX90640_SUBPAGE_WORDS = 834; // RAM + CONTROL1 + subpage number
 constexpr static std::size_t MLX90640_SUBPAGE_SIZE = MLX90640_SUBPAGE_WORDS * sizeof(uint16_t);
 constexpr static std::size_t MLX90640_FRAME_WORDS = 2 * MLX90640_SUBPAGE_WORDS;
 constexpr static std::size_t MLX90640_FRAME_SIZE = MLX90640_FRAME_WORDS * sizeof(uint16_t);
@@ -202,8 +203,10 @@ public:
     // Correct sequence:
     //  1. Assume caller has waited for NEW_DATA.
     //  2. Read STATUS → get subpage ID and confirm NEW_DATA.
-    //  3. Read RAM snapshot.
-    //  4. Clear NEW_DATA.
+    //  3. Read RAM snapshot (832 words).
+    //  4. Read CONTROL1 into word 832 and store the subpage ID in
+    //     word 833, as in the Melexis frame layout.
+    //  5. Clear NEW_DATA.
     //
     bool readSubpage(uint16_t *buf, int &subpage)
     {
@@ -232,13 +235,23 @@ public:
         if (!readBlock(
                 static_cast<uint16_t>(MLX90640_REGISTERS::RAM_START),
                 reinterpret_cast<uint8_t *>(buf),
-                MLX90640_SUBPAGE_SIZE))
+                MLX90640_RAM_WORDS * sizeof(uint16_t)))
         {
             log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: read RAM failed\r\n");
             return false;
         }
 
-        // 3. Clear NEW_DATA (write‑1‑to‑clear)
+        // 3. Reading pattern and ADC resolution the subpage was measured with
+        uint16_t ctrl = 0;
+        if (!readReg16(static_cast<uint16_t>(MLX90640_REGISTERS::CONTROL1), ctrl))
+        {
+            log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: read CONTROL1 failed\r\n");
+            return false;
+        }
+        buf[MLX90640_RAM_WORDS] = ctrl;
+        buf[MLX90640_RAM_WORDS + 1] = static_cast<uint16_t>(subpage);
+
+        // 4. Clear NEW_DATA (write‑1‑to‑clear)
         if (!clearStatus())
         {
             log(LOG_LEVEL_ERROR, "MLX90640::readSubpage: clearStatus failed\r\n");
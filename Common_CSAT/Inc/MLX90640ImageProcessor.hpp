@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <array>
 
+struct MLX90640_Calibration;
+
 class MLX90640ImageProcessor
 {
 public:
@@ -11,14 +13,129 @@ public:
     static constexpr int HEIGHT = 24;
     static constexpr int PIXELS = WIDTH * HEIGHT;
 
+    // One subpage frame as read from RAM: 768 pixels, 64 aux words,
+    // control register 1 and the subpage number
+    static constexpr int FRAME_WORDS    = 834;
+    static constexpr int SUBPAGE_PIXELS = PIXELS / 2;
+
+    // The calibration tables are rebuilt once Ta or Vdd drift further than
+    // this from the values they were built for
+    static constexpr float TA_REBUILD_DELTA  = 0.1f;   // degC
+    static constexpr float VDD_REBUILD_DELTA = 0.005f; // V
+
     using RawImage  = std::array<int16_t, PIXELS>;
     using TempImage = std::array<float,   PIXELS>;
 
-    MLX90640ImageProcessor() = default;
+    // Operating point of one subpage frame (Melexis GetVdd / GetTa)
+    struct FrameConditions
+    {
+        float    vdd;
+        float    ta;
+        bool     chess;   // chess (true) or interleaved (false) reading pattern
+        uint16_t subPage;
+    };
+
+    MLX90640ImageProcessor();
+    explicit MLX90640ImageProcessor(const MLX90640_Calibration& cal);
 
     bool demultiplexFrame(const uint16_t* frame, RawImage& outRaw) const;
 
+    // Copy the pixels of one subpage (chess pattern) into outRaw, the other
+    // half of the image is left as it is
+    bool demultiplexSubpage(const uint16_t* subpage, uint16_t subPage, RawImage& outRaw) const;
+
     bool computeTemperatures(const RawImage& raw,
                              TempImage& outTemps,
                              float Ta = 25.0f) const;
+
+    FrameConditions frameConditions(const uint16_t* frame) const;
+
+    // Stage 1: fold offset, Kta, Kv, IL/chess correction and alpha of every
+    // pixel into per-subpage tables for the given operating point.
+    void calibrate(float Ta, float vdd, bool chess);
+
+    // Stage 2: object temperatures of the pixels read in this subpage frame,
+    // equivalent to MLX90640_CalculateTo. Pixels of the other subpage are left
+    // untouched. Rebuilds the tables first when the operating point moved.
+    bool calculateTo(const uint16_t* frame,
+                     float emissivity,
+                     float tr,
+                     TempImage& outTemps);
+
+    bool  isCalibrated() const { return calibrated_; }
+    float calibratedTa() const { return tablesTa_; }
+    float calibratedVdd() const { return tablesVdd_; }
+
+private:
+    // Structure of arrays over the pixels of one subpage, in pixel order
+    struct SubpageTables
+    {
+        std::array<uint16_t, SUBPAGE_PIXELS> index;     // pixel number
+        std::array<float,    SUBPAGE_PIXELS> irOffset;  // compensated offset, IL/chess included
+        std::array<float,    SUBPAGE_PIXELS> alpha;     // compensated sensitivity
+        std::array<float,    SUBPAGE_PIXELS> alpha3;    // alpha^3 for Sx
+        std::array<float,    SUBPAGE_PIXELS> alphaK1;   // alpha * (1 - KsTo1 * 273.15)
+    };
+
+    const MLX90640_Calibration* cal_;
+
+    std::array<SubpageTables, 2> tables_{};
+    std::array<float, 2> cpOffset_{};   // compensated CP offsets per subpage
+    std::array<float, 4> rangeA_{};     // alphaCorrR * (1 - ksTo * ct) per To range
+    std::array<float, 4> rangeB_{};     // alphaCorrR * ksTo per To range
+    std::array<float, 3> rangeLimit_{}; // ct[1..3]
+
+    bool  calibrated_  = false;
+    bool  tablesChess_ = false;
+    float tablesTa_    = 0.0f;
+    float tablesVdd_   = 0.0f;
+};
+
+// Subpage sink for TaskMLX90640: keeps a temperature image that is updated
+// half by half as the subpages are read, so a usable image is available one
+// subpage after start-up and refreshed every subpage afterwards.
+// Subpages must carry control register 1 in word 832 and the subpage number in
+// word 833, as in the Melexis frame layout; MLX90640::readSubpage() reads both
+// after the 832 RAM words.
+class MLX90640ThermalImage
+{
+public:
+    using TempImage = MLX90640ImageProcessor::TempImage;
+
+    bool processSubpage(uint16_t* subpage, int sp)
+    {
+        if (sp != 0 && sp != 1)
+        {
+            return false;
+        }
+
+        subpage[MLX90640ImageProcessor::FRAME_WORDS - 1] = static_cast<uint16_t>(sp);
+        if (!processor_.calculateTo(subpage, emissivity_, tr_, temps_))
+        {
+            return false;
+        }
+
+        updated_[static_cast<std::size_t>(sp)] = true;
+        ++updates_;
+        return true;
+    }
+
+    void setEmissivity(float emissivity) { emissivity_ = emissivity; }
+    void setReflectedTemperature(float tr) { tr_ = tr; }
+
+    // Both halves hold data
+    bool isComplete() const { return updated_[0] && updated_[1]; }
+    uint32_t updates() const { return updates_; }
+
+    const TempImage& temperatures() const { return temps_; }
+    MLX90640ImageProcessor& processor() { return processor_; }
+
+private:
+    MLX90640ImageProcessor processor_;
+    TempImage temps_{};
+    std::array<bool, 2> updated_{};
+    uint32_t updates_ = 0;
+
+    float emissivity_ = 0.95f;
+    float tr_         = 23.0f;
 };
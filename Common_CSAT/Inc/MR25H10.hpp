@@ -2,7 +2,10 @@
 #ifndef INC_MR25H10_H_
 #define INC_MR25H10_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include "Transport.hpp"
 
@@ -30,10 +33,25 @@ public:
 	MR25H10() = delete;
 	explicit MR25H10(const Transport &transport) : transport_(transport) {}
 
+	static constexpr uint32_t SIZE = 128 * 1024; // 1 Mbit
+	static constexpr size_t CHUNK_SIZE = 32;     // data bytes per SPI frame
+
 	std::optional<uint8_t> readStatus() const;
 	bool writeStatus(uint8_t status) const;
 
+	// Memory array access, split into frames of CHUNK_SIZE data bytes.
+	// MRAM writes complete within the frame, there is nothing to poll.
+	bool read(uint32_t address, uint8_t *data, size_t size) const;
+	bool write(uint32_t address, const uint8_t *data, size_t size) const;
+
 private:
+	static void putAddress(uint8_t *frame, uint32_t address)
+	{
+		frame[1] = static_cast<uint8_t>((address >> 16) & 0x01);
+		frame[2] = static_cast<uint8_t>((address >> 8) & 0xFF);
+		frame[3] = static_cast<uint8_t>(address & 0xFF);
+	}
+
 	const Transport &transport_;
 };
 
@@ -60,4 +78,67 @@ bool MR25H10<Transport>::writeStatus(uint8_t data) const
 	return transport_.write(tx_buf, sizeof(tx_buf));
 }
 
+template <typename Transport>
+	requires StreamModeTransport<Transport>
+bool MR25H10<Transport>::read(uint32_t address, uint8_t *data, size_t size) const
+{
+	if (address + size > SIZE)
+	{
+		return false;
+	}
+
+	while (size > 0)
+	{
+		const size_t chunk = std::min(size, CHUNK_SIZE);
+		uint8_t tx[4 + CHUNK_SIZE] = {static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_READ)};
+		uint8_t rx[4 + CHUNK_SIZE] = {0};
+		putAddress(tx, address);
+
+		if (!transport_.transfer(tx, rx, static_cast<uint16_t>(4 + chunk)))
+		{
+			return false;
+		}
+		std::memcpy(data, rx + 4, chunk);
+
+		address += static_cast<uint32_t>(chunk);
+		data += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+template <typename Transport>
+	requires StreamModeTransport<Transport>
+bool MR25H10<Transport>::write(uint32_t address, const uint8_t *data, size_t size) const
+{
+	if (address + size > SIZE)
+	{
+		return false;
+	}
+
+	while (size > 0)
+	{
+		const uint8_t wren = static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_WREN);
+		if (!transport_.write(&wren, 1))
+		{
+			return false;
+		}
+
+		const size_t chunk = std::min(size, CHUNK_SIZE);
+		uint8_t tx[4 + CHUNK_SIZE] = {static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_WRITE)};
+		putAddress(tx, address);
+		std::memcpy(tx + 4, data, chunk);
+
+		if (!transport_.write(tx, static_cast<uint16_t>(4 + chunk)))
+		{
+			return false;
+		}
+
+		address += static_cast<uint32_t>(chunk);
+		data += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
 #endif /* INC_MR25H10_H_ */
@@ -5,17 +5,51 @@
 #include "OV2640_Registers.hpp"
 #include "OV2640_Initialization.hpp"
 #include "CameraDriver.hpp"
+#include "RegisterTableLoader.hpp"
 #include <array>
 #include <cstdint>
 #include <concepts>
 
+// Register table layout of the OV2640: 0xFF selects the DSP (0) or sensor (1)
+// bank, COM7 bit 7 in the sensor bank is the soft reset
+struct OV2640TablePolicy
+{
+    static constexpr bool banked = true;
+    static constexpr size_t max_burst = 16;
+    static constexpr uint32_t reset_delay_ms = 10;
+
+    static constexpr bool isBankSelect(uint16_t addr)
+    {
+        return addr == static_cast<uint8_t>(OV2640_Register::BANK_SEL);
+    }
+
+    static constexpr bool isReset(uint16_t addr, uint8_t value, uint8_t bank)
+    {
+        return addr == static_cast<uint8_t>(OV2640_Register::REG_COM7) && (value & 0x80) != 0 &&
+               bank != static_cast<uint8_t>(OV2640_Register::BANK_DSP);
+    }
+
+    // gain and exposure are rewritten by AEC / AGC
+    static constexpr bool cacheable(uint16_t addr, uint8_t bank)
+    {
+        if (bank != static_cast<uint8_t>(OV2640_Register::BANK_SENSOR))
+            return true;
+        return addr != 0x00 && addr != 0x04 && addr != 0x10 && addr != 0x45;
+    }
+
+    static constexpr uint16_t shadowKey(uint16_t addr, uint8_t bank)
+    {
+        return static_cast<uint16_t>(((bank & 0x01U) << 8) | (addr & 0xFFU));
+    }
+};
+
 template <typename Transport>
     requires RegisterModeTransport<Transport>
 class OV2640
 {
 public:
     explicit OV2640(Transport &transport)
-        : transport_(transport)
+        : transport_(transport), loader_(transport)
     {
     }
 
@@ -25,6 +59,7 @@ public:
     // ────────────────────────────────────────────────────────────────
     //
 
+// Register by register, for tables only known at run time
 void apply_table(const Word_Byte_t *tbl, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
@@ -32,9 +67,17 @@ void apply_table(const Word_Byte_t *tbl, size_t n)
     }
 }
 
+// Constexpr table in bursts, skipping what the sensor already holds
+template <const auto &Table>
+bool loadTable()
+{
+    return loader_.template load<Table>();
+}
+
 bool init()
 {
-    // Hardware reset already done outside
+    // Hardware reset already done outside, nothing written before is valid
+    loader_.invalidate();
 
     // Soft reset (if not already in table)
     writeRegister(0xFF, 0x01);
@@ -42,9 +85,7 @@ bool init()
     HAL_Delay(10);
 
     // Now apply ST table exactly
-    apply_table(OV2640_QQVGA, std::size(OV2640_QQVGA));
-
-    return true;
+    return loadTable<OV2640_QQVGA>();
 }
 
     bool setResolution(uint16_t width, uint16_t height)
@@ -118,7 +159,7 @@ bool init()
 
     bool writeRegister(uint8_t reg, uint8_t value)
     {
-        return transport_.write_reg(reg, &value, 1);
+        return loader_.write(reg, &value, 1);
     }
 
     bool writeRegister(OV2640_Register reg, uint8_t value)
@@ -131,7 +172,7 @@ bool init()
         // OV2640 uses 8‑bit registers, no endian swapping required.
         if (size % 2 != 0)
             return false;
-        return transport_.write_reg(static_cast<uint8_t>(reg), data, size);
+        return loader_.write(static_cast<uint8_t>(reg), data, static_cast<uint16_t>(size));
     }
 
     uint8_t readRegister(uint8_t reg)
@@ -146,6 +187,8 @@ bool init()
         return readRegister(static_cast<uint8_t>(reg));
     }
 
+    const RegisterLoadStats &registerStats() const { return loader_.stats(); }
+
     bool readRegister(OV2640_Register reg, uint8_t *buffer, size_t size)
     {
         if (size % 2 != 0)
@@ -155,6 +198,7 @@ bool init()
 
 private:
     Transport &transport_;
+    RegisterTableLoader<Transport, OV2640TablePolicy> loader_;
     constexpr static float OV2640_GAIN_SCALE = 8.0f;
     constexpr static uint8_t OV2640_EXPOSURE_SHIFT = 8;
 };
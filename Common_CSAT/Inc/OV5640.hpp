@@ -5,17 +5,44 @@
 #include "OV5640_Registers.hpp"
 #include "OV5640_Initialization.hpp"
 #include "CameraDriver.hpp"
+#include "RegisterTableLoader.hpp"
 #include <array>
 #include <cstdint>
 #include <concepts>
 
+// Register table layout of the OV5640: flat 16-bit addresses, SYSTEM_CTRL0
+// bit 7 is the soft reset
+struct OV5640TablePolicy
+{
+    static constexpr bool banked = false;
+    static constexpr size_t max_burst = 32;
+    static constexpr uint32_t reset_delay_ms = 5;
+
+    static constexpr bool isBankSelect(uint16_t) { return false; }
+
+    static constexpr bool isReset(uint16_t addr, uint8_t value, uint8_t)
+    {
+        return addr == static_cast<uint16_t>(OV5640_Register::SYS_CTRL0) && (value & 0x80) != 0;
+    }
+
+    // exposure and real gain are rewritten by AEC / AGC
+    static constexpr bool cacheable(uint16_t addr, uint8_t)
+    {
+        const auto exposure = static_cast<uint16_t>(OV5640_Register::AEC_PK_EXPOSURE_HI);
+        const auto gain = static_cast<uint16_t>(OV5640_Register::AEC_PK_REAL_GAIN);
+        return !(addr >= exposure && addr <= exposure + 2) && !(addr >= gain && addr <= gain + 1);
+    }
+
+    static constexpr uint16_t shadowKey(uint16_t addr, uint8_t) { return addr; }
+};
+
 template <typename Transport>
     requires RegisterModeTransport<Transport>
 class OV5640
 {
 public:
     explicit OV5640(Transport &transport)
-        : transport_(transport)
+        : transport_(transport), loader_(transport)
     {
     }
 
@@ -27,12 +54,16 @@ public:
 
     bool init()
     {
-    	static constexpr auto& Initialization = cfg_init_;
-    	for (auto& w : Initialization) {
-    	    if (!writeRegister(w.addr, w.data)) return false;
-    	}
+        // called after power-up, nothing written before is valid
+        loader_.invalidate();
+        return loadTable<cfg_init_>();
+    }
 
-        return true;
+    // Constexpr table in bursts, skipping what the sensor already holds
+    template <const auto &Table>
+    bool loadTable()
+    {
+        return loader_.template load<Table>();
     }
 
     bool setResolution(uint16_t width, uint16_t height)
@@ -141,7 +172,7 @@ public:
 
     bool writeRegister(uint16_t reg, uint8_t value)
     {
-        return transport_.write_reg(reg, &value, 1);
+        return loader_.write(reg, &value, 1);
     }
 
     bool writeRegister(uint16_t reg, const uint8_t *data, size_t size)
@@ -158,7 +189,7 @@ public:
             tx[i + 1] = data[i];
         }
 
-        return transport_.write_reg(reg, tx.data(), size);
+        return loader_.write(reg, tx.data(), static_cast<uint16_t>(size));
     }
 
     uint8_t readRegister(uint16_t reg)
@@ -182,8 +213,11 @@ public:
         return true;
     }
 
+    const RegisterLoadStats &registerStats() const { return loader_.stats(); }
+
 private:
     Transport &transport_;
+    RegisterTableLoader<Transport, OV5640TablePolicy> loader_;
 };
 
 #endif // _OV5640_HPP_
@@ -2,6 +2,7 @@
 #define __ORIENTATION_SERVICE_HPP__
 
 #include <functional>
+#include <optional>
 #include "IMU.hpp"
 #include "au.hpp"
 #include "TimeUtils.hpp"
@@ -143,7 +144,14 @@ OrientationSolution GyrMagOrientation<Tracker, IMU, MAG>::predict()
         result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::MAGNETIC_FIELD);
     }
 
-    update(result.timestamp);  // updates tracker
+    // Fuse the samples read above rather than reading the sensors again in update()
+    if (optional_angular && optional_magnetic) {
+        tracker_.updateSensorFusion(
+            gyrVector(optional_angular.value()),
+            magVector(optional_magnetic.value()),
+            result.timestamp);
+    }
+
     auto q_ = tracker_.getOrientation();
     result.q = { q_.w(), q_.x(), q_.y(), q_.z() };
     result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::QUATERNION);
@@ -356,4 +364,109 @@ void AccGyrOrientation<Tracker, IMU>::update(au::QuantityU64<au::Milli<au::Secon
     }
 }
 
+/*!
+ * Gyro/magnetometer fusion fed from a BMI270Fifo: every queued gyro sample
+ * propagates the tracker at its own timestamp, the newest magnetometer sample
+ * of the batch is fused once per tick.
+ */
+template <typename Tracker, typename Fifo>
+class FifoGyrMagOrientation
+{
+public:
+    FifoGyrMagOrientation() = delete;
+    FifoGyrMagOrientation(RTC_HandleTypeDef *hrtc, Tracker &tracker, Fifo &fifo) : hrtc_(hrtc), tracker_(tracker), fifo_(fifo) {}
+
+    bool predict(std::array<float, 4> &q, au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
+    OrientationSolution predict();
+    void update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
+
+private:
+    au::QuantityU64<au::Milli<au::Seconds>> now() const;
+
+private:
+    RTC_HandleTypeDef *hrtc_;
+    Tracker &tracker_;
+    Fifo &fifo_;
+    std::optional<IMUSample> last_gyr_;
+    std::optional<IMUSample> last_mag_;
+};
+
+template <typename Tracker, typename Fifo>
+au::QuantityU64<au::Milli<au::Seconds>> FifoGyrMagOrientation<Tracker, Fifo>::now() const
+{
+    TimeUtils::RTCDateTimeSubseconds rtc;
+    HAL_RTC_GetTime(hrtc_, &rtc.time, RTC_FORMAT_BIN);
+    HAL_RTC_GetDate(hrtc_, &rtc.date, RTC_FORMAT_BIN);
+    return TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
+}
+
+template <typename Tracker, typename Fifo>
+bool FifoGyrMagOrientation<Tracker, Fifo>::predict(std::array<float, 4> &q, au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
+{
+    timestamp = now();
+    update(timestamp);
+
+    auto q_ = tracker_.getOrientation();
+    q[0] = q_.w();
+    q[1] = q_.x();
+    q[2] = q_.y();
+    q[3] = q_.z();
+
+    return true;
+}
+
+template <typename Tracker, typename Fifo>
+OrientationSolution FifoGyrMagOrientation<Tracker, Fifo>::predict()
+{
+    OrientationSolution result{};
+    result.timestamp = now();
+    update(result.timestamp);
+
+    if (last_gyr_.has_value()) {
+        result.angular_velocity = last_gyr_->angular_velocity;
+        result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::ANGULAR_VELOCITY);
+    }
+
+    if (last_mag_.has_value()) {
+        result.magnetic_field = last_mag_->magnetic_field;
+        result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::MAGNETIC_FIELD);
+    }
+
+    auto q_ = tracker_.getOrientation();
+    result.q = { q_.w(), q_.x(), q_.y(), q_.z() };
+    result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::QUATERNION);
+
+    result.euler_angles = getEulerAngles({ q_.w(), q_.x(), q_.y(), q_.z() });
+    result.validity_flags |= static_cast<uint8_t>(OrientationSolution::Validity::ORIENTATIONS);
+
+    return result;
+}
+
+template <typename Tracker, typename Fifo>
+void FifoGyrMagOrientation<Tracker, Fifo>::update(au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
+{
+    fifo_.drain(timestamp);
+
+    last_gyr_.reset();
+    last_mag_.reset();
+    IMUSample sample;
+    while (fifo_.pop(sample))
+    {
+        if (sample.has(IMUSample::GYR))
+        {
+            tracker_.updateGyro(gyrVector(sample.angular_velocity), sample.timestamp);
+            last_gyr_ = sample;
+        }
+        if (sample.has(IMUSample::MAG))
+        {
+            last_mag_ = sample;
+        }
+    }
+
+    if (last_mag_.has_value())
+    {
+        tracker_.updateMagnetometer(magVector(last_mag_->magnetic_field), last_mag_->timestamp);
+    }
+}
+
 #endif // __ORIENTATION_SERVICE_HPP__
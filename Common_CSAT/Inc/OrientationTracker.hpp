@@ -394,4 +394,304 @@ public:
     }
 };
 
+#
+#
+#
+
+/*
+ * Multiplicative EKF: the attitude is a nominal quaternion, the filter state is a
+ * 3 component body frame attitude error plus a 3 component gyro bias. The 6x6
+ * covariance is propagated through the linearized error dynamics and the
+ * measurement Jacobians of a reference vector are closed form, H = [ [b_hat x]  0 ].
+ * Errors are folded into the nominal state after each update.
+ */
+template <int MeasurementSize>
+class BaseMEKFOrientationTracker
+{
+public:
+    static constexpr int StateSize = 6; // attitude error, gyro bias
+
+    using ErrorState = Eigen::Matrix<float, StateSize, 1>;
+    using Measurement = Eigen::Matrix<float, MeasurementSize, 1>;
+    using MeasurementMatrix = Eigen::Matrix<float, MeasurementSize, StateSize>;
+
+    /**
+     * @param gyroNoise          Gyro angle random walk [rad/s/sqrt(Hz)]
+     * @param biasNoise          Gyro bias random walk [rad/s^2/sqrt(Hz)]
+     * @param measurementNoise   Variance of each normalized reference vector component
+     * @param attitudeVariance   Initial attitude error variance [rad^2]
+     * @param biasVariance       Initial gyro bias variance [(rad/s)^2]
+     */
+    BaseMEKFOrientationTracker(float gyroNoise, float biasNoise, float measurementNoise, float attitudeVariance, float biasVariance)
+        : ekf(Eigen::Matrix<float, StateSize, StateSize>::Zero(),
+              Eigen::Matrix<float, MeasurementSize, MeasurementSize>::Identity() * measurementNoise,
+              initialCovariance(attitudeVariance, biasVariance),
+              ErrorState::Zero()),
+          gyro_variance(gyroNoise * gyroNoise),
+          bias_variance(biasNoise * biasNoise),
+          q(Eigen::Quaternionf::Identity()),
+          bias(Eigen::Vector3f::Zero()),
+          omega(Eigen::Vector3f::Zero()),
+          last_timestamp(au::make_quantity<au::Milli<au::Seconds>>(0)),
+          started(false)
+    {
+        ekf.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+    }
+
+    void predictTo(au::QuantityU64<au::Milli<au::Seconds>> new_timestamp)
+    {
+        // the first timestamp only starts the clock, timestamps are RTC epoch based
+        if (!started)
+        {
+            last_timestamp = new_timestamp;
+            started = true;
+            return;
+        }
+
+        float dt = 0.001f * static_cast<float>((new_timestamp - last_timestamp).in(au::milli(au::seconds)));
+        if (dt <= 0.f)
+            return;
+
+        const Eigen::Vector3f rate = omega - bias;
+        const float angle = rate.norm() * dt;
+        Eigen::Matrix3f R_step = Eigen::Matrix3f::Identity();
+        if (angle > 1e-6f)
+        {
+            const Eigen::AngleAxisf step(angle, rate / rate.norm());
+            q = (q * Eigen::Quaternionf(step)).normalized();
+            R_step = step.toRotationMatrix();
+        }
+
+        // d(dtheta)/dt = -[rate x] dtheta - dbias, exact over a step with constant rate
+        Eigen::Matrix<float, StateSize, StateSize> F = Eigen::Matrix<float, StateSize, StateSize>::Identity();
+        F.template block<3, 3>(0, 0) = R_step.transpose();
+        F.template block<3, 3>(0, 3) = -Eigen::Matrix3f::Identity() * dt;
+
+        ekf.processNoiseCovarianceMatrix.setZero();
+        ekf.processNoiseCovarianceMatrix.template block<3, 3>(0, 0).diagonal().setConstant(gyro_variance * dt);
+        ekf.processNoiseCovarianceMatrix.template block<3, 3>(3, 3).diagonal().setConstant(bias_variance * dt);
+        ekf.predict(F);
+
+        last_timestamp = new_timestamp;
+    }
+
+    void updateGyro(const Eigen::Vector3f &gyro, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+        omega = gyro;
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+    }
+
+    void setGyroAngularRate(const Eigen::Vector3f &rate)
+    {
+        omega = rate;
+    }
+
+    void setOrientation(const Eigen::Quaternionf &orientation)
+    {
+        q = orientation.normalized();
+    }
+
+    Eigen::Quaternionf getOrientation() const
+    {
+        return q;
+    }
+
+    Eigen::Vector3f getGyroBias() const
+    {
+        return bias;
+    }
+
+    const Eigen::Matrix<float, StateSize, StateSize> &getCovariance() const
+    {
+        return ekf.stateCovarianceMatrix;
+    }
+
+    Eigen::Vector3f getYawPitchRoll() const
+    {
+        float sinp = 2.f * (q.w() * q.y() - q.z() * q.x());
+        sinp = std::clamp(sinp, -1.f, 1.f);
+
+        float yaw = std::atan2(2.f * (q.w() * q.z() + q.x() * q.y()),
+                               1.f - 2.f * (q.y() * q.y() + q.z() * q.z()));
+        float pitch = std::asin(sinp);
+        float roll = std::atan2(2.f * (q.w() * q.x() + q.y() * q.z()),
+                                1.f - 2.f * (q.x() * q.x() + q.y() * q.y()));
+        return Eigen::Vector3f(yaw, pitch, roll);
+    }
+
+    // Closed form Jacobian of the predicted body vector q^-1 v_ned wrt the body attitude error
+    static Eigen::Matrix3f referenceJacobian(const Eigen::Vector3f &predicted_body)
+    {
+        Eigen::Matrix3f J;
+        J << 0.f, -predicted_body.z(), predicted_body.y(),
+            predicted_body.z(), 0.f, -predicted_body.x(),
+            -predicted_body.y(), predicted_body.x(), 0.f;
+        return J;
+    }
+
+protected:
+    // Measurement rows are stacked reference vectors, R is diagonal
+    void correct(const MeasurementMatrix &H, const Measurement &residual)
+    {
+        ekf.stateVector.setZero();
+        ekf.updateSequential(H, residual);
+
+        const Eigen::Vector3f dtheta = ekf.stateVector.template segment<3>(0);
+        q = (q * Eigen::Quaternionf(1.f, 0.5f * dtheta.x(), 0.5f * dtheta.y(), 0.5f * dtheta.z())).normalized();
+        bias += ekf.stateVector.template segment<3>(3);
+        ekf.stateVector.setZero();
+    }
+
+    static Eigen::Matrix<float, StateSize, StateSize> initialCovariance(float attitudeVariance, float biasVariance)
+    {
+        Eigen::Matrix<float, StateSize, StateSize> P = Eigen::Matrix<float, StateSize, StateSize>::Zero();
+        P.template block<3, 3>(0, 0).diagonal().setConstant(attitudeVariance);
+        P.template block<3, 3>(3, 3).diagonal().setConstant(biasVariance);
+        return P;
+    }
+
+    KalmanFilter<StateSize, MeasurementSize> ekf;
+    float gyro_variance;
+    float bias_variance;
+    Eigen::Quaternionf q;
+    Eigen::Vector3f bias;
+    Eigen::Vector3f omega;
+    au::QuantityU64<au::Milli<au::Seconds>> last_timestamp;
+    bool started;
+};
+
+#
+#
+#
+
+// Drop-in for GyrMagOrientationTracker
+class GyrMagMEKFOrientationTracker : public BaseMEKFOrientationTracker<3>
+{
+public:
+    GyrMagMEKFOrientationTracker() : BaseMEKFOrientationTracker<3>(1e-3f, 1e-4f, 0.01f, 0.3f, 1e-3f), magnetic_ned(Eigen::Vector3f(0.3f, 0.5f, 0.8f).normalized()) {}
+
+    void updateMagnetometer(const Eigen::Vector3f &mag_body, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        const Eigen::Vector3f predicted = q.conjugate() * magnetic_ned;
+        MeasurementMatrix H = MeasurementMatrix::Zero();
+        H.block<3, 3>(0, 0) = referenceJacobian(predicted);
+        correct(H, mag_body.normalized() - predicted);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &mag_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateMagnetometer(mag_body, timestamp);
+    }
+
+    void setReferenceVectors(const Eigen::Vector3f &magnetic_ned_in)
+    {
+        magnetic_ned = magnetic_ned_in.normalized();
+    }
+
+private:
+    Eigen::Vector3f magnetic_ned;
+};
+
+#
+#
+#
+
+// Drop-in for AccGyrMagOrientationTracker
+class AccGyrMagMEKFOrientationTracker : public BaseMEKFOrientationTracker<6>
+{
+public:
+    AccGyrMagMEKFOrientationTracker()
+        : BaseMEKFOrientationTracker<6>(1e-3f, 1e-4f, 0.01f, 0.3f, 1e-3f),
+          accel_ned(0.f, 0.f, 1.f),
+          magnetic_ned(Eigen::Vector3f(0.51f, 0.04f, 0.89f).normalized())
+    {
+    }
+
+    void updateAccelerometerMagnetometer(const Eigen::Vector3f &accel_body,
+                                         const Eigen::Vector3f &mag_body,
+                                         au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        const Eigen::Vector3f predicted_accel = q.conjugate() * accel_ned;
+        const Eigen::Vector3f predicted_mag = q.conjugate() * magnetic_ned;
+
+        MeasurementMatrix H = MeasurementMatrix::Zero();
+        H.block<3, 3>(0, 0) = referenceJacobian(predicted_accel);
+        H.block<3, 3>(3, 0) = referenceJacobian(predicted_mag);
+
+        Measurement residual;
+        residual << accel_body.normalized() - predicted_accel, mag_body.normalized() - predicted_mag;
+        correct(H, residual);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &accel_body,
+                            const Eigen::Vector3f &mag_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateAccelerometerMagnetometer(accel_body, mag_body, timestamp);
+    }
+
+    void setReferenceVectors(const Eigen::Vector3f &accel_ned_in,
+                             const Eigen::Vector3f &magnetic_ned_in)
+    {
+        accel_ned = accel_ned_in.normalized();
+        magnetic_ned = magnetic_ned_in.normalized();
+    }
+
+private:
+    Eigen::Vector3f accel_ned;
+    Eigen::Vector3f magnetic_ned;
+};
+
+#
+#
+#
+
+// Drop-in for AccGyrOrientationTracker
+class AccGyrMEKFOrientationTracker : public BaseMEKFOrientationTracker<3>
+{
+public:
+    AccGyrMEKFOrientationTracker() : BaseMEKFOrientationTracker<3>(1e-3f, 1e-4f, 0.01f, 0.3f, 1e-3f), accel_ned(0.f, 0.f, 1.f) {}
+
+    void updateAccelerometer(const Eigen::Vector3f &accel_body,
+                             au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        predictTo(timestamp);
+
+        const Eigen::Vector3f predicted = q.conjugate() * accel_ned;
+        MeasurementMatrix H = MeasurementMatrix::Zero();
+        H.block<3, 3>(0, 0) = referenceJacobian(predicted);
+        correct(H, accel_body.normalized() - predicted);
+    }
+
+    void updateSensorFusion(const Eigen::Vector3f &gyro,
+                            const Eigen::Vector3f &accel_body,
+                            au::QuantityU64<au::Milli<au::Seconds>> timestamp)
+    {
+        updateGyro(gyro, timestamp);
+        updateAccelerometer(accel_body, timestamp);
+    }
+
+    void setReferenceVectors(const Eigen::Vector3f &accel_ned_in)
+    {
+        accel_ned = accel_ned_in.normalized();
+    }
+
+private:
+    Eigen::Vector3f accel_ned;
+};
+
 #endif // __ORIENTATION_TRACKER_HPP__
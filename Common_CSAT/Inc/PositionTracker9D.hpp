@@ -59,16 +59,11 @@ public:
     PositionTracker9D()
         : last_timestamp(au::make_quantity<au::Milli<au::Seconds>>(0)),
           A(Eigen::Matrix<float, StateSize, StateSize>::Identity()),
-          H_gps(Eigen::Matrix<float, PosMeasSize, StateSize>::Zero()),
-          H_acc(Eigen::Matrix<float, AccMeasSize, StateSize>::Zero()),
           Q(Eigen::Matrix<float, StateSize, StateSize>::Identity() * 1e-4f),
           R_gps(Eigen::Matrix3f::Identity() * 5e-3f),
           R_accel(Eigen::Matrix3f::Identity() * 1e-2f),
           kf(Q, R_gps, Q, StateVector::Zero())
-
     {
-        H_gps.block<3, 3>(0, 0) = Eigen::Matrix3f::Identity();
-        H_acc.block<3, 3>(0, 6) = Eigen::Matrix3f::Identity();
     }
 
     void updateWithAccel(const Eigen::Vector3f &accel, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
@@ -80,7 +75,7 @@ public:
         // kf.stateVector = accelKF.stateVector;
         // kf.stateCovarianceMatrix = accelKF.stateCovarianceMatrix;
 
-        kf.update(H_acc, accel);
+        kf.updateSequential(ACC_STATES, accel);
 
         // std::cerr << "timestamp_sec: " << timestamp_sec << ", A:\n" << A << "\n";
         // std::cerr << "State end of updateWithAccel:\n" << kf.getState().transpose() << "\n";
@@ -89,7 +84,7 @@ public:
     void updateWithGps(const Eigen::Vector3f &gps, au::QuantityU64<au::Milli<au::Seconds>> timestamp)
     {
         maybePredict(timestamp);
-        kf.update(H_gps, gps);
+        kf.updateSequential(GPS_STATES, gps);
         // std::cerr << "timestamp_sec: " << timestamp_sec << ", A:\n" << A << "\n";
         // std::cerr << "State end of updateWithGps:\n" << kf.getState().transpose() << "\n";
     }
@@ -106,7 +101,7 @@ public:
 
     void injectGpsWithoutPrediction(const Eigen::Vector3f &gps)
     {
-        kf.update(H_gps, gps);
+        kf.updateSequential(GPS_STATES, gps);
     }
 
 protected:
@@ -142,8 +137,9 @@ protected:
 protected:
     au::QuantityU64<au::Milli<au::Seconds>> last_timestamp;
     Eigen::Matrix<float, StateSize, StateSize> A;
-    Eigen::Matrix<float, PosMeasSize, StateSize> H_gps;
-    Eigen::Matrix<float, AccMeasSize, StateSize> H_acc;
+    // GPS and accelerometer measure state blocks directly, H is a selector and R is diagonal
+    static constexpr std::array<int, PosMeasSize> GPS_STATES{0, 1, 2};
+    static constexpr std::array<int, AccMeasSize> ACC_STATES{6, 7, 8};
     Eigen::Matrix<float, StateSize, StateSize> Q;
     Eigen::Matrix3f R_gps, R_accel;
     KalmanFilter<StateSize, PosMeasSize> kf;
@@ -3,11 +3,13 @@
 
 #include <tuple>
 #include <memory>
+#include <type_traits>
 
 #include "cyphal.hpp"
 #include "canard_adapter.hpp"
 #include "serard_adapter.hpp"
 #include "loopard_adapter.hpp"
+#include "CyphalRouter.hpp"
 
 #include "CircularBuffer.hpp"
 #include "ServiceManager.hpp"
@@ -31,18 +33,33 @@ struct CanRxFrame
     uint8_t data[CAN_MTU];
 };
 
-template <typename Allocator>
+template <typename Allocator, typename Router = CyphalRouter<>>
 class LoopManager
 {
 private:
     Allocator &allocator_;
+    Router router_;
 
 public:
     LoopManager(Allocator &allocator) : allocator_(allocator) {}
 
+    // Forwarding table, received transfers only leave on adapters with a matching route
+    Router &router() { return router_; }
+    const Router &router() const { return router_; }
+
+    // Index of the first Cyphal<Adapter> in the tuple, the link a transfer was received on
+    template <typename Adapter, typename... Adapters>
+    static constexpr uint8_t ingressIndex(const std::tuple<Adapters...> &)
+    {
+        uint8_t index = 0;
+        bool found = false;
+        ((found = found || std::is_same_v<Adapters, Cyphal<Adapter>>, index = static_cast<uint8_t>(index + (found ? 0 : 1))), ...);
+        return found ? index : Router::NO_ADAPTER;
+    }
+
     // Common transfer processing function
     template <typename... Adapters>
-    bool processTransfer(CyphalTransfer &transfer, ServiceManager *service_manager, std::tuple<Adapters...> &adapters)
+    bool processTransfer(CyphalTransfer &transfer, ServiceManager *service_manager, std::tuple<Adapters...> &adapters, uint8_t ingress = Router::NO_ADAPTER)
     {
 //    	constexpr size_t BUFFER_SIZE = 512;
 //    	char hex_string_buffer[BUFFER_SIZE];
@@ -52,13 +69,7 @@ public:
     	std::shared_ptr<CyphalTransfer> transfer_ptr = std::allocate_shared<CyphalTransfer>(allocator_, transfer);
         service_manager->handleMessage(transfer_ptr);
 
-        bool all_successful = true;
-        std::apply([&](auto &...adapter)
-                   { ([&]()
-                      {
-            int32_t res = adapter.cyphalTxForward(static_cast<CyphalMicrosecond>(0), &transfer.metadata, transfer.payload_size, transfer.payload, CYPHAL_NODE_ID_UNSET);
-            all_successful = all_successful && (res > 0); }(), ...); }, adapters);
-        return all_successful; // Return success status
+        return router_.forward(transfer, adapters, ingress); // Return success status
     }
 
     template <size_t N, typename... Adapters>
@@ -79,7 +90,7 @@ public:
             int32_t result = cyphal->cyphalRxReceive(frame.header.ExtId, &frame_size, frame.data, &transfer);
             if (result == 1)
             {
-                processTransfer(transfer, service_manager, adapters);
+                processTransfer(transfer, service_manager, adapters, ingressIndex<CanardAdapter>(adapters));
             }
         }
     }
@@ -107,7 +118,7 @@ public:
 
                 if (result == 1)
                 {
-                    processTransfer(transfer, service_manager, adapters);
+                    processTransfer(transfer, service_manager, adapters, ingressIndex<SerardAdapter>(adapters));
                 }
 
                 if (frame_size == 0)
@@ -123,7 +134,7 @@ public:
         CyphalTransfer transfer;
         while (cyphal->cyphalRxReceive(nullptr, nullptr, &transfer))
         {
-            processTransfer(transfer, service_manager, adapters);
+            processTransfer(transfer, service_manager, adapters, ingressIndex<LoopardAdapter>(adapters));
         }
     }
 
@@ -0,0 +1,424 @@
+#ifndef __REGISTER_TABLE_LOADER_HPP__
+#define __REGISTER_TABLE_LOADER_HPP__
+
+#ifdef __arm__
+#include "stm32l4xx_hal.h"
+#elif __x86_64__
+#include "mock_hal.h"
+#endif
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "OVXXXX_Common.hpp"
+
+// -----------------------------------------------------------------------------
+// Register table loader for the OV camera init tables
+//
+// The tables are {addr, value} lists written in order. At compile time,
+// runs of consecutive addresses are folded into bursts that go out as one
+// multi-byte register write (the sensors auto-increment the address), so
+// each run costs one address phase instead of one per register.
+//
+// At run time the loader keeps a shadow of what it wrote. Bytes at the edges
+// of a burst that already hold the table value are trimmed off, and bursts
+// that match completely are skipped. Re-applying a table, or switching to a
+// table that shares most registers, then costs only the differences.
+//
+// The policy describes the sensor:
+//   banked / isBankSelect  a register selecting which register page the
+//                          following addresses refer to (OV2640 0xFF)
+//   isReset                a soft reset; the shadow is dropped after it
+//   cacheable              false for registers the sensor changes on its own
+//                          (AEC / AGC results), these are always written
+//   shadowKey              16-bit key of a register in a bank
+//   max_burst              longest burst the sensor accepts
+// Bank selects and resets never share a burst with other registers.
+// -----------------------------------------------------------------------------
+
+constexpr uint8_t REGISTER_BANK_UNKNOWN = 0xFF;
+
+template <typename P>
+concept RegisterTablePolicy = requires(uint16_t addr, uint8_t value, uint8_t bank) {
+    { P::banked } -> std::convertible_to<bool>;
+    { P::max_burst } -> std::convertible_to<size_t>;
+    { P::reset_delay_ms } -> std::convertible_to<uint32_t>;
+    { P::isBankSelect(addr) } -> std::same_as<bool>;
+    { P::isReset(addr, value, bank) } -> std::same_as<bool>;
+    { P::cacheable(addr, bank) } -> std::same_as<bool>;
+    { P::shadowKey(addr, bank) } -> std::same_as<uint16_t>;
+};
+
+// Optional non-blocking write (I2C DMA). write_reg_async() starts a write
+// whose data must stay valid until write_reg_wait() reported it done.
+template <typename T>
+concept AsyncRegisterWriteTransport = requires(T t, uint16_t reg, const uint8_t *data, uint16_t len) {
+    { t.write_reg_async(reg, data, len) } -> std::same_as<bool>;
+    { t.write_reg_wait() } -> std::same_as<bool>;
+};
+
+struct RegisterBurst
+{
+    uint16_t addr;   // first register
+    uint16_t first;  // index of the first value in the table's value array
+    uint16_t length; // number of registers
+};
+
+struct RegisterTableView
+{
+    const RegisterBurst *bursts;
+    size_t count;
+    const uint8_t *values;
+};
+
+namespace register_table
+{
+// A table entry that has to be written on its own
+template <RegisterTablePolicy Policy>
+constexpr bool isBarrier(const Word_Byte_t &e)
+{
+    return Policy::isBankSelect(e.addr) || Policy::isReset(e.addr, e.data, REGISTER_BANK_UNKNOWN);
+}
+
+// Entry i continues the burst that ends with entry i - 1 (of `length` entries)
+template <RegisterTablePolicy Policy, size_t N>
+constexpr bool continues(const Word_Byte_t (&table)[N], size_t i, size_t length)
+{
+    return i > 0 && length < Policy::max_burst &&
+           table[i].addr == table[i - 1].addr + 1 &&
+           !isBarrier<Policy>(table[i]) && !isBarrier<Policy>(table[i - 1]);
+}
+
+template <RegisterTablePolicy Policy, size_t N>
+constexpr size_t countBursts(const Word_Byte_t (&table)[N])
+{
+    size_t count = 0;
+    size_t length = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (continues<Policy>(table, i, length))
+        {
+            ++length;
+        }
+        else
+        {
+            ++count;
+            length = 1;
+        }
+    }
+    return count;
+}
+
+template <RegisterTablePolicy Policy, size_t Count, size_t N>
+constexpr std::array<RegisterBurst, Count> buildBursts(const Word_Byte_t (&table)[N])
+{
+    std::array<RegisterBurst, Count> bursts{};
+    size_t b = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (b > 0 && continues<Policy>(table, i, bursts[b - 1].length))
+        {
+            ++bursts[b - 1].length;
+        }
+        else
+        {
+            bursts[b++] = RegisterBurst{table[i].addr, static_cast<uint16_t>(i), 1};
+        }
+    }
+    return bursts;
+}
+
+template <size_t N>
+constexpr std::array<uint8_t, N> buildValues(const Word_Byte_t (&table)[N])
+{
+    std::array<uint8_t, N> values{};
+    for (size_t i = 0; i < N; ++i)
+        values[i] = table[i].data;
+    return values;
+}
+} // namespace register_table
+
+// Burst form of a constexpr init table, built at compile time (lives in flash)
+template <const auto &Table, RegisterTablePolicy Policy>
+struct RegisterBurstTable
+{
+    static constexpr size_t entries = std::size(Table);
+    static constexpr size_t count = register_table::countBursts<Policy>(Table);
+
+    static_assert(entries <= UINT16_MAX, "register table too long");
+
+    static constexpr std::array<RegisterBurst, count> bursts =
+        register_table::buildBursts<Policy, count>(Table);
+    static constexpr std::array<uint8_t, entries> values = register_table::buildValues(Table);
+
+    static constexpr RegisterTableView view() { return {bursts.data(), count, values.data()}; }
+};
+
+// Last written value per register key, open addressing with linear probing.
+// When it is full further registers are simply not cached.
+template <size_t Capacity>
+class RegisterShadow
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool lookup(uint16_t key, uint8_t &value) const
+    {
+        const size_t s = find(key);
+        if (s == NOT_FOUND || slots_[s].state != State::Valid)
+            return false;
+        value = slots_[s].value;
+        return true;
+    }
+
+    void store(uint16_t key, uint8_t value)
+    {
+        Slot *slot = findOrInsert(key);
+        if (slot == nullptr)
+            return;
+        slot->value = value;
+        slot->state = State::Valid;
+    }
+
+    void forget(uint16_t key)
+    {
+        const size_t s = find(key);
+        if (s != NOT_FOUND)
+            slots_[s].state = State::Unknown;
+    }
+
+    void clear() { slots_ = {}; }
+
+private:
+    enum class State : uint8_t
+    {
+        Empty,
+        Unknown, // key seen, value not known (keeps the probe chain intact)
+        Valid
+    };
+
+    struct Slot
+    {
+        uint16_t key;
+        uint8_t value;
+        State state;
+    };
+
+    static size_t home(uint16_t key) { return (key * 40503U) & (Capacity - 1); }
+
+    static constexpr size_t NOT_FOUND = Capacity;
+
+    size_t find(uint16_t key) const
+    {
+        for (size_t i = 0, s = home(key); i < Capacity; ++i, s = (s + 1) & (Capacity - 1))
+        {
+            if (slots_[s].state == State::Empty)
+                return NOT_FOUND;
+            if (slots_[s].key == key)
+                return s;
+        }
+        return NOT_FOUND;
+    }
+
+    Slot *findOrInsert(uint16_t key)
+    {
+        for (size_t i = 0, s = home(key); i < Capacity; ++i, s = (s + 1) & (Capacity - 1))
+        {
+            if (slots_[s].state == State::Empty)
+            {
+                slots_[s].key = key;
+                slots_[s].state = State::Unknown;
+                return &slots_[s];
+            }
+            if (slots_[s].key == key)
+                return &slots_[s];
+        }
+        return nullptr;
+    }
+
+    std::array<Slot, Capacity> slots_{};
+};
+
+struct RegisterLoadStats
+{
+    uint32_t transactions = 0; // register writes put on the bus
+    uint32_t bytes = 0;        // register values written
+    uint32_t skipped = 0;      // register values already in the sensor
+};
+
+template <typename Transport, RegisterTablePolicy Policy, size_t ShadowCapacity = 512>
+class RegisterTableLoader
+{
+public:
+    explicit RegisterTableLoader(Transport &transport) : transport_(transport) {}
+
+    template <const auto &Table>
+    bool load()
+    {
+        return load(RegisterBurstTable<Table, Policy>::view());
+    }
+
+    bool load(const RegisterTableView &table)
+    {
+        bool pending = false;
+        for (size_t b = 0; b < table.count; ++b)
+        {
+            const RegisterBurst &burst = table.bursts[b];
+            const uint8_t *values = table.values + burst.first;
+
+            uint16_t first = 0;
+            uint16_t length = burst.length;
+            const bool barrier = isBarrierWrite(burst.addr, values[0]);
+            if (!barrier)
+                trim(burst.addr, values, first, length);
+            else if (Policy::isBankSelect(burst.addr) && bank_ == values[0])
+                length = 0;
+
+            stats_.skipped += static_cast<uint32_t>(burst.length - length);
+            if (length == 0)
+                continue;
+
+            const uint16_t addr = static_cast<uint16_t>(burst.addr + first);
+            const uint8_t *data = values + first;
+
+            // the previous burst was on the bus while this one was trimmed
+            if (pending && !finish(pending))
+                return false;
+            if (!start(addr, data, length, pending))
+                return false;
+
+            if (barrier && Policy::isReset(addr, data[0], bank_))
+            {
+                if (pending && !finish(pending))
+                    return false;
+                if (Policy::reset_delay_ms > 0)
+                    HAL_Delay(Policy::reset_delay_ms);
+            }
+            record(addr, data, length);
+        }
+        return !pending || finish(pending);
+    }
+
+    // Plain register write outside a table; keeps the shadow in step
+    bool write(uint16_t addr, const uint8_t *data, uint16_t length)
+    {
+        ++stats_.transactions;
+        stats_.bytes += length;
+        if (!transport_.write_reg(addr, data, length))
+        {
+            invalidate();
+            return false;
+        }
+        record(addr, data, length);
+        return true;
+    }
+
+    // The sensor was reset or powered down: nothing is known about it
+    void invalidate()
+    {
+        shadow_.clear();
+        bank_ = REGISTER_BANK_UNKNOWN;
+    }
+
+    const RegisterLoadStats &stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+private:
+    bool bankKnown() const { return !Policy::banked || bank_ != REGISTER_BANK_UNKNOWN; }
+
+    bool isBarrierWrite(uint16_t addr, uint8_t value) const
+    {
+        return Policy::isBankSelect(addr) || Policy::isReset(addr, value, REGISTER_BANK_UNKNOWN);
+    }
+
+    bool matches(uint16_t addr, uint8_t value) const
+    {
+        if (!bankKnown() || !Policy::cacheable(addr, bank_))
+            return false;
+        uint8_t cached = 0;
+        return shadow_.lookup(Policy::shadowKey(addr, bank_), cached) && cached == value;
+    }
+
+    // Drop the registers at both ends of the burst that already match
+    void trim(uint16_t addr, const uint8_t *values, uint16_t &first, uint16_t &length) const
+    {
+        while (length > 0 && matches(static_cast<uint16_t>(addr + first), values[first]))
+        {
+            ++first;
+            --length;
+        }
+        while (length > 0 && matches(static_cast<uint16_t>(addr + first + length - 1), values[first + length - 1]))
+            --length;
+    }
+
+    bool start(uint16_t addr, const uint8_t *data, uint16_t length, bool &pending)
+    {
+        ++stats_.transactions;
+        stats_.bytes += length;
+
+        if constexpr (AsyncRegisterWriteTransport<Transport>)
+        {
+            // table data is static, it can be read by the DMA in place
+            if (transport_.write_reg_async(addr, data, length))
+            {
+                pending = true;
+                return true;
+            }
+        }
+        if (!transport_.write_reg(addr, data, length))
+        {
+            invalidate();
+            return false;
+        }
+        return true;
+    }
+
+    bool finish(bool &pending)
+    {
+        pending = false;
+        if constexpr (AsyncRegisterWriteTransport<Transport>)
+        {
+            if (!transport_.write_reg_wait())
+            {
+                invalidate();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void record(uint16_t addr, const uint8_t *data, uint16_t length)
+    {
+        if (Policy::isBankSelect(addr))
+        {
+            bank_ = data[0];
+            return;
+        }
+        if (Policy::isReset(addr, data[0], bank_))
+        {
+            invalidate();
+            return;
+        }
+        if (!bankKnown())
+            return;
+
+        for (uint16_t i = 0; i < length; ++i)
+        {
+            const auto reg = static_cast<uint16_t>(addr + i);
+            if (Policy::cacheable(reg, bank_))
+                shadow_.store(Policy::shadowKey(reg, bank_), data[i]);
+            else
+                shadow_.forget(Policy::shadowKey(reg, bank_));
+        }
+    }
+
+    Transport &transport_;
+    RegisterShadow<ShadowCapacity> shadow_;
+    uint8_t bank_ = REGISTER_BANK_UNKNOWN;
+    RegisterLoadStats stats_;
+};
+
+#endif // __REGISTER_TABLE_LOADER_HPP__
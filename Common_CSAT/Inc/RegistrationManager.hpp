@@ -8,6 +8,7 @@
 #include <type_traits>
 #include "ArrayList.hpp"
 #include "Task.hpp"
+#include "TaskDispatchTable.hpp"
 #include "cyphal.hpp"
 
 /**
@@ -112,6 +113,12 @@ public:
      */
     inline const ArrayList<TaskHandler, NUM_TASK_HANDLERS> &getHandlers() const;
 
+    /**
+     * @brief Gets the port-sorted dispatch index over the task handlers.
+     * @return A const reference to the dispatch table, rebuilt on every (un)registration.
+     */
+    inline const TaskDispatchTable<NUM_TASK_HANDLERS> &getDispatchTable() const;
+
     /**
      * @brief Gets the list of Cyphal subscriptions.
      * @return A const reference to the ArrayList of Cyphal subscriptions.
@@ -129,6 +136,11 @@ private:
      */
     ArrayList<TaskHandler, NUM_TASK_HANDLERS> handlers_;
 
+    /**
+     * @brief Dispatch index over handlers_, keyed by port ID.
+     */
+    TaskDispatchTable<NUM_TASK_HANDLERS> dispatch_;
+
     /**
      * @brief List of Cyphal subscriptions.
      */
@@ -172,6 +184,12 @@ inline bool RegistrationManager::containsTask(const std::shared_ptr<Task> &task)
  */
 inline const ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> &RegistrationManager::getHandlers() const { return handlers_; }
 
+/**
+ * @brief Gets the port-sorted dispatch index over the task handlers.
+ * @return A const reference to the dispatch table.
+ */
+inline const TaskDispatchTable<RegistrationManager::NUM_TASK_HANDLERS> &RegistrationManager::getDispatchTable() const { return dispatch_; }
+
 /**
  * @brief Gets the list of Cyphal subscriptions.
  * @return A const reference to the ArrayList of Cyphal subscriptions.
@@ -24,10 +24,8 @@ public:
     Sgp4PositionTracker()
         : Q(Eigen::Matrix<float, StateSize, StateSize>::Identity() * 0.01f),
           R(Eigen::Matrix3f::Identity() * 0.1f),
-          H(Eigen::Matrix<float, MeasurementSize, StateSize>::Zero()),
           kf(Q, R, Q, StateVector::Zero())
     {
-        H.block<3, 3>(0, 0) = Eigen::Matrix3f::Identity();
     }
 
     void setPrediction(const Eigen::Vector3f &pos, const Eigen::Vector3f &vel)
@@ -40,7 +38,7 @@ public:
 
     void updateWithGps(const Eigen::Vector3f &gps_measurement)
     {
-        kf.update(H, gps_measurement);
+        kf.updateSequential(GPS_STATES, gps_measurement);
     }
 
     StateVector getState() const
@@ -50,8 +48,10 @@ public:
 
 private:
     Eigen::Matrix<float, StateSize, StateSize> Q;
+    // GPS measures the position states, H = [I 0] and R is diagonal
+    static constexpr std::array<int, MeasurementSize> GPS_STATES{0, 1, 2};
+
     Eigen::Matrix3f R;
-    Eigen::Matrix<float, MeasurementSize, StateSize> H;
     KalmanFilter<StateSize, MeasurementSize> kf;
 };
 
@@ -9,25 +9,57 @@
 #define INC_SERVICEMANAGER_HPP_
 
 #include <memory>
+#include <array>
 #include "cstdint"
 
 #include "ArrayList.hpp"
 #include "Task.hpp"
 #include "RegistrationManager.hpp"
+#include "TaskDispatchTable.hpp"
+#include "TaskScheduler.hpp"
 
 class ServiceManager {
 public:
 	ServiceManager () = delete;
-	ServiceManager(const ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> &handlers): handlers_(handlers) {};
+	// a bare handler list has no change notification: messages are matched against the
+	// live list and the schedule is rebuilt whenever the listed tasks differ
+	ServiceManager(const ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> &handlers)
+		: handlers_(handlers), dispatch_(nullptr), scheduler_(), scheduled_generation_(0), scheduled_tasks_(), scheduled_count_(0), schedule_valid_(false) {};
 
-	void initializeServices(uint32_t now) const;
-	void handleMessage(std::shared_ptr<CyphalTransfer> transfer) const;
-	void handleServices() const;
+	// shares the dispatch index the RegistrationManager keeps up to date on (un)registration
+	ServiceManager(const RegistrationManager &manager)
+		: handlers_(manager.getHandlers()), dispatch_(&manager.getDispatchTable()), scheduler_(), scheduled_generation_(0), scheduled_tasks_(), scheduled_count_(0), schedule_valid_(false) {};
+
+	ServiceManager(const ServiceManager &) = delete;
+	ServiceManager &operator=(const ServiceManager &) = delete;
+
+	void initializeServices(uint32_t now);
+	void handleMessage(const std::shared_ptr<CyphalTransfer> &transfer) const;
+
+	// runs the tasks that are due, in deadline order
+	void handleServices();
+
+	// tick at which the earliest task is due, TaskScheduler::NO_DEADLINE without tasks
+	uint32_t nextDeadline();
+
+	// re-keys a task whose interval or last tick was changed outside its own run
+	void reschedule(Task *task);
 
     inline const ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> &getHandlers() const { return handlers_; };
+    // nullptr when constructed from a bare handler list
+    inline const TaskDispatchTable<RegistrationManager::NUM_TASK_HANDLERS> *getDispatchTable() const { return dispatch_; };
 
 private:
 	const ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> &handlers_;
+	const TaskDispatchTable<RegistrationManager::NUM_TASK_HANDLERS> *dispatch_;
+	TaskScheduler<RegistrationManager::NUM_TASK_HANDLERS> scheduler_;
+	uint32_t scheduled_generation_;
+	std::array<const Task *, RegistrationManager::NUM_TASK_HANDLERS> scheduled_tasks_;
+	size_t scheduled_count_;
+	bool schedule_valid_;
+
+	bool handlersChanged() const;
+	void updateSchedule();
 };
 
 #endif /* INC_SERVICEMANAGER_HPP_ */
@@ -0,0 +1,103 @@
+#ifndef INC_TASKDISPATCHTABLE_HPP_
+#define INC_TASKDISPATCHTABLE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "ArrayList.hpp"
+#include "Task.hpp"
+#include "cyphal.hpp"
+
+/**
+ * @brief A dispatch entry maps a port to the task that handles transfers on it.
+ *        The task pointer is non-owning; the owning shared_ptr lives in the
+ *        TaskHandler list the table was built from.
+ */
+struct TaskDispatchEntry
+{
+	CyphalPortID port_id;
+	Task *task;
+};
+
+/**
+ * @brief Port-sorted index over a TaskHandler list.
+ *
+ * The table is rebuilt whenever the handler list changes (registration time) and
+ * answers "which tasks listen on port X" with a binary search over a contiguous
+ * array, without touching the shared_ptr reference counts of the tasks.
+ * Tasks registered on the same port keep their registration order.
+ */
+template <size_t capacity_>
+class TaskDispatchTable
+{
+public:
+	TaskDispatchTable() : entries_(), count_(0), generation_(0) {}
+
+	void rebuild(const ArrayList<TaskHandler, capacity_> &handlers)
+	{
+		++generation_;
+		count_ = 0;
+		for (const auto &handler : handlers)
+		{
+			insert(TaskDispatchEntry{handler.port_id, handler.task.get()});
+		}
+	}
+
+	std::span<const TaskDispatchEntry> find(CyphalPortID port_id) const
+	{
+		size_t lo = lowerBound(port_id);
+		size_t hi = lo;
+		while (hi < count_ && entries_[hi].port_id == port_id)
+		{
+			++hi;
+		}
+		return std::span<const TaskDispatchEntry>(entries_.data() + lo, hi - lo);
+	}
+
+	size_t size() const { return count_; }
+	size_t capacity() const { return capacity_; }
+
+	// bumped on every rebuild so dependents can tell the handler list changed
+	uint32_t generation() const { return generation_; }
+
+private:
+	size_t lowerBound(CyphalPortID port_id) const
+	{
+		size_t lo = 0;
+		size_t hi = count_;
+		while (lo < hi)
+		{
+			size_t mid = lo + (hi - lo) / 2;
+			if (entries_[mid].port_id < port_id)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	// insertion keeps the table sorted and stable without heap allocation
+	void insert(const TaskDispatchEntry &entry)
+	{
+		if (count_ >= capacity_)
+			return;
+
+		size_t pos = count_;
+		while (pos > 0 && entries_[pos - 1].port_id > entry.port_id)
+		{
+			entries_[pos] = entries_[pos - 1];
+			--pos;
+		}
+		entries_[pos] = entry;
+		++count_;
+	}
+
+private:
+	std::array<TaskDispatchEntry, capacity_> entries_;
+	size_t count_;
+	uint32_t generation_;
+};
+
+#endif /* INC_TASKDISPATCHTABLE_HPP_ */
@@ -0,0 +1,89 @@
+#ifndef _TASKDRAINLOG_HPP_
+#define _TASKDRAINLOG_HPP_
+
+#include "Task.hpp"
+#include "RegistrationManager.hpp"
+#include "DeferredLog.hpp"
+
+// Empties the LOG_DEFERRED ring from the main loop, as text through the
+// Logger outputs or as binary frames for the ground decoder
+class TaskDrainLog : public Task
+{
+public:
+    enum class Output : uint8_t
+    {
+        Text,
+        Binary
+    };
+
+    TaskDrainLog(uint32_t interval, uint32_t tick, Output output = Output::Text, size_t max_entries = 16)
+        : Task(interval, tick)
+        , output_(output)
+        , max_entries_(max_entries)
+    {}
+
+    virtual void registerTask(RegistrationManager* manager, std::shared_ptr<Task> task) override;
+    virtual void unregisterTask(RegistrationManager* manager, std::shared_ptr<Task> task) override;
+
+    virtual void handleTaskImpl() override;
+
+    size_t drained() const { return drained_; }
+
+protected:
+    void emit(const deferred_log::Entry& entry);
+
+    Output output_;
+    size_t max_entries_;
+    size_t drained_ = 0;
+    uint32_t reported_drops_ = 0;
+};
+
+inline void TaskDrainLog::handleTaskImpl()
+{
+    deferred_log::Entry entry;
+    for (size_t i = 0; i < max_entries_ && deferred_log::ring.peek(entry); ++i)
+    {
+        emit(entry);
+        deferred_log::ring.pop();
+        ++drained_;
+    }
+
+    const uint32_t drops = deferred_log::ring.dropped();
+    if (drops != reported_drops_)
+    {
+        log(LOG_LEVEL_WARNING, "TaskDrainLog %u entries dropped\r\n", static_cast<unsigned>(drops - reported_drops_));
+        reported_drops_ = drops;
+    }
+}
+
+inline void TaskDrainLog::emit([[maybe_unused]] const deferred_log::Entry& entry)
+{
+#ifdef LOGGER_ENABLED
+    if (output_ == Output::Binary)
+    {
+        uint8_t frame[deferred_log::FRAME_HEADER + 2 * deferred_log::Ring::payloadCapacity()];
+        const size_t size = deferred_log::encode(entry, frame, sizeof(frame));
+        if (size > 0)
+            Logger::writeBinary(frame, size);
+    }
+    else
+    {
+        char text[256];
+        const size_t size = deferred_log::format(entry, text, sizeof(text));
+        if (size > 0)
+            Logger::write(entry.site->level, text, size);
+    }
+#endif
+}
+
+inline void TaskDrainLog::registerTask(RegistrationManager* manager, std::shared_ptr<Task> task)
+{
+    manager->subscribe(PURE_HANDLER, task);
+}
+
+inline void TaskDrainLog::unregisterTask(RegistrationManager* manager, std::shared_ptr<Task> task)
+{
+    manager->unsubscribe(PURE_HANDLER, task);
+}
+
+#endif // _TASKDRAINLOG_HPP_
@@ -11,6 +11,7 @@
 #include "RegistrationManager.hpp"
 #include "ImageBufferConcept.hpp"
 #include "Trigger.hpp"
+#include "ThermalCompression.hpp"
 
 // ─────────────────────────────────────────────
 // MLX90640 Task State Machine
@@ -48,10 +49,31 @@ enum class MLXMode : uint8_t
     Continuous // Acquire frames indefinitely
 };
 
+// ─────────────────────────────────────────────
+// Payload format of published frames
+// ─────────────────────────────────────────────
+enum class MLXCompression : uint8_t
+{
+    None,     // Raw 2 x 834 word frame
+    Lossless, // METADATA_FORMAT::MLXD
+    Quantized // METADATA_FORMAT::MLXQ, needs a sink with temperatures()
+};
+
+// ─────────────────────────────────────────────
+// Subpage sinks: handed every subpage right after
+// readSubpage(), so processing is spread over the
+// two subpage ticks instead of waiting for the frame
+// ─────────────────────────────────────────────
+struct NoSubpageSink
+{
+    bool processSubpage(uint16_t *, int) { return true; }
+};
+
 // ─────────────────────────────────────────────
 // TaskMLX90640
 // ─────────────────────────────────────────────
-template <typename PowerSwitchT, typename MLXT, ImageBufferConcept ImageBufferT, typename TriggerT = OnceTrigger>
+template <typename PowerSwitchT, typename MLXT, ImageBufferConcept ImageBufferT, typename TriggerT = OnceTrigger,
+          typename SubpageSinkT = NoSubpageSink>
 class TaskMLX90640 : public Task, private TaskPacing
 {
 public:
@@ -88,6 +110,22 @@ public:
     MLXMode getMode() const { return mode_; }
     uint32_t getBurstRemaining() const { return burstRemaining_; }
 
+    // Continuous mode only: after the first full frame, publish a frame after
+    // every subpage, made of the newest subpage and the previous one
+    void setRollingFrames(bool enable) { rolling_ = enable; }
+    bool getRollingFrames() const { return rolling_; }
+
+    SubpageSinkT &subpageSink() { return sink_; }
+
+    // Quantized falls back to Lossless while the sink has no complete
+    // temperature image (or cannot provide one)
+    void setCompression(MLXCompression compression, uint16_t step_mK = DEFAULT_QUANTIZATION_MK)
+    {
+        compression_ = compression;
+        step_mK_ = step_mK == 0 ? DEFAULT_QUANTIZATION_MK : step_mK;
+    }
+    MLXCompression getCompression() const { return compression_; }
+
 protected:
     void handleTaskImpl() override
     {
@@ -225,7 +263,7 @@ private:
 
     void stateReadSubpageA()
     {
-        if (sensor_.readSubpage(subA_, spA_))
+        if (sensor_.readSubpage(sub_, spA_))
         {
             // spA_ is now 0 or 1 (or something bogus)
             if (spA_ != 0 && spA_ != 1)
@@ -235,6 +273,8 @@ private:
                 return;
             }
 
+            acceptSubpage(spA_);
+
             // We have one subpage stored; wait for the other one.
             state_ = MLXState::WaitForReadyB;
             t0_ = HAL_GetTick();
@@ -257,7 +297,7 @@ private:
     void stateReadSubpageB()
     {
         int new_sp = -1;
-        if (sensor_.readSubpage(subB_, new_sp))
+        if (sensor_.readSubpage(sub_, new_sp))
         {
             if (new_sp != 0 && new_sp != 1)
             {
@@ -266,6 +306,8 @@ private:
                 return;
             }
 
+            acceptSubpage(new_sp);
+
             if (new_sp == spA_)
             {
                 // We got the same subpage as before:
@@ -274,8 +316,7 @@ private:
                     "TaskMLX90640: same subpage twice (sp=%d) - restarting pair\r\n",
                     new_sp);
 
-                // Move B -> A, just to reuse the buffers.
-                std::memcpy(subA_, subB_, sizeof(subA_));
+                // The newer subpage already replaced the older one in frame_.
                 spA_ = new_sp;
 
                 // Wait for the other subpage again.
@@ -300,11 +341,7 @@ private:
     {
         if (spA_ != spB_ && spA_ >= 0 && spB_ >= 0)
         {
-            if (spA_ == 0)
-                sensor_.createFrame(subA_, subB_, frame_);
-            else
-                sensor_.createFrame(subB_, subA_, frame_);
-
+            // Both subpages are already in place in frame_
             publishFrame();
         }
         else
@@ -336,12 +373,31 @@ private:
             else
                 state_ = MLXState::WaitForReadyA;
         }
+        else if (rolling_) // Continuous, rolling frames
+        {
+            // The newest subpage becomes the first half of the next frame
+            spA_ = spB_;
+            spB_ = -1;
+            state_ = MLXState::WaitForReadyB;
+            t0_ = HAL_GetTick();
+        }
         else // Continuous
         {
             state_ = MLXState::WaitForReadyA;
         }
     }
 
+    // Store a freshly read subpage in its half of frame_ and hand it to the sink
+    void acceptSubpage(int sp)
+    {
+        std::memcpy(frame_ + static_cast<size_t>(sp) * MLX90640_SUBPAGE_WORDS, sub_, MLX90640_SUBPAGE_SIZE);
+
+        if (!sink_.processSubpage(sub_, sp))
+        {
+            log(LOG_LEVEL_WARNING, "TaskMLX90640: processing subpage %d failed\r\n", sp);
+        }
+    }
+
     void stateShuttingDown()
     {
         sensor_.sleep();
@@ -355,6 +411,14 @@ private:
         state_ = MLXState::Waiting; // Successful cycle → Waiting
     }
 
+    bool quantizedAvailable()
+    {
+        if constexpr (requires(SubpageSinkT &s) { s.temperatures(); s.isComplete(); })
+            return sink_.isComplete();
+        else
+            return false;
+    }
+
     void publishFrame()
     {
         ImageMetadata meta{};
@@ -365,6 +429,25 @@ private:
         meta.producer = METADATA_PRODUCER::CAMERA_1;
         meta.format = METADATA_FORMAT::UNKN;
 
+        MLXCompression compression = compression_;
+        if (compression == MLXCompression::Quantized && !quantizedAvailable())
+            compression = MLXCompression::Lossless;
+
+        if (compression == MLXCompression::Lossless)
+        {
+            meta.format = METADATA_FORMAT::MLXD;
+            meta.payload_size = static_cast<uint32_t>(ThermalEncoder<>::frameSize(frame_));
+        }
+        else if (compression == MLXCompression::Quantized)
+        {
+            if constexpr (requires(SubpageSinkT &s) { s.temperatures(); })
+            {
+                meta.format = METADATA_FORMAT::MLXQ;
+                meta.payload_size = static_cast<uint32_t>(
+                    ThermalEncoder<>::temperaturesSize(sink_.temperatures(), step_mK_));
+            }
+        }
+
         log(LOG_LEVEL_INFO, "MLX90640: Publishing frame to ImageBuffer\r\n");
         if (image_buffer_.add_image(meta) != ImageBufferError::NO_ERROR)
         {
@@ -372,19 +455,17 @@ private:
             return;
         }
 
-        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(frame_);
-        size_t remaining = meta.payload_size;
-
-        while (remaining > 0)
+        if (compression != MLXCompression::None)
         {
-            size_t chunk = remaining;
-            if (image_buffer_.add_data_chunk(bytes, chunk) != ImageBufferError::NO_ERROR)
+            if (writeCompressed(compression) != ImageBufferError::NO_ERROR)
             {
                 log(LOG_LEVEL_ERROR, "MLX90640: add_data_chunk() failed\r\n");
                 return;
             }
-            bytes += chunk;
-            remaining -= chunk;
+        }
+        else if (!writeRaw(meta.payload_size))
+        {
+            return;
         }
 
         if (image_buffer_.push_image() != ImageBufferError::NO_ERROR)
@@ -396,6 +477,35 @@ private:
         log(LOG_LEVEL_DEBUG, "MLX90640: frame stored in ImageBuffer\r\n");
     }
 
+    ImageBufferError writeCompressed(MLXCompression compression)
+    {
+        if constexpr (requires(SubpageSinkT &s) { s.temperatures(); })
+        {
+            if (compression == MLXCompression::Quantized)
+                return ThermalEncoder<>::encodeTemperatures(sink_.temperatures(), step_mK_, image_buffer_);
+        }
+        return ThermalEncoder<>::encodeFrame(frame_, image_buffer_);
+    }
+
+    bool writeRaw(size_t payload_size)
+    {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(frame_);
+        size_t remaining = payload_size;
+
+        while (remaining > 0)
+        {
+            size_t chunk = remaining;
+            if (image_buffer_.add_data_chunk(bytes, chunk) != ImageBufferError::NO_ERROR)
+            {
+                log(LOG_LEVEL_ERROR, "MLX90640: add_data_chunk() failed\r\n");
+                return false;
+            }
+            bytes += chunk;
+            remaining -= chunk;
+        }
+        return true;
+    }
+
 private:
     PowerSwitchT &power_;
     CIRCUITS circuit_;
@@ -410,16 +520,22 @@ private:
     uint32_t burstCount_;
     uint32_t burstRemaining_;
 
-    uint16_t subA_[MLX90640_SUBPAGE_WORDS];
-    uint16_t subB_[MLX90640_SUBPAGE_WORDS];
+    uint16_t sub_[MLX90640_SUBPAGE_WORDS];
     uint16_t frame_[MLX90640_FRAME_WORDS];
     int spA_;
     int spB_;
 
+    SubpageSinkT sink_{};
+    bool rolling_ = false;
+
+    MLXCompression compression_ = MLXCompression::None;
+    uint16_t step_mK_ = DEFAULT_QUANTIZATION_MK;
+
     constexpr static MLX90640_RefreshRate REFRESH_RATE = MLX90640_RefreshRate::Hz4;
     constexpr static uint32_t REFRESH_INTERVAL = getRefreshIntervalMs(REFRESH_RATE);
     constexpr static uint32_t REFRESH_INTERVAL_2 = REFRESH_INTERVAL/2;
     constexpr static uint32_t TASK_BOOT_DELAY_MS = MLX90640_BOOT_TIME_MS;
+    constexpr static uint16_t DEFAULT_QUANTIZATION_MK = 50;
 };
 
 #endif /* INC_TASKMLX90640_HPP_ */
@@ -71,9 +71,11 @@ void TaskRegisterServer<Accessor, Dictionary, MapSize, Adapters...>::processRequ
     const std::string_view key(reinterpret_cast<const char*>(request_data.name.name.elements),
                                request_data.name.name.count);
 
-    if (uavcan_register_Value_1_0_is_unstructured_(&request_data.value)) {
+    const MapEntry* entry = named_store_.find(key);
+
+    if (entry != nullptr && uavcan_register_Value_1_0_is_unstructured_(&request_data.value)) {
         size_t size = request_data.value.unstructured.value.count;
-        named_store_.write_blob_by_name(key, request_data.value.unstructured.value.elements, size);
+        named_store_.direct_write_blob(request_data.value.unstructured.value.elements, size, entry->offset, entry->size);
     }
 
     response_data.timestamp.microsecond = 1234567890;
@@ -84,8 +86,9 @@ void TaskRegisterServer<Accessor, Dictionary, MapSize, Adapters...>::processRequ
     auto max_size = sizeof(response_data.value.unstructured.value.elements);
     response_data.value.unstructured.value.count = max_size;
 
-    auto span = named_store_.read_blob_by_name(key, response_data.value.unstructured.value.elements, max_size);
-    response_data.value.unstructured.value.count = span.size();
+    bool found = entry != nullptr &&
+                 named_store_.direct_read_blob(response_data.value.unstructured.value.elements, max_size, entry->offset, entry->size);
+    response_data.value.unstructured.value.count = found ? entry->size : 0;
 }
 
 // Answer: Serializes and publishes the response
@@ -112,7 +115,11 @@ template <typename Accessor, typename Dictionary, size_t MapSize, typename... Ad
 void TaskRegisterServer<Accessor, Dictionary, MapSize, Adapters...>::handleTaskImpl() {
     uavcan_register_Access_Request_1_0 request_data{};
     auto transfer = receiveRequest(request_data);
-    if (!transfer) return;
+    if (!transfer) {
+        // Write-back stores are flushed once a burst of requests is over
+        if constexpr (requires(Accessor& a) { a.flush(); }) accessor_.flush();
+        return;
+    }
 
     uavcan_register_Access_Response_1_0 response_data{};
     processRequest(request_data, response_data);
@@ -11,6 +11,15 @@
 #include "uavcan/file/Read_1_1.h"
 #include "uavcan/file/Error_1_0.h"
 
+#include <algorithm>
+#include <cstring>
+
+// By default one Read request is outstanding at a time. set_read_ahead(n > 1)
+// keeps up to n requests in flight at consecutive offsets; responses land in
+// a small reorder buffer and go to the output stream strictly in file order.
+// A request that times out or fails is retried on its own, the file is only
+// restarted once a chunk exhausts its retries. As per uavcan.file.Read, a
+// chunk shorter than the maximum marks the end of the file.
 template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
 class TaskRequestRead : public TaskForClient<CyphalBuffer8, Adapters...>, private TaskPacing
 {
@@ -31,6 +40,23 @@ public:
         CyphalTransferID last_transfer_id;
     };
 
+    constexpr static size_t MAX_READ_AHEAD = 8U; // below half the 5-bit transfer-ID space
+    constexpr static size_t CHUNK_SIZE = uavcan_primitive_Unstructured_1_0_value_ARRAY_CAPACITY_;
+    constexpr static uint32_t TIMEOUT_FACTOR = 100U;
+    constexpr static uint8_t MAX_NUM_TRIES = 5U;
+
+    struct ReadAhead
+    {
+        bool used;
+        bool received;                // data waits in the reorder buffer
+        bool resend;                  // timed out or answered with an error
+        size_t offset;
+        size_t size;
+        CyphalTransferID transfer_id;
+        uint32_t timeout;
+        uint8_t num_tries;
+    };
+
     enum TransferIDState
     {
         OK = 0,
@@ -53,6 +79,10 @@ public:
 
     virtual void update(uint32_t now) override;
 
+    // Only between files; 1 restores one request at a time
+    bool set_read_ahead(size_t read_ahead);
+    size_t read_ahead() const { return read_ahead_; }
+
 protected:
     bool no_response_available() const;
     TransferIDState validate_transfer_id(const std::shared_ptr<CyphalTransfer> &t) const;
@@ -65,6 +95,15 @@ protected:
     void reset();
     bool reset_and_fail();
 
+    bool read_ahead_enabled() const { return read_ahead_ > 1 && chunks_ != nullptr; }
+    void start_read_ahead();
+    bool request_read_ahead();
+    bool respond_read_ahead();
+    bool deliver_in_order();
+    void send_read_request(size_t slot);
+    ReadAhead *find_outstanding(CyphalTransferID transfer_id);
+    void check_read_timeouts();
+
     template <typename T, typename... Args>
     auto make_on_local_heap(Args &&...args)
     {
@@ -77,11 +116,22 @@ protected:
     using ValueAlloc = SafeAllocator<ValueBuffer, LocalHeap>;
     using ValuePtr = std::unique_ptr<ValueBuffer, ValueAlloc::Deletor>;
 
+    using ChunkBuffer = std::array<ValueBuffer, MAX_READ_AHEAD>;
+    using ChunkAlloc = SafeAllocator<ChunkBuffer, LocalHeap>;
+    using ChunkPtr = std::unique_ptr<ChunkBuffer, typename ChunkAlloc::Deletor>;
+
 protected:
     FileSource &source_;
     OutputStream &output_;
     ReadState read_state_;
     ValuePtr values_;
+
+    // read-ahead state; read_state_.offset is the next offset to deliver
+    size_t read_ahead_ = 1;
+    size_t next_offset_ = 0;         // next offset to request
+    size_t eof_offset_ = SIZE_MAX;   // known once a short chunk arrived
+    std::array<ReadAhead, MAX_READ_AHEAD> slots_{};
+    ChunkPtr chunks_{};
 };
 
 template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
@@ -158,6 +208,7 @@ void TaskRequestRead<FileSource, OutputStream, Adapters...>::reset()
         TaskForClient<CyphalBuffer8, Adapters...>::buffer_.pop();
     }
     read_state_ = ReadState{START, 0, 0};
+    slots_ = {};
     this->transfer_id_ = wrap_transfer_id(this->transfer_id_ + 1);
     TaskPacing::sleep(*this);
 
@@ -178,6 +229,10 @@ void TaskRequestRead<FileSource, OutputStream, Adapters...>::handleTaskImpl()
     {
         values_ = make_on_local_heap<ValueBuffer>();
     }
+    if (read_ahead_ > 1 && chunks_ == nullptr)
+    {
+        chunks_ = make_on_local_heap<ChunkBuffer>();
+    }
 
     (void)respond();
     (void)request();
@@ -186,6 +241,9 @@ void TaskRequestRead<FileSource, OutputStream, Adapters...>::handleTaskImpl()
 template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
 bool TaskRequestRead<FileSource, OutputStream, Adapters...>::respond()
 {
+    if (read_ahead_enabled() && read_state_.state == WAIT_RESPONSE)
+        return respond_read_ahead();
+
     if (no_response_available())
     {
         log(LOG_LEVEL_INFO, "TaskRequestRead: respond() no response available, state=%d offset=%u\r\n",
@@ -315,6 +373,11 @@ bool TaskRequestRead<FileSource, OutputStream, Adapters...>::request()
         read_state_.state = SEND_REQUEST;
         read_state_.offset = 0;
         TaskPacing::operate(*this);
+        if (read_ahead_enabled())
+        {
+            start_read_ahead();
+            return request_read_ahead();
+        }
         [[fallthrough]];
     case SEND_REQUEST:
         [[fallthrough]];
@@ -324,6 +387,8 @@ bool TaskRequestRead<FileSource, OutputStream, Adapters...>::request()
         std::memcpy(request_data->path.path.elements, source_.getPath().data(), source_.getPathLength());
         break;
     case WAIT_RESPONSE:
+        if (read_ahead_enabled())
+            return request_read_ahead();
         return true; // waiting for response
     case SLEEP:
     	read_state_.state = START;
@@ -350,6 +415,197 @@ bool TaskRequestRead<FileSource, OutputStream, Adapters...>::request()
     return true;
 }
 
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+bool TaskRequestRead<FileSource, OutputStream, Adapters...>::set_read_ahead(size_t read_ahead)
+{
+    if (read_state_.state != START && read_state_.state != SLEEP)
+        return false;
+
+    read_ahead_ = std::clamp(read_ahead, size_t{1}, MAX_READ_AHEAD);
+    slots_ = {};
+    return true;
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+void TaskRequestRead<FileSource, OutputStream, Adapters...>::start_read_ahead()
+{
+    slots_ = {};
+    next_offset_ = read_state_.offset;
+    eof_offset_ = SIZE_MAX;
+    read_state_.state = WAIT_RESPONSE;
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+typename TaskRequestRead<FileSource, OutputStream, Adapters...>::ReadAhead *
+TaskRequestRead<FileSource, OutputStream, Adapters...>::find_outstanding(CyphalTransferID transfer_id)
+{
+    for (auto &slot : slots_)
+    {
+        if (slot.used && !slot.received && slot.transfer_id == transfer_id)
+            return &slot;
+    }
+    return nullptr;
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+bool TaskRequestRead<FileSource, OutputStream, Adapters...>::request_read_ahead()
+{
+    for (size_t i = 0; i < MAX_READ_AHEAD; ++i)
+    {
+        ReadAhead &slot = slots_[i];
+        if (!slot.used || !slot.resend)
+            continue;
+
+        if (++slot.num_tries > MAX_NUM_TRIES)
+        {
+            log(LOG_LEVEL_ERROR, "TaskRequestRead: offset %u failed %d times, restarting file\r\n",
+                static_cast<unsigned>(slot.offset), slot.num_tries);
+            return reset_and_fail();
+        }
+        send_read_request(i);
+    }
+
+    auto in_use = [this]()
+    {
+        return static_cast<size_t>(std::count_if(slots_.begin(), slots_.end(),
+                                                 [](const ReadAhead &slot) { return slot.used; }));
+    };
+
+    while (in_use() < read_ahead_ && next_offset_ < eof_offset_)
+    {
+        const auto free_slot = std::find_if(slots_.begin(), slots_.end(),
+                                            [](const ReadAhead &slot) { return !slot.used; });
+        const size_t i = static_cast<size_t>(free_slot - slots_.begin());
+
+        slots_[i] = ReadAhead{true, false, false, next_offset_, 0, 0, 0, 0};
+        next_offset_ += CHUNK_SIZE;
+        send_read_request(i);
+    }
+    return true;
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+void TaskRequestRead<FileSource, OutputStream, Adapters...>::send_read_request(size_t slot)
+{
+    ReadAhead &chunk = slots_[slot];
+
+    auto request_data = make_on_local_heap<uavcan_file_Read_Request_1_1>();
+    request_data->offset = chunk.offset;
+    request_data->path.path.count = source_.getPathLength();
+    std::memcpy(request_data->path.path.elements, source_.getPath().data(), source_.getPathLength());
+
+    chunk.transfer_id = wrap_transfer_id(this->transfer_id_);
+    constexpr size_t PAYLOAD_SIZE = uavcan_file_Read_Request_1_1_SERIALIZATION_BUFFER_SIZE_BYTES_;
+    uint8_t payload[PAYLOAD_SIZE];
+    TaskForClient<CyphalBuffer8, Adapters...>::publish(PAYLOAD_SIZE, payload, request_data.get(),
+                                                       reinterpret_cast<int8_t (*)(const void *const, uint8_t *const, size_t *const)>(uavcan_file_Read_Request_1_1_serialize_),
+                                                       uavcan_file_Read_1_1_FIXED_PORT_ID_, TaskForClient<CyphalBuffer8, Adapters...>::node_id_);
+    this->transfer_id_ = wrap_transfer_id(this->transfer_id_ + 1);
+
+    chunk.resend = false;
+    chunk.timeout = HAL_GetTick() + TIMEOUT_FACTOR * Task::interval_;
+    log(LOG_LEVEL_DEBUG, "TaskRequestRead: read-ahead request for offset %u, transfer_id %u\r\n",
+        static_cast<unsigned>(chunk.offset), chunk.transfer_id);
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+bool TaskRequestRead<FileSource, OutputStream, Adapters...>::respond_read_ahead()
+{
+    while (!no_response_available())
+    {
+        auto transfer = TaskForClient<CyphalBuffer8, Adapters...>::buffer_.pop();
+        if (!validate_response(transfer))
+            continue;
+
+        // Responses carry the transfer-ID of their request; anything else
+        // answers a request that was already served or resent.
+        ReadAhead *slot = find_outstanding(transfer->metadata.transfer_id);
+        if (slot == nullptr)
+        {
+            log(LOG_LEVEL_DEBUG, "TaskRequestRead: stale transfer-ID %u\r\n", transfer->metadata.transfer_id);
+            continue;
+        }
+
+        uavcan_file_Read_Response_1_1 response_data;
+        size_t payload_size = transfer->payload_size;
+        int8_t res = uavcan_file_Read_Response_1_1_deserialize_(
+            &response_data,
+            static_cast<const uint8_t *>(transfer->payload),
+            &payload_size);
+
+        if (res < 0 || response_data._error.value != uavcan_file_Error_1_0_OK)
+        {
+            log(LOG_LEVEL_ERROR, "TaskRequestRead: offset %u failed, res=%d error=%d\r\n",
+                static_cast<unsigned>(slot->offset), res, response_data._error.value);
+            slot->resend = true;
+            continue;
+        }
+
+        const size_t i = static_cast<size_t>(slot - slots_.data());
+        std::memcpy((*chunks_)[i].data(), response_data.data.value.elements, response_data.data.value.count);
+        slot->size = response_data.data.value.count;
+        slot->received = true;
+
+        if (slot->size < CHUNK_SIZE)
+            eof_offset_ = std::min(eof_offset_, slot->offset + slot->size);
+    }
+
+    if (deliver_in_order())
+        return true;
+
+    check_read_timeouts();
+    return true;
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+bool TaskRequestRead<FileSource, OutputStream, Adapters...>::deliver_in_order()
+{
+    for (;;)
+    {
+        auto next = std::find_if(slots_.begin(), slots_.end(),
+                                 [this](const ReadAhead &slot)
+                                 { return slot.used && slot.received && slot.offset == read_state_.offset; });
+        if (next == slots_.end())
+            return false;
+
+        const size_t i = static_cast<size_t>(next - slots_.begin());
+        if (!output_.output((*chunks_)[i].data(), next->size))
+        {
+            log(LOG_LEVEL_ERROR, "TaskRequestRead: OutputStream error\r\n");
+            next->received = false;
+            next->resend = true;
+            return false;
+        }
+
+        next->used = false;
+        read_state_.offset += next->size;
+
+        if (next->size < CHUNK_SIZE)
+        {
+            log(LOG_LEVEL_INFO, "TaskRequestRead: EOF reached at %u, finalizing\r\n",
+                static_cast<unsigned>(read_state_.offset));
+            output_.finalize();
+            slots_ = {};
+            read_state_.state = SLEEP;
+            return true;
+        }
+    }
+}
+
+template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
+void TaskRequestRead<FileSource, OutputStream, Adapters...>::check_read_timeouts()
+{
+    const uint32_t now = HAL_GetTick();
+    for (auto &slot : slots_)
+    {
+        if (slot.used && !slot.received && !slot.resend && now >= slot.timeout)
+        {
+            log(LOG_LEVEL_WARNING, "TaskRequestRead: offset %u timed out\r\n", static_cast<unsigned>(slot.offset));
+            slot.resend = true;
+        }
+    }
+}
+
 template <FileSourceConcept FileSource, OutputStreamConcept OutputStream, typename... Adapters>
 void TaskRequestRead<FileSource, OutputStream, Adapters...>::registerTask(RegistrationManager *manager, std::shared_ptr<Task> task)
 {
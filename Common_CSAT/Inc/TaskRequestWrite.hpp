@@ -11,7 +11,13 @@
 #include "uavcan/file/Error_1_0.h"
 
 #include <cstring>
+#include <algorithm>
 
+// Data chunks go out stop-and-wait by default. set_window(n > 1) switches the
+// data phase to a sliding window: up to n Write requests in flight, each
+// tracked by transfer-ID and offset, with per-chunk timeouts derived from the
+// measured round-trip time. Every request carries its own offset, so any
+// standard uavcan.file.Write server accepts them in whatever order they land.
 template <InputStreamConcept InputStream, typename... Adapters>
 class TaskRequestWrite : public TaskForClient<CyphalBuffer8, Adapters...>, private TaskPacing
 {
@@ -43,6 +49,26 @@ public:
     constexpr static uint32_t TIMEOUT_FACTOR = 100U;
     constexpr static uint8_t MAX_NUM_TRIES = 5U;
 
+    // Every attempt takes a fresh transfer-ID and the write response echoes
+    // nothing else, so a window retried to the limit must not wrap the 5-bit
+    // CAN transfer-ID space. Otherwise a late response to an abandoned attempt
+    // could acknowledge a newer chunk.
+    constexpr static size_t MAX_WINDOW = 5U;
+    constexpr static size_t TRANSFER_ID_SPACE = 32U;
+    static_assert(MAX_WINDOW * (MAX_NUM_TRIES + 1U) <= TRANSFER_ID_SPACE, "window retries wrap the transfer-ID");
+
+    struct InFlight
+    {
+        bool used;
+        bool resend;                  // timed out or answered with an error
+        size_t offset;
+        size_t size;
+        CyphalTransferID transfer_id;
+        uint32_t sent_at;
+        uint32_t timeout;
+        uint8_t num_tries;
+    };
+
     enum TransferIDState
 	{
     	OK = 0,
@@ -71,6 +97,12 @@ public:
 
     virtual void update(uint32_t now) override;
 
+    // Only while idle; 1 restores stop-and-wait
+    bool set_window(size_t max_window);
+    size_t window() const { return window_; }
+    size_t in_flight() const;
+    uint32_t round_trip_time() const { return srtt_; }
+
 protected:
     bool request();
     void send_init_request(uavcan_file_Write_Request_1_1 *data, size_t num_values);
@@ -93,6 +125,20 @@ protected:
     bool should_restart_transfer() const;
     void restart_transfer();
 
+    CyphalTransferID publish_request(uavcan_file_Write_Request_1_1 *data);
+
+    bool windowed() const { return max_window_ > 1 && chunks_ != nullptr; }
+    bool respond_window();
+    bool request_window();
+    void send_chunk(uavcan_file_Write_Request_1_1 *data, size_t slot);
+    InFlight *find_in_flight(CyphalTransferID transfer_id);
+    void check_chunk_timeouts();
+    void clear_window();
+    void sample_rtt(uint32_t rtt);
+    void on_chunk_acknowledged();
+    void on_chunk_lost();
+    uint32_t clamp_rto(uint32_t rto) const;
+
     template <typename T, typename... Args>
     auto make_on_local_heap(Args &&...args)
     {
@@ -105,6 +151,10 @@ protected:
     using ValueAlloc = SafeAllocator<ValueBuffer, LocalHeap>;
     using ValuePtr = std::unique_ptr<ValueBuffer, ValueAlloc::Deletor>;
 
+    using ChunkBuffer = std::array<ValueBuffer, MAX_WINDOW>;
+    using ChunkAlloc = SafeAllocator<ChunkBuffer, LocalHeap>;
+    using ChunkPtr = std::unique_ptr<ChunkBuffer, typename ChunkAlloc::Deletor>;
+
 protected:
     InputStream &stream_;
     size_t total_size_;
@@ -112,6 +162,20 @@ protected:
     WriteState write_state_;
     ValuePtr values_;
     size_t num_values_;
+
+    // sliding window state, only used when max_window_ > 1
+    size_t max_window_ = 1;
+    size_t window_ = 1;
+    size_t acked_in_window_ = 0;
+    bool stream_done_ = false;
+    std::array<InFlight, MAX_WINDOW> in_flight_{};
+    ChunkPtr chunks_{};
+
+    bool has_rtt_ = false;
+    uint32_t srtt_ = 0;
+    uint32_t rttvar_ = 0;
+    uint32_t min_rtt_ = 0;
+    uint32_t rto_ = 0;
 };
 
 template <InputStreamConcept InputStream, typename... Adapters>
@@ -123,6 +187,7 @@ void TaskRequestWrite<InputStream, Adapters...>::reset()
     }
     
     write_state_ = WriteState{IDLE, 0, 0, 0, 0};
+    clear_window();
     this->transfer_id_ = wrap_transfer_id(this->transfer_id_ + 1);
     log(LOG_LEVEL_WARNING, "TaskRequestWrite: reset, transfer_id  %d -> %d\r\n", write_state_.last_transfer_id, this->transfer_id_);
 
@@ -137,6 +202,10 @@ void TaskRequestWrite<InputStream, Adapters...>::handleTaskImpl()
     {
         values_ = make_on_local_heap<ValueBuffer>();
     }
+    if (max_window_ > 1 && chunks_ == nullptr)
+    {
+        chunks_ = make_on_local_heap<ChunkBuffer>();
+    }
     (void)respond();
     (void)request();
 }
@@ -282,6 +351,9 @@ bool TaskRequestWrite<InputStream, Adapters...>::respond()
 {
     log(LOG_LEVEL_DEBUG, "TaskRequestWrite: respond() in state %d offset=%d last_tid=%d tries=%d\r\n", write_state_.state, write_state_.offset, write_state_.last_transfer_id, write_state_.num_tries);
 
+    if (windowed() && (write_state_.state == SEND_TRANSFER || write_state_.state == WAIT_TRANSFER))
+        return respond_window();
+
     // Case A: no messages at all → timeout logic
     if (no_response_available())
         return handle_timeout_or_wait();
@@ -369,6 +441,7 @@ void TaskRequestWrite<InputStream, Adapters...>::restart_transfer()
     write_state_.state = SEND_INIT;
     write_state_.offset = 0;
     write_state_.num_tries = 0;
+    clear_window();
 }
 
 template <InputStreamConcept InputStream, typename... Adapters>
@@ -427,6 +500,15 @@ bool TaskRequestWrite<InputStream, Adapters...>::request()
 
     case SEND_TRANSFER:
     {
+        if (windowed())
+        {
+            if (request_window())
+                return true;
+            if (write_state_.state != SEND_DONE)
+                return false;
+            goto send_done_label;
+        }
+
         num_values_ = std::min(MAX_CHUNK_SIZE, uavcan_primitive_Unstructured_1_0_value_ARRAY_CAPACITY_);
         stream_.getChunk(values_->data(), num_values_);
         if (num_values_ == 0)
@@ -476,23 +558,259 @@ bool TaskRequestWrite<InputStream, Adapters...>::request()
         return false; // catch it all
     }
 
-    write_state_.last_transfer_id = wrap_transfer_id(this->transfer_id_);
+    write_state_.last_transfer_id = publish_request(data.get());
+    log(LOG_LEVEL_DEBUG, "TaskRequestWrite: sent request with %d bytes at offset %d and transfer_id %d\r\n", data->data.value.count, write_state_.offset - data->data.value.count, write_state_.last_transfer_id);
+    write_state_.timeout = HAL_GetTick() + TIMEOUT_FACTOR * Task::interval_;
+    return true;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+CyphalTransferID TaskRequestWrite<InputStream, Adapters...>::publish_request(uavcan_file_Write_Request_1_1 *data)
+{
+    const CyphalTransferID transfer_id = wrap_transfer_id(this->transfer_id_);
     constexpr size_t PAYLOAD_SIZE = uavcan_file_Write_Request_1_1_SERIALIZATION_BUFFER_SIZE_BYTES_;
     uint8_t payload[PAYLOAD_SIZE];
     TaskForClient<CyphalBuffer8, Adapters...>::publish(
         PAYLOAD_SIZE,
         payload,
-        data.get(),
+        data,
         reinterpret_cast<int8_t (*)(const void *const, uint8_t *const, size_t *const)>(
             uavcan_file_Write_Request_1_1_serialize_),
         uavcan_file_Write_1_1_FIXED_PORT_ID_,
         TaskForClient<CyphalBuffer8, Adapters...>::node_id_);
-    log(LOG_LEVEL_DEBUG, "TaskRequestWrite: sent request with %d bytes at offset %d and transfer_id %d\r\n", data->data.value.count, write_state_.offset - data->data.value.count, this->transfer_id_);
-    write_state_.timeout = HAL_GetTick() + TIMEOUT_FACTOR * Task::interval_;
     this->transfer_id_ = wrap_transfer_id(this->transfer_id_ + 1);
+    return transfer_id;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+bool TaskRequestWrite<InputStream, Adapters...>::set_window(size_t max_window)
+{
+    if (write_state_.state != IDLE)
+        return false;
+
+    max_window_ = std::clamp(max_window, size_t{1}, MAX_WINDOW);
+    window_ = max_window_;
+    acked_in_window_ = 0;
+    clear_window();
     return true;
 }
 
+template <InputStreamConcept InputStream, typename... Adapters>
+size_t TaskRequestWrite<InputStream, Adapters...>::in_flight() const
+{
+    return static_cast<size_t>(std::count_if(in_flight_.begin(), in_flight_.end(),
+                                             [](const InFlight &slot) { return slot.used; }));
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::clear_window()
+{
+    in_flight_ = {};
+    stream_done_ = false;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+typename TaskRequestWrite<InputStream, Adapters...>::InFlight *
+TaskRequestWrite<InputStream, Adapters...>::find_in_flight(CyphalTransferID transfer_id)
+{
+    for (auto &slot : in_flight_)
+    {
+        if (slot.used && slot.transfer_id == transfer_id)
+            return &slot;
+    }
+    return nullptr;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+bool TaskRequestWrite<InputStream, Adapters...>::respond_window()
+{
+    while (!no_response_available())
+    {
+        auto transfer = pop_response();
+        if (!validate_response(transfer))
+            continue;
+
+        // Responses carry the transfer-ID of their request. Anything not in
+        // flight answers a chunk that was already acknowledged or resent.
+        InFlight *slot = find_in_flight(transfer->metadata.transfer_id);
+        if (slot == nullptr)
+        {
+            log(LOG_LEVEL_DEBUG, "TaskRequestWrite: stale transfer-ID %d\r\n", transfer->metadata.transfer_id);
+            continue;
+        }
+
+        uavcan_file_Write_Response_1_1 data;
+        if (!deserialize_response(transfer, data))
+            return reset_and_fail();
+
+        if (data._error.value != uavcan_file_Error_1_0_OK)
+        {
+            slot->resend = true;
+            continue;
+        }
+
+        // Karn: a retransmitted chunk gives no unambiguous round-trip sample
+        if (slot->num_tries == 0)
+            sample_rtt(HAL_GetTick() - slot->sent_at);
+
+        slot->used = false;
+        on_chunk_acknowledged();
+    }
+
+    check_chunk_timeouts();
+    write_state_.state = SEND_TRANSFER;
+    return true;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::check_chunk_timeouts()
+{
+    const uint32_t now = HAL_GetTick();
+    bool lost = false;
+    for (auto &slot : in_flight_)
+    {
+        if (slot.used && !slot.resend && now >= slot.timeout)
+        {
+            slot.resend = true;
+            lost = true;
+        }
+    }
+
+    if (lost)
+        on_chunk_lost();
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+bool TaskRequestWrite<InputStream, Adapters...>::request_window()
+{
+    auto data = make_on_local_heap<uavcan_file_Write_Request_1_1>();
+    bool sent = false;
+
+    for (size_t i = 0; i < MAX_WINDOW; ++i)
+    {
+        InFlight &slot = in_flight_[i];
+        if (!slot.used || !slot.resend)
+            continue;
+
+        if (++slot.num_tries > MAX_NUM_TRIES)
+        {
+            restart_transfer();
+            return false;
+        }
+        send_chunk(data.get(), i);
+        sent = true;
+    }
+
+    while (!stream_done_ && in_flight() < window_)
+    {
+        const auto free_slot = std::find_if(in_flight_.begin(), in_flight_.end(),
+                                            [](const InFlight &slot) { return !slot.used; });
+        const size_t i = static_cast<size_t>(free_slot - in_flight_.begin());
+
+        size_t size = std::min(MAX_CHUNK_SIZE, uavcan_primitive_Unstructured_1_0_value_ARRAY_CAPACITY_);
+        stream_.getChunk((*chunks_)[i].data(), size);
+        if (size == 0)
+        {
+            stream_done_ = true;
+            break;
+        }
+
+        in_flight_[i] = InFlight{true, false, write_state_.offset, size, 0, 0, 0, 0};
+        write_state_.offset += size;
+        send_chunk(data.get(), i);
+        sent = true;
+    }
+
+    if (stream_done_ && in_flight() == 0)
+    {
+        write_state_.state = SEND_DONE;
+        return false;
+    }
+
+    write_state_.state = WAIT_TRANSFER;
+    return sent;
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::send_chunk(uavcan_file_Write_Request_1_1 *data, size_t slot)
+{
+    InFlight &chunk = in_flight_[slot];
+
+    data->offset = chunk.offset;
+    data->data.value.count = chunk.size;
+    data->path.path.count = NAME_LENGTH;
+    std::memcpy(data->path.path.elements, name_.data(), NAME_LENGTH);
+    std::memcpy(data->data.value.elements, (*chunks_)[slot].data(), chunk.size);
+
+    if (rto_ == 0)
+        rto_ = clamp_rto(TIMEOUT_FACTOR * Task::interval_);
+
+    chunk.transfer_id = publish_request(data);
+    chunk.resend = false;
+    chunk.sent_at = HAL_GetTick();
+    chunk.timeout = chunk.sent_at + rto_;
+    log(LOG_LEVEL_DEBUG, "TaskRequestWrite: sent chunk with %d bytes at offset %d and transfer_id %d\r\n", chunk.size, chunk.offset, chunk.transfer_id);
+}
+
+// Round-trip estimate and retransmission timeout after RFC 6298, in ticks
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::sample_rtt(uint32_t rtt)
+{
+    if (!has_rtt_)
+    {
+        has_rtt_ = true;
+        srtt_ = rtt;
+        rttvar_ = rtt / 2;
+        min_rtt_ = rtt;
+    }
+    else
+    {
+        const uint32_t error = (srtt_ > rtt) ? srtt_ - rtt : rtt - srtt_;
+        rttvar_ = (3 * rttvar_ + error) / 4;
+        srtt_ = (7 * srtt_ + rtt) / 8;
+        min_rtt_ = std::min(min_rtt_, rtt);
+    }
+    rto_ = clamp_rto(srtt_ + std::max(Task::interval_, 4 * rttvar_));
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+uint32_t TaskRequestWrite<InputStream, Adapters...>::clamp_rto(uint32_t rto) const
+{
+    const uint32_t lower = std::max(Task::interval_, 1U);
+    const uint32_t upper = std::max(TIMEOUT_FACTOR * Task::interval_, lower);
+    return std::clamp(rto, lower, upper);
+}
+
+// Once per acknowledged window: if the round trip has grown well past the
+// best one seen, requests are queueing at the server, so give one slot back;
+// otherwise probe for one more.
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::on_chunk_acknowledged()
+{
+    if (++acked_in_window_ < window_)
+        return;
+    acked_in_window_ = 0;
+
+    if (srtt_ > 2 * min_rtt_ + Task::interval_)
+    {
+        if (window_ > 1)
+            --window_;
+    }
+    else if (window_ < max_window_)
+    {
+        ++window_;
+    }
+}
+
+template <InputStreamConcept InputStream, typename... Adapters>
+void TaskRequestWrite<InputStream, Adapters...>::on_chunk_lost()
+{
+    window_ = std::max(window_ / 2, size_t{1});
+    acked_in_window_ = 0;
+    rto_ = clamp_rto(2 * rto_);
+    log(LOG_LEVEL_WARNING, "TaskRequestWrite: chunk timed out, window %d, timeout %d\r\n", window_, rto_);
+}
+
 template <InputStreamConcept InputStream, typename... Adapters>
 void TaskRequestWrite<InputStream, Adapters...>::registerTask(RegistrationManager *manager, std::shared_ptr<Task> task)
 {
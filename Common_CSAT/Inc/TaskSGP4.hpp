@@ -29,6 +29,7 @@ public:
     void setSGP4TLE(const SGP4TwoLineElement &tle)
     {
         tle_ = tle;
+        satrecValid_ = false;
     }
 
     SGP4TwoLineElement getSGP4TLE() const
@@ -39,35 +40,51 @@ public:
     bool predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
     bool predict(std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp);
 
+    // Same as above for a given time instead of the RTC, used to propagate ahead
+    bool predict_teme_at(std::chrono::system_clock::time_point when, std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v);
+    bool predict_at(std::chrono::system_clock::time_point when, std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v);
+
+private:
+    void initializeSatrec();
+    static void temeToEcef(std::chrono::system_clock::time_point when, const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r_teme, const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v_teme, std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v);
+
 private:
     RTC_HandleTypeDef *hrtc_;
     SGP4TwoLineElement tle_;
+
+    // SGP4 model initialized from tle_ (satrec2rv), reused by every prediction
+    // until the next setSGP4TLE
+    elsetrec satrec_{};
+    bool satrecValid_ = false;
 };
 
-bool SGP4::predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
+void SGP4::initializeSatrec()
 {
-    if (tle_.satelliteNumber == 0)
-    {
-        return false;
-    }
+    satrec_ = elsetrec{};
+    snprintf(satrec_.satnum, sizeof(satrec_.satnum), "%05d", static_cast<int>(tle_.satelliteNumber));
+    satrec_.epochyr = tle_.epochYear;
+    satrec_.epochdays = tle_.epochDay;
+    satrec_.ndot = tle_.meanMotionDerivative1;
+    satrec_.nddot = tle_.meanMotionDerivative2;
+    satrec_.bstar = tle_.bStarDrag;
+    satrec_.ephtype = tle_.ephemerisType;
+    satrec_.elnum = tle_.elementNumber;
+    satrec_.inclo = tle_.inclination;
+    satrec_.nodeo = tle_.rightAscensionAscendingNode;
+    satrec_.ecco = tle_.eccentricity;
+    satrec_.argpo = tle_.argumentOfPerigee;
+    satrec_.mo = tle_.meanAnomaly;
+    satrec_.no_kozai = tle_.meanMotion;
+    satrec_.revnum = tle_.revolutionNumberAtEpoch;
 
-    elsetrec satrec{};
-    sprintf(satrec.satnum, "%05d", tle_.satelliteNumber);
-    satrec.epochyr = tle_.epochYear;
-    satrec.epochdays = tle_.epochDay;
-    satrec.ndot = tle_.meanMotionDerivative1;
-    satrec.nddot = tle_.meanMotionDerivative2;
-    satrec.bstar = tle_.bStarDrag;
-    satrec.ephtype = tle_.ephemerisType;
-    satrec.elnum = tle_.elementNumber;
-    satrec.inclo = tle_.inclination;
-    satrec.nodeo = tle_.rightAscensionAscendingNode;
-    satrec.ecco = tle_.eccentricity;
-    satrec.argpo = tle_.argumentOfPerigee;
-    satrec.mo = tle_.meanAnomaly;
-    satrec.no_kozai = tle_.meanMotion;
-    satrec.revnum = tle_.revolutionNumberAtEpoch;
+    gravconsttype whichconst = wgs84; // Choose the gravity model (wgs72old, wgs72, wgs84)
+    char opsmode = 'i';               // Operation mode ('a' for AFSPC, 'i' for improved)
+    SGP4Funcs::satrec2rv(opsmode, whichconst, satrec_);
+    satrecValid_ = true;
+}
 
+bool SGP4::predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v, au::QuantityU64<au::Milli<au::Seconds>> &timestamp)
+{
     TimeUtils::RTCDateTimeSubseconds rtc;
     HAL_RTC_GetTime(hrtc_, &rtc.time, RTC_FORMAT_BIN);
     HAL_RTC_GetDate(hrtc_, &rtc.date, RTC_FORMAT_BIN);
@@ -81,18 +98,29 @@ bool SGP4::predict_teme(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>
         .second = rtc.time.Seconds,
         .millisecond = static_cast<uint16_t>(static_cast<uint64_t>(1000 * (rtc.time.SecondFraction - rtc.time.SubSeconds) / (rtc.time.SecondFraction + 1)))};
 
-    std::chrono::system_clock::time_point now = TimeUtils::to_timepoint(dtc);
+    std::chrono::milliseconds milliseconds = TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
+    timestamp = milliseconds;
+
+    return predict_teme_at(TimeUtils::to_timepoint(dtc), r, v);
+}
+
+bool SGP4::predict_teme_at(std::chrono::system_clock::time_point when, std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r, std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v)
+{
+    if (tle_.satelliteNumber == 0)
+    {
+        return false;
+    }
+
+    if (!satrecValid_)
+    {
+        initializeSatrec();
+    }
+
     std::chrono::system_clock::time_point epoch = TimeUtils::to_timepoint(static_cast<uint16_t>(tle_.epochYear) + TimeUtils::EPOCH_YEAR, tle_.epochDay);
-    float fractional_minutes_since_epoch = TimeUtils::to_fractional_days(epoch, now) * 60.f * 24.f;
+    float fractional_minutes_since_epoch = TimeUtils::to_fractional_days(epoch, when) * 60.f * 24.f;
 
     float r_[3], v_[3];
-    gravconsttype whichconst = wgs84; // Choose the gravity model (wgs72old, wgs72, wgs84)
-    char opsmode = 'i';               // Operation mode ('a' for AFSPC, 'i' for improved)
-    SGP4Funcs::satrec2rv(opsmode, whichconst, satrec);
-    bool result = SGP4Funcs::sgp4(satrec, fractional_minutes_since_epoch, r_, v_);
-
-    std::chrono::milliseconds milliseconds = TimeUtils::from_rtc(rtc, hrtc_->Init.SynchPrediv);
-    timestamp = milliseconds;
+    bool result = SGP4Funcs::sgp4(satrec_, fractional_minutes_since_epoch, r_, v_);
 
     std::transform(std::begin(r_), std::end(r_), std::begin(r), [](const auto &item)
                    { return au::make_quantity<au::Kilo<au::MetersInTemeFrame>>(item); });
@@ -110,29 +138,33 @@ bool SGP4::predict(std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::
 
     uint64_t milliseconds_since_epoch = timestamp.in(au::milli(au::seconds));
     TimeUtils::epoch_duration duration(milliseconds_since_epoch);
-    auto now = TimeUtils::to_timepoint(duration);
+    temeToEcef(TimeUtils::to_timepoint(duration), r_teme, v_teme, r, v);
 
-    auto j2000 = TimeUtils::to_timepoint(TimeUtils::DateTimeComponents{
-        .year = 2000,
-        .month = 1,
-        .day = 1,
-        .hour = 12,
-        .minute = 0,
-        .second = 0,
-        .millisecond = 0});
+    return result;
+}
 
+bool SGP4::predict_at(std::chrono::system_clock::time_point when, std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v)
+{
+    std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> r_teme;
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> v_teme;
+    if (!predict_teme_at(when, r_teme, v_teme))
+    {
+        return false;
+    }
 
-    float jd2000 = TimeUtils::to_fractional_days(j2000, now);
+    temeToEcef(when, r_teme, v_teme, r, v);
+    return true;
+}
 
-    auto r_ecefs = coordinate_transformations::temeToecef(r_teme, jd2000);
-    auto v_ecefs = coordinate_transformations::temeToecef(v_teme, jd2000);
+void SGP4::temeToEcef(std::chrono::system_clock::time_point when, const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> &r_teme, const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> &v_teme, std::array<au::QuantityF<au::MetersInEcefFrame>, 3> &r, std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3> &v)
+{
+    auto r_ecefs = coordinate_transformations::temeToecef(r_teme, when);
+    auto v_ecefs = coordinate_transformations::temeToecef(v_teme, when);
 
     std::transform(std::begin(r_ecefs), std::end(r_ecefs), std::begin(r), [](const auto &item)
                    { return au::make_quantity<au::MetersInEcefFrame>(item.in(au::meters * au::ecefs)); });
     std::transform(std::begin(v_ecefs), std::end(v_ecefs), std::begin(v), [](const auto &item)
                    { return au::make_quantity<au::MetersPerSecondInEcefFrame>(item.in(au::meters * au::ecefs / au::seconds)); });
-
-    return result;
 }
 
 #
@@ -0,0 +1,157 @@
+#ifndef INC_TASKSCHEDULER_HPP_
+#define INC_TASKSCHEDULER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "ArrayList.hpp"
+#include "Task.hpp"
+
+/**
+ * @brief Deadline-ordered scheduler over the registered tasks.
+ *
+ * Tasks are kept in a binary min-heap keyed on their next deadline
+ * (last tick + interval), so only tasks that are due get touched and the
+ * main loop can ask how long it may sleep. A task appearing under several
+ * ports is scheduled once.
+ *
+ * Deadlines are re-read from the task after it ran, which picks up interval
+ * changes made by the task itself (TaskPacing). Entries that come due but whose
+ * task has moved its deadline later are re-queued without running; if a task's
+ * deadline is moved earlier from outside its own run, call reschedule().
+ */
+template <size_t capacity_>
+class TaskScheduler
+{
+public:
+	static constexpr uint32_t NO_DEADLINE = std::numeric_limits<uint32_t>::max();
+
+	TaskScheduler() : heap_(), count_(0) {}
+
+	void rebuild(const ArrayList<TaskHandler, capacity_> &handlers)
+	{
+		count_ = 0;
+		for (const auto &handler : handlers)
+		{
+			Task *task = handler.task.get();
+			if (task == nullptr || contains(task))
+				continue;
+			heap_[count_++] = Entry{deadlineOf(*task), task};
+		}
+		for (size_t i = count_ / 2; i-- > 0;)
+		{
+			siftDown(i);
+		}
+	}
+
+	// runs every task due at now, each at most once per call
+	void runDue(uint32_t now)
+	{
+		std::array<Task *, capacity_> due;
+		size_t num_due = 0;
+		while (count_ > 0 && heap_[0].deadline <= now)
+		{
+			due[num_due++] = pop().task;
+		}
+
+		for (size_t i = 0; i < num_due; ++i)
+		{
+			Task *task = due[i];
+			if (deadlineOf(*task) <= now)
+			{
+				task->handleTask();
+			}
+			push(Entry{deadlineOf(*task), task});
+		}
+	}
+
+	void reschedule(Task *task)
+	{
+		for (size_t i = 0; i < count_; ++i)
+		{
+			if (heap_[i].task == task)
+			{
+				heap_[i].deadline = deadlineOf(*task);
+				siftUp(i);
+				siftDown(i);
+				return;
+			}
+		}
+	}
+
+	uint32_t nextDeadline() const { return count_ > 0 ? heap_[0].deadline : NO_DEADLINE; }
+	size_t size() const { return count_; }
+
+private:
+	struct Entry
+	{
+		uint32_t deadline;
+		Task *task;
+	};
+
+	static uint32_t deadlineOf(const Task &task) { return task.getLastTick() + task.getInterval(); }
+
+	bool contains(const Task *task) const
+	{
+		for (size_t i = 0; i < count_; ++i)
+		{
+			if (heap_[i].task == task)
+				return true;
+		}
+		return false;
+	}
+
+	void push(const Entry &entry)
+	{
+		heap_[count_] = entry;
+		siftUp(count_);
+		++count_;
+	}
+
+	Entry pop()
+	{
+		Entry top = heap_[0];
+		heap_[0] = heap_[--count_];
+		siftDown(0);
+		return top;
+	}
+
+	void siftUp(size_t index)
+	{
+		while (index > 0)
+		{
+			size_t parent = (index - 1) / 2;
+			if (heap_[parent].deadline <= heap_[index].deadline)
+				break;
+			std::swap(heap_[parent], heap_[index]);
+			index = parent;
+		}
+	}
+
+	void siftDown(size_t index)
+	{
+		for (;;)
+		{
+			size_t smallest = index;
+			size_t left = 2 * index + 1;
+			size_t right = left + 1;
+			if (left < count_ && heap_[left].deadline < heap_[smallest].deadline)
+				smallest = left;
+			if (right < count_ && heap_[right].deadline < heap_[smallest].deadline)
+				smallest = right;
+			if (smallest == index)
+				return;
+			std::swap(heap_[smallest], heap_[index]);
+			index = smallest;
+		}
+	}
+
+private:
+	std::array<Entry, capacity_> heap_;
+	size_t count_;
+};
+
+#endif /* INC_TASKSCHEDULER_HPP_ */
@@ -0,0 +1,329 @@
+#ifndef INC_THERMALCOMPRESSION_HPP_
+#define INC_THERMALCOMPRESSION_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <concepts>
+
+#include "ImageBufferConcept.hpp"
+#include "MLX90640ImageProcessor.hpp"
+
+// -----------------------------------------------------------------------------
+// Thermal image compression
+//
+// Every pixel of the 32x24 image is predicted from its left, upper and
+// upper-left neighbours (LOCO-I median edge detector) and the residual is Rice
+// coded with a parameter adapted from the running mean of the previous
+// residuals, so no code tables are stored.
+//
+//   METADATA_FORMAT::MLXD  lossless: the raw 32x24 pixels of a 2 x 834 word
+//                          frame, each taken from the subpage that measured it
+//                          (chess or interleaved, from control register 1 in
+//                          word 832), then the aux words (768..833) of both
+//                          subpages, subpage 1 as a delta to subpage 0
+//   METADATA_FORMAT::MLXQ  lossy: temperatures quantized to step_mK
+//
+// The encoder streams into any add_data_chunk() sink in ChunkSize pieces and
+// reads the input in place, so its RAM use is one chunk. ImageBuffer needs the
+// payload size up front; frameSize() / temperaturesSize() run the encoder
+// against a byte counter for that.
+// -----------------------------------------------------------------------------
+
+constexpr uint8_t THERMAL_STREAM_VERSION = 1;
+
+#pragma pack(push, 1)
+struct ThermalStreamHeader
+{
+    uint8_t  version;  // THERMAL_STREAM_VERSION
+    uint8_t  width;
+    uint8_t  height;
+    uint8_t  flags;    // reserved, 0
+    uint16_t step_mK;  // MLXQ quantization step in millikelvin, 0 for MLXD
+};
+#pragma pack(pop)
+
+namespace thermal
+{
+constexpr int WIDTH  = MLX90640ImageProcessor::WIDTH;
+constexpr int HEIGHT = MLX90640ImageProcessor::HEIGHT;
+constexpr int PIXELS = MLX90640ImageProcessor::PIXELS;
+
+// first and one-past-last aux word of a subpage
+constexpr int AUX_FIRST = PIXELS;
+constexpr int AUX_END   = MLX90640ImageProcessor::FRAME_WORDS;
+
+// control register 1 as stored behind the RAM words of a subpage
+constexpr int      WORD_CONTROL       = 832;
+constexpr uint16_t CONTROL_CHESS_MODE = 0x1000u;
+
+// Rice quotients from ESCAPE_QUOTIENT on are sent as the raw 32-bit value
+constexpr unsigned ESCAPE_QUOTIENT = 24;
+constexpr unsigned MAX_RICE_K      = 24;
+
+// Quantized temperatures are clamped to this magnitude
+constexpr int32_t MAX_QUANTIZED = (1 << 22);
+
+inline int32_t predictMED(int32_t left, int32_t up, int32_t upLeft)
+{
+    const int32_t hi = std::max(left, up);
+    const int32_t lo = std::min(left, up);
+    if (upLeft >= hi)
+        return lo;
+    if (upLeft <= lo)
+        return hi;
+    return left + up - upLeft;
+}
+
+// Prediction of pixel p from already coded pixels, pixel(i) returns pixel i
+template <typename Pixel>
+int32_t predict(int p, Pixel &&pixel)
+{
+    const int row = p / WIDTH;
+    const int col = p % WIDTH;
+    if (row == 0)
+        return col == 0 ? 0 : pixel(p - 1);
+    if (col == 0)
+        return pixel(p - WIDTH);
+    return predictMED(pixel(p - 1), pixel(p - WIDTH), pixel(p - WIDTH - 1));
+}
+
+inline uint32_t zigzag(int32_t v)
+{
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline int32_t unzigzag(uint32_t u)
+{
+    return static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1U);
+}
+
+// Adaptive Rice parameter: k is the smallest value with n * 2^k >= a, where
+// a is the running sum of the residuals and n their count (halved every
+// RESET symbols so the coder follows changes across the image)
+class RiceContext
+{
+public:
+    static constexpr uint32_t RESET = 32;
+
+    unsigned k() const
+    {
+        unsigned k = 0;
+        while ((n_ << k) < a_ && k < MAX_RICE_K)
+            ++k;
+        return k;
+    }
+
+    void update(uint32_t u)
+    {
+        a_ += std::min<uint32_t>(u, 1U << 24);
+        if (++n_ == RESET)
+        {
+            a_ = (a_ + 1) >> 1;
+            n_ >>= 1;
+        }
+    }
+
+private:
+    uint32_t a_ = 16;
+    uint32_t n_ = 1;
+};
+
+inline int32_t quantize(float temperature, uint16_t step_mK)
+{
+    if (!std::isfinite(temperature) || step_mK == 0)
+        return 0;
+    const float q = std::round(temperature * 1000.0f / float(step_mK));
+    return static_cast<int32_t>(std::clamp(q, -float(MAX_QUANTIZED), float(MAX_QUANTIZED)));
+}
+
+inline float dequantize(int32_t q, uint16_t step_mK)
+{
+    return float(q) * float(step_mK) / 1000.0f;
+}
+
+inline bool chessMode(const uint16_t *frame)
+{
+    return (frame[WORD_CONTROL] & CONTROL_CHESS_MODE) != 0;
+}
+
+// Value of pixel p in a 2 x 834 word frame: the subpage is (row + col) & 1 in
+// chess mode and row & 1 in interleaved mode
+inline int32_t framePixel(const uint16_t *frame, int p, bool chess)
+{
+    const int row = p / WIDTH;
+    const int sub = chess ? ((row + p) & 1) : (row & 1);
+    return static_cast<int16_t>(frame[sub * MLX90640ImageProcessor::FRAME_WORDS + p]);
+}
+
+inline int32_t framePixel(const uint16_t *frame, int p)
+{
+    return framePixel(frame, p, chessMode(frame));
+}
+} // namespace thermal
+
+// Sink that only counts the bytes it is given
+struct ThermalSizeCounter
+{
+    size_t bytes = 0;
+
+    ImageBufferError add_data_chunk(const uint8_t *, size_t size)
+    {
+        bytes += size;
+        return ImageBufferError::NO_ERROR;
+    }
+};
+
+// MSB-first bit packer that hands full chunks to the sink
+template <size_t ChunkSize, typename Sink>
+class ThermalBitWriter
+{
+public:
+    explicit ThermalBitWriter(Sink &sink) : sink_(sink) {}
+
+    void put(uint32_t bits, unsigned count)
+    {
+        const uint64_t mask = (uint64_t{1} << count) - 1;
+        acc_ = (acc_ << count) | (bits & mask);
+        nbits_ += count;
+        while (nbits_ >= 8)
+        {
+            nbits_ -= 8;
+            emit(static_cast<uint8_t>(acc_ >> nbits_));
+        }
+    }
+
+    void putRice(uint32_t u, unsigned k)
+    {
+        const uint32_t q = u >> k;
+        if (q >= thermal::ESCAPE_QUOTIENT)
+        {
+            put((1U << thermal::ESCAPE_QUOTIENT) - 1, thermal::ESCAPE_QUOTIENT);
+            put(u, 32);
+            return;
+        }
+        // q ones, a terminating zero, then the k low bits
+        put(((1U << q) - 1) << 1, q + 1);
+        if (k > 0)
+            put(u, k);
+    }
+
+    // Pads the last byte with zeros and hands the partial chunk to the sink
+    ImageBufferError finish()
+    {
+        if (nbits_ > 0)
+            put(0, 8 - nbits_);
+        flushChunk();
+        return error_;
+    }
+
+private:
+    void emit(uint8_t byte)
+    {
+        buffer_[pos_++] = byte;
+        if (pos_ == ChunkSize)
+            flushChunk();
+    }
+
+    void flushChunk()
+    {
+        if (pos_ > 0 && error_ == ImageBufferError::NO_ERROR)
+        {
+            size_t size = pos_;
+            error_ = sink_.add_data_chunk(buffer_.data(), size);
+        }
+        pos_ = 0;
+    }
+
+    Sink &sink_;
+    std::array<uint8_t, ChunkSize> buffer_{};
+    size_t   pos_   = 0;
+    uint64_t acc_   = 0;
+    unsigned nbits_ = 0;
+    ImageBufferError error_ = ImageBufferError::NO_ERROR;
+};
+
+template <size_t ChunkSize = 64>
+class ThermalEncoder
+{
+public:
+    using TempImage = MLX90640ImageProcessor::TempImage;
+
+    // Lossless MLXD stream of a 2 x 834 word frame, in either reading pattern
+    template <typename Sink>
+    static ImageBufferError encodeFrame(const uint16_t *frame, Sink &sink)
+    {
+        ThermalBitWriter<ChunkSize, Sink> out(sink);
+        putHeader(out, 0);
+        const bool chess = thermal::chessMode(frame);
+        putImage(out, [frame, chess](int p) { return thermal::framePixel(frame, p, chess); });
+
+        const uint16_t *aux0 = frame;
+        const uint16_t *aux1 = frame + MLX90640ImageProcessor::FRAME_WORDS;
+        thermal::RiceContext ctx;
+        for (int w = thermal::AUX_FIRST; w < thermal::AUX_END; ++w)
+            out.put(aux0[w], 16);
+        for (int w = thermal::AUX_FIRST; w < thermal::AUX_END; ++w)
+        {
+            const uint32_t u = thermal::zigzag(int32_t{static_cast<int16_t>(aux1[w])} -
+                                               int32_t{static_cast<int16_t>(aux0[w])});
+            out.putRice(u, ctx.k());
+            ctx.update(u);
+        }
+        return out.finish();
+    }
+
+    static size_t frameSize(const uint16_t *frame)
+    {
+        ThermalSizeCounter counter;
+        (void)encodeFrame(frame, counter);
+        return counter.bytes;
+    }
+
+    // Lossy MLXQ stream, temperatures rounded to step_mK
+    template <typename Sink>
+    static ImageBufferError encodeTemperatures(const TempImage &temps, uint16_t step_mK, Sink &sink)
+    {
+        ThermalBitWriter<ChunkSize, Sink> out(sink);
+        putHeader(out, step_mK);
+        putImage(out, [&temps, step_mK](int p) {
+            return thermal::quantize(temps[static_cast<size_t>(p)], step_mK);
+        });
+        return out.finish();
+    }
+
+    static size_t temperaturesSize(const TempImage &temps, uint16_t step_mK)
+    {
+        ThermalSizeCounter counter;
+        (void)encodeTemperatures(temps, step_mK, counter);
+        return counter.bytes;
+    }
+
+private:
+    template <typename Writer>
+    static void putHeader(Writer &out, uint16_t step_mK)
+    {
+        out.put(THERMAL_STREAM_VERSION, 8);
+        out.put(thermal::WIDTH, 8);
+        out.put(thermal::HEIGHT, 8);
+        out.put(0, 8);
+        out.put(step_mK & 0xFFU, 8); // little endian, like the packed header
+        out.put(static_cast<uint32_t>(step_mK >> 8), 8);
+    }
+
+    template <typename Writer, typename Pixel>
+    static void putImage(Writer &out, Pixel &&pixel)
+    {
+        thermal::RiceContext ctx;
+        for (int p = 0; p < thermal::PIXELS; ++p)
+        {
+            const uint32_t u = thermal::zigzag(pixel(p) - thermal::predict(p, pixel));
+            out.putRice(u, ctx.k());
+            ctx.update(u);
+        }
+    }
+};
+
+#endif /* INC_THERMALCOMPRESSION_HPP_ */
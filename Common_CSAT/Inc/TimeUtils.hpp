@@ -74,6 +74,9 @@ RTCDateTimeSubseconds to_rtc(const epoch_duration &d, uint32_t secondFraction);
 RTCDateTimeSubseconds to_rtc(const DateTimeComponents &components, uint32_t secondFraction);
 
 float gsTimeJ2000(float jd2000);
+// Same with the J2000 date split into the preceding midnight (0h UT) and the
+// days since; a single float jd2000 only resolves ~84 s around 2025
+float gsTimeJ2000(float midnight, float days_since_midnight);
 float hoursToRadians(float gsm);
 
 // Error codes (adjust as needed)
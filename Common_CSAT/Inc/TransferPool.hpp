@@ -0,0 +1,183 @@
+#ifndef INC_TRANSFERPOOL_HPP_
+#define INC_TRANSFERPOOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "canard.h"
+#include "IRQLock.hpp"
+
+typedef struct
+{
+	size_t capacity;
+	size_t in_use;
+	size_t high_water;
+	uint64_t exhausted_count;
+	uint64_t oversize_count;
+} TransferPoolDiagnostics;
+
+// Pool used from the main loop only
+struct NoPoolLock
+{
+	static void lock() {}
+	static void unlock() {}
+};
+
+// Pool shared with libcanard, which frees sent frames from the TX mailbox interrupt
+struct CanIrqPoolLock
+{
+	static void lock()
+	{
+		CanTxIrqLock::lock();
+		CanRx0IrqLock::lock();
+		CanRx1IrqLock::lock();
+	}
+
+	static void unlock()
+	{
+		CanTxIrqLock::unlock();
+		CanRx0IrqLock::unlock();
+		CanRx1IrqLock::unlock();
+	}
+};
+
+/**
+ * @brief Fixed-size block pool for received transfers.
+ *
+ * Drop-in Heap for SafeAllocator: std::allocate_shared<CyphalTransfer> places the
+ * reference counts and the transfer in a single block, so with this pool the
+ * per-transfer shared_ptr costs a free-list pop instead of an o1heap allocation
+ * with the CAN interrupts masked.
+ *
+ * Requests larger than BlockSize, or arriving while the pool is exhausted, are
+ * served by Fallback and counted, so a mis-sized pool degrades instead of failing.
+ * Release goes to the pool owning the block, so pools chain into size classes:
+ * a pool whose Fallback is another TransferPool passes larger requests on.
+ *
+ * The libcanard/serard memory hooks let the protocol stacks take their frame and
+ * payload buffers from a chain of pools as well. The payload is adopted by the
+ * CyphalTransfer and released through SafeAllocator, which reaches the owning
+ * pool through the chain. Such a pool needs CanIrqPoolLock; payloads larger than
+ * the largest class still come from the heap and show up in oversize_count.
+ */
+template <size_t NumBlocks, size_t BlockSize, typename Fallback, typename Lock = NoPoolLock>
+class TransferPool
+{
+	static_assert(NumBlocks > 0, "pool needs at least one block");
+	static_assert(BlockSize >= sizeof(void *), "block must hold a free-list link");
+
+	static constexpr size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+	static constexpr size_t STRIDE = (BlockSize + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+private:
+	alignas(BLOCK_ALIGNMENT) static uint8_t pool_buffer[NumBlocks * STRIDE];
+	static FreeBlock *free_list;
+	static TransferPoolDiagnostics diagnostics;
+
+	static bool owns(const void *pointer)
+	{
+		const uint8_t *p = static_cast<const uint8_t *>(pointer);
+		return p >= pool_buffer && p < pool_buffer + sizeof(pool_buffer);
+	}
+
+public:
+	static void initialize()
+	{
+		free_list = nullptr;
+		for (size_t i = NumBlocks; i-- > 0;)
+		{
+			FreeBlock *block = reinterpret_cast<FreeBlock *>(pool_buffer + i * STRIDE);
+			block->next = free_list;
+			free_list = block;
+		}
+		diagnostics = TransferPoolDiagnostics{NumBlocks, 0, 0, 0, 0};
+	}
+
+	static void *heapAllocate(void *const handle, const size_t amount)
+	{
+		Lock::lock();
+		FreeBlock *block = nullptr;
+		if (amount > BlockSize)
+		{
+			++diagnostics.oversize_count;
+		}
+		else if (free_list == nullptr)
+		{
+			++diagnostics.exhausted_count;
+		}
+		else
+		{
+			block = free_list;
+			free_list = block->next;
+			if (++diagnostics.in_use > diagnostics.high_water)
+			{
+				diagnostics.high_water = diagnostics.in_use;
+			}
+		}
+		Lock::unlock();
+
+		if (block == nullptr)
+			return Fallback::heapAllocate(handle, amount);
+		return block;
+	}
+
+	static void heapFree(void *const handle, void *const pointer)
+	{
+		if (pointer == nullptr)
+			return;
+
+		if (!owns(pointer))
+		{
+			Fallback::heapFree(handle, pointer);
+			return;
+		}
+
+		Lock::lock();
+		FreeBlock *block = static_cast<FreeBlock *>(pointer);
+		block->next = free_list;
+		free_list = block;
+		--diagnostics.in_use;
+		Lock::unlock();
+	}
+
+	static void *canardMemoryAllocate(CanardInstance *const /*canard*/, const size_t size)
+	{
+		return heapAllocate(nullptr, size);
+	}
+
+	static void canardMemoryDeallocate(CanardInstance *const /*canard*/, void *const pointer)
+	{
+		heapFree(nullptr, pointer);
+	}
+
+	static void *serardMemoryAllocate(void *const /*user_reference*/, const size_t size)
+	{
+		return heapAllocate(nullptr, size);
+	}
+
+	static void serardMemoryDeallocate(void *const /*user_reference*/, const size_t /*size*/, void *const pointer)
+	{
+		heapFree(nullptr, pointer);
+	}
+
+	static TransferPoolDiagnostics getDiagnostics()
+	{
+		return diagnostics;
+	}
+};
+
+template <size_t NumBlocks, size_t BlockSize, typename Fallback, typename Lock>
+alignas(TransferPool<NumBlocks, BlockSize, Fallback, Lock>::BLOCK_ALIGNMENT) uint8_t TransferPool<NumBlocks, BlockSize, Fallback, Lock>::pool_buffer[NumBlocks * STRIDE];
+
+template <size_t NumBlocks, size_t BlockSize, typename Fallback, typename Lock>
+typename TransferPool<NumBlocks, BlockSize, Fallback, Lock>::FreeBlock *TransferPool<NumBlocks, BlockSize, Fallback, Lock>::free_list = nullptr;
+
+template <size_t NumBlocks, size_t BlockSize, typename Fallback, typename Lock>
+TransferPoolDiagnostics TransferPool<NumBlocks, BlockSize, Fallback, Lock>::diagnostics = TransferPoolDiagnostics{NumBlocks, 0, 0, 0, 0};
+
+#endif /* INC_TRANSFERPOOL_HPP_ */
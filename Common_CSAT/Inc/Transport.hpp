@@ -98,6 +98,24 @@ public:
         return HAL_I2C_Mem_Read(&Config::handle(), Config::address, encode_reg(reg), static_cast<uint16_t>(Config::address_width), data, len, Config::timeout) == HAL_OK;
     }
 
+    // DMA write, data must stay valid until write_reg_wait() returns. Fails
+    // (and the caller falls back to write_reg) if the handle has no TX DMA.
+    bool write_reg_async(uint16_t reg, const uint8_t *data, uint16_t len) const
+    {
+        return HAL_I2C_Mem_Write_DMA(&Config::handle(), Config::address, encode_reg(reg), static_cast<uint16_t>(Config::address_width), const_cast<uint8_t *>(data), len) == HAL_OK;
+    }
+
+    bool write_reg_wait() const
+    {
+        const uint32_t start = HAL_GetTick();
+        while (HAL_I2C_GetState(&Config::handle()) != HAL_I2C_STATE_READY)
+        {
+            if (HAL_GetTick() - start > Config::timeout)
+                return false;
+        }
+        return HAL_I2C_GetError(&Config::handle()) == HAL_I2C_ERROR_NONE;
+    }
+
     static_assert(Config::address_width == I2CAddressWidth::Bits8 || Config::address_width == I2CAddressWidth::Bits16);
 };
 
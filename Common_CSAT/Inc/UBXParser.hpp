@@ -0,0 +1,171 @@
+#ifndef INC_UBXPARSER_HPP_
+#define INC_UBXPARSER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// https://content.u-blox.com/sites/default/files/u-blox-M10-SPG-5.10_InterfaceDescription_UBX-21035062.pdf
+
+struct UBXFrame
+{
+	uint8_t cls;
+	uint8_t id;
+	uint16_t length;
+	const uint8_t *payload; // valid until the next byte is fed
+};
+
+/*!
+ * Incremental UBX framing: bytes are fed one at a time in any fragmentation,
+ * the Fletcher checksum is accumulated on the fly and a frame is reported as
+ * soon as its last checksum byte arrived. Frames longer than MAX_PAYLOAD are
+ * dropped at the length field so garbage cannot stall the parser.
+ */
+template <uint16_t MAX_PAYLOAD = 100>
+class UBXParser
+{
+public:
+	static constexpr uint8_t SYNC1 = 0xB5;
+	static constexpr uint8_t SYNC2 = 0x62;
+
+	// Returns true and fills frame when byte completes a valid frame
+	bool feed(uint8_t byte, UBXFrame &frame);
+
+	// Feeds a block, fn(const UBXFrame&) is called for each valid frame
+	template <typename Fn>
+	size_t feed(const uint8_t *data, size_t size, Fn &&fn);
+
+	void reset() { state_ = State::Sync1; }
+
+	uint32_t frames() const { return frames_; }
+	uint32_t checksumErrors() const { return checksum_errors_; }
+	uint32_t oversized() const { return oversized_; }
+
+private:
+	enum class State : uint8_t
+	{
+		Sync1,
+		Sync2,
+		Class,
+		Id,
+		Length1,
+		Length2,
+		Payload,
+		CkA,
+		CkB
+	};
+
+	void add(uint8_t byte)
+	{
+		cka_ = static_cast<uint8_t>(cka_ + byte);
+		ckb_ = static_cast<uint8_t>(ckb_ + cka_);
+	}
+
+	void reject(uint8_t byte)
+	{
+		++checksum_errors_;
+		state_ = (byte == SYNC1) ? State::Sync2 : State::Sync1;
+	}
+
+private:
+	State state_ = State::Sync1;
+	uint8_t cls_ = 0;
+	uint8_t id_ = 0;
+	uint16_t length_ = 0;
+	uint16_t index_ = 0;
+	uint8_t cka_ = 0;
+	uint8_t ckb_ = 0;
+	uint8_t payload_[MAX_PAYLOAD > 0 ? MAX_PAYLOAD : 1];
+
+	uint32_t frames_ = 0;
+	uint32_t checksum_errors_ = 0;
+	uint32_t oversized_ = 0;
+};
+
+template <uint16_t MAX_PAYLOAD>
+bool UBXParser<MAX_PAYLOAD>::feed(uint8_t byte, UBXFrame &frame)
+{
+	switch (state_)
+	{
+	case State::Sync1:
+		if (byte == SYNC1)
+			state_ = State::Sync2;
+		break;
+	case State::Sync2:
+		if (byte == SYNC2)
+			state_ = State::Class;
+		else if (byte != SYNC1)
+			state_ = State::Sync1;
+		break;
+	case State::Class:
+		cls_ = byte;
+		cka_ = 0;
+		ckb_ = 0;
+		add(byte);
+		state_ = State::Id;
+		break;
+	case State::Id:
+		id_ = byte;
+		add(byte);
+		state_ = State::Length1;
+		break;
+	case State::Length1:
+		length_ = byte;
+		add(byte);
+		state_ = State::Length2;
+		break;
+	case State::Length2:
+		length_ = static_cast<uint16_t>(length_ | (byte << 8));
+		add(byte);
+		index_ = 0;
+		if (length_ > MAX_PAYLOAD)
+		{
+			++oversized_;
+			state_ = State::Sync1;
+		}
+		else
+			state_ = (length_ == 0) ? State::CkA : State::Payload;
+		break;
+	case State::Payload:
+		payload_[index_++] = byte;
+		add(byte);
+		if (index_ == length_)
+			state_ = State::CkA;
+		break;
+	case State::CkA:
+		if (byte != cka_)
+			reject(byte);
+		else
+			state_ = State::CkB;
+		break;
+	case State::CkB:
+		if (byte != ckb_)
+		{
+			reject(byte);
+			break;
+		}
+		state_ = State::Sync1;
+		++frames_;
+		frame = UBXFrame{.cls = cls_, .id = id_, .length = length_, .payload = payload_};
+		return true;
+	}
+	return false;
+}
+
+template <uint16_t MAX_PAYLOAD>
+template <typename Fn>
+size_t UBXParser<MAX_PAYLOAD>::feed(const uint8_t *data, size_t size, Fn &&fn)
+{
+	size_t count = 0;
+	UBXFrame frame;
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (feed(data[i], frame))
+		{
+			fn(frame);
+			++count;
+		}
+	}
+	return count;
+}
+
+#endif /* INC_UBXPARSER_HPP_ */
@@ -0,0 +1,73 @@
+#ifndef INC_UARTDMARING_HPP_
+#define INC_UARTDMARING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ * Receive ring filled by a circular DMA channel. The DMA write position is
+ * reported from HAL_UARTEx_RxEventCallback (idle line, half and full transfer),
+ * the main loop consumes the new bytes in at most two contiguous segments.
+ * With HT and TC events enabled no more than N/2 bytes arrive between two
+ * events, so the modulo N distance between positions is unambiguous.
+ */
+template <uint16_t N>
+class UartDmaRing
+{
+public:
+	static_assert(N >= 2, "ring too small");
+
+	uint8_t *buffer() { return buffer_; }
+	static constexpr uint16_t size() { return N; }
+
+	// ISR context, pos is the DMA write index as passed to the Rx event callback
+	void onRxEvent(uint16_t pos)
+	{
+		if (pos >= N)
+			pos = 0;
+		const uint16_t delta = static_cast<uint16_t>(pos >= head_ ? pos - head_ : N - head_ + pos);
+		head_ = pos;
+		received_.store(received_.load(std::memory_order_relaxed) + delta, std::memory_order_release);
+	}
+
+	// Main loop, fn(const uint8_t* data, size_t size) sees every new byte once
+	template <typename Fn>
+	size_t consume(Fn &&fn)
+	{
+		const uint32_t received = received_.load(std::memory_order_acquire);
+		uint32_t pending = received - consumed_;
+		if (pending > N)
+		{
+			// the DMA lapped the reader, only the last N bytes are still there
+			++overruns_;
+			consumed_ = received - N;
+			pending = N;
+		}
+
+		const size_t total = pending;
+		uint16_t tail = static_cast<uint16_t>(consumed_ % N);
+		while (pending > 0)
+		{
+			const uint16_t chunk = static_cast<uint16_t>(std::min<uint32_t>(pending, N - tail));
+			fn(static_cast<const uint8_t *>(buffer_ + tail), static_cast<size_t>(chunk));
+			tail = static_cast<uint16_t>((tail + chunk) % N);
+			pending -= chunk;
+		}
+		consumed_ = received;
+		return total;
+	}
+
+	uint32_t received() const { return received_.load(std::memory_order_relaxed); }
+	uint32_t overruns() const { return overruns_; }
+
+private:
+	uint8_t buffer_[N];
+	uint16_t head_ = 0;
+	std::atomic<uint32_t> received_{0};
+	uint32_t consumed_ = 0;
+	uint32_t overruns_ = 0;
+};
+
+#endif /* INC_UARTDMARING_HPP_ */
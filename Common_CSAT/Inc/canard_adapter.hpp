@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Logger.hpp"
+#include "DeferredLog.hpp"
 
 #include "cyphal.hpp"
 #include "canard.h"
@@ -8,6 +9,7 @@
 #include <cstring>
 #include "BoxSet.hpp"
 #include "CanTxQueueDrainer.hpp"
+#include "IRQLock.hpp"
 
 extern CanTxQueueDrainer tx_drainer;
 
@@ -57,13 +59,7 @@ public:
                          const size_t payload_size,
                          const void *const payload)
     {
-        log(LOG_LEVEL_INFO, "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", HAL_GetTick(),
-        		metadata->remote_node_id, metadata->source_node_id, metadata->destination_node_id, metadata->port_id, metadata->transfer_id);
-
-
-    	auto res = canardTxPush(&adapter_->que, &adapter_->ins, tx_deadline_usec, reinterpret_cast<const CanardTransferMetadata *>(metadata), payload_size, payload);
-        tx_drainer.irq_safe_drain();
-        return res;
+        return txPush(&adapter_->ins, tx_deadline_usec, metadata, payload_size, payload);
     }
 
     inline CanardNodeID getNodeID() const { return adapter_->ins.node_id; }
@@ -78,13 +74,12 @@ public:
         CyphalTransferMetadata metadata_{*metadata};
         metadata_.remote_node_id = metadata_.destination_node_id;
 
-    	CanardNodeID node_id_ = getNodeID();
-        setNodeID(metadata_.source_node_id);
-
-        int32_t res{};
-        res = cyphalTxPush(tx_deadline_usec, &metadata_, payload_size, payload);
+        // canardTxPush takes the source node-ID from the instance, forward through a
+        // copy so the local node-ID is never changed under other publishers
+        CanardInstance ins{adapter_->ins};
+        ins.node_id = metadata_.source_node_id;
+        int32_t res = txPush(&ins, tx_deadline_usec, &metadata_, payload_size, payload);
 
-        setNodeID(node_id_);
         log(LOG_LEVEL_INFO, "canardTxForward at %08u: %3d -> %3d (%4d %3d)\r\n", HAL_GetTick(),
         		metadata->source_node_id, metadata->destination_node_id, metadata->port_id, metadata->transfer_id);
         return res;
@@ -124,6 +119,29 @@ public:
         		out_transfer->metadata.source_node_id, out_transfer->metadata.destination_node_id, out_transfer->metadata.port_id, out_transfer->metadata.transfer_id);
         return result;
     }
+
+private:
+    int32_t txPush(CanardInstance *ins,
+                   const CyphalMicrosecond tx_deadline_usec,
+                   const CyphalTransferMetadata *const metadata,
+                   const size_t payload_size,
+                   const void *const payload)
+    {
+        LOG_DEFERRED(LOG_LEVEL_INFO, "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", HAL_GetTick(),
+        		metadata->remote_node_id, metadata->source_node_id, metadata->destination_node_id, metadata->port_id, metadata->transfer_id);
+
+
+        // stamp a deadline so the drainer can expire stale frames and measure queue latency
+        const CyphalMicrosecond deadline_usec = (tx_deadline_usec != 0) ? tx_deadline_usec
+        		: static_cast<CyphalMicrosecond>(HAL_GetTick()) * 1000ULL + CAN_TX_TIMEOUT_USEC;
+
+        // the TX mailbox interrupt pops from the same queue
+        CanTxIrqLock::lock();
+    	auto res = canardTxPush(&adapter_->que, ins, deadline_usec, reinterpret_cast<const CanardTransferMetadata *>(metadata), payload_size, payload);
+        CanTxIrqLock::unlock();
+        tx_drainer.irq_safe_drain();
+        return res;
+    }
 };
 
 #include "cyphal_adapter_api.hpp"
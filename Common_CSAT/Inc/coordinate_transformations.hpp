@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include <array>
+#include <chrono>
 #include <numbers>
 #include "au.hpp"
 
@@ -75,6 +76,10 @@ namespace coordinate_transformations
 
     std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>,3> temeToecef(const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>,3> teme, float jd2000);
     std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>,3> temeToecef(const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>,3> teme, float jd2000);
+    // Same with the time as a time point, the sidereal time then keeps the
+    // resolution of the time of day instead of the ~84 s of a float jd2000
+    std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>,3> temeToecef(const std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>,3> teme, std::chrono::system_clock::time_point when);
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>,3> temeToecef(const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>,3> teme, std::chrono::system_clock::time_point when);
     std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>,3> ecefToteme(const std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>,3> teme, float jd2000);
     std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>,3> ecefToteme(const std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>,3> teme, float jd2000);
 
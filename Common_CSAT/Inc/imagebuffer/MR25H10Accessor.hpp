@@ -0,0 +1,80 @@
+#ifndef MR25H10_ACCESSOR_H
+#define MR25H10_ACCESSOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+#include "MR25H10.hpp"
+#include "imagebuffer/accessor.hpp" // Accessor concept, AccessorError
+
+// Accessor over (a region of) the MR25H10 MRAM. MRAM is byte writable and has
+// no erase; erase() fills an ERASE_BLOCK_SIZE block with 0xFF so code written
+// for flash sees the state it expects.
+template <typename Transport>
+class MR25H10Accessor
+{
+public:
+    static constexpr size_t ERASE_BLOCK_SIZE = 256;
+
+    MR25H10Accessor(const MR25H10<Transport> &mram,
+                    size_t flash_start = 0,
+                    size_t size = MR25H10<Transport>::SIZE)
+        : mram_(mram), flash_start_(flash_start), size_(size)
+    {
+    }
+
+    AccessorError write(size_t address, const uint8_t *data, size_t size)
+    {
+        if (!inRange(address, size))
+            return AccessorError::OUT_OF_BOUNDS;
+        return mram_.write(static_cast<uint32_t>(address), data, size)
+                   ? AccessorError::NO_ERROR
+                   : AccessorError::WRITE_ERROR;
+    }
+
+    AccessorError read(size_t address, uint8_t *data, size_t size)
+    {
+        if (!inRange(address, size))
+            return AccessorError::OUT_OF_BOUNDS;
+        return mram_.read(static_cast<uint32_t>(address), data, size)
+                   ? AccessorError::NO_ERROR
+                   : AccessorError::READ_ERROR;
+    }
+
+    AccessorError erase(size_t address)
+    {
+        if (!inRange(address, 1))
+            return AccessorError::OUT_OF_BOUNDS;
+
+        const size_t start = flash_start_ + (address - flash_start_) / ERASE_BLOCK_SIZE * ERASE_BLOCK_SIZE;
+        const size_t end   = std::min(start + ERASE_BLOCK_SIZE, flash_start_ + size_);
+
+        std::array<uint8_t, MR25H10<Transport>::CHUNK_SIZE> blank;
+        blank.fill(0xFF);
+        for (size_t a = start; a < end; a += blank.size())
+        {
+            if (!mram_.write(static_cast<uint32_t>(a), blank.data(), std::min(blank.size(), end - a)))
+                return AccessorError::WRITE_ERROR;
+        }
+        return AccessorError::NO_ERROR;
+    }
+
+    size_t getAlignment() const         { return 1; }
+    size_t getFlashMemorySize() const   { return size_; }
+    size_t getFlashStartAddress() const { return flash_start_; }
+    size_t getEraseBlockSize() const    { return ERASE_BLOCK_SIZE; }
+
+private:
+    bool inRange(size_t address, size_t size) const
+    {
+        return address >= flash_start_ && address - flash_start_ + size <= size_;
+    }
+
+    const MR25H10<Transport> &mram_;
+    size_t flash_start_;
+    size_t size_;
+};
+
+#endif // MR25H10_ACCESSOR_H
@@ -6,6 +6,7 @@
 #include <array>
 #include <algorithm>
 #include <cstring>
+#include <bitset>
 
 #include "ImageBuffer.hpp" 
 #include "imagebuffer/accessor.hpp" // Accessor concept, AccessorError
@@ -21,6 +22,8 @@ enum class MT29_CMD : uint8_t
     WRITE_ENABLE     = 0x06,
     WRITE_DISABLE    = 0x04,
     PAGE_READ        = 0x13, // array -> data reg/cache
+    PAGE_READ_CACHE_SEQUENTIAL = 0x31, // data reg -> cache, load next page
+    PAGE_READ_CACHE_LAST       = 0x3F, // data reg -> cache, end cache read
     READ_FROM_CACHE  = 0x03, // x1 (or 0x0B fast read)
 
     PROGRAM_LOAD     = 0x02, // cache load (x1)
@@ -45,6 +48,16 @@ enum class MT29_CMD : uint8_t
 };
 
 // NOTE: TransportT must satisfy StreamAccessTransport
+//
+// Caching:
+//   - the last page read stays resident in page_cache_; reads hitting it are
+//     served without another PAGE_READ
+//   - writes collect in write_buffer_ and are programmed once per page, when
+//     the write moves to another page, the page is full, or on flush()
+//   - reads spanning several pages use the sequential cache read (31h/3Fh),
+//     so the next page loads from the array while the current one is clocked out
+//   - reads of the page being buffered flush it first, erase drops pending
+//     data and cached pages of the erased block
 template <StreamAccessTransport TransportT>
 class MT29F4G01Accessor
 {
@@ -60,6 +73,10 @@ public:
     static constexpr size_t TOTAL_BLOCKS    = 2048;
     static constexpr size_t TOTAL_SIZE      = BLOCK_SIZE * TOTAL_BLOCKS;
 
+    // Logical address space: data bytes only, the spare area is not addressable
+    static constexpr size_t DATA_BLOCK_SIZE = PAGE_SIZE * PAGES_PER_BLOCK;    // 262,144
+    static constexpr size_t DATA_SIZE       = DATA_BLOCK_SIZE * TOTAL_BLOCKS;
+
     // ─────────────────────────────────────────────
     // Constructor
     // ─────────────────────────────────────────────
@@ -78,10 +95,27 @@ public:
     AccessorError erase(size_t address);
     void format(); 
 
+    // program the partially written page, if any
+    AccessorError flush();
+
+    // forget the resident page, e.g. after the array was changed behind our back
+    void invalidateCache() { cached_row_ = NO_ROW; }
+
+    void setCacheReadEnabled(bool enabled) { cache_read_enabled_ = enabled; }
+
+    // ─────────────────────────────────────────────
+    // Bad block handling
+    //   isBlockMarkedBad() reads the marker in the first spare byte of page 0,
+    //   markBlockBad() programs it; both keep the RAM table that every page
+    //   read, program and erase is checked against up to date
+    // ─────────────────────────────────────────────
+    bool isBlockMarkedBad(uint32_t block);
+    bool markBlockBad(uint32_t block);
+
     size_t getAlignment() const         { return PAGE_SIZE; }
-    size_t getFlashMemorySize() const   { return TOTAL_SIZE; }
+    size_t getFlashMemorySize() const   { return DATA_SIZE; }
     size_t getFlashStartAddress() const { return flash_start_; }
-    size_t getEraseBlockSize() const { return BLOCK_SIZE; }
+    size_t getEraseBlockSize() const { return DATA_BLOCK_SIZE; }
 
     // ─────────────────────────────────────────────
     // Public mapping for testing / introspection
@@ -109,6 +143,11 @@ private:
                   uint32_t page_in_block,
                   uint8_t* page_buf);
 
+    bool readFromCache(uint8_t* page_buf);
+
+    // streams the pages from `logical` on through the cache read mode
+    AccessorError readSequential(size_t logical, uint8_t* data, size_t size);
+
     bool programPage(uint32_t block,
                      uint32_t page_in_block,
                      const uint8_t* page_buf);
@@ -120,11 +159,26 @@ private:
                          uint32_t page_in_block,
                          uint8_t row_addr[3]) const;
 
+    static uint32_t rowOf(const PhysAddr& phys)
+    {
+        return phys.block * static_cast<uint32_t>(PAGES_PER_BLOCK) + phys.page_in_block;
+    }
+
 private:
+    static constexpr uint32_t NO_ROW = 0xFFFFFFFFu;
+
     TransportT& spi_;
     size_t      flash_start_;
 
     std::array<uint8_t, PAGE_TOTAL_SIZE> page_cache_{};
+    uint32_t cached_row_ = NO_ROW;
+
+    std::array<uint8_t, PAGE_TOTAL_SIZE> write_buffer_{};
+    uint32_t write_row_ = NO_ROW;
+
+    bool cache_read_enabled_ = true;
+
+    std::bitset<TOTAL_BLOCKS> bad_blocks_{};
 };
 
 // ─────────────────────────────────────────────
@@ -205,10 +259,73 @@ template <StreamAccessTransport TransportT>
 inline bool
 MT29F4G01Accessor<TransportT>::isBadBlock(uint32_t block)
 {
-    // TODO: read spare byte 0 of page 0 (or 1) and check != 0xFF → bad.
-    // For now, trust all blocks.
-    (void)block;
-    return false;
+    return block >= TOTAL_BLOCKS || bad_blocks_.test(block);
+}
+
+template <StreamAccessTransport TransportT>
+inline bool
+MT29F4G01Accessor<TransportT>::isBlockMarkedBad(uint32_t block)
+{
+    if (block >= TOTAL_BLOCKS)
+        return true;
+
+    uint8_t row_addr[3];
+    buildRowAddress(block, 0U, row_addr);
+
+    uint8_t cmd_pr[4] = { static_cast<uint8_t>(MT29_CMD::PAGE_READ), row_addr[0], row_addr[1], row_addr[2] };
+    if (!spi_.write(cmd_pr, sizeof(cmd_pr)) || !waitReady())
+        return false;
+
+    // READ FROM CACHE from the first spare byte
+    uint8_t cmd_rc[4];
+    cmd_rc[0] = static_cast<uint8_t>(MT29_CMD::READ_FROM_CACHE);
+    cmd_rc[1] = static_cast<uint8_t>((PAGE_SIZE >> 8) & 0x1F); // column high
+    cmd_rc[2] = static_cast<uint8_t>(PAGE_SIZE & 0xFF);        // column low
+    cmd_rc[3] = 0x00; // dummy byte
+
+    uint8_t marker = 0xFF;
+    if (!spi_.write(cmd_rc, sizeof(cmd_rc)) || !spi_.read(&marker, 1U))
+        return false;
+
+    bad_blocks_.set(block, marker != 0xFF);
+    return marker != 0xFF;
+}
+
+template <StreamAccessTransport TransportT>
+inline bool
+MT29F4G01Accessor<TransportT>::markBlockBad(uint32_t block)
+{
+    if (block >= TOTAL_BLOCKS)
+        return false;
+
+    bad_blocks_.set(block);
+
+    const uint32_t pages = static_cast<uint32_t>(PAGES_PER_BLOCK);
+    if (write_row_ != NO_ROW && write_row_ / pages == block)
+        write_row_ = NO_ROW;
+    if (cached_row_ != NO_ROW && cached_row_ / pages == block)
+        cached_row_ = NO_ROW;
+
+    uint8_t row_addr[3];
+    buildRowAddress(block, 0U, row_addr);
+
+    if (!writeEnable())
+        return false;
+
+    // PROGRAM LOAD at the first spare byte, marker 00h
+    uint8_t cmd_pl[3];
+    cmd_pl[0] = static_cast<uint8_t>(MT29_CMD::PROGRAM_LOAD);
+    cmd_pl[1] = static_cast<uint8_t>((PAGE_SIZE >> 8) & 0x1F);
+    cmd_pl[2] = static_cast<uint8_t>(PAGE_SIZE & 0xFF);
+    const uint8_t marker = 0x00;
+    if (!spi_.write(cmd_pl, sizeof(cmd_pl)) || !spi_.write(&marker, 1U))
+        return false;
+
+    uint8_t cmd_pe[4] = { static_cast<uint8_t>(MT29_CMD::PROGRAM_EXECUTE), row_addr[0], row_addr[1], row_addr[2] };
+    if (!spi_.write(cmd_pe, sizeof(cmd_pe)))
+        return false;
+
+    return waitReady();
 }
 
 // ─────────────────────────────────────────────
@@ -220,7 +337,8 @@ MT29F4G01Accessor<TransportT>::readPage(uint32_t block,
                                         uint32_t page_in_block,
                                         uint8_t* page_buf)
 {
-    if (isBadBlock(block))
+    // bad blocks stay readable, so data can be moved off a grown bad block
+    if (block >= TOTAL_BLOCKS)
         return false;
 
     uint8_t row_addr[3];
@@ -239,7 +357,15 @@ MT29F4G01Accessor<TransportT>::readPage(uint32_t block,
     if (!waitReady())
         return false;
 
-    // 3) READ FROM CACHE x1 (03h) from column 0 with 1 dummy byte
+    // 3) READ FROM CACHE
+    return readFromCache(page_buf);
+}
+
+template <StreamAccessTransport TransportT>
+inline bool
+MT29F4G01Accessor<TransportT>::readFromCache(uint8_t* page_buf)
+{
+    // READ FROM CACHE x1 (03h) from column 0 with 1 dummy byte
     uint8_t cmd_rc[4];
     cmd_rc[0] = static_cast<uint8_t>(MT29_CMD::READ_FROM_CACHE);
     cmd_rc[1] = 0x00; // column low
@@ -358,7 +484,7 @@ MT29F4G01Accessor<TransportT>::read(size_t address,
                                     uint8_t* data,
                                     size_t size)
 {
-    if (address + size > TOTAL_SIZE)
+    if (address + size > DATA_SIZE)
         return AccessorError::OUT_OF_BOUNDS;
 
     size_t remaining = size;
@@ -367,13 +493,28 @@ MT29F4G01Accessor<TransportT>::read(size_t address,
 
     while (remaining > 0)
     {
-        auto   phys          = logicalToPhysical(logical);
-        size_t in_page_off   = phys.column;
-        size_t bytes_in_page = PAGE_SIZE - in_page_off;
-        size_t chunk         = std::min(remaining, bytes_in_page);
+        auto     phys          = logicalToPhysical(logical);
+        uint32_t row           = rowOf(phys);
+        size_t   in_page_off   = phys.column;
+        size_t   bytes_in_page = PAGE_SIZE - in_page_off;
+        size_t   chunk         = std::min(remaining, bytes_in_page);
 
-        if (!readPage(phys.block, phys.page_in_block, page_cache_.data()))
-            return AccessorError::READ_ERROR;
+        if (row == write_row_ && flush() != AccessorError::NO_ERROR)
+            return AccessorError::WRITE_ERROR;
+
+        if (row != cached_row_)
+        {
+            // more than this page left: stream the rest
+            if (cache_read_enabled_ && remaining > bytes_in_page)
+                return readSequential(logical, data + dst_off, remaining);
+
+            if (!readPage(phys.block, phys.page_in_block, page_cache_.data()))
+            {
+                cached_row_ = NO_ROW;
+                return AccessorError::READ_ERROR;
+            }
+            cached_row_ = row;
+        }
 
         std::memcpy(data + dst_off,
                     page_cache_.data() + in_page_off,
@@ -387,13 +528,67 @@ MT29F4G01Accessor<TransportT>::read(size_t address,
     return AccessorError::NO_ERROR;
 }
 
+template <StreamAccessTransport TransportT>
+inline AccessorError
+MT29F4G01Accessor<TransportT>::readSequential(size_t logical,
+                                              uint8_t* data,
+                                              size_t size)
+{
+    size_t dst_off = 0;
+
+    while (size > 0)
+    {
+        // one cache read run per block
+        const auto     first      = logicalToPhysical(logical);
+        const size_t   span       = first.column + size;
+        const uint32_t pages      = static_cast<uint32_t>(
+            std::min((span + PAGE_SIZE - 1) / PAGE_SIZE, PAGES_PER_BLOCK - first.page_in_block));
+        const uint32_t first_row  = rowOf(first);
+
+        if (write_row_ >= first_row && write_row_ < first_row + pages &&
+            flush() != AccessorError::NO_ERROR)
+            return AccessorError::WRITE_ERROR;
+
+        if (first.block >= TOTAL_BLOCKS)
+            return AccessorError::READ_ERROR;
+
+        cached_row_ = NO_ROW;
+
+        uint8_t row_addr[3];
+        buildRowAddress(first.block, first.page_in_block, row_addr);
+        uint8_t cmd_pr[4] = { static_cast<uint8_t>(MT29_CMD::PAGE_READ), row_addr[0], row_addr[1], row_addr[2] };
+        if (!spi_.write(cmd_pr, sizeof(cmd_pr)) || !waitReady())
+            return AccessorError::READ_ERROR;
+
+        for (uint32_t i = 0; i < pages; ++i)
+        {
+            const uint8_t cmd = static_cast<uint8_t>(
+                (i + 1 < pages) ? MT29_CMD::PAGE_READ_CACHE_SEQUENTIAL : MT29_CMD::PAGE_READ_CACHE_LAST);
+            if (!spi_.write(&cmd, 1U) || !waitReady() || !readFromCache(page_cache_.data()))
+                return AccessorError::READ_ERROR;
+
+            const size_t in_page_off = (i == 0) ? first.column : 0;
+            const size_t chunk       = std::min(size, PAGE_SIZE - in_page_off);
+            std::memcpy(data + dst_off, page_cache_.data() + in_page_off, chunk);
+
+            logical += chunk;
+            dst_off += chunk;
+            size    -= chunk;
+        }
+
+        cached_row_ = first_row + pages - 1;
+    }
+
+    return AccessorError::NO_ERROR;
+}
+
 template <StreamAccessTransport TransportT>
 inline AccessorError
 MT29F4G01Accessor<TransportT>::write(size_t address,
                                      const uint8_t* data,
                                      size_t size)
 {
-    if (address + size > TOTAL_SIZE)
+    if (address + size > DATA_SIZE)
         return AccessorError::OUT_OF_BOUNDS;
 
     size_t remaining = size;
@@ -402,19 +597,27 @@ MT29F4G01Accessor<TransportT>::write(size_t address,
 
     while (remaining > 0)
     {
-        auto   phys          = logicalToPhysical(logical);
-        size_t in_page_off   = phys.column;
-        size_t bytes_in_page = PAGE_SIZE - in_page_off;
-        size_t chunk         = std::min(remaining, bytes_in_page);
-
-        // For append-only usage, assume pages are erased and program full page.
-        std::fill(page_cache_.begin(), page_cache_.end(), 0xFF);
-
-        std::memcpy(page_cache_.data() + in_page_off,
+        auto     phys          = logicalToPhysical(logical);
+        uint32_t row           = rowOf(phys);
+        size_t   in_page_off   = phys.column;
+        size_t   bytes_in_page = PAGE_SIZE - in_page_off;
+        size_t   chunk         = std::min(remaining, bytes_in_page);
+
+        if (row != write_row_)
+        {
+            if (flush() != AccessorError::NO_ERROR)
+                return AccessorError::WRITE_ERROR;
+
+            // For append-only usage, assume pages are erased; unwritten bytes stay 0xFF.
+            std::fill(write_buffer_.begin(), write_buffer_.end(), 0xFF);
+            write_row_ = row;
+        }
+
+        std::memcpy(write_buffer_.data() + in_page_off,
                     data + src_off,
                     chunk);
 
-        if (!programPage(phys.block, phys.page_in_block, page_cache_.data()))
+        if (in_page_off + chunk == PAGE_SIZE && flush() != AccessorError::NO_ERROR)
             return AccessorError::WRITE_ERROR;
 
         logical   += chunk;
@@ -425,6 +628,26 @@ MT29F4G01Accessor<TransportT>::write(size_t address,
     return AccessorError::NO_ERROR;
 }
 
+template <StreamAccessTransport TransportT>
+inline AccessorError
+MT29F4G01Accessor<TransportT>::flush()
+{
+    if (write_row_ == NO_ROW)
+        return AccessorError::NO_ERROR;
+
+    const uint32_t row = write_row_;
+    write_row_ = NO_ROW;
+    if (row == cached_row_)
+        cached_row_ = NO_ROW;
+
+    const uint32_t block = row / static_cast<uint32_t>(PAGES_PER_BLOCK);
+    const uint32_t page  = row % static_cast<uint32_t>(PAGES_PER_BLOCK);
+    if (!programPage(block, page, write_buffer_.data()))
+        return AccessorError::WRITE_ERROR;
+
+    return AccessorError::NO_ERROR;
+}
+
 template <StreamAccessTransport TransportT>
 void MT29F4G01Accessor<TransportT>::format() {
     const size_t block = getEraseBlockSize();
@@ -440,10 +663,18 @@ template <StreamAccessTransport TransportT>
 inline AccessorError
 MT29F4G01Accessor<TransportT>::erase(size_t address)
 {
-    if (address >= TOTAL_SIZE)
+    if (address >= DATA_SIZE)
         return AccessorError::OUT_OF_BOUNDS;
 
     const auto phys = logicalToPhysical(address);
+
+    // anything buffered or cached for this block is gone after the erase
+    const uint32_t pages = static_cast<uint32_t>(PAGES_PER_BLOCK);
+    if (write_row_ != NO_ROW && write_row_ / pages == phys.block)
+        write_row_ = NO_ROW;
+    if (cached_row_ != NO_ROW && cached_row_ / pages == phys.block)
+        cached_row_ = NO_ROW;
+
     if (!eraseBlock(phys.block))
         return AccessorError::WRITE_ERROR; // or ERASE_ERROR if you add it
 
@@ -0,0 +1,617 @@
+#ifndef WEAR_LEVELING_ACCESSOR_H
+#define WEAR_LEVELING_ACCESSOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+
+#include "imagebuffer/accessor.hpp" // Accessor concept, AccessorError
+#include "Checksum.hpp"
+
+// Block level hooks the wear leveling layer needs from the device below
+template <typename T>
+concept BadBlockAccessor = Accessor<T> && requires(T a, uint32_t block) {
+    { a.isBlockMarkedBad(block) } -> std::same_as<bool>;
+    { a.markBlockBad(block) } -> std::same_as<bool>;
+};
+
+// Written at the start of every physical block after it was erased
+constexpr uint32_t WEAR_BLOCK_MAGIC =
+    (static_cast<uint32_t>('W') << 24) |
+    (static_cast<uint32_t>('L') << 16) |
+    (static_cast<uint32_t>('B') << 8)  |
+    static_cast<uint32_t>('K');
+
+#pragma pack(push, 1)
+struct WearBlockHeader
+{
+    uint32_t magic;          // WEAR_BLOCK_MAGIC
+    uint32_t sequence;       // bumped on every (re)mapping, newest header wins
+    uint32_t erase_count;    // erases of this physical block, including this one
+    uint16_t logical_block;  // NO_LOGICAL_BLOCK for a formatted, unused block
+    uint16_t reserved;
+    uint32_t header_crc;     // CRC over all previous bytes
+};
+#pragma pack(pop)
+
+constexpr uint16_t NO_LOGICAL_BLOCK = 0xFFFF;
+
+struct WearLevelingStatistics
+{
+    size_t   bad_blocks;
+    size_t   free_blocks;
+    uint32_t min_erase_count;
+    uint32_t max_erase_count;
+    uint32_t relocations;    // blocks moved away from after a failed program
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// WearLevelingAccessor
+//
+// Accessor wrapper mapping logical erase blocks onto the physical blocks of a
+// NAND device, so ImageBuffer can run its ring over it unchanged.
+//
+//   - the first getAlignment() bytes of every physical block hold a
+//     WearBlockHeader; the logical erase block is the rest of the block
+//   - erase() never erases in place: the logical block moves to the least worn
+//     free physical block, which is erased and stamped with a new header. The
+//     old block keeps its (older) header and becomes free
+//   - mount() rebuilds the map, erase counts and bad block table from the
+//     headers and bad block markers once; afterwards they live in RAM
+//   - blocks failing erase or program are marked bad on the device and never
+//     used again; a logical block whose program fails is moved to a fresh block
+//     with the data written so far. Only WRITE_ERROR counts as a failed
+//     program, and one operation moves at most MAX_RELOCATIONS times
+//   - the inner accessor may buffer the page being written, so the data written
+//     to that page is mirrored here until it is programmed; a failed program
+//     loses the inner buffer but not the mirror
+//
+// PhysicalBlocks counts the device blocks used from the start of the inner
+// accessor, SpareBlocks of them are kept out of the logical address space so
+// there is always a free block to move to. MaxPageSize bounds the page
+// (getAlignment()) of the inner accessor.
+// ─────────────────────────────────────────────────────────────────────────────
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize = 4096>
+class WearLevelingAccessor
+{
+    static_assert(SpareBlocks > 0 && SpareBlocks < PhysicalBlocks, "need at least one spare block");
+    static_assert(PhysicalBlocks < NO_LOGICAL_BLOCK, "block numbers are 16 bit");
+
+public:
+    static constexpr size_t   LOGICAL_BLOCKS  = PhysicalBlocks - SpareBlocks;
+    static constexpr uint32_t NO_BLOCK        = 0xFFFFFFFFu;
+    static constexpr size_t   MAX_RELOCATIONS = 3;
+
+    explicit WearLevelingAccessor(Inner &inner) : inner_(inner)
+    {
+        map_.fill(NO_BLOCK);
+        state_.fill(BlockState::FREE);
+        erase_count_.fill(0);
+    }
+
+    // ─────────────────────────────────────────────
+    // Accessor concept API
+    // ─────────────────────────────────────────────
+    AccessorError write(size_t address, const uint8_t *data, size_t size);
+    AccessorError read(size_t address, uint8_t *data, size_t size);
+    AccessorError erase(size_t address);
+    void format();
+
+    // program whatever the inner accessor still buffers
+    AccessorError flush();
+
+    // scan headers and markers, call once before use
+    AccessorError mount();
+
+    size_t getAlignment() const         { return inner_.getAlignment(); }
+    size_t getFlashMemorySize() const   { return LOGICAL_BLOCKS * getEraseBlockSize(); }
+    size_t getFlashStartAddress() const { return 0; }
+    size_t getEraseBlockSize() const    { return inner_.getEraseBlockSize() - headerSize(); }
+
+    // ─────────────────────────────────────────────
+    // Introspection
+    // ─────────────────────────────────────────────
+    uint32_t physicalBlock(size_t logical_block) const { return map_[logical_block]; }
+    bool     isBad(size_t physical_block) const        { return state_[physical_block] == BlockState::BAD; }
+    uint32_t eraseCount(size_t physical_block) const   { return erase_count_[physical_block]; }
+    WearLevelingStatistics statistics() const;
+
+private:
+    enum class BlockState : uint8_t
+    {
+        FREE,
+        MAPPED,
+        BAD
+    };
+
+    size_t headerSize() const
+    {
+        const size_t align = std::max<size_t>(inner_.getAlignment(), 1);
+        return (sizeof(WearBlockHeader) + align - 1) / align * align;
+    }
+
+    size_t blockAddress(uint32_t physical) const
+    {
+        return inner_.getFlashStartAddress() + physical * inner_.getEraseBlockSize();
+    }
+
+    static uint32_t headerCrc(const WearBlockHeader &header)
+    {
+        DefaultChecksumPolicy cs;
+        cs.reset();
+        cs.update(reinterpret_cast<const uint8_t *>(&header), offsetof(WearBlockHeader, header_crc));
+        return cs.get();
+    }
+
+    bool readHeader(uint32_t physical, WearBlockHeader &header);
+    AccessorError flushInner();
+
+    // erases the block and writes its header, retires it when the device fails
+    AccessorError stamp(uint32_t physical, uint16_t logical);
+
+    // takes the least worn free block for `logical`, trying at most
+    // MAX_RELOCATIONS blocks
+    uint32_t allocate(uint16_t logical);
+    void     retire(uint32_t physical);
+
+    // moves `logical` to a fresh block, carrying over what was written to it
+    AccessorError relocate(uint32_t logical);
+    AccessorError carryOver(uint32_t from, uint32_t to);
+
+    // mirrors a successful write to the active block
+    void track(size_t offset, const uint8_t *data, size_t size);
+
+private:
+    Inner &inner_;
+
+    std::array<uint32_t, LOGICAL_BLOCKS>   map_{};
+    std::array<BlockState, PhysicalBlocks> state_{};
+    std::array<uint32_t, PhysicalBlocks>   erase_count_{};
+
+    uint32_t sequence_    = 0;
+    uint32_t relocations_ = 0;
+
+    // physical block the inner accessor may still buffer data for; the data
+    // offsets [pending_start_, active_end_) may not be programmed yet
+    uint32_t active_block_  = NO_BLOCK;
+    size_t   pending_start_ = 0;
+    size_t   active_end_    = 0;
+
+    std::array<uint8_t, MaxPageSize> pending_{};
+    std::array<uint8_t, 256> copy_buffer_{};
+};
+
+// ─────────────────────────────────────────────
+// Mount / format
+// ─────────────────────────────────────────────
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::mount()
+{
+    if (inner_.getEraseBlockSize() <= headerSize() ||
+        inner_.getAlignment() > MaxPageSize ||
+        inner_.getFlashMemorySize() < PhysicalBlocks * inner_.getEraseBlockSize())
+        return AccessorError::OUT_OF_BOUNDS;
+
+    map_.fill(NO_BLOCK);
+    sequence_     = 0;
+    active_block_ = NO_BLOCK;
+
+    for (uint32_t p = 0; p < PhysicalBlocks; ++p)
+    {
+        erase_count_[p] = 0;
+        state_[p]       = BlockState::FREE;
+
+        if (inner_.isBlockMarkedBad(p))
+        {
+            state_[p] = BlockState::BAD;
+            continue;
+        }
+
+        WearBlockHeader header{};
+        if (!readHeader(p, header))
+            continue; // blank or torn: free, wear unknown
+
+        erase_count_[p] = header.erase_count;
+        sequence_       = std::max(sequence_, header.sequence);
+
+        if (header.logical_block >= LOGICAL_BLOCKS)
+            continue;
+
+        // several blocks may claim a logical block, the newest header wins
+        const uint32_t current = map_[header.logical_block];
+        if (current != NO_BLOCK)
+        {
+            WearBlockHeader other{};
+            if (readHeader(current, other) && other.sequence > header.sequence)
+                continue;
+            state_[current] = BlockState::FREE;
+        }
+        map_[header.logical_block] = p;
+        state_[p] = BlockState::MAPPED;
+    }
+
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+void WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::format()
+{
+    (void)flushInner();
+    map_.fill(NO_BLOCK);
+    active_block_ = NO_BLOCK;
+
+    for (uint32_t p = 0; p < PhysicalBlocks; ++p)
+    {
+        state_[p] = BlockState::FREE;
+        if (inner_.isBlockMarkedBad(p))
+        {
+            state_[p] = BlockState::BAD;
+            continue;
+        }
+
+        // keep the wear history across the format
+        WearBlockHeader header{};
+        if (readHeader(p, header))
+        {
+            erase_count_[p] = std::max(erase_count_[p], header.erase_count);
+            sequence_       = std::max(sequence_, header.sequence);
+        }
+
+        // stays free, stamped with its wear
+        (void)stamp(p, NO_LOGICAL_BLOCK);
+    }
+}
+
+// ─────────────────────────────────────────────
+// Block management
+// ─────────────────────────────────────────────
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline bool
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::readHeader(uint32_t physical,
+                                                                     WearBlockHeader &header)
+{
+    if (inner_.read(blockAddress(physical),
+                    reinterpret_cast<uint8_t *>(&header),
+                    sizeof(header)) != AccessorError::NO_ERROR)
+        return false;
+
+    return header.magic == WEAR_BLOCK_MAGIC && header.header_crc == headerCrc(header);
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::flushInner()
+{
+    if constexpr (requires(Inner &a) { { a.flush() } -> std::same_as<AccessorError>; })
+        return inner_.flush();
+    else
+        return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::stamp(uint32_t physical, uint16_t logical)
+{
+    AccessorError err = inner_.erase(blockAddress(physical));
+    if (err != AccessorError::NO_ERROR)
+    {
+        if (err == AccessorError::WRITE_ERROR)
+            retire(physical);
+        return err;
+    }
+    ++erase_count_[physical];
+
+    WearBlockHeader header{};
+    header.magic         = WEAR_BLOCK_MAGIC;
+    header.sequence      = ++sequence_;
+    header.erase_count   = erase_count_[physical];
+    header.logical_block = logical;
+    header.reserved      = 0xFFFF;
+    header.header_crc    = headerCrc(header);
+
+    err = inner_.write(blockAddress(physical), reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    if (err == AccessorError::NO_ERROR)
+        err = flushInner();
+    if (err == AccessorError::WRITE_ERROR)
+        retire(physical);
+    return err;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline uint32_t
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::allocate(uint16_t logical)
+{
+    // the header is programmed on its own, nothing else may be pending
+    if (active_block_ != NO_BLOCK && flush() != AccessorError::NO_ERROR)
+        return NO_BLOCK;
+    active_block_ = NO_BLOCK;
+
+    for (size_t attempt = 0; attempt < MAX_RELOCATIONS; ++attempt)
+    {
+        // least worn free block, lowest number on a tie
+        uint32_t best = NO_BLOCK;
+        for (uint32_t p = 0; p < PhysicalBlocks; ++p)
+        {
+            if (state_[p] == BlockState::FREE &&
+                (best == NO_BLOCK || erase_count_[p] < erase_count_[best]))
+                best = p;
+        }
+        if (best == NO_BLOCK)
+            return NO_BLOCK;
+
+        const AccessorError err = stamp(best, logical);
+        if (err == AccessorError::NO_ERROR)
+        {
+            state_[best] = BlockState::MAPPED;
+            return best;
+        }
+        if (err != AccessorError::WRITE_ERROR)
+            return NO_BLOCK;
+    }
+    return NO_BLOCK;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline void
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::retire(uint32_t physical)
+{
+    state_[physical] = BlockState::BAD;
+    if (active_block_ == physical)
+        active_block_ = NO_BLOCK;
+    (void)inner_.markBlockBad(physical);
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::relocate(uint32_t logical)
+{
+    // the programmed data is read back from the block that failed
+    const uint32_t from = map_[logical];
+    retire(from);
+
+    for (size_t attempt = 0; attempt < MAX_RELOCATIONS; ++attempt)
+    {
+        ++relocations_;
+        const uint32_t to = allocate(static_cast<uint16_t>(logical));
+        map_[logical] = to;
+        if (to == NO_BLOCK)
+            return AccessorError::WRITE_ERROR;
+
+        const AccessorError err = carryOver(from, to);
+        if (err == AccessorError::NO_ERROR)
+        {
+            active_block_ = to;
+            return AccessorError::NO_ERROR;
+        }
+        if (err != AccessorError::WRITE_ERROR)
+            return err;
+        retire(to);
+    }
+    return AccessorError::WRITE_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::carryOver(uint32_t from, uint32_t to)
+{
+    // programmed pages come from the old block, the page that was still
+    // buffered when the program failed comes from the mirror
+    const size_t data_start = headerSize();
+    for (size_t off = 0; off < pending_start_; off += copy_buffer_.size())
+    {
+        const size_t chunk = std::min(copy_buffer_.size(), pending_start_ - off);
+        if (inner_.read(blockAddress(from) + data_start + off, copy_buffer_.data(), chunk) != AccessorError::NO_ERROR)
+            return AccessorError::READ_ERROR;
+        const AccessorError err = inner_.write(blockAddress(to) + data_start + off, copy_buffer_.data(), chunk);
+        if (err != AccessorError::NO_ERROR)
+            return err;
+    }
+
+    if (active_end_ > pending_start_)
+    {
+        const size_t page_size = std::max<size_t>(inner_.getAlignment(), 1);
+        const size_t in_page   = pending_start_ % page_size;
+        return inner_.write(blockAddress(to) + data_start + pending_start_, pending_.data() + in_page, active_end_ - pending_start_);
+    }
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline void
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::track(size_t offset, const uint8_t *data, size_t size)
+{
+    const size_t page_size = std::max<size_t>(inner_.getAlignment(), 1);
+    const size_t end       = offset + size;
+
+    // a write ending on a page boundary leaves nothing buffered below
+    if (end % page_size == 0)
+    {
+        pending_start_ = end;
+        active_end_    = end;
+        return;
+    }
+
+    // bytes of the page programmed before this activation stay on the device
+    const size_t page = end - end % page_size;
+    if (active_end_ <= page || pending_start_ < page)
+        pending_start_ = std::max(offset, page);
+    else if (offset > active_end_)
+        std::memset(pending_.data() + (active_end_ - page), 0xFF, offset - active_end_);
+
+    const size_t from = std::max(offset, page);
+    std::memcpy(pending_.data() + (from - page), data + (from - offset), end - from);
+    active_end_ = end;
+}
+
+// ─────────────────────────────────────────────
+// Accessor API: read / write / erase
+// ─────────────────────────────────────────────
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::read(size_t address,
+                                                               uint8_t *data,
+                                                               size_t size)
+{
+    if (address + size > getFlashMemorySize())
+        return AccessorError::OUT_OF_BOUNDS;
+
+    const size_t block_size = getEraseBlockSize();
+
+    while (size > 0)
+    {
+        const size_t logical = address / block_size;
+        const size_t offset  = address % block_size;
+        const size_t chunk   = std::min(size, block_size - offset);
+
+        const uint32_t physical = map_[logical];
+        if (physical == NO_BLOCK)
+        {
+            // never written since the last erase
+            std::memset(data, 0xFF, chunk);
+        }
+        else
+        {
+            const AccessorError err = inner_.read(blockAddress(physical) + headerSize() + offset, data, chunk);
+            if (err != AccessorError::NO_ERROR)
+                return err;
+        }
+
+        address += chunk;
+        data    += chunk;
+        size    -= chunk;
+    }
+
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::write(size_t address,
+                                                                const uint8_t *data,
+                                                                size_t size)
+{
+    if (address + size > getFlashMemorySize())
+        return AccessorError::OUT_OF_BOUNDS;
+
+    const size_t block_size = getEraseBlockSize();
+
+    while (size > 0)
+    {
+        const size_t logical = address / block_size;
+        const size_t offset  = address % block_size;
+        const size_t chunk   = std::min(size, block_size - offset);
+
+        if (map_[logical] == NO_BLOCK)
+        {
+            map_[logical] = allocate(static_cast<uint16_t>(logical));
+            if (map_[logical] == NO_BLOCK)
+                return AccessorError::WRITE_ERROR;
+        }
+
+        // keep buffered data of one block at a time, so a failed program
+        // can be pinned on the right block
+        if (map_[logical] != active_block_)
+        {
+            if (active_block_ != NO_BLOCK && flush() != AccessorError::NO_ERROR)
+                return AccessorError::WRITE_ERROR;
+            active_block_  = map_[logical];
+            pending_start_ = offset;
+            active_end_    = offset;
+        }
+
+        for (size_t attempt = 0;; ++attempt)
+        {
+            const AccessorError err = inner_.write(blockAddress(map_[logical]) + headerSize() + offset, data, chunk);
+            if (err == AccessorError::NO_ERROR)
+                break;
+            if (err != AccessorError::WRITE_ERROR)
+                return err;
+            if (attempt == MAX_RELOCATIONS || relocate(static_cast<uint32_t>(logical)) != AccessorError::NO_ERROR)
+                return AccessorError::WRITE_ERROR;
+        }
+        track(offset, data, chunk);
+
+        address += chunk;
+        data    += chunk;
+        size    -= chunk;
+    }
+
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::flush()
+{
+    for (size_t attempt = 0;; ++attempt)
+    {
+        const AccessorError err = flushInner();
+        if (err == AccessorError::NO_ERROR)
+            break;
+        if (err != AccessorError::WRITE_ERROR)
+            return err;
+        if (active_block_ == NO_BLOCK || attempt == MAX_RELOCATIONS)
+            return AccessorError::WRITE_ERROR;
+
+        const auto it = std::find(map_.begin(), map_.end(), active_block_);
+        if (it == map_.end() ||
+            relocate(static_cast<uint32_t>(it - map_.begin())) != AccessorError::NO_ERROR)
+            return AccessorError::WRITE_ERROR;
+    }
+    pending_start_ = active_end_;
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline AccessorError
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::erase(size_t address)
+{
+    if (address >= getFlashMemorySize())
+        return AccessorError::OUT_OF_BOUNDS;
+
+    const size_t   logical = address / getEraseBlockSize();
+    const uint32_t old     = map_[logical];
+
+    // reads as erased already, the block gets mapped on its first write
+    if (old == NO_BLOCK)
+        return AccessorError::NO_ERROR;
+
+    // the old block stays mapped until the new header is on flash
+    const uint32_t fresh = allocate(static_cast<uint16_t>(logical));
+    if (fresh == NO_BLOCK)
+        return AccessorError::WRITE_ERROR;
+
+    if (state_[old] == BlockState::MAPPED)
+        state_[old] = BlockState::FREE;
+    map_[logical] = fresh;
+
+    return AccessorError::NO_ERROR;
+}
+
+template <BadBlockAccessor Inner, size_t PhysicalBlocks, size_t SpareBlocks, size_t MaxPageSize>
+inline WearLevelingStatistics
+WearLevelingAccessor<Inner, PhysicalBlocks, SpareBlocks, MaxPageSize>::statistics() const
+{
+    WearLevelingStatistics stats{0, 0, 0xFFFFFFFFu, 0, relocations_};
+    for (size_t p = 0; p < PhysicalBlocks; ++p)
+    {
+        if (state_[p] == BlockState::BAD)
+        {
+            ++stats.bad_blocks;
+            continue;
+        }
+        if (state_[p] == BlockState::FREE)
+            ++stats.free_blocks;
+        stats.min_erase_count = std::min(stats.min_erase_count, erase_count_[p]);
+        stats.max_erase_count = std::max(stats.max_erase_count, erase_count_[p]);
+    }
+    if (stats.bad_blocks == PhysicalBlocks)
+        stats.min_erase_count = 0;
+    return stats;
+}
+
+#endif // WEAR_LEVELING_ACCESSOR_H
@@ -0,0 +1,197 @@
+#ifndef IMAGE_BUFFER_CHECKPOINT_HPP
+#define IMAGE_BUFFER_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <concepts>
+
+#include "imagebuffer/accessor.hpp"
+#include "Checksum.hpp"
+
+// -----------------------------------------------------------------------------
+// ImageBufferCheckpoint: ring state saved at push/pop time, so mounting only
+// has to verify the entries pushed after it instead of scanning the capacity.
+// Entry offsets are not stored, they chain from head through the headers.
+// -----------------------------------------------------------------------------
+
+// Magic constant for identifying checkpoint records ("CKPT")
+constexpr uint32_t CHECKPOINT_MAGIC =
+    (static_cast<uint32_t>('C') << 24) |
+    (static_cast<uint32_t>('K') << 16) |
+    (static_cast<uint32_t>('P') << 8)  |
+    static_cast<uint32_t>('T');
+
+#pragma pack(push, 1)
+struct ImageBufferCheckpoint
+{
+    uint32_t magic;            // CHECKPOINT_MAGIC
+    uint32_t generation;       // bumped by the store on every save
+    uint32_t capacity;         // ring capacity the state belongs to
+    uint32_t head;
+    uint32_t tail;
+    uint32_t size;
+    uint32_t count;
+    uint32_t next_sequence_id; // the head entry carries next_sequence_id - count
+    uint32_t crc;              // CRC over all previous bytes
+};
+#pragma pack(pop)
+
+template <typename T>
+concept CheckpointStore = requires(T s, ImageBufferCheckpoint &out, const ImageBufferCheckpoint &in) {
+    { s.load(out) } -> std::same_as<bool>;
+    { s.save(in) } -> std::same_as<bool>;
+};
+
+// Default: no checkpoint, ImageBuffer always mounts by scanning
+struct NoCheckpoint
+{
+    bool load(ImageBufferCheckpoint &) { return false; }
+    bool save(const ImageBufferCheckpoint &) { return true; }
+};
+
+// -----------------------------------------------------------------------------
+// AccessorCheckpointStore: checkpoint journal in a region of any Accessor,
+// e.g. reserved NAND blocks or the MR25H10 MRAM.
+//   - the region is split in two halves of whole erase blocks
+//   - records are appended to one half, one alignment unit each; when it is
+//     full the other half is erased and takes over, so the newest valid record
+//     always survives a torn write
+//   - load() picks the valid record with the highest generation
+// -----------------------------------------------------------------------------
+template <Accessor Storage>
+class AccessorCheckpointStore
+{
+public:
+    AccessorCheckpointStore(Storage &storage, size_t start, size_t region_size)
+        : storage_(storage), start_(start), half_size_(region_size / 2)
+    {
+    }
+
+    bool load(ImageBufferCheckpoint &out)
+    {
+        scanned_    = true;
+        half_       = 0;
+        next_slot_  = 0;
+        generation_ = 0;
+
+        const size_t slots = slotsPerHalf();
+        if (slots == 0)
+            return false;
+
+        bool   found = false;
+        size_t used[2] = {0, 0};
+        for (size_t half = 0; half < 2; ++half)
+        {
+            for (size_t slot = 0; slot < slots; ++slot)
+            {
+                ImageBufferCheckpoint record{};
+                if (storage_.read(slotAddress(half, slot),
+                                  reinterpret_cast<uint8_t *>(&record),
+                                  sizeof(record)) != AccessorError::NO_ERROR)
+                    break;
+
+                // records are appended, the first unwritten slot ends the half
+                if (record.magic != CHECKPOINT_MAGIC)
+                    break;
+                used[half] = slot + 1;
+                if (record.crc != crcOf(record) ||
+                    (found && record.generation <= generation_))
+                    continue;
+
+                out         = record;
+                found       = true;
+                generation_ = record.generation;
+                half_       = half;
+            }
+        }
+
+        // append behind everything written to the current half (torn records
+        // included); with nothing usable start over on a clean half
+        next_slot_ = found ? used[half_] : slots;
+        return found;
+    }
+
+    bool save(const ImageBufferCheckpoint &in)
+    {
+        if (!scanned_)
+        {
+            ImageBufferCheckpoint ignored{};
+            (void)load(ignored);
+        }
+
+        const size_t slots = slotsPerHalf();
+        if (slots == 0)
+            return false;
+
+        if (next_slot_ >= slots)
+        {
+            const size_t other = half_ ^ 1U;
+            if (!eraseHalf(other))
+                return false;
+            half_      = other;
+            next_slot_ = 0;
+        }
+
+        ImageBufferCheckpoint record = in;
+        record.magic      = CHECKPOINT_MAGIC;
+        record.generation = ++generation_;
+        record.crc        = crcOf(record);
+
+        const size_t slot = next_slot_++;
+        if (storage_.write(slotAddress(half_, slot),
+                           reinterpret_cast<const uint8_t *>(&record),
+                           sizeof(record)) != AccessorError::NO_ERROR)
+            return false;
+
+        if constexpr (requires(Storage &a) { { a.flush() } -> std::same_as<AccessorError>; })
+        {
+            if (storage_.flush() != AccessorError::NO_ERROR)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    size_t slotSize() const
+    {
+        const size_t align = storage_.getAlignment() == 0 ? 1 : storage_.getAlignment();
+        return (sizeof(ImageBufferCheckpoint) + align - 1) / align * align;
+    }
+
+    size_t slotsPerHalf() const { return half_size_ / slotSize(); }
+
+    size_t slotAddress(size_t half, size_t slot) const
+    {
+        return start_ + half * half_size_ + slot * slotSize();
+    }
+
+    bool eraseHalf(size_t half)
+    {
+        const size_t block = storage_.getEraseBlockSize() == 0 ? 1 : storage_.getEraseBlockSize();
+        for (size_t off = 0; off < half_size_; off += block)
+        {
+            if (storage_.erase(start_ + half * half_size_ + off) != AccessorError::NO_ERROR)
+                return false;
+        }
+        return true;
+    }
+
+    static uint32_t crcOf(const ImageBufferCheckpoint &record)
+    {
+        DefaultChecksumPolicy cs;
+        cs.reset();
+        cs.update(reinterpret_cast<const uint8_t *>(&record), offsetof(ImageBufferCheckpoint, crc));
+        return cs.get();
+    }
+
+    Storage &storage_;
+    size_t start_;
+    size_t half_size_;
+
+    bool     scanned_    = false;
+    size_t   half_       = 0;
+    size_t   next_slot_  = 0;
+    uint32_t generation_ = 0;
+};
+
+#endif // IMAGE_BUFFER_CHECKPOINT_HPP
@@ -22,6 +22,10 @@ enum class METADATA_PRODUCER : uint8_t
 enum class METADATA_FORMAT : uint16_t
 {
     MX2F = 1,
+    MLXD = 2, // MLX90640 raw frame, lossless predictive + Rice coded (ThermalCompression.hpp)
+    MLXQ = 3, // MLX90640 temperatures, quantized, predictive + Rice coded (ThermalCompression.hpp)
+    JPEG = 4, // camera JPEG stream
+    CHNK = 5, // segment of a streamed frame, see DcmiImageBufferConsumer
     UNKN = 0xFFFF,
 };
 
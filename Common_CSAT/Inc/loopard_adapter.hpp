@@ -63,10 +63,15 @@ public:
                             const void *const payload,
                             const CyphalNodeID node_id)
     {
-        CyphalNodeID node_id_ = getNodeID();
-        setNodeID(node_id);
-        cyphalTxPush(tx_deadline_usec, metadata, payload_size, payload);
-        setNodeID(node_id_);
+        (void)tx_deadline_usec;
+        if (adapter_->buffer.is_full())
+            return 0;
+
+        // stamp the forwarded node-ID on a copy, the local node-ID and the caller's metadata stay as they are
+        CyphalTransfer transfer = {*metadata, 0, payload_size, adapter_->memory_allocate(payload_size)};
+        transfer.metadata.remote_node_id = node_id;
+        std::memcpy(transfer.payload, payload, payload_size);
+        adapter_->buffer.push(transfer);
         return 1;
     }
 
@@ -66,44 +66,66 @@ namespace magnetic_model
         std::array<float, NTERMS> dP_vector{};
 
         (void)wmm_model::MAG_PcupLow<NMAX, NTERMS>(P_vector, dP_vector, sin_latitude);
-        float X = 0.0f, Y = 0.0f, Z = 0.0f;
 
-        for (size_t i = 0; i < coefficients.size(); ++i)
+        // cos(m * lon), sin(m * lon) by the angle addition recurrence
+        std::array<float, NMAX + 1> cos_m_longitude{};
+        std::array<float, NMAX + 1> sin_m_longitude{};
+        cos_m_longitude[0] = 1.0f;
+        sin_m_longitude[0] = 0.0f;
+        if constexpr (NMAX > 0)
         {
-            const GaussCoefficient coeff = coefficients[i];
-            float P = P_vector[i + 1];
-            float dP = dP_vector[i + 1];
+            cos_m_longitude[1] = cosf(longitude_rad);
+            sin_m_longitude[1] = sinf(longitude_rad);
+        }
+        for (size_t m = 2; m <= NMAX; ++m)
+        {
+            cos_m_longitude[m] = cos_m_longitude[m - 1] * cos_m_longitude[1] - sin_m_longitude[m - 1] * sin_m_longitude[1];
+            sin_m_longitude[m] = sin_m_longitude[m - 1] * cos_m_longitude[1] + cos_m_longitude[m - 1] * sin_m_longitude[1];
+        }
 
-            int n = coeff.n;
-            int m = coeff.m;
-            float g = coeff.g;
-            float h = coeff.h;
+        // Radial distance factor (R_EARTH / r)^(n + 2) by repeated multiplication
+        const float ratio = R_EARTH / radius_m;
+        std::array<float, NMAX + 1> ratio_power{};
+        ratio_power[0] = ratio * ratio;
+        for (size_t n = 1; n <= NMAX; ++n)
+            ratio_power[n] = ratio_power[n - 1] * ratio;
 
-            float cos_m_longitude = cosf(static_cast<float>(m) * longitude_rad);
-            float sin_m_longitude = sinf(static_cast<float>(m) * longitude_rad);
+        // Time adjustment (linear interpolation)
+        float time_diff = (float)(year - irgf_year); // Example: Adjust based on the file
+        (void)time_diff;
+        // g += coeff.g_dot * time_diff;
+        // h += coeff.h_dot * time_diff;
+
+        const float inv_cos_latitude = 1.0f / cos_latitude;
+        float X = 0.0f, Y = 0.0f, Z = 0.0f;
+
+        for (size_t i = 0; i < coefficients.size(); ++i)
+        {
+            const GaussCoefficient &coeff = coefficients[i];
+            const float P = P_vector[i + 1];
+            const float dP = dP_vector[i + 1];
 
-            // Time adjustment (linear interpolation)
-            float time_diff = (float)(year - irgf_year); // Example: Adjust based on the file
-            (void)time_diff;
-            // g += coeff.g_dot * time_diff;
-            // h += coeff.h_dot * time_diff;
+            const auto n = static_cast<size_t>(coeff.n);
+            const auto m = static_cast<size_t>(coeff.m);
+            const float g = coeff.g;
+            const float h = coeff.h;
 
-            // Radial distance factor
-            float ratio = R_EARTH / radius_m;
-            float power = static_cast<float>(n + 2);
-            float term = powf(ratio, power);
+            const float term = ratio_power[n];
+            const float cos_m = cos_m_longitude[m];
+            const float sin_m = sin_m_longitude[m];
 
             // Calculate X, Y, and Z components
             if (m == 0)
             {
-                X += term * g * cos_m_longitude * dP;
-                Z += term * static_cast<float>(n + 1) * g * cos_m_longitude * P;
+                X += term * g * dP;
+                Z += term * static_cast<float>(n + 1) * g * P;
             }
             else
             {
-                X += term * (g * cos_m_longitude + h * sin_m_longitude) * dP;
-                Y += term * static_cast<float>(m) * (g * sin_m_longitude - h * cos_m_longitude) * P / cos_latitude;
-                Z += term * static_cast<float>(n + 1) * (g * cos_m_longitude + h * sin_m_longitude) * P;
+                const float gh = g * cos_m + h * sin_m;
+                X += term * gh * dP;
+                Y += term * static_cast<float>(m) * (g * sin_m - h * cos_m) * P * inv_cos_latitude;
+                Z += term * static_cast<float>(n + 1) * gh * P;
             }
         }
 
@@ -29,6 +29,9 @@ extern "C" {
 #define CAN_TX_MAILBOX0             (0x00000001U)  // Tx Mailbox 0
 #define CAN_TX_MAILBOX1             (0x00000002U)  // Tx Mailbox 1
 #define CAN_TX_MAILBOX2             (0x00000004U)  // Tx Mailbox 2
+#define CAN_IT_TX_MAILBOX_EMPTY     (0x00000001U)  // Transmit mailbox empty interrupt
+#define CAN_IT_RX_FIFO0_MSG_PENDING (0x00000002U)  // FIFO 0 message pending interrupt
+#define CAN_TX_MAILBOX_COUNT        3              // bxCAN hardware mailboxes
 
 //--- CAN Structures ---
 typedef struct {
@@ -99,9 +102,23 @@ void set_current_rx_fifo_fill_level(uint32_t rx_fifo_level);
 
 HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs);
 HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs);
-
-#define __HAL_CAN_ENABLE_IT(__HANDLE__, __INTERRUPT__)   (void)0
-#define __HAL_CAN_DISABLE_IT(__HANDLE__, __INTERRUPT__)  (void)0
+uint32_t get_can_enabled_interrupts();
+
+//--- CAN Mailbox Completion Model ---
+// When enabled, HAL_CAN_AddTxMessage occupies one of the three hardware mailboxes
+// until the test completes it; completions run the TX mailbox complete callbacks
+// if CAN_IT_TX_MAILBOX_EMPTY is active, like the TX interrupt would.
+void enable_can_mailbox_model(bool enable);
+uint32_t get_can_busy_mailboxes();
+int complete_can_tx_mailbox();      // completes the pending frame with the lowest identifier, returns its mailbox index or -1
+int complete_can_tx_mailboxes(int count);
+
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan);
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan);
+
+#define __HAL_CAN_ENABLE_IT(__HANDLE__, __INTERRUPT__)   ((void)HAL_CAN_ActivateNotification((__HANDLE__), (__INTERRUPT__)))
+#define __HAL_CAN_DISABLE_IT(__HANDLE__, __INTERRUPT__)  ((void)HAL_CAN_DeactivateNotification((__HANDLE__), (__INTERRUPT__)))
 
 #ifdef __cplusplus
 }
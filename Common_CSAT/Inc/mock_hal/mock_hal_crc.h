@@ -0,0 +1,82 @@
+#ifndef MOCK_HAL_CRC_H
+#define MOCK_HAL_CRC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Include core definitions
+#include "mock_hal/mock_hal_core.h"
+
+#define DEFAULT_CRC32_POLY                ((uint32_t)0x04C11DB7U)
+#define DEFAULT_CRC_INITVALUE             ((uint32_t)0xFFFFFFFFU)
+
+#define DEFAULT_POLYNOMIAL_ENABLE         ((uint8_t)0x00U)
+#define DEFAULT_POLYNOMIAL_DISABLE        ((uint8_t)0x01U)
+#define DEFAULT_INIT_VALUE_ENABLE         ((uint8_t)0x00U)
+#define DEFAULT_INIT_VALUE_DISABLE        ((uint8_t)0x01U)
+
+#define CRC_POLYLENGTH_32B                ((uint32_t)0x00000000U)
+
+#define CRC_INPUTDATA_INVERSION_NONE      ((uint32_t)0x00000000U)
+#define CRC_INPUTDATA_INVERSION_BYTE      ((uint32_t)0x00000020U)
+#define CRC_INPUTDATA_INVERSION_HALFWORD  ((uint32_t)0x00000040U)
+#define CRC_INPUTDATA_INVERSION_WORD      ((uint32_t)0x00000060U)
+
+#define CRC_OUTPUTDATA_INVERSION_DISABLE  ((uint32_t)0x00000000U)
+#define CRC_OUTPUTDATA_INVERSION_ENABLE   ((uint32_t)0x00000080U)
+
+#define CRC_INPUTDATA_FORMAT_BYTES        ((uint32_t)0x00000001U)
+#define CRC_INPUTDATA_FORMAT_HALFWORDS    ((uint32_t)0x00000002U)
+#define CRC_INPUTDATA_FORMAT_WORDS        ((uint32_t)0x00000003U)
+
+    typedef struct
+    {
+        uint32_t DR;   /*!< Data register */
+        uint32_t IDR;  /*!< Independent data register */
+        uint32_t CR;   /*!< Control register */
+        uint32_t INIT; /*!< Initial CRC value register */
+        uint32_t POL;  /*!< Polynomial register */
+    } CRC_TypeDef;
+
+    typedef struct
+    {
+        uint8_t DefaultPolynomialUse;     /*!< DEFAULT_POLYNOMIAL_ENABLE or DEFAULT_POLYNOMIAL_DISABLE */
+        uint8_t DefaultInitValueUse;      /*!< DEFAULT_INIT_VALUE_ENABLE or DEFAULT_INIT_VALUE_DISABLE */
+        uint32_t GeneratingPolynomial;    /*!< Used when DefaultPolynomialUse is disabled */
+        uint32_t CRCLength;               /*!< Only CRC_POLYLENGTH_32B is modelled */
+        uint32_t InitValue;               /*!< Used when DefaultInitValueUse is disabled */
+        uint32_t InputDataInversionMode;  /*!< CRC_INPUTDATA_INVERSION_xxx */
+        uint32_t OutputDataInversionMode; /*!< CRC_OUTPUTDATA_INVERSION_xxx */
+    } CRC_InitTypeDef;
+
+    typedef struct
+    {
+        CRC_TypeDef *Instance;
+        CRC_InitTypeDef Init;
+        uint32_t InputDataFormat;         /*!< CRC_INPUTDATA_FORMAT_xxx, only bytes are modelled */
+    } CRC_HandleTypeDef;
+
+    extern CRC_TypeDef mock_crc_peripheral;
+#define CRC (&mock_crc_peripheral)
+
+#define __HAL_CRC_DR_RESET(__HANDLE__)                        ((__HANDLE__)->Instance->DR = (__HANDLE__)->Instance->INIT)
+#define __HAL_CRC_INITIALCRCVALUE_CONFIG(__HANDLE__, __INIT__) ((__HANDLE__)->Instance->INIT = (__INIT__))
+
+    HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc);
+    uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+    uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength);
+
+    //--- Getter Function Prototypes ---
+    uint32_t get_crc_bytes_processed();
+    void reset_crc_bytes_processed();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOCK_HAL_CRC_H */
@@ -5,6 +5,7 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -58,6 +59,110 @@ uint32_t HAL_DCMI_GetError(DCMI_HandleTypeDef *hdcmi); //return ErrorCode
 void set_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi, uint8_t *buffer, uint32_t width, uint32_t height);
 uint8_t* get_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi); // Added getter
 
+//------------------------------------------------------------------------------
+//  Register level DCMI + DMA2 Channel 6 model
+//------------------------------------------------------------------------------
+// DcmiCapture programs these registers directly. The model moves a byte
+// stream (e.g. a JPEG file) from the "sensor" into the DMA target as 32-bit
+// words, at a fixed number of words per SysTick, once DCMI is enabled and
+// capturing and the channel is enabled. It wraps in circular mode and raises
+// half/full transfer and DCMI frame end, calling the registered handlers the
+// way the NVIC would. Flags are cleared through IFCR / ICR like the hardware.
+
+typedef struct {
+    __IO uint32_t CR;
+    __IO uint32_t SR;
+    __IO uint32_t RISR;
+    __IO uint32_t IER;
+    __IO uint32_t MISR;
+    __IO uint32_t ICR;
+    __IO uint32_t ESCR;
+    __IO uint32_t ESUR;
+    __IO uint32_t CWSTRTR;
+    __IO uint32_t CWSIZER;
+    __IO uint32_t DR;
+} DCMI_TypeDef;
+
+// CPAR / CMAR hold host pointers, so they are pointer sized here
+typedef struct {
+    __IO uint32_t CCR;
+    __IO uint32_t CNDTR;
+    __IO uintptr_t CPAR;
+    __IO uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    __IO uint32_t ISR;
+    __IO uint32_t IFCR;
+} DMA_TypeDef;
+
+extern DCMI_TypeDef mock_dcmi_registers;
+extern DMA_TypeDef mock_dma2_registers;
+extern DMA_Channel_TypeDef mock_dma2_channel6_registers;
+
+#define DCMI            (&mock_dcmi_registers)
+#define DMA2            (&mock_dma2_registers)
+#define DMA2_Channel6   (&mock_dma2_channel6_registers)
+
+#define __HAL_RCC_DCMI_CLK_ENABLE()  do {} while(0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()  do {} while(0)
+
+//--- DCMI register bits (RM0351) ---
+#define DCMI_CR_CAPTURE     (1U << 0)
+#define DCMI_CR_CM          (1U << 1)
+#define DCMI_CR_CROP        (1U << 2)
+#define DCMI_CR_JPEG        (1U << 3)
+#define DCMI_CR_ESS         (1U << 4)
+#define DCMI_CR_PCKPOL      (1U << 5)
+#define DCMI_CR_HSPOL       (1U << 6)
+#define DCMI_CR_VSPOL       (1U << 7)
+#define DCMI_CR_ENABLE      (1U << 14)
+
+#define DCMI_RIS_FRAME_RIS  (1U << 0)
+#define DCMI_RIS_OVR_RIS    (1U << 1)
+#define DCMI_IER_FRAME_IE   (1U << 0)
+#define DCMI_IER_OVR_IE     (1U << 1)
+#define DCMI_MIS_FRAME_MIS  (1U << 0)
+#define DCMI_MIS_OVR_MIS    (1U << 1)
+#define DCMI_ICR_FRAME_ISC  (1U << 0)
+#define DCMI_ICR_OVR_ISC    (1U << 1)
+
+//--- DMA channel register bits ---
+#define DMA_CCR_EN          (1U << 0)
+#define DMA_CCR_TCIE        (1U << 1)
+#define DMA_CCR_HTIE        (1U << 2)
+#define DMA_CCR_TEIE        (1U << 3)
+#define DMA_CCR_DIR         (1U << 4)
+#define DMA_CCR_CIRC        (1U << 5)
+#define DMA_CCR_PINC        (1U << 6)
+#define DMA_CCR_MINC        (1U << 7)
+#define DMA_CCR_PSIZE_1     (1U << 9)
+#define DMA_CCR_MSIZE_1     (1U << 11)
+
+#define DMA_ISR_GIF6        (1U << 20)
+#define DMA_ISR_TCIF6       (1U << 21)
+#define DMA_ISR_HTIF6       (1U << 22)
+#define DMA_ISR_TEIF6       (1U << 23)
+#define DMA_IFCR_CGIF6      (1U << 20)
+#define DMA_IFCR_CTCIF6     (1U << 21)
+#define DMA_IFCR_CHTIF6     (1U << 22)
+#define DMA_IFCR_CTEIF6     (1U << 23)
+
+//--- Replay model ---
+typedef void (*MockIrqHandler)(void);
+
+void mock_dcmi_reset(void);
+void mock_dcmi_load(const uint8_t *data, size_t size);   // copies the stream
+bool mock_dcmi_load_file(const char *path);
+void mock_dcmi_set_rate(uint32_t words_per_tick);
+void mock_dcmi_set_irq_handlers(MockIrqHandler dma2_channel6, MockIrqHandler dcmi);
+
+// Moves up to `words` words, returns how many were moved
+uint32_t mock_dcmi_transfer(uint32_t words);
+// Called from HAL_IncTick on every tick, transfers words_per_tick words
+void mock_dcmi_tick(void);
+uint32_t mock_dcmi_frames_completed(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,16 @@ extern "C"
 #define I2C_MEMADD_SIZE_8BIT (0x00000001U)  // I2C Memory address size: 8-bit
 #define I2C_MEMADD_SIZE_16BIT (0x00000002U) // I2C Memory address size: 16-bit
 
+#define HAL_I2C_ERROR_NONE (0x00000000U)
+
+    typedef enum
+    {
+        HAL_I2C_STATE_RESET = 0x00U,
+        HAL_I2C_STATE_READY = 0x20U,
+        HAL_I2C_STATE_BUSY = 0x24U,
+        HAL_I2C_STATE_BUSY_TX = 0x21U,
+    } HAL_I2C_StateTypeDef;
+
     //--- I2C Structures ---
     typedef struct
     {
@@ -43,6 +53,10 @@ extern "C"
     HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
     HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
     HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+    // Completes immediately, the handle is READY again on return
+    HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+    HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+    uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
 
     //--- I2C Helper Function Prototypes ---
     void inject_i2c_rx_data(uint16_t DevAddress, const uint8_t *data, uint16_t size);
@@ -59,6 +73,9 @@ extern "C"
     uint8_t *get_i2c_rx_buffer();
     int get_i2c_tx_buffer_count();
     uint8_t *get_i2c_tx_buffer();
+    uint32_t get_i2c_mem_write_count(); // Mem_Write and Mem_Write_DMA calls
+    uint32_t get_i2c_mem_write_dma_count();
+    void clear_i2c_mem_write_count();
 
 #ifdef __cplusplus
 }
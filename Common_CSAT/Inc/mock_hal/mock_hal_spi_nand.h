@@ -0,0 +1,63 @@
+#ifndef MOCK_HAL_SPI_NAND_H
+#define MOCK_HAL_SPI_NAND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "mock_hal/mock_hal_core.h"
+#include "mock_hal/mock_hal_spi.h"
+
+// Geometry of the modelled part (Micron MT29F4G01ABAFD)
+#define SPI_NAND_PAGE_SIZE        4096
+#define SPI_NAND_SPARE_SIZE       256
+#define SPI_NAND_PAGE_TOTAL_SIZE  (SPI_NAND_PAGE_SIZE + SPI_NAND_SPARE_SIZE)
+#define SPI_NAND_PAGES_PER_BLOCK  64
+
+//--- SPI-NAND Model ---
+// Once attached to a handle, HAL_SPI_Transmit / Receive / TransmitReceive on that
+// handle are decoded as SPI-NAND commands instead of going to the byte buffers.
+// Each transmit is one command; the data phase of READ FROM CACHE / GET FEATURE
+// is the following receive, the data phase of PROGRAM LOAD may follow as its own
+// transmit. Only the first num_blocks blocks are backed by memory; programming
+// clears bits like real NAND (array &= cache). Operations complete instantly.
+// Blocks can be given a factory bad block marker or made to fail program and
+// erase (grown bad block); failures are reported through P_FAIL / E_FAIL.
+typedef struct {
+    uint32_t page_read;              // 13h
+    uint32_t cache_read_sequential;  // 31h
+    uint32_t cache_read_last;        // 3Fh
+    uint32_t read_from_cache;        // 03h / 0Bh
+    uint32_t program_load;           // 02h / 84h
+    uint32_t program_execute;        // 10h
+    uint32_t block_erase;            // D8h
+    uint32_t get_feature;            // 0Fh
+} SpiNandCounters;
+
+void spi_nand_attach(SPI_HandleTypeDef *hspi, uint32_t num_blocks);
+void spi_nand_detach();
+bool spi_nand_is_attached(const SPI_HandleTypeDef *hspi);
+
+HAL_StatusTypeDef spi_nand_transmit(const uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef spi_nand_receive(uint8_t *pData, uint16_t Size);
+
+//--- Getter Function Prototypes ---
+SpiNandCounters get_spi_nand_counters();
+void reset_spi_nand_counters();
+uint8_t *get_spi_nand_page(uint32_t row);   // NULL outside the backed blocks
+uint32_t get_spi_nand_erase_count(uint32_t block);
+
+//--- Fault Injection ---
+void spi_nand_mark_factory_bad(uint32_t block);
+void spi_nand_fail_block(uint32_t block, bool failing);
+void spi_nand_garble_failed_programs(bool garble); // reset by spi_nand_attach
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOCK_HAL_SPI_NAND_H */
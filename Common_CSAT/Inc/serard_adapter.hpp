@@ -115,19 +115,14 @@ public:
                             const void *const payload,
                             const CyphalNodeID /*node_id*/)
     {
+        (void)tx_deadline_usec;
         CyphalTransferMetadata metadata_{*metadata};
         metadata_.remote_node_id = metadata_.destination_node_id;
 
-        CanardNodeID node_id_ = getNodeID();
-        setNodeID(metadata_.source_node_id);
-
-        int32_t res{};
-        res = cyphalTxPush(tx_deadline_usec, &metadata_, payload_size, payload);
-        (void)tx_deadline_usec;
-        (void)payload_size;
-        (void)payload;
+        // serardTxPush takes the source node-ID as an argument, the instance is left alone
+        SerardTransferMetadata serard_metadata = cyphalMetadataToSerard(metadata_);
+        int32_t res = serardTxPush(cyphalNodeIdToSerard(metadata_.source_node_id), &serard_metadata, payload_size, payload, adapter_->user_reference, adapter_->emitter);
 
-        setNodeID(node_id_);
         log(LOG_LEVEL_DEBUG, "serardTxForward at %08u: %3d -> %3d (%4d %3d)\r\n", HAL_GetTick(),
         		metadata->source_node_id, metadata->destination_node_id, metadata->port_id, metadata->transfer_id);
         return res;
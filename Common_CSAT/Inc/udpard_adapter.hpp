@@ -88,11 +88,17 @@ public:
                          const void *const payload,
                          const CyphalNodeID node_id)
     {
-        const UdpardNodeID *node_id_ = getNodeID();
+        // udpardTxPublish reads the source node-ID through the instance, publish through a
+        // copy and keep only the queue it grew so the local node-ID pointer is never swapped
         UdpardNodeID forward_node_id = cyphalNodeIdToUdpard(node_id);
-        setNodeID(&forward_node_id);
-        int32_t res =  cyphalTxPush(tx_deadline_usec, metadata, payload_size, payload);
-        setNodeID(node_id_);
+        UdpardTx ins{adapter_->ins};
+        ins.local_node_id = &forward_node_id;
+
+        struct UdpardPayload payload_ = {payload_size, payload};
+        int32_t res = udpardTxPublish(&ins, tx_deadline_usec, static_cast<UdpardPriority>(metadata->priority), static_cast<UdpardPortID>(metadata->port_id), cyphalTransferIdToUdpard(metadata->transfer_id), payload_, adapter_->user_transfer_reference);
+
+        ins.local_node_id = adapter_->ins.local_node_id;
+        adapter_->ins = ins;
         return res;
     }
 
@@ -11,6 +11,64 @@
 namespace wmm_model
 {
 
+    namespace detail
+    {
+        // Newton iteration, std::sqrt is not constexpr
+        constexpr double sqrt(double x)
+        {
+            if (x <= 0.0)
+                return 0.0;
+            double r = x > 1.0 ? x : 1.0;
+            for (int i = 0; i < 64; ++i)
+            {
+                const double next = 0.5 * (r + x / r);
+                if (next >= r)
+                    break;
+                r = next;
+            }
+            return r;
+        }
+    } // namespace detail
+
+    /* Ratio between the Schmidt quasi-normalized associated Legendre functions
+       and the Gauss-normalized version, index n * (n + 1) / 2 + m */
+    template <uint16_t nMax>
+    constexpr std::array<float, (size_t{nMax} + 1) * (size_t{nMax} + 2) / 2> schmidtQuasiNormTable()
+    {
+        std::array<double, (size_t{nMax} + 1) * (size_t{nMax} + 2) / 2> norm{};
+        norm[0] = 1.0;
+        for (size_t n = 1; n <= nMax; n++)
+        {
+            const size_t index = n * (n + 1) / 2;
+            norm[index] = norm[(n - 1) * n / 2] * static_cast<double>(2 * n - 1) / static_cast<double>(n);
+            for (size_t m = 1; m <= n; m++)
+                norm[index + m] = norm[index + m - 1] * detail::sqrt(static_cast<double>((n - m + 1) * (m == 1 ? 2 : 1)) / static_cast<double>(n + m));
+        }
+
+        std::array<float, (size_t{nMax} + 1) * (size_t{nMax} + 2) / 2> table{};
+        for (size_t i = 0; i < table.size(); ++i)
+            table[i] = static_cast<float>(norm[i]);
+        return table;
+    }
+
+    /* ((n-1)^2 - m^2) / ((2n-1)(2n-3)) of the Gauss-normalized recursion,
+       index n * (n + 1) / 2 + m, zero where it is not used */
+    template <uint16_t nMax>
+    constexpr std::array<float, (size_t{nMax} + 1) * (size_t{nMax} + 2) / 2> gaussRecursionTable()
+    {
+        std::array<float, (size_t{nMax} + 1) * (size_t{nMax} + 2) / 2> table{};
+        for (size_t n = 2; n <= nMax; n++)
+            for (size_t m = 0; m + 2 <= n; m++)
+                table[n * (n + 1) / 2 + m] = static_cast<float>((n - 1) * (n - 1) - m * m) / static_cast<float>((2 * n - 1) * (2 * n - 3));
+        return table;
+    }
+
+    template <uint16_t nMax>
+    inline constexpr auto SCHMIDT_QUASI_NORM = schmidtQuasiNormTable<nMax>();
+
+    template <uint16_t nMax>
+    inline constexpr auto GAUSS_RECURSION = gaussRecursionTable<nMax>();
+
     template <uint16_t nMax, size_t N>
     bool MAG_PcupLow(std::array<float, N> &Pcup, std::array<float, N> &dPcup, float x);
 
@@ -51,8 +109,6 @@ namespace wmm_model
         dPcup[0] = 0.0f;
         z = sqrtf((1.0f - x) * (1.0f + x));
 
-        std::array<float, N + 1> schmidtQuasiNorm;
-
         /*	 First,	Compute the Gauss-normalized associated Legendre  functions*/
 
         for (n = 1; n <= nMax; n++)
@@ -84,46 +140,24 @@ namespace wmm_model
                     }
                     else
                     {
-                        k = (float)(((n - 1) * (n - 1)) - (m * m)) / (float)((2 * n - 1) * (2 * n - 3));
+                        k = GAUSS_RECURSION<nMax>[index];
                         Pcup[index] = x * Pcup[index2] - k * Pcup[index1];
                         dPcup[index] = x * dPcup[index2] - z * Pcup[index2] - k * dPcup[index1];
                     }
                 }
             }
         }
-        /* Compute the ration between the the Schmidt quasi-normalized associated Legendre
-         * functions and the Gauss-normalized version. */
-
-        schmidtQuasiNorm[0] = 1.0;
-        for (n = 1; n <= nMax; n++)
-        {
-            index = static_cast<uint16_t>((n * (n + 1) / 2));
-            index1 = static_cast<uint16_t>((n - 1) * n / 2);
-            /* for m = 0 */
-            schmidtQuasiNorm[index] = schmidtQuasiNorm[index1] * (float)(2 * n - 1) / (float)n;
-
-            for (m = 1; m <= n; m++)
-            {
-                index = static_cast<uint16_t>((n * (n + 1) / 2 + m));
-                index1 = static_cast<uint16_t>((n * (n + 1) / 2 + m - 1));
-                schmidtQuasiNorm[index] = schmidtQuasiNorm[index1] * sqrtf((float)((n - m + 1) * (m == 1 ? 2 : 1)) / (float)(n + m));
-            }
-        }
 
         /* Converts the  Gauss-normalized associated Legendre
-                  functions to the Schmidt quasi-normalized version using pre-computed
-                  relation stored in the variable schmidtQuasiNorm */
+                  functions to the Schmidt quasi-normalized version using the
+                  relation generated at compile time in SCHMIDT_QUASI_NORM */
 
-        for (n = 1; n <= nMax; n++)
+        for (index = 1; index < N; index++)
         {
-            for (m = 0; m <= n; m++)
-            {
-                index = static_cast<uint16_t>((n * (n + 1) / 2 + m));
-                Pcup[index] = Pcup[index] * schmidtQuasiNorm[index];
-                dPcup[index] = -dPcup[index] * schmidtQuasiNorm[index];
-                /* The sign is changed since the new WMM routines use derivative with respect to latitude
-                insted of co-latitude */
-            }
+            Pcup[index] = Pcup[index] * SCHMIDT_QUASI_NORM<nMax>[index];
+            dPcup[index] = -dPcup[index] * SCHMIDT_QUASI_NORM<nMax>[index];
+            /* The sign is changed since the new WMM routines use derivative with respect to latitude
+            insted of co-latitude */
         }
 
         return true;
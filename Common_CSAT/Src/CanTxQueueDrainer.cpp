@@ -1,21 +1,35 @@
 #include "CanTxQueueDrainer.hpp"
 #include "canard_adapter.hpp"
 #include "Logger.hpp"
+#include "DeferredLog.hpp"
 #include "IRQLock.hpp"
 
 CanTxQueueDrainer::CanTxQueueDrainer(CanardAdapter* adapter,
                                      CAN_HandleTypeDef* hcan)
-    : adapter_(adapter), hcan_(hcan)
+    : adapter_(adapter), hcan_(hcan), statistics_(), window_start_(HAL_GetTick()), window_frames_(0)
 {}
 
 void CanTxQueueDrainer::drain()
 {
+    const uint32_t now = HAL_GetTick();
+    const uint64_t now_usec = static_cast<uint64_t>(now) * 1000ULL;
+
 	const CanardTxQueueItem* ti = nullptr;
     while ((ti = canardTxPeek(&adapter_->que)) != nullptr)
     {
+        if (ti->tx_deadline_usec != 0 && ti->tx_deadline_usec < now_usec)
+        {
+            ++statistics_.frames_expired;
+            adapter_->ins.memory_free(&adapter_->ins, canardTxPop(&adapter_->que, ti));
+            continue;
+        }
+
     	auto num_mailboxes = HAL_CAN_GetTxMailboxesFreeLevel(hcan_);
     	if (num_mailboxes == 0)
+        {
+            ++statistics_.mailbox_full;
             break;
+        }
 
         CAN_TxHeaderTypeDef header;
         header.ExtId = ti->frame.extended_can_id;
@@ -24,33 +38,71 @@ void CanTxQueueDrainer::drain()
         header.IDE   = CAN_ID_EXT;
 
         uint32_t mailbox;
-        HAL_CAN_AddTxMessage(hcan_, &header, (uint8_t*)ti->frame.payload, &mailbox);
+        if (HAL_CAN_AddTxMessage(hcan_, &header, (uint8_t*)ti->frame.payload, &mailbox) != HAL_OK)
+        {
+            ++statistics_.mailbox_full;
+            break;
+        }
 
         CyphalHeader cyphal_header = parse_header(header.ExtId);
         uint8_t transfer_id = reinterpret_cast<const uint8_t*>(ti->frame.payload)[header.DLC-1];
-        log(LOG_LEVEL_INFO, "CanTxQueueDrainer mailbox %d of %d available: %3d -> %3d subject %3d transfer_id %2x\r\n",
+        LOG_DEFERRED(LOG_LEVEL_TRACE, "CanTxQueueDrainer mailbox %d of %d available: %3d -> %3d subject %3d transfer_id %2x\r\n",
         			mailbox, num_mailboxes, cyphal_header.source_id, cyphal_header.destination_id, cyphal_header.port_id, transfer_id);
 
+        if (ti->tx_deadline_usec >= CAN_TX_TIMEOUT_USEC)
+        {
+            const uint64_t pushed_usec = ti->tx_deadline_usec - CAN_TX_TIMEOUT_USEC;
+            const uint32_t latency_ms = now_usec > pushed_usec ? static_cast<uint32_t>((now_usec - pushed_usec) / 1000ULL) : 0;
+            statistics_.total_latency_ms += latency_ms;
+            if (latency_ms > statistics_.max_latency_ms)
+                statistics_.max_latency_ms = latency_ms;
+        }
+        ++statistics_.frames_sent;
+        ++window_frames_;
+
         adapter_->ins.memory_free(&adapter_->ins, canardTxPop(&adapter_->que, ti));
     }
 
-//    if (adapter_->que.size > 0 && HAL_CAN_GetTxMailboxesFreeLevel(hcan_) == 0)
-//    {
-//    	__HAL_CAN_ENABLE_IT(hcan_, CAN_IT_TX_MAILBOX_EMPTY);
-//    }
-//    else
-//    {
-//    	__HAL_CAN_DISABLE_IT(hcan_, CAN_IT_TX_MAILBOX_EMPTY);
-//    }
+    update_rate(now);
+
+    // the mailbox empty interrupt only needs to fire while there is something to refill
+    if (adapter_->que.size > 0)
+    {
+    	__HAL_CAN_ENABLE_IT(hcan_, CAN_IT_TX_MAILBOX_EMPTY);
+    }
+    else
+    {
+    	__HAL_CAN_DISABLE_IT(hcan_, CAN_IT_TX_MAILBOX_EMPTY);
+    }
 }
 
 void CanTxQueueDrainer::irq_safe_drain()
 {
-//	CanTxIrqLock::lock();
+	CanTxIrqLock::lock();
 	drain();
-//	CanTxIrqLock::unlock();
+	CanTxIrqLock::unlock();
 }
 
-// #ifdef __x86_64__
-// CanTxQueueDrainer tx_drainer;
-// #endif // __x86_64__
+void CanTxQueueDrainer::on_tx_complete()
+{
+    ++statistics_.irq_refills;
+    drain();
+}
+
+void CanTxQueueDrainer::reset_statistics()
+{
+    statistics_ = CanTxStatistics{};
+    window_start_ = HAL_GetTick();
+    window_frames_ = 0;
+}
+
+void CanTxQueueDrainer::update_rate(uint32_t now)
+{
+    const uint32_t elapsed = now - window_start_;
+    if (elapsed < 1000)
+        return;
+
+    statistics_.frames_per_second = static_cast<uint32_t>(static_cast<uint64_t>(window_frames_) * 1000ULL / elapsed);
+    window_start_ = now;
+    window_frames_ = 0;
+}
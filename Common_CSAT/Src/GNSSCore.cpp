@@ -67,7 +67,7 @@ union i_Long
 /*!
  * Parse data to unique chip ID standard.
  */
-UniqueID GNSSCore::parseUniqID(uint8_t *messageBuffer)
+UniqueID GNSSCore::parseUniqID(const uint8_t *messageBuffer)
 {
 	return UniqueID{
 		.id = {getUByte(messageBuffer, 4),
@@ -81,7 +81,7 @@ UniqueID GNSSCore::parseUniqID(uint8_t *messageBuffer)
 /*!
  * Parse data to navigation position velocity time solution standard.
  */
-NavigationPVT GNSSCore::parseNavPVT(uint8_t *messageBuffer)
+NavigationPVT GNSSCore::parseNavPVT(const uint8_t *messageBuffer)
 {
 	return NavigationPVT{
 		.utcTime = {
@@ -123,7 +123,7 @@ NavigationPVT GNSSCore::parseNavPVT(uint8_t *messageBuffer)
 /*!
  * Parse data to UTC time solution standard.
  */
-UTCTime GNSSCore::parseNavTimeUTC(uint8_t *messageBuffer)
+UTCTime GNSSCore::parseNavTimeUTC(const uint8_t *messageBuffer)
 {
 	return UTCTime{
 		.year = getUShort(messageBuffer, 12),							  // year
@@ -141,7 +141,7 @@ UTCTime GNSSCore::parseNavTimeUTC(uint8_t *messageBuffer)
 /*!
  * Parse data to geodetic position solution standard.
  */
-PositionLLH GNSSCore::parseNavPosLLH(uint8_t *messageBuffer)
+PositionLLH GNSSCore::parseNavPosLLH(const uint8_t *messageBuffer)
 {
 	return PositionLLH{
 		.lon = getILong(messageBuffer, 4),	   // lon
@@ -156,7 +156,7 @@ PositionLLH GNSSCore::parseNavPosLLH(uint8_t *messageBuffer)
 /*!
  * Parse data to earth centric position solution standard.
  */
-PositionECEF GNSSCore::parseNavPosECEF(uint8_t *messageBuffer)
+PositionECEF GNSSCore::parseNavPosECEF(const uint8_t *messageBuffer)
 {
 	return PositionECEF{
 		.ecefX = getILong(messageBuffer, 4),  // ecefX
@@ -169,7 +169,7 @@ PositionECEF GNSSCore::parseNavPosECEF(uint8_t *messageBuffer)
 /*!
  * Parse data to geodetic velocity solution standard.
  */
-VelocityNED GNSSCore::parseNavVelNED(uint8_t *messageBuffer)
+VelocityNED GNSSCore::parseNavVelNED(const uint8_t *messageBuffer)
 {
 	return VelocityNED{
 		.velN = getILong(messageBuffer, 4),		// velN
@@ -186,7 +186,7 @@ VelocityNED GNSSCore::parseNavVelNED(uint8_t *messageBuffer)
 /*!
  * Parse data to earth centric velocity solution standard.
  */
-VelocityECEF GNSSCore::parseNavVelECEF(uint8_t *messageBuffer)
+VelocityECEF GNSSCore::parseNavVelECEF(const uint8_t *messageBuffer)
 {
 	return VelocityECEF{
 		.ecefVX = getILong(messageBuffer, 4),  // velX
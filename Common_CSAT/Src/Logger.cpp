@@ -42,20 +42,40 @@ void Logger::log(uint8_t level, const char* format, va_list args)
     int len = vsnprintf(buffer, sizeof(buffer), format, args);
     if (len <= 0) return;
 
+    write(level, buffer, strlen(buffer));
+}
+
+void Logger::write([[maybe_unused]] uint8_t level, [[maybe_unused]] const char* str, [[maybe_unused]] size_t size)
+{
 #ifdef LOGGER_OUTPUT_UART
-    uart_transmit_log_message(buffer, static_cast<uint16_t>(strlen(buffer)));
+    uart_transmit_log_message(str, static_cast<uint16_t>(size));
 #endif
 
 #ifdef LOGGER_OUTPUT_USB
-    usb_cdc_transmit_log_message(buffer, static_cast<uint16_t>(strlen(buffer)));
+    usb_cdc_transmit_log_message(str, static_cast<uint16_t>(size));
 #endif
 
 #ifdef LOGGER_OUTPUT_STDERR
-    stream_transmit_log_message(buffer);
+    stream_transmit_log_message(str);
 #endif
 
 #ifdef LOGGER_OUTPUT_CYPHAL
-    can_transmit_log_message(buffer, strlen(buffer), level);
+    can_transmit_log_message(str, size, level);
+#endif
+}
+
+void Logger::writeBinary([[maybe_unused]] const uint8_t* data, [[maybe_unused]] size_t size)
+{
+#ifdef LOGGER_OUTPUT_UART
+    uart_transmit_log_message(reinterpret_cast<const char*>(data), static_cast<uint16_t>(size));
+#endif
+
+#ifdef LOGGER_OUTPUT_USB
+    usb_cdc_transmit_log_message(reinterpret_cast<const char*>(data), static_cast<uint16_t>(size));
+#endif
+
+#ifdef LOGGER_OUTPUT_STDERR
+    stream_->write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
 #endif
 }
 
@@ -2,27 +2,73 @@
 #include "MLX90640Calibration.hpp"
 #include <cmath>
 
+namespace
+{
+// Frame words behind the pixel data (MLX90640 datasheet, RAM map)
+constexpr int WORD_VBE         = 768;
+constexpr int WORD_CP_SUBPAGE0 = 776;
+constexpr int WORD_GAIN        = 778;
+constexpr int WORD_PTAT        = 800;
+constexpr int WORD_CP_SUBPAGE1 = 808;
+constexpr int WORD_VDD         = 810;
+constexpr int WORD_CONTROL     = 832;
+constexpr int WORD_SUBPAGE     = 833;
+
+constexpr uint16_t CONTROL_CHESS_MODE       = 0x1000u;
+constexpr int      CONTROL_RESOLUTION_SHIFT = 10;
+
+constexpr float KELVIN = 273.15f;
+
+// Pixel numbers of each subpage in chess mode, (row + col) even for subpage 0
+using SubpageIndex = std::array<std::array<uint16_t, MLX90640ImageProcessor::SUBPAGE_PIXELS>, 2>;
+
+constexpr SubpageIndex makeChessIndex()
+{
+    SubpageIndex index{};
+    std::array<std::size_t, 2> fill{};
+    for (int p = 0; p < MLX90640ImageProcessor::PIXELS; ++p)
+    {
+        const std::size_t sub = std::size_t(((p / MLX90640ImageProcessor::WIDTH) + p) & 1);
+        index[sub][fill[sub]++] = uint16_t(p);
+    }
+    return index;
+}
+
+constexpr SubpageIndex CHESS_INDEX = makeChessIndex();
+}
+
+MLX90640ImageProcessor::MLX90640ImageProcessor()
+    : cal_(&MLX90640_CAL)
+{
+}
+
+MLX90640ImageProcessor::MLX90640ImageProcessor(const MLX90640_Calibration& cal)
+    : cal_(&cal)
+{
+}
+
 bool MLX90640ImageProcessor::demultiplexFrame(const uint16_t* frame,
                                               RawImage& outRaw) const
 {
-    const uint16_t* sub0 = frame;
-    const uint16_t* sub1 = frame + 834;
+    // Checkerboard pattern:
+    // subpage 0: (row + col) even
+    // subpage 1: (row + col) odd
+    return demultiplexSubpage(frame, 0, outRaw) &&
+           demultiplexSubpage(frame + FRAME_WORDS, 1, outRaw);
+}
 
-    for (std::size_t row = 0; row < HEIGHT; ++row)
+bool MLX90640ImageProcessor::demultiplexSubpage(const uint16_t* subpage,
+                                                uint16_t subPage,
+                                                RawImage& outRaw) const
+{
+    if (subPage > 1)
     {
-        for (std::size_t col = 0; col < WIDTH; ++col)
-        {
-            std::size_t idx = row * WIDTH + col;
-
-            // Checkerboard pattern:
-            // subpage 0: (row + col) even
-            // subpage 1: (row + col) odd
-            bool useSub1 = ((row + col) & 1u) != 0;
+        return false;
+    }
 
-            outRaw[idx] = useSub1
-                ? int16_t(sub1[idx])
-                : int16_t(sub0[idx]);
-        }
+    for (const uint16_t p : CHESS_INDEX[subPage])
+    {
+        outRaw[p] = s16(subpage[p]);
     }
 
     return true;
@@ -67,3 +113,156 @@ bool MLX90640ImageProcessor::computeTemperatures(const RawImage& raw,
 
     return true;
 }
+
+MLX90640ImageProcessor::FrameConditions
+MLX90640ImageProcessor::frameConditions(const uint16_t* frame) const
+{
+    const auto& P = *cal_;
+    FrameConditions fc{};
+
+    const int resolutionRAM = (frame[WORD_CONTROL] >> CONTROL_RESOLUTION_SHIFT) & 0x3;
+    const float resolutionCorrection = pow2f(P.resolutionEE) / pow2f(resolutionRAM);
+    fc.vdd = (resolutionCorrection * float(s16(frame[WORD_VDD])) - float(P.vdd25))
+             / float(P.kVdd) + 3.3f;
+
+    const float ptat    = float(s16(frame[WORD_PTAT]));
+    const float ptatArt = ptat / (ptat * P.alphaPTAT + float(s16(frame[WORD_VBE]))) * pow2f(18);
+    fc.ta = (ptatArt / (1.0f + P.KvPTAT * (fc.vdd - 3.3f)) - float(P.vPTAT25)) / P.KtPTAT + 25.0f;
+
+    fc.chess   = (frame[WORD_CONTROL] & CONTROL_CHESS_MODE) != 0;
+    fc.subPage = frame[WORD_SUBPAGE];
+    return fc;
+}
+
+void MLX90640ImageProcessor::calibrate(float Ta, float vdd, bool chess)
+{
+    const auto& P = *cal_;
+
+    const float dTa  = Ta - 25.0f;
+    const float dVdd = vdd - 3.3f;
+
+    const float ktaScale = pow2f(P.ktaScale);
+    const float kvScale  = pow2f(P.kvScale);
+    const float alphaTa  = 0.000001f * pow2f(P.alphaScale) * (1.0f + P.KsTa * dTa);
+    const float k1       = 1.0f - P.ksTo[1] * KELVIN;
+
+    // the IL/chess correction applies when reading in the other pattern
+    // than the one the part was calibrated in
+    const bool patternCorrection = chess != (P.calibrationModeEE != 0);
+
+    std::array<std::size_t, 2> fill{};
+    for (int p = 0; p < PIXELS; ++p)
+    {
+        const int il           = p / 32 - (p / 64) * 2;
+        const int chessPattern = il ^ (p & 1);
+        const int conversion   = ((p + 2) / 4 - (p + 3) / 4 + (p + 1) / 4 - p / 4) * (1 - 2 * il);
+
+        SubpageTables& t = tables_[std::size_t(chess ? chessPattern : il)];
+        const std::size_t k = fill[std::size_t(chess ? chessPattern : il)]++;
+
+        float offset = float(P.offset[p])
+                       * (1.0f + float(P.kta[p]) / ktaScale * dTa)
+                       * (1.0f + float(P.kv[p]) / kvScale * dVdd);
+        if (patternCorrection)
+        {
+            offset -= P.ilChessC[2] * float(2 * il - 1) - P.ilChessC[1] * float(conversion);
+        }
+
+        const float alpha = alphaTa / float(P.alpha[p]);
+
+        t.index[k]    = uint16_t(p);
+        t.irOffset[k] = offset;
+        t.alpha[k]    = alpha;
+        t.alpha3[k]   = alpha * alpha * alpha;
+        t.alphaK1[k]  = alpha * k1;
+    }
+
+    const float cpScale = (1.0f + P.cpKta * dTa) * (1.0f + P.cpKv * dVdd);
+    cpOffset_[0] = float(P.cpOffset[0]) * cpScale;
+    cpOffset_[1] = (float(P.cpOffset[1]) + (patternCorrection ? P.ilChessC[0] : 0.0f)) * cpScale;
+
+    // the range correction alpha * corr * (1 + ksTo * (To - ct)) is linear
+    // in To, keep it as A + B * To
+    std::array<float, 4> corr{};
+    corr[0] = 1.0f / (1.0f + P.ksTo[0] * 40.0f);
+    corr[1] = 1.0f;
+    corr[2] = 1.0f + P.ksTo[1] * float(P.ct[2]);
+    corr[3] = corr[2] * (1.0f + P.ksTo[2] * float(P.ct[3] - P.ct[2]));
+    for (std::size_t r = 0; r < 4; ++r)
+    {
+        rangeA_[r] = corr[r] * (1.0f - P.ksTo[r] * float(P.ct[r]));
+        rangeB_[r] = corr[r] * P.ksTo[r];
+    }
+    for (std::size_t r = 0; r < 3; ++r)
+    {
+        rangeLimit_[r] = float(P.ct[r + 1]);
+    }
+
+    tablesTa_    = Ta;
+    tablesVdd_   = vdd;
+    tablesChess_ = chess;
+    calibrated_  = true;
+}
+
+bool MLX90640ImageProcessor::calculateTo(const uint16_t* frame,
+                                         float emissivity,
+                                         float tr,
+                                         TempImage& outTemps)
+{
+    const auto& P = *cal_;
+    const FrameConditions fc = frameConditions(frame);
+
+    const int16_t gainWord = s16(frame[WORD_GAIN]);
+    if (fc.subPage > 1 || gainWord == 0 || emissivity <= 0.0f)
+    {
+        return false;
+    }
+
+    if (!calibrated_ ||
+        fc.chess != tablesChess_ ||
+        std::fabs(fc.ta - tablesTa_) > TA_REBUILD_DELTA ||
+        std::fabs(fc.vdd - tablesVdd_) > VDD_REBUILD_DELTA)
+    {
+        calibrate(fc.ta, fc.vdd, fc.chess);
+    }
+
+    // per-frame scalars
+    const float gain   = float(P.gainEE) / float(gainWord);
+    const uint16_t cp  = fc.subPage == 0 ? frame[WORD_CP_SUBPAGE0] : frame[WORD_CP_SUBPAGE1];
+    const float irCP   = float(s16(cp)) * gain - cpOffset_[fc.subPage];
+    const float irBias = P.tgc * irCP;
+    const float invE   = 1.0f / emissivity;
+
+    float ta4 = fc.ta + KELVIN;
+    ta4 = ta4 * ta4;
+    ta4 = ta4 * ta4;
+    float tr4 = tr + KELVIN;
+    tr4 = tr4 * tr4;
+    tr4 = tr4 * tr4;
+    const float taTr = tr4 - (tr4 - ta4) / emissivity;
+
+    const float ksTo1 = P.ksTo[1];
+
+    // per-pixel kernel: straight loop over the subpage tables, the To range
+    // is picked by comparison sums instead of branches
+    const SubpageTables& t = tables_[fc.subPage];
+    for (std::size_t k = 0; k < SUBPAGE_PIXELS; ++k)
+    {
+        const uint16_t p = t.index[k];
+
+        const float ir = (float(s16(frame[p])) * gain - t.irOffset[k] - irBias) * invE;
+        const float a  = t.alpha[k];
+
+        const float Sx = ksTo1 * std::sqrt(std::sqrt(t.alpha3[k] * (ir + a * taTr)));
+        const float To = std::sqrt(std::sqrt(ir / (t.alphaK1[k] + Sx) + taTr)) - KELVIN;
+
+        const std::size_t range = std::size_t(To >= rangeLimit_[0])
+                                + std::size_t(To >= rangeLimit_[1])
+                                + std::size_t(To >= rangeLimit_[2]);
+
+        outTemps[p] = std::sqrt(std::sqrt(ir / (a * (rangeA_[range] + rangeB_[range] * To)) + taTr))
+                      - KELVIN;
+    }
+
+    return true;
+}
@@ -10,6 +10,7 @@ void RegistrationManager::subscribe(const CyphalPortID port_id, std::shared_ptr<
     TaskHandler handler = {port_id, task};
     handlers_.pushOrReplace(handler, [&](const TaskHandler &existing_handler, const TaskHandler &new_handler)
                             { return existing_handler.port_id == new_handler.port_id && existing_handler.task == new_handler.task; });
+    dispatch_.rebuild(handlers_);
     subscribe(port_id);
 }
 
@@ -35,6 +36,7 @@ void RegistrationManager::unsubscribe(const CyphalPortID port_id, std::shared_pt
 {
     handlers_.removeIf([&](const TaskHandler &handler)
                        { return handler.port_id == port_id && handler.task == task; });
+    dispatch_.rebuild(handlers_);
 
     if (!handlers_.containsIf([&](const TaskHandler &handler)
                               { return handler.port_id == port_id; }))
@@ -54,6 +56,7 @@ void RegistrationManager::publish(const CyphalPortID port_id, std::shared_ptr<Ta
     TaskHandler handler = {port_id, task};
     handlers_.pushOrReplace(handler, [&](const TaskHandler &existing_handler, const TaskHandler &new_handler)
                             { return existing_handler.port_id == new_handler.port_id && existing_handler.task == new_handler.task; });
+    dispatch_.rebuild(handlers_);
     publish(port_id);
 }
 
@@ -79,6 +82,7 @@ void RegistrationManager::unpublish(const CyphalPortID port_id, std::shared_ptr<
 {
     handlers_.removeIf([&](const TaskHandler &handler)
                        { return handler.port_id == port_id && handler.task == task; });
+    dispatch_.rebuild(handlers_);
     if (!handlers_.containsIf([&](const TaskHandler &handler)
                               { return handler.port_id == port_id; }))
     {
@@ -97,6 +101,7 @@ void RegistrationManager::client(const CyphalPortID port_id, std::shared_ptr<Tas
     TaskHandler handler = {port_id, task};
     handlers_.pushOrReplace(handler, [&](const TaskHandler &existing_handler, const TaskHandler &new_handler)
                             { return existing_handler.port_id == new_handler.port_id && existing_handler.task == new_handler.task; });
+    dispatch_.rebuild(handlers_);
     client(port_id);
 }
 
@@ -122,6 +127,7 @@ void RegistrationManager::unclient(const CyphalPortID port_id, std::shared_ptr<T
 {
     handlers_.removeIf([&](const TaskHandler &handler)
                        { return handler.port_id == port_id && handler.task == task; });
+    dispatch_.rebuild(handlers_);
      if (!handlers_.containsIf([&](const TaskHandler &handler)
                               { return handler.port_id == port_id; }))
     {
@@ -140,6 +146,7 @@ void RegistrationManager::server(const CyphalPortID port_id, std::shared_ptr<Tas
     TaskHandler handler = {port_id, task};
     handlers_.pushOrReplace(handler, [&](const TaskHandler &existing_handler, const TaskHandler &new_handler)
                             { return existing_handler.port_id == new_handler.port_id && existing_handler.task == new_handler.task; });
+    dispatch_.rebuild(handlers_);
     server(port_id);
 }
 
@@ -165,6 +172,7 @@ void RegistrationManager::unserver(const CyphalPortID port_id, std::shared_ptr<T
 {
     handlers_.removeIf([&](const TaskHandler &handler)
                        { return handler.port_id == port_id && handler.task == task; });
+    dispatch_.rebuild(handlers_);
     if (!handlers_.containsIf([&](const TaskHandler &handler)
                               { return handler.port_id == port_id; }))
     {
@@ -8,19 +8,29 @@
 #include "ServiceManager.hpp"
 #include <algorithm>
 
-void ServiceManager::initializeServices(uint32_t now) const
+void ServiceManager::initializeServices(uint32_t now)
 {
-	for(auto handler : handlers_)
+	for(const auto &handler : handlers_)
 	{
 		handler.task->initialize(now);
 	}
+	schedule_valid_ = false;
 }
 
-void ServiceManager::handleMessage(std::shared_ptr<CyphalTransfer> transfer) const
+void ServiceManager::handleMessage(const std::shared_ptr<CyphalTransfer> &transfer) const
 {
 	log(LOG_LEVEL_DEBUG, "ServiceManager::handleMessage %4d %2d %4d\r\n",
 			transfer->metadata.remote_node_id, transfer->metadata.transfer_kind, transfer->metadata.port_id);
-	for(auto handler : handlers_)
+	if (dispatch_ != nullptr)
+	{
+		for(const auto &entry : dispatch_->find(transfer->metadata.port_id))
+		{
+			entry.task->handleMessage(transfer);
+		}
+		return;
+	}
+
+	for(const auto &handler : handlers_)
 	{
 		if (handler.port_id == transfer->metadata.port_id)
 		{
@@ -29,10 +39,59 @@ void ServiceManager::handleMessage(std::shared_ptr<CyphalTransfer> transfer) con
 	}
 }
 
-void ServiceManager::handleServices() const
+void ServiceManager::handleServices()
+{
+	updateSchedule();
+	scheduler_.runDue(HAL_GetTick());
+}
+
+uint32_t ServiceManager::nextDeadline()
+{
+	updateSchedule();
+	return scheduler_.nextDeadline();
+}
+
+void ServiceManager::reschedule(Task *task)
 {
-	for(auto handler : handlers_)
+	if (schedule_valid_)
 	{
-		handler.task->handleTask();
+		scheduler_.reschedule(task);
+	}
+}
+
+// compares the handler list against the tasks the schedule was built from
+bool ServiceManager::handlersChanged() const
+{
+	if (handlers_.size() != scheduled_count_)
+		return true;
+
+	size_t i = 0;
+	for(const auto &handler : handlers_)
+	{
+		if (handler.task.get() != scheduled_tasks_[i++])
+			return true;
+	}
+	return false;
+}
+
+void ServiceManager::updateSchedule()
+{
+	bool changed = dispatch_ != nullptr ? scheduled_generation_ != dispatch_->generation() : handlersChanged();
+	if (schedule_valid_ && !changed)
+		return;
+
+	scheduler_.rebuild(handlers_);
+	if (dispatch_ != nullptr)
+	{
+		scheduled_generation_ = dispatch_->generation();
+	}
+	else
+	{
+		scheduled_count_ = 0;
+		for(const auto &handler : handlers_)
+		{
+			scheduled_tasks_[scheduled_count_++] = handler.task.get();
+		}
 	}
+	schedule_valid_ = true;
 }
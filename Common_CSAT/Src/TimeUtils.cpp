@@ -287,14 +287,21 @@ namespace TimeUtils
     float midnight = floorf(jd2000) + 0.5f;
     float days_since_midnight = jd2000 - midnight;
 
+    return gsTimeJ2000(midnight, days_since_midnight);
+  }
+
+  float gsTimeJ2000(float midnight, float days_since_midnight)
+  {
     float hours_since_midnight = days_since_midnight * 24.0f;
-    float days_since_epoch = jd2000;
+    float days_since_epoch = midnight + days_since_midnight;
     float centuries_since_epoch = days_since_epoch / 36525.0f;
-    float whole_days_since_epoch = jd2000;
-    whole_days_since_epoch = midnight;
+    float whole_days_since_epoch = midnight;
 
     // https://astronomy.stackexchange.com/questions/21002/how-to-find-greenwich-mean-sideral-time
-    float GMST = 6.697374558f + 0.06570982441908f * whole_days_since_epoch + 1.00273790935f * hours_since_midnight + 0.000026f * centuries_since_epoch * centuries_since_epoch;
+    // the day term is reduced on its own (in double, in float it is off by up
+    // to 0.1 s), so the sum keeps the resolution of the time of day
+    float day_term = static_cast<float>(std::fmod(6.697374558 + 0.06570982441908 * static_cast<double>(whole_days_since_epoch), 24.0));
+    float GMST = day_term + 1.00273790935f * hours_since_midnight + 0.000026f * centuries_since_epoch * centuries_since_epoch;
 
     // https://aa.usno.navy.mil/faq/GAST
     // float GMST = 6.697375f + 0.065707485828f * whole_days_since_epoch + 1.0027379f * hours_since_midnight + 0.0000258f * centuries_since_epoch * centuries_since_epoch;
@@ -1,6 +1,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <limits>
+#include <chrono>
 #include <iostream>
 #include "coordinate_transformations.hpp"
 #include <numbers>
@@ -276,16 +277,13 @@ namespace coordinate_transformations
         return temp;
     } // end gstime
 
-    void teme2ecef(const float rteme[3], float jd2000, float recef[3])
+    // gmst in radians, jd2000 only for the polar motion
+    static void teme2ecef(const float rteme[3], float gmst, float jd2000, float recef[3])
     {
         float st[3][3];
         float rpef[3];
         float pm[3][3];
 
-        // Get Greenwich mean sidereal time
-        float gmst = TimeUtils::hoursToRadians(TimeUtils::gsTimeJ2000(jd2000));
-        // float gmst = gsTimeJD(jd2000);
-
         // st is the pef - tod matrix
         st[0][0] = cosf(gmst);
         st[0][1] = -sinf(gmst);
@@ -312,6 +310,27 @@ namespace coordinate_transformations
         recef[2] = pm[0][2] * rpef[0] + pm[1][2] * rpef[1] + pm[2][2] * rpef[2];
     }
 
+    void teme2ecef(const float rteme[3], float jd2000, float recef[3])
+    {
+        // Get Greenwich mean sidereal time
+        float gmst = TimeUtils::hoursToRadians(TimeUtils::gsTimeJ2000(jd2000));
+        // float gmst = gsTimeJD(jd2000);
+        teme2ecef(rteme, gmst, jd2000, recef);
+    }
+
+    static void teme2ecef(const float rteme[3], std::chrono::system_clock::time_point when, float recef[3])
+    {
+        // J2000 date split into the preceding midnight (0h UT) and the days since
+        constexpr std::chrono::sys_days j2000_midnight{std::chrono::year{2000} / 1 / 1};
+        const auto since = when - j2000_midnight;
+        const std::chrono::days whole = std::chrono::floor<std::chrono::days>(since);
+        const float midnight = static_cast<float>(whole.count()) - 0.5f;
+        const float days_since_midnight = std::chrono::duration<float, std::ratio<86400>>(since - whole).count();
+
+        float gmst = TimeUtils::hoursToRadians(TimeUtils::gsTimeJ2000(midnight, days_since_midnight));
+        teme2ecef(rteme, gmst, midnight + days_since_midnight, recef);
+    }
+
     ECEF temeToECEF(TEME teme, float jd2000)
     {
         ECEF ecef;
@@ -363,6 +382,42 @@ namespace coordinate_transformations
         };    
     }
 
+    std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>,3> temeToecef(std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>,3> teme, std::chrono::system_clock::time_point when)
+    {
+        float rteme[3] = {
+            teme[0].in(au::kilo(au::meters * au::temes)),
+            teme[1].in(au::kilo(au::meters * au::temes)),
+            teme[2].in(au::kilo(au::meters * au::temes))
+        };
+
+        float recef[3];
+        teme2ecef(rteme, when, recef);
+
+        return std::array<au::QuantityF<au::Kilo<au::MetersInEcefFrame>>,3> {
+            au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(recef[0]),
+            au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(recef[1]),
+            au::make_quantity<au::Kilo<au::MetersInEcefFrame>>(recef[2])
+        };
+    }
+
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>,3> temeToecef(std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>,3> teme, std::chrono::system_clock::time_point when)
+    {
+        float rteme[3] = {
+            teme[0].in(au::kilo(au::meters * au::temes / au::seconds)),
+            teme[1].in(au::kilo(au::meters * au::temes / au::seconds)),
+            teme[2].in(au::kilo(au::meters * au::temes / au::seconds))
+        };
+
+        float recef[3];
+        teme2ecef(rteme, when, recef);
+
+        return std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInEcefFrame>>,3> {
+            au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(recef[0]),
+            au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(recef[1]),
+            au::make_quantity<au::Kilo<au::MetersPerSecondInEcefFrame>>(recef[2])
+        };
+    }
+
     void ecef2teme(const float recef[3], float jd2000, float rteme[3])
     {
         float st[3][3];
@@ -20,10 +20,32 @@ extern uint32_t current_tick;
 uint32_t current_free_mailboxes = 3;        // Number of free CAN mailboxes
 uint32_t current_rx_fifo_fill_level = 0;   // Fill level of CAN RX FIFO
 
+//--- Mailbox Model ---
+static bool can_mailbox_model = false;
+static uint32_t can_mailbox_busy = 0;                      // bit n set: mailbox n holds a frame
+static uint32_t can_mailbox_id[CAN_TX_MAILBOX_COUNT];     // identifier waiting in each mailbox
+static void *can_mailbox_hcan = NULL;                      // handle passed to the completion callbacks
 
-uint32_t HAL_CAN_AddTxMessage(void */*hcan*/, CAN_TxHeaderTypeDef *pHeader, uint8_t aData[], uint32_t *pTxMailbox)
+static uint32_t count_busy_mailboxes()
+{
+    uint32_t count = 0;
+    for (int i = 0; i < CAN_TX_MAILBOX_COUNT; ++i)
+        if (can_mailbox_busy & (1U << i)) ++count;
+    return count;
+}
+
+
+uint32_t HAL_CAN_AddTxMessage(void *hcan, CAN_TxHeaderTypeDef *pHeader, uint8_t aData[], uint32_t *pTxMailbox)
 {
     if (pHeader == NULL) return 1; //HAL_ERROR
+
+    int mailbox_index = 0;
+    if (can_mailbox_model) {
+        while (mailbox_index < CAN_TX_MAILBOX_COUNT && (can_mailbox_busy & (1U << mailbox_index)))
+            ++mailbox_index;
+        if (mailbox_index == CAN_TX_MAILBOX_COUNT) return 1; // HAL_ERROR, no free mailbox
+    }
+
     if (can_tx_buffer_count < CAN_TX_BUFFER_SIZE) {
         can_tx_buffer[can_tx_buffer_count].TxHeader = *pHeader;
 
@@ -36,6 +58,13 @@ uint32_t HAL_CAN_AddTxMessage(void */*hcan*/, CAN_TxHeaderTypeDef *pHeader, uint
 
         can_tx_buffer[can_tx_buffer_count].Mailbox = 0; // Mock mailbox
         *pTxMailbox = 0;
+        if (can_mailbox_model) {
+            can_mailbox_busy |= 1U << mailbox_index;
+            can_mailbox_id[mailbox_index] = (pHeader->IDE == CAN_ID_EXT) ? pHeader->ExtId : pHeader->StdId;
+            can_mailbox_hcan = hcan;
+            can_tx_buffer[can_tx_buffer_count].Mailbox = CAN_TX_MAILBOX0 << mailbox_index;
+            *pTxMailbox = CAN_TX_MAILBOX0 << mailbox_index;
+        }
         can_tx_buffer_count++;
         return 0; // HAL_OK
     }
@@ -70,6 +99,8 @@ uint32_t HAL_CAN_GetRxMessage(void *hcan, uint32_t /*Fifo*/, CAN_RxHeaderTypeDef
 
 
 uint32_t HAL_CAN_GetTxMailboxesFreeLevel(void */*hcan*/) {
+    if (can_mailbox_model)
+        return CAN_TX_MAILBOX_COUNT - count_busy_mailboxes();
     return current_free_mailboxes;
 }
 
@@ -184,5 +215,60 @@ HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32
     return 0; // HAL_OK
 }
 
+uint32_t get_can_enabled_interrupts()
+{
+    return mock_can_enabled_interrupts;
+}
+
+// ----- Mailbox Completion Model -----
+
+void enable_can_mailbox_model(bool enable)
+{
+    can_mailbox_model = enable;
+    can_mailbox_busy = 0;
+    can_mailbox_hcan = NULL;
+    memset(can_mailbox_id, 0, sizeof(can_mailbox_id));
+}
+
+uint32_t get_can_busy_mailboxes()
+{
+    return count_busy_mailboxes();
+}
+
+int complete_can_tx_mailbox()
+{
+    // bxCAN transmits the pending mailbox with the lowest identifier first
+    int mailbox_index = -1;
+    for (int i = 0; i < CAN_TX_MAILBOX_COUNT; ++i) {
+        if ((can_mailbox_busy & (1U << i)) && (mailbox_index < 0 || can_mailbox_id[i] < can_mailbox_id[mailbox_index]))
+            mailbox_index = i;
+    }
+    if (mailbox_index < 0)
+        return -1;
+
+    can_mailbox_busy &= ~(1U << mailbox_index);
+    if (mock_can_enabled_interrupts & CAN_IT_TX_MAILBOX_EMPTY) {
+        CAN_HandleTypeDef *hcan = (CAN_HandleTypeDef *)can_mailbox_hcan;
+        switch (mailbox_index) {
+        case 0: HAL_CAN_TxMailbox0CompleteCallback(hcan); break;
+        case 1: HAL_CAN_TxMailbox1CompleteCallback(hcan); break;
+        default: HAL_CAN_TxMailbox2CompleteCallback(hcan); break;
+        }
+    }
+    return mailbox_index;
+}
+
+int complete_can_tx_mailboxes(int count)
+{
+    int completed = 0;
+    while (completed < count && complete_can_tx_mailbox() >= 0)
+        ++completed;
+    return completed;
+}
+
+__attribute__((weak)) void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef */*hcan*/) {}
+__attribute__((weak)) void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef */*hcan*/) {}
+__attribute__((weak)) void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef */*hcan*/) {}
+
 
 #endif
\ No newline at end of file
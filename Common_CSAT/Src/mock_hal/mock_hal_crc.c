@@ -0,0 +1,82 @@
+#ifdef __x86_64__
+
+#include "mock_hal/mock_hal_crc.h"
+#include <stddef.h>
+
+// Bit-serial model of the STM32L4 CRC unit (32-bit polynomial, byte input)
+
+CRC_TypeDef mock_crc_peripheral = {0, 0, 0, DEFAULT_CRC_INITVALUE, DEFAULT_CRC32_POLY};
+static uint32_t crc_bytes_processed = 0;
+
+static uint8_t reverse_byte(uint8_t value)
+{
+    uint8_t result = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        result = (uint8_t)((result << 1) | (value & 1U));
+        value = (uint8_t)(value >> 1);
+    }
+    return result;
+}
+
+static uint32_t reverse_word(uint32_t value)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < 32; ++i)
+    {
+        result = (result << 1) | (value & 1U);
+        value >>= 1;
+    }
+    return result;
+}
+
+static uint32_t crc_output(const CRC_HandleTypeDef *hcrc)
+{
+    return (hcrc->Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE) ? reverse_word(hcrc->Instance->DR) : hcrc->Instance->DR;
+}
+
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
+{
+    if (hcrc == NULL) return HAL_ERROR;
+    if (hcrc->Instance == NULL) hcrc->Instance = CRC;
+
+    hcrc->Instance->POL = (hcrc->Init.DefaultPolynomialUse == DEFAULT_POLYNOMIAL_ENABLE) ? DEFAULT_CRC32_POLY : hcrc->Init.GeneratingPolynomial;
+    hcrc->Instance->INIT = (hcrc->Init.DefaultInitValueUse == DEFAULT_INIT_VALUE_ENABLE) ? DEFAULT_CRC_INITVALUE : hcrc->Init.InitValue;
+    hcrc->Instance->CR = hcrc->Init.InputDataInversionMode | hcrc->Init.OutputDataInversionMode;
+    __HAL_CRC_DR_RESET(hcrc);
+    return HAL_OK;
+}
+
+uint32_t HAL_CRC_Accumulate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    const uint8_t *data = (const uint8_t *)pBuffer;
+    uint32_t crc = hcrc->Instance->DR;
+    for (uint32_t i = 0; i < BufferLength; ++i)
+    {
+        uint8_t byte = (hcrc->Init.InputDataInversionMode == CRC_INPUTDATA_INVERSION_NONE) ? data[i] : reverse_byte(data[i]);
+        crc ^= (uint32_t)byte << 24;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc & 0x80000000U) ? (crc << 1) ^ hcrc->Instance->POL : (crc << 1);
+    }
+    hcrc->Instance->DR = crc;
+    crc_bytes_processed += BufferLength;
+    return crc_output(hcrc);
+}
+
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+    __HAL_CRC_DR_RESET(hcrc);
+    return HAL_CRC_Accumulate(hcrc, pBuffer, BufferLength);
+}
+
+uint32_t get_crc_bytes_processed()
+{
+    return crc_bytes_processed;
+}
+
+void reset_crc_bytes_processed()
+{
+    crc_bytes_processed = 0;
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifdef __x86_64__
 
 #include "mock_hal/mock_hal_dcmi.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 //--- DCMI Buffers ---
@@ -73,4 +75,209 @@ uint8_t* get_dcmi_frame_buffer(DCMI_HandleTypeDef *hdcmi) {
     return NULL;
 }
 
-#endif
\ No newline at end of file
+//------------------------------------------------------------------------------
+//  Register level DCMI + DMA2 Channel 6 model
+//------------------------------------------------------------------------------
+
+DCMI_TypeDef mock_dcmi_registers;
+DMA_TypeDef mock_dma2_registers;
+DMA_Channel_TypeDef mock_dma2_channel6_registers;
+
+static uint8_t *replay_data = NULL;
+static size_t replay_size = 0;
+static size_t replay_pos = 0;
+static uint32_t replay_rate = 0;
+static uint32_t frames_completed = 0;
+
+static MockIrqHandler dma_handler = NULL;
+static MockIrqHandler dcmi_handler = NULL;
+
+// CNDTR / CMAR latched when the channel gets enabled, reused on circular reload
+static bool channel_armed = false;
+static uint32_t channel_reload = 0;
+static uintptr_t channel_base = 0;
+// capture restarts wait for the next VSYNC, i.e. the start of the stream
+static bool was_capturing = false;
+
+static void apply_clears(void)
+{
+    if (DMA2->IFCR != 0)
+    {
+        DMA2->ISR &= ~DMA2->IFCR;
+        if ((DMA2->ISR & (DMA_ISR_TCIF6 | DMA_ISR_HTIF6 | DMA_ISR_TEIF6)) == 0)
+            DMA2->ISR &= ~DMA_ISR_GIF6;
+        DMA2->IFCR = 0;
+    }
+    if (DCMI->ICR != 0)
+    {
+        DCMI->RISR &= ~DCMI->ICR;
+        DCMI->ICR = 0;
+    }
+    DCMI->MISR = DCMI->RISR & DCMI->IER;
+}
+
+static void raise_dma(uint32_t flag, uint32_t enable)
+{
+    DMA2->ISR |= flag | DMA_ISR_GIF6;
+    if ((DMA2_Channel6->CCR & enable) != 0 && dma_handler != NULL)
+        dma_handler();
+    apply_clears();
+}
+
+static void raise_dcmi(uint32_t flag)
+{
+    DCMI->RISR |= flag;
+    DCMI->MISR = DCMI->RISR & DCMI->IER;
+    if ((DCMI->MISR & flag) != 0 && dcmi_handler != NULL)
+        dcmi_handler();
+    apply_clears();
+}
+
+static void sync_channel(void)
+{
+    const bool enabled = (DMA2_Channel6->CCR & DMA_CCR_EN) != 0;
+    if (enabled && !channel_armed)
+    {
+        channel_reload = DMA2_Channel6->CNDTR;
+        channel_base = DMA2_Channel6->CMAR;
+    }
+    channel_armed = enabled;
+}
+
+void mock_dcmi_reset(void)
+{
+    free(replay_data);
+    replay_data = NULL;
+    replay_size = 0;
+    replay_pos = 0;
+    replay_rate = 0;
+    frames_completed = 0;
+    dma_handler = NULL;
+    dcmi_handler = NULL;
+    channel_armed = false;
+    channel_reload = 0;
+    channel_base = 0;
+    was_capturing = false;
+    memset(&mock_dcmi_registers, 0, sizeof(mock_dcmi_registers));
+    memset(&mock_dma2_registers, 0, sizeof(mock_dma2_registers));
+    memset(&mock_dma2_channel6_registers, 0, sizeof(mock_dma2_channel6_registers));
+}
+
+void mock_dcmi_load(const uint8_t *data, size_t size)
+{
+    free(replay_data);
+    replay_data = (uint8_t *)malloc(size > 0 ? size : 1);
+    if (replay_data != NULL && size > 0)
+        memcpy(replay_data, data, size);
+    replay_size = replay_data != NULL ? size : 0;
+    replay_pos = 0;
+}
+
+bool mock_dcmi_load_file(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+    {
+        uint8_t *grown = (uint8_t *)realloc(data, size + n);
+        if (grown == NULL)
+        {
+            free(data);
+            fclose(f);
+            return false;
+        }
+        data = grown;
+        memcpy(data + size, chunk, n);
+        size += n;
+    }
+    fclose(f);
+
+    mock_dcmi_load(data, size);
+    free(data);
+    return size > 0;
+}
+
+void mock_dcmi_set_rate(uint32_t words_per_tick)
+{
+    replay_rate = words_per_tick;
+}
+
+void mock_dcmi_set_irq_handlers(MockIrqHandler dma2_channel6, MockIrqHandler dcmi)
+{
+    dma_handler = dma2_channel6;
+    dcmi_handler = dcmi;
+}
+
+uint32_t mock_dcmi_transfer(uint32_t words)
+{
+    uint32_t moved = 0;
+    while (moved < words)
+    {
+        sync_channel();
+        if ((DCMI->CR & DCMI_CR_ENABLE) == 0 || (DCMI->CR & DCMI_CR_CAPTURE) == 0 || replay_size == 0)
+        {
+            was_capturing = false;
+            break;
+        }
+        if (!was_capturing)
+            replay_pos = 0;
+        was_capturing = true;
+
+        if (!channel_armed || DMA2_Channel6->CNDTR == 0)
+        {
+            // the sensor keeps clocking data nobody takes
+            raise_dcmi(DCMI_RIS_OVR_RIS);
+            break;
+        }
+
+        // bytes are packed little endian, the last word of a frame zero padded
+        uint32_t word = 0;
+        for (uint32_t b = 0; b < 4 && replay_pos < replay_size; ++b)
+            word |= (uint32_t)replay_data[replay_pos++] << (8 * b);
+        DCMI->DR = word;
+
+        const uint32_t index = channel_reload - DMA2_Channel6->CNDTR;
+        ((uint32_t *)channel_base)[index] = word;
+        DMA2_Channel6->CNDTR--;
+        ++moved;
+
+        if (channel_reload - DMA2_Channel6->CNDTR == channel_reload / 2)
+            raise_dma(DMA_ISR_HTIF6, DMA_CCR_HTIE);
+        if (DMA2_Channel6->CNDTR == 0)
+        {
+            if ((DMA2_Channel6->CCR & DMA_CCR_CIRC) != 0)
+                DMA2_Channel6->CNDTR = channel_reload;
+            raise_dma(DMA_ISR_TCIF6, DMA_CCR_TCIE);
+        }
+
+        if (replay_pos >= replay_size)
+        {
+            // VSYNC: frame end; snapshot mode stops, continuous replays again
+            replay_pos = 0;
+            ++frames_completed;
+            if ((DCMI->CR & DCMI_CR_CM) == 0)
+                DCMI->CR &= ~DCMI_CR_CAPTURE;
+            raise_dcmi(DCMI_RIS_FRAME_RIS);
+        }
+    }
+    return moved;
+}
+
+void mock_dcmi_tick(void)
+{
+    if (replay_rate > 0)
+        (void)mock_dcmi_transfer(replay_rate);
+}
+
+uint32_t mock_dcmi_frames_completed(void)
+{
+    return frames_completed;
+}
+
+#endif
@@ -13,6 +13,9 @@ uint16_t i2c_tx_buffer_count = 0;           // Number of bytes in I2C TX buffer
 uint16_t i2c_mem_buffer_dev_address; // I2C device address
 uint16_t i2c_mem_buffer_mem_address; // I2C memory address
 
+uint32_t i2c_mem_write_count = 0;     // Mem_Write + Mem_Write_DMA calls
+uint32_t i2c_mem_write_dma_count = 0; // Mem_Write_DMA calls
+
 uint32_t HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t /*Timeout*/)
 {
     if (hi2c == NULL || pData == NULL)
@@ -84,9 +87,34 @@ uint32_t HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_
 
     i2c_tx_buffer_count = Size;
     memcpy(i2c_tx_buffer, pData, Size);
+    ++i2c_mem_write_count;
     return 0;
 }
 
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+    if (Size > I2C_MEM_BUFFER_SIZE)
+    {
+        return HAL_ERROR;
+    }
+    if (HAL_I2C_Mem_Write(hi2c, DevAddress, MemAddress, MemAddSize, pData, Size, 0) != 0)
+    {
+        return HAL_ERROR;
+    }
+    ++i2c_mem_write_dma_count;
+    return HAL_OK;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef * /*hi2c*/)
+{
+    return HAL_I2C_STATE_READY;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef * /*hi2c*/)
+{
+    return HAL_I2C_ERROR_NONE;
+}
+
 // I2C Injectors
 void inject_i2c_tx_data(uint16_t DevAddress, const uint8_t *data, uint16_t size)
 {
@@ -151,4 +179,20 @@ uint16_t get_i2c_mem_address()
     return i2c_mem_buffer_mem_address;
 }
 
+uint32_t get_i2c_mem_write_count()
+{
+    return i2c_mem_write_count;
+}
+
+uint32_t get_i2c_mem_write_dma_count()
+{
+    return i2c_mem_write_dma_count;
+}
+
+void clear_i2c_mem_write_count()
+{
+    i2c_mem_write_count = 0;
+    i2c_mem_write_dma_count = 0;
+}
+
 #endif
\ No newline at end of file
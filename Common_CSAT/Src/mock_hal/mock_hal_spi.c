@@ -1,6 +1,7 @@
 #ifdef __x86_64__
 
 #include "mock_hal/mock_hal_spi.h"
+#include "mock_hal/mock_hal_spi_nand.h"
 #include <cstring>
 #include <string.h>
 #include <stdio.h> //For printf
@@ -13,8 +14,9 @@ uint8_t spi_rx_buffer[SPI_RX_BUFFER_SIZE];   // SPI receive buffer
 size_t spi_rx_buffer_count = 0;                  // Number of bytes in SPI RX buffer
 size_t spi_rx_buffer_read_pos = 0;               // Read position in SPI RX buffer
 
-uint32_t HAL_SPI_Transmit(SPI_HandleTypeDef */*hspi*/, uint8_t *pData, uint16_t Size, uint32_t /*Timeout*/) {
+uint32_t HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t /*Timeout*/) {
     if (!pData) return 1; // HAL_ERROR
+    if (spi_nand_is_attached(hspi)) return spi_nand_transmit(pData, Size);
     if (spi_tx_buffer_count + Size <= SPI_TX_BUFFER_SIZE) {
         std::memcpy(spi_tx_buffer + spi_tx_buffer_count, pData, Size);
         spi_tx_buffer_count += Size;
@@ -23,8 +25,9 @@ uint32_t HAL_SPI_Transmit(SPI_HandleTypeDef */*hspi*/, uint8_t *pData, uint16_t
     return 1; // HAL_ERROR, buffer overflow
 }
 
-uint32_t HAL_SPI_Receive(SPI_HandleTypeDef */*hspi*/, uint8_t *pData, uint16_t Size, uint32_t /*Timeout*/) {
+uint32_t HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t /*Timeout*/) {
    if (!pData) return 1; // HAL_ERROR
+   if (spi_nand_is_attached(hspi)) return spi_nand_receive(pData, Size);
 
     //Copy injected rx data into provided buffer
     if (spi_rx_buffer_count > 0) {
@@ -43,8 +46,9 @@ uint32_t HAL_SPI_Receive(SPI_HandleTypeDef */*hspi*/, uint8_t *pData, uint16_t S
 }
 
 
-uint32_t HAL_SPI_TransmitReceive(SPI_HandleTypeDef */*hspi*/, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t /*Timeout*/) {
+uint32_t HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData, uint8_t *pRxData, uint16_t Size, uint32_t /*Timeout*/) {
    if (!pTxData || !pRxData) return 1; // HAL_ERROR
+   if (spi_nand_is_attached(hspi)) return spi_nand_receive(pRxData, Size);
 
     //Transmit part
     if (spi_tx_buffer_count + Size <= SPI_TX_BUFFER_SIZE) {
@@ -0,0 +1,291 @@
+#ifdef __x86_64__
+
+#include "mock_hal/mock_hal_spi_nand.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Command opcodes and status bits as in the MT29F4G01 datasheet
+#define NAND_RESET                 0xFF
+#define NAND_GET_FEATURE           0x0F
+#define NAND_SET_FEATURE           0x1F
+#define NAND_WRITE_ENABLE          0x06
+#define NAND_WRITE_DISABLE         0x04
+#define NAND_PAGE_READ             0x13
+#define NAND_PAGE_READ_CACHE_SEQ   0x31
+#define NAND_PAGE_READ_CACHE_LAST  0x3F
+#define NAND_READ_FROM_CACHE       0x03
+#define NAND_READ_FROM_CACHE_FAST  0x0B
+#define NAND_PROGRAM_LOAD          0x02
+#define NAND_PROGRAM_LOAD_RANDOM   0x84
+#define NAND_PROGRAM_EXECUTE       0x10
+#define NAND_BLOCK_ERASE           0xD8
+
+#define NAND_FEATURE_STATUS        0xC0
+#define NAND_STATUS_P_FAIL         0x08
+#define NAND_STATUS_E_FAIL         0x04
+#define NAND_STATUS_WEL            0x02
+
+typedef enum {
+    NAND_PENDING_NONE,
+    NAND_PENDING_READ_CACHE,
+    NAND_PENDING_FEATURE,
+    NAND_PENDING_PROGRAM_DATA
+} NandPending;
+
+static SPI_HandleTypeDef *nand_hspi = NULL;
+static uint8_t *nand_array = NULL;
+static uint32_t nand_rows = 0;
+static uint32_t nand_blocks = 0;
+static bool *nand_failing = NULL;       // per block, program/erase report failure
+static bool nand_garble_failed = false; // failed programs leave zeros instead of the data
+static uint32_t *nand_erase_counts = NULL;
+
+static uint8_t nand_cache[SPI_NAND_PAGE_TOTAL_SIZE];
+static uint32_t nand_data_register_row = 0;
+static uint8_t nand_status = 0;
+static uint8_t nand_features[256];
+static NandPending nand_pending = NAND_PENDING_NONE;
+static uint32_t nand_column = 0;
+static uint8_t nand_feature_address = 0;
+static SpiNandCounters nand_counters;
+
+static uint32_t row_address(const uint8_t *pData)
+{
+    return ((uint32_t)pData[1] << 16) | ((uint32_t)pData[2] << 8) | (uint32_t)pData[3];
+}
+
+static void load_cache(uint32_t row)
+{
+    uint8_t *page = get_spi_nand_page(row);
+    if (page)
+        memcpy(nand_cache, page, SPI_NAND_PAGE_TOTAL_SIZE);
+    else
+        memset(nand_cache, 0xFF, SPI_NAND_PAGE_TOTAL_SIZE);
+}
+
+static bool block_failing(uint32_t row)
+{
+    uint32_t block = row / SPI_NAND_PAGES_PER_BLOCK;
+    return block < nand_blocks && nand_failing[block];
+}
+
+static void load_program_data(const uint8_t *pData, size_t size)
+{
+    for (size_t i = 0; i < size && nand_column + i < SPI_NAND_PAGE_TOTAL_SIZE; ++i)
+        nand_cache[nand_column + i] = pData[i];
+}
+
+void spi_nand_attach(SPI_HandleTypeDef *hspi, uint32_t num_blocks)
+{
+    spi_nand_detach();
+    nand_blocks = num_blocks;
+    nand_rows = num_blocks * SPI_NAND_PAGES_PER_BLOCK;
+    nand_array = (uint8_t *)malloc((size_t)nand_rows * SPI_NAND_PAGE_TOTAL_SIZE);
+    if (nand_array)
+        memset(nand_array, 0xFF, (size_t)nand_rows * SPI_NAND_PAGE_TOTAL_SIZE);
+    nand_failing = (bool *)calloc(num_blocks, sizeof(bool));
+    nand_erase_counts = (uint32_t *)calloc(num_blocks, sizeof(uint32_t));
+    nand_hspi = hspi;
+    nand_garble_failed = false;
+    nand_status = 0;
+    nand_pending = NAND_PENDING_NONE;
+    memset(nand_features, 0, sizeof(nand_features));
+    memset(nand_cache, 0xFF, sizeof(nand_cache));
+    reset_spi_nand_counters();
+}
+
+void spi_nand_detach()
+{
+    free(nand_array);
+    free(nand_failing);
+    free(nand_erase_counts);
+    nand_array = NULL;
+    nand_failing = NULL;
+    nand_erase_counts = NULL;
+    nand_rows = 0;
+    nand_blocks = 0;
+    nand_hspi = NULL;
+}
+
+bool spi_nand_is_attached(const SPI_HandleTypeDef *hspi)
+{
+    return nand_hspi != NULL && hspi == nand_hspi;
+}
+
+HAL_StatusTypeDef spi_nand_transmit(const uint8_t *pData, uint16_t Size)
+{
+    if (!pData || Size == 0) return HAL_ERROR;
+
+    if (nand_pending == NAND_PENDING_PROGRAM_DATA)
+    {
+        load_program_data(pData, Size);
+        nand_pending = NAND_PENDING_NONE;
+        return HAL_OK;
+    }
+    nand_pending = NAND_PENDING_NONE;
+
+    switch (pData[0])
+    {
+    case NAND_RESET:
+        nand_status = 0;
+        break;
+    case NAND_WRITE_ENABLE:
+        nand_status |= NAND_STATUS_WEL;
+        break;
+    case NAND_WRITE_DISABLE:
+        nand_status &= (uint8_t)~NAND_STATUS_WEL;
+        break;
+    case NAND_GET_FEATURE:
+        if (Size < 2) return HAL_ERROR;
+        ++nand_counters.get_feature;
+        nand_feature_address = pData[1];
+        nand_pending = NAND_PENDING_FEATURE;
+        break;
+    case NAND_SET_FEATURE:
+        if (Size < 3) return HAL_ERROR;
+        if (pData[1] != NAND_FEATURE_STATUS)
+            nand_features[pData[1]] = pData[2];
+        break;
+    case NAND_PAGE_READ:
+        if (Size < 4) return HAL_ERROR;
+        ++nand_counters.page_read;
+        nand_data_register_row = row_address(pData);
+        load_cache(nand_data_register_row);
+        break;
+    case NAND_PAGE_READ_CACHE_SEQ:
+        // data register goes to the cache, the next page starts loading
+        ++nand_counters.cache_read_sequential;
+        load_cache(nand_data_register_row);
+        ++nand_data_register_row;
+        break;
+    case NAND_PAGE_READ_CACHE_LAST:
+        ++nand_counters.cache_read_last;
+        load_cache(nand_data_register_row);
+        break;
+    case NAND_READ_FROM_CACHE:
+    case NAND_READ_FROM_CACHE_FAST:
+        if (Size < 3) return HAL_ERROR;
+        ++nand_counters.read_from_cache;
+        nand_column = (((uint32_t)pData[1] << 8) | pData[2]) & 0x1FFFU;
+        nand_pending = NAND_PENDING_READ_CACHE;
+        break;
+    case NAND_PROGRAM_LOAD:
+    case NAND_PROGRAM_LOAD_RANDOM:
+        if (Size < 3) return HAL_ERROR;
+        ++nand_counters.program_load;
+        if (pData[0] == NAND_PROGRAM_LOAD)
+            memset(nand_cache, 0xFF, sizeof(nand_cache));
+        nand_column = (((uint32_t)pData[1] << 8) | pData[2]) & 0x1FFFU;
+        if (Size > 3)
+            load_program_data(pData + 3, (size_t)Size - 3);
+        else
+            nand_pending = NAND_PENDING_PROGRAM_DATA;
+        break;
+    case NAND_PROGRAM_EXECUTE:
+        if (Size < 4) return HAL_ERROR;
+        if (!(nand_status & NAND_STATUS_WEL)) break; // ignored without WRITE ENABLE
+        ++nand_counters.program_execute;
+        nand_status &= (uint8_t)~(NAND_STATUS_WEL | NAND_STATUS_P_FAIL);
+        {
+            // a failing block still takes the bits, like a page that did not verify,
+            // unless failed programs are set to garble the page
+            uint8_t *page = get_spi_nand_page(row_address(pData));
+            bool garble = nand_garble_failed && block_failing(row_address(pData));
+            if (page)
+            {
+                for (size_t i = 0; i < SPI_NAND_PAGE_TOTAL_SIZE; ++i)
+                    page[i] &= garble ? 0x00 : nand_cache[i];
+            }
+            if (!page || block_failing(row_address(pData)))
+                nand_status |= NAND_STATUS_P_FAIL;
+        }
+        break;
+    case NAND_BLOCK_ERASE:
+        if (Size < 4) return HAL_ERROR;
+        if (!(nand_status & NAND_STATUS_WEL)) break;
+        ++nand_counters.block_erase;
+        nand_status &= (uint8_t)~(NAND_STATUS_WEL | NAND_STATUS_E_FAIL);
+        {
+            uint32_t first_row = row_address(pData) / SPI_NAND_PAGES_PER_BLOCK * SPI_NAND_PAGES_PER_BLOCK;
+            uint8_t *page = get_spi_nand_page(first_row);
+            if (page && !block_failing(first_row))
+            {
+                memset(page, 0xFF, (size_t)SPI_NAND_PAGES_PER_BLOCK * SPI_NAND_PAGE_TOTAL_SIZE);
+                ++nand_erase_counts[first_row / SPI_NAND_PAGES_PER_BLOCK];
+            }
+            else
+                nand_status |= NAND_STATUS_E_FAIL;
+        }
+        break;
+    default:
+        break;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef spi_nand_receive(uint8_t *pData, uint16_t Size)
+{
+    if (!pData) return HAL_ERROR;
+
+    switch (nand_pending)
+    {
+    case NAND_PENDING_READ_CACHE:
+        for (size_t i = 0; i < Size; ++i)
+            pData[i] = (nand_column + i < SPI_NAND_PAGE_TOTAL_SIZE) ? nand_cache[nand_column + i] : 0xFF;
+        break;
+    case NAND_PENDING_FEATURE:
+        memset(pData, 0, Size);
+        if (Size > 0)
+            pData[0] = (nand_feature_address == NAND_FEATURE_STATUS) ? nand_status : nand_features[nand_feature_address];
+        break;
+    default:
+        memset(pData, 0xFF, Size);
+        break;
+    }
+    nand_pending = NAND_PENDING_NONE;
+    return HAL_OK;
+}
+
+SpiNandCounters get_spi_nand_counters()
+{
+    return nand_counters;
+}
+
+void reset_spi_nand_counters()
+{
+    memset(&nand_counters, 0, sizeof(nand_counters));
+}
+
+uint8_t *get_spi_nand_page(uint32_t row)
+{
+    if (!nand_array || row >= nand_rows)
+        return NULL;
+    return nand_array + (size_t)row * SPI_NAND_PAGE_TOTAL_SIZE;
+}
+
+void spi_nand_mark_factory_bad(uint32_t block)
+{
+    uint8_t *page = get_spi_nand_page(block * SPI_NAND_PAGES_PER_BLOCK);
+    if (!page)
+        return;
+    page[SPI_NAND_PAGE_SIZE] = 0x00; // bad block marker, first spare byte of page 0
+    nand_failing[block] = true;
+}
+
+void spi_nand_fail_block(uint32_t block, bool failing)
+{
+    if (block < nand_blocks)
+        nand_failing[block] = failing;
+}
+
+void spi_nand_garble_failed_programs(bool garble)
+{
+    nand_garble_failed = garble;
+}
+
+uint32_t get_spi_nand_erase_count(uint32_t block)
+{
+    return (block < nand_blocks) ? nand_erase_counts[block] : 0;
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifdef __x86_64__
 
 #include "mock_hal/mock_hal_time.h"
+#include "mock_hal/mock_hal_dcmi.h"
 
 //------------------------------------------------------------------------------
 //  GLOBAL MOCKED VARIABLES - State
@@ -66,6 +67,7 @@ void HAL_IncTick(void)
     {
         current_tick++; // increment global system tick counter
         SysTick->VAL = SysTick->LOAD; //Reset to LOAD value AFTER incrementing HAL_GetTick()
+        mock_dcmi_tick(); // camera data keeps flowing while time passes
     }
 }
 
@@ -0,0 +1,127 @@
+#ifndef BMI270_FIFO_GENERATOR_HPP
+#define BMI270_FIFO_GENERATOR_HPP
+
+// Builds header mode BMI270 FIFO byte streams for the SPI mock
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "BMI270Fifo.hpp"
+#include "MMC5983.hpp"
+
+class BMI270FifoGenerator
+{
+public:
+	using Axes = std::array<int16_t, 3>;
+	using Aux = std::array<uint8_t, BMI270FifoCore::AUX_SIZE>;
+
+	// Regular frame, tag sets the interrupt tag bits 1:0 of the header
+	BMI270FifoGenerator &frame(std::optional<Axes> acc, std::optional<Axes> gyr, std::optional<Aux> aux = std::nullopt, uint8_t tag = 0)
+	{
+		uint8_t header = BMI270FifoCore::HEADER_REGULAR | (tag & 0x03);
+		if (aux)
+			header |= BMI270FifoCore::HEADER_AUX;
+		if (gyr)
+			header |= BMI270FifoCore::HEADER_GYR;
+		if (acc)
+			header |= BMI270FifoCore::HEADER_ACC;
+		fifo(header);
+
+		if (aux)
+			fifo(aux->data(), aux->size());
+		if (gyr)
+			axes(*gyr);
+		if (acc)
+			axes(*acc);
+		return *this;
+	}
+
+	BMI270FifoGenerator &skip(uint8_t frames)
+	{
+		fifo(BMI270FifoCore::HEADER_SKIP);
+		fifo(frames);
+		return *this;
+	}
+
+	BMI270FifoGenerator &inputConfig(uint8_t config_1 = 0xD0)
+	{
+		const uint8_t payload[] = {0x00, config_1, 0x00, 0x00};
+		fifo(BMI270FifoCore::HEADER_INPUT_CONFIG);
+		fifo(payload, sizeof(payload));
+		return *this;
+	}
+
+	// Appended by the sensor once the FIFO runs empty, not part of FIFO_LENGTH
+	BMI270FifoGenerator &sensorTime(uint32_t ticks)
+	{
+		bytes_.push_back(BMI270FifoCore::HEADER_SENSOR_TIME);
+		bytes_.push_back(static_cast<uint8_t>(ticks));
+		bytes_.push_back(static_cast<uint8_t>(ticks >> 8));
+		bytes_.push_back(static_cast<uint8_t>(ticks >> 16));
+		return *this;
+	}
+
+	const std::vector<uint8_t> &bytes() const { return bytes_; }
+	uint16_t length() const { return length_; }
+
+	// SPI answer to the FIFO_LENGTH_0 read: dummy, LSB, MSB
+	std::vector<uint8_t> lengthResponse() const
+	{
+		return {0xFF, static_cast<uint8_t>(length_), static_cast<uint8_t>(length_ >> 8)};
+	}
+
+	// SPI answer to a FIFO_DATA burst of read bytes, padded with the over-read pattern
+	std::vector<uint8_t> dataResponse(size_t read) const
+	{
+		std::vector<uint8_t> rx{0xFF};
+		rx.insert(rx.end(), bytes_.begin(), bytes_.end());
+		for (size_t i = 0; rx.size() < read; ++i)
+			rx.push_back(i % 2 == 0 ? 0x80 : 0x00);
+		rx.resize(read);
+		return rx;
+	}
+
+	// MMC5983 XOUT0..TOUT block for the given signed 18 bit counts
+	static Aux mmc5983(int32_t x, int32_t y, int32_t z, uint8_t temperature = 0)
+	{
+		const uint32_t ux = static_cast<uint32_t>(x + MMC5983Core::NULL_VALUE);
+		const uint32_t uy = static_cast<uint32_t>(y + MMC5983Core::NULL_VALUE);
+		const uint32_t uz = static_cast<uint32_t>(z + MMC5983Core::NULL_VALUE);
+		return {
+			static_cast<uint8_t>(ux >> 10), static_cast<uint8_t>(ux >> 2),
+			static_cast<uint8_t>(uy >> 10), static_cast<uint8_t>(uy >> 2),
+			static_cast<uint8_t>(uz >> 10), static_cast<uint8_t>(uz >> 2),
+			static_cast<uint8_t>((ux & 0x3U) << 6 | (uy & 0x3U) << 4 | (uz & 0x3U) << 2),
+			temperature};
+	}
+
+private:
+	void fifo(uint8_t byte)
+	{
+		bytes_.push_back(byte);
+		++length_;
+	}
+
+	void fifo(const uint8_t *data, size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+			fifo(data[i]);
+	}
+
+	void axes(const Axes &v)
+	{
+		for (int16_t a : v)
+		{
+			fifo(static_cast<uint8_t>(a));
+			fifo(static_cast<uint8_t>(static_cast<uint16_t>(a) >> 8));
+		}
+	}
+
+	std::vector<uint8_t> bytes_;
+	uint16_t length_ = 0;
+};
+
+#endif // BMI270_FIFO_GENERATOR_HPP
@@ -0,0 +1,179 @@
+#ifndef LOG_DECODER_HPP
+#define LOG_DECODER_HPP
+
+// Ground side decoder for the DeferredLog.hpp binary frames
+
+#include <cctype>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DeferredLog.hpp"
+
+struct DecodedLogEntry
+{
+    uint32_t id;
+    uint32_t tick;
+    uint8_t level;
+    std::string text;
+};
+
+class LogDecoder
+{
+public:
+    // Registers a format string, returns its ID
+    uint32_t addFormat(const std::string &format)
+    {
+        const uint32_t id = deferred_log::fnv1a(format.c_str());
+        auto [it, inserted] = formats_.emplace(id, format);
+        if (!inserted && it->second != format)
+            ++collisions_;
+        return id;
+    }
+
+    // Collects the format strings of all LOG_DEFERRED calls in a source file,
+    // adjacent string literals are joined like the compiler does
+    size_t addSource(const std::string &source)
+    {
+        size_t found = 0;
+        const std::string macro = "LOG_DEFERRED(";
+        for (size_t pos = source.find(macro); pos != std::string::npos; pos = source.find(macro, pos + 1))
+        {
+            // part of a longer identifier
+            if (pos > 0 && (std::isalnum(static_cast<unsigned char>(source[pos - 1])) || source[pos - 1] == '_'))
+                continue;
+            size_t i = source.find(',', pos);
+            if (i == std::string::npos)
+                break;
+
+            std::string format;
+            bool literal = false;
+            for (++i; i < source.size(); ++i)
+            {
+                const char c = source[i];
+                if (c == '"')
+                {
+                    literal = true;
+                    i = readLiteral(source, i + 1, format);
+                }
+                else if (c == ',' || c == ')')
+                    break;
+                else if (!std::isspace(static_cast<unsigned char>(c)))
+                {
+                    literal = false; // macro argument name, not a literal
+                    break;
+                }
+            }
+            if (literal)
+            {
+                addFormat(format);
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    // Decodes a byte stream, bytes outside of valid frames are skipped
+    std::vector<DecodedLogEntry> decode(const uint8_t *data, size_t size)
+    {
+        std::vector<DecodedLogEntry> entries;
+        size_t pos = 0;
+        while (pos + deferred_log::FRAME_HEADER <= size)
+        {
+            if (data[pos] != deferred_log::FRAME_SYNC)
+            {
+                ++pos;
+                ++skipped_;
+                continue;
+            }
+            const size_t total = static_cast<size_t>(data[pos + 1]) + 2;
+            const uint8_t count = data[pos + 11];
+            if (total < deferred_log::FRAME_HEADER + count || pos + total > size || !validTypes(data + pos + 12, count))
+            {
+                ++pos;
+                ++skipped_;
+                continue;
+            }
+
+            DecodedLogEntry entry{};
+            entry.id = read32(data + pos + 2);
+            entry.tick = read32(data + pos + 6);
+            entry.level = data[pos + 10];
+
+            const auto *types = reinterpret_cast<const deferred_log::ArgType *>(data + pos + 12);
+            const uint8_t *payload = data + pos + deferred_log::FRAME_HEADER + count;
+            const size_t payload_size = total - deferred_log::FRAME_HEADER - count;
+
+            auto it = formats_.find(entry.id);
+            if (it != formats_.end())
+            {
+                char text[512];
+                const size_t n = deferred_log::format(it->second.c_str(), types, count, payload, payload_size, text, sizeof(text));
+                entry.text.assign(text, n);
+            }
+            else
+            {
+                char text[32];
+                snprintf(text, sizeof(text), "<unknown format %08X>", static_cast<unsigned>(entry.id));
+                entry.text = text;
+                ++unknown_;
+            }
+            entries.push_back(std::move(entry));
+            pos += total;
+        }
+        return entries;
+    }
+
+    size_t formats() const { return formats_.size(); }
+    size_t collisions() const { return collisions_; }
+    size_t unknown() const { return unknown_; }
+    size_t skipped() const { return skipped_; }
+
+private:
+    static uint32_t read32(const uint8_t *p)
+    {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    static bool validTypes(const uint8_t *types, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            if (types[i] > static_cast<uint8_t>(deferred_log::ArgType::BYTES))
+                return false;
+        return true;
+    }
+
+    // Reads a string literal body starting after the opening quote, returns
+    // the index of the closing quote
+    static size_t readLiteral(const std::string &source, size_t i, std::string &out)
+    {
+        for (; i < source.size() && source[i] != '"'; ++i)
+        {
+            if (source[i] != '\\' || i + 1 >= source.size())
+            {
+                out += source[i];
+                continue;
+            }
+            switch (source[++i])
+            {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case '0': out += '\0'; break;
+            default: out += source[i]; break;
+            }
+        }
+        return i;
+    }
+
+    std::map<uint32_t, std::string> formats_;
+    size_t collisions_ = 0;
+    size_t unknown_ = 0;
+    size_t skipped_ = 0;
+};
+
+#endif // LOG_DECODER_HPP
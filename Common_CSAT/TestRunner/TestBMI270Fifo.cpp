@@ -0,0 +1,340 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <vector>
+
+#include "BMI270Fifo.hpp"
+#include "BMI270_MMC5983.hpp"
+#include "BMI270FifoGenerator.hpp"
+#include "mock_hal.h"
+#include "Transport.hpp"
+
+SPI_HandleTypeDef mock_spi;
+GPIO_TypeDef mock_gpio;
+
+using Config = SPI_Register_Config<mock_spi, GPIO_PIN_5, 128>;
+using Transport = SPIRegisterTransport<Config>;
+using IMU = BMI270<Transport>;
+using IMUCombo = BMI270_MMC5983<Transport>;
+
+constexpr uint16_t BURST = 127; // one dummy byte + 127 within max_transfer_size
+
+static_assert(!BMI270Fifo<IMU>::HAS_AUX);
+static_assert(BMI270Fifo<IMUCombo>::HAS_AUX);
+
+static au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t value)
+{
+    return au::make_quantity<au::Milli<au::Seconds>>(value);
+}
+
+// Answers for readFifoLength() and the following readFifo() burst
+static void injectDrain(const BMI270FifoGenerator &fifo)
+{
+    clear_spi_tx_buffer();
+    clear_spi_rx_buffer();
+    auto length = fifo.lengthResponse();
+    inject_spi_rx_data(length.data(), length.size());
+    const size_t read = std::min<size_t>(fifo.length() + BMI270FifoCore::SENSOR_TIME_FRAME_SIZE, BURST) + 1;
+    auto data = fifo.dataResponse(read);
+    inject_spi_rx_data(data.data(), data.size());
+}
+
+TEST_CASE("BMI270FifoCore parses regular and control frames")
+{
+    BMI270FifoGenerator fifo;
+    fifo.frame(BMI270FifoGenerator::Axes{1, 2, 3}, BMI270FifoGenerator::Axes{4, 5, 6})
+        .skip(3)
+        .frame(BMI270FifoGenerator::Axes{7, 8, 9}, std::nullopt, std::nullopt, 0x02)
+        .inputConfig()
+        .frame(std::nullopt, BMI270FifoGenerator::Axes{-1, -2, -3})
+        .sensorTime(0x123456);
+
+    std::vector<BMI270FifoFrame> frames;
+    auto status = BMI270FifoCore::parse(fifo.bytes().data(), fifo.bytes().size(), [&](const BMI270FifoFrame &f)
+                                        { frames.push_back(f); });
+
+    CHECK(status.frames == 3);
+    CHECK(status.skipped == 3);
+    CHECK(status.config_changes == 1);
+    CHECK(status.has_sensor_time);
+    CHECK(status.sensor_time == 0x123456);
+    CHECK(status.used == fifo.bytes().size());
+
+    REQUIRE(frames.size() == 3);
+    CHECK(frames[0].acc != nullptr);
+    CHECK(frames[0].gyr != nullptr);
+    CHECK(frames[0].aux == nullptr);
+    CHECK(frames[0].gyr[0] == 4);  // GYR precedes ACC
+    CHECK(frames[0].acc[0] == 1);
+    CHECK(frames[1].acc[4] == 9); // tag bits do not change the layout
+    CHECK(frames[1].gyr == nullptr);
+    CHECK(frames[2].acc == nullptr);
+    CHECK(frames[2].gyr[0] == 0xFF);
+}
+
+TEST_CASE("BMI270FifoCore stops at over-read, truncated and unknown frames")
+{
+    BMI270FifoGenerator fifo;
+    fifo.frame(BMI270FifoGenerator::Axes{1, 2, 3}, BMI270FifoGenerator::Axes{4, 5, 6});
+    const size_t one_frame = fifo.bytes().size();
+    CHECK(one_frame == 13);
+
+    SUBCASE("Over-read pattern")
+    {
+        auto rx = fifo.dataResponse(40);
+        auto status = BMI270FifoCore::parse(rx.data() + 1, rx.size() - 1, [](const BMI270FifoFrame &) {});
+        CHECK(status.frames == 1);
+        CHECK(status.used == one_frame);
+        CHECK_FALSE(status.has_sensor_time);
+    }
+
+    SUBCASE("Truncated frame")
+    {
+        auto status = BMI270FifoCore::parse(fifo.bytes().data(), one_frame - 1, [](const BMI270FifoFrame &) {});
+        CHECK(status.frames == 0);
+        CHECK(status.used == 0);
+    }
+
+    SUBCASE("Unknown header")
+    {
+        std::vector<uint8_t> bytes = fifo.bytes();
+        bytes.insert(bytes.begin(), {0x50, 0x00});
+        auto status = BMI270FifoCore::parse(bytes.data(), bytes.size(), [](const BMI270FifoFrame &) {});
+        CHECK(status.frames == 0);
+    }
+}
+
+TEST_CASE("BMI270FifoCore sensortime helpers")
+{
+    CHECK(BMI270FifoCore::periodTicks(0x08) == 256); // 100 Hz
+    CHECK(BMI270FifoCore::periodTicks(0x0A) == 64);  // 400 Hz
+    CHECK(BMI270FifoCore::periodTicks(0x06) == 1024); // 25 Hz
+    CHECK(BMI270FifoCore::ticksToMilliseconds(256) == 10);
+    CHECK(BMI270FifoCore::ticksToMilliseconds(25600) == 1000);
+}
+
+TEST_CASE("BMI270 configureFifo enables header mode with sensortime")
+{
+    clear_spi_rx_buffer();
+
+    SUBCASE("BMI270")
+    {
+        clear_spi_rx_buffer();
+        uint8_t raw[] = {
+            0xFF, 0x02, // FIFO_CONFIG_0
+            0xFF, 0xD0  // FIFO_CONFIG_1
+        };
+        inject_spi_rx_data(raw, sizeof(raw));
+
+        Config config(&mock_gpio);
+        Transport transport(config);
+        IMU imu(transport);
+        BMI270Fifo<IMU> fifo(imu);
+        CHECK(fifo.configure() == true);
+    }
+
+    SUBCASE("BMI270_MMC5983 adds the AUX channel")
+    {
+        clear_spi_rx_buffer();
+        uint8_t raw[] = {
+            0xFF, 0x02, // FIFO_CONFIG_0
+            0xFF, 0xF0  // FIFO_CONFIG_1
+        };
+        inject_spi_rx_data(raw, sizeof(raw));
+
+        Config config(&mock_gpio);
+        Transport transport(config);
+        IMUCombo imu(transport);
+        BMI270Fifo<IMUCombo> fifo(imu);
+        CHECK(fifo.configure() == true);
+    }
+
+    SUBCASE("Readback mismatch")
+    {
+        clear_spi_rx_buffer();
+        uint8_t raw[] = {
+            0xFF, 0x02, // FIFO_CONFIG_0
+            0xFF, 0xC0  // FIFO_CONFIG_1 without header mode
+        };
+        inject_spi_rx_data(raw, sizeof(raw));
+
+        Config config(&mock_gpio);
+        Transport transport(config);
+        IMU imu(transport);
+        BMI270Fifo<IMU> fifo(imu);
+        CHECK(fifo.configure() == false);
+    }
+}
+
+TEST_CASE("BMI270Fifo drain timestamps samples from the sensortime frame")
+{
+    BMI270FifoGenerator gen;
+    gen.frame(BMI270FifoGenerator::Axes{16384, 0, 0}, BMI270FifoGenerator::Axes{164, 0, 0})
+        .frame(BMI270FifoGenerator::Axes{0, 16384, 0}, BMI270FifoGenerator::Axes{0, 164, 0})
+        .frame(BMI270FifoGenerator::Axes{0, 0, 16384}, BMI270FifoGenerator::Axes{0, 0, 164})
+        .sensorTime(1000 * 256 + 100); // 100 ticks after the last data ready
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMU imu(transport);
+    BMI270Fifo<IMU, 8, BURST> fifo(imu);
+
+    CHECK(fifo.drain(ms(10000)) == 3);
+    CHECK(fifo.size() == 3);
+    // two transactions, address + FIFO_LENGTH and address + one FIFO_DATA burst up to the sensortime frame
+    CHECK(get_spi_tx_buffer_count() == (1U + 3U) + (1U + 1U + gen.length() + BMI270FifoCore::SENSOR_TIME_FRAME_SIZE));
+
+    const uint32_t expected_time[] = {255488, 255744, 256000};
+    const uint64_t expected_ms[] = {9977, 9987, 9997};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        IMUSample sample;
+        REQUIRE(fifo.pop(sample));
+        CHECK(sample.sensor_time == expected_time[i]);
+        CHECK(sample.timestamp == ms(expected_ms[i]));
+        CHECK(sample.has(IMUSample::ACC));
+        CHECK(sample.has(IMUSample::GYR));
+        CHECK_FALSE(sample.has(IMUSample::MAG));
+    }
+
+    IMUSample sample;
+    CHECK_FALSE(fifo.pop(sample));
+}
+
+TEST_CASE("BMI270Fifo drain converts with the register read scaling")
+{
+    BMI270FifoGenerator gen;
+    gen.frame(BMI270FifoGenerator::Axes{16384, -16384, 8192}, BMI270FifoGenerator::Axes{164, -328, 16})
+        .sensorTime(512);
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMU imu(transport);
+    BMI270Fifo<IMU, 8, BURST> fifo(imu);
+
+    REQUIRE(fifo.drain(ms(500)) == 1);
+    IMUSample sample;
+    REQUIRE(fifo.pop(sample));
+
+    const uint8_t *raw = gen.bytes().data() + 1;
+    const auto angular = imu.toAngularVelocity(raw);
+    const auto acceleration = imu.toAcceleration(raw + BMI270FifoCore::GYR_SIZE);
+    for (size_t i = 0; i < 3; ++i)
+    {
+        CHECK(sample.angular_velocity[i].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(angular[i].in(au::degreesPerSecondInBodyFrame)));
+        CHECK(sample.acceleration[i].in(au::metersPerSecondSquaredInBodyFrame) == doctest::Approx(acceleration[i].in(au::metersPerSecondSquaredInBodyFrame)));
+    }
+    CHECK(sample.acceleration[0].in(au::metersPerSecondSquaredInBodyFrame) == doctest::Approx(-9.80665f));
+    CHECK(sample.angular_velocity[0].in(au::degreesPerSecondInBodyFrame) == doctest::Approx(10.0f));
+    CHECK(sample.timestamp == ms(500));
+}
+
+TEST_CASE("BMI270Fifo drain without sensortime spaces samples by the ODR")
+{
+    BMI270FifoGenerator gen;
+    gen.frame(BMI270FifoGenerator::Axes{1, 1, 1}, BMI270FifoGenerator::Axes{1, 1, 1})
+        .frame(BMI270FifoGenerator::Axes{2, 2, 2}, BMI270FifoGenerator::Axes{2, 2, 2})
+        .frame(BMI270FifoGenerator::Axes{3, 3, 3}, BMI270FifoGenerator::Axes{3, 3, 3});
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMU imu(transport);
+    BMI270Fifo<IMU, 8, BURST> fifo(imu, 0x0A); // 400 Hz
+
+    REQUIRE(fifo.drain(ms(1000)) == 3);
+    const uint64_t expected_ms[] = {995, 998, 1000};
+    for (uint64_t expected : expected_ms)
+    {
+        IMUSample sample;
+        REQUIRE(fifo.pop(sample));
+        CHECK(sample.timestamp == ms(expected));
+    }
+}
+
+TEST_CASE("BMI270Fifo counts skipped and dropped frames")
+{
+    BMI270FifoGenerator gen;
+    gen.skip(2);
+    for (int16_t i = 0; i < 6; ++i)
+    {
+        gen.frame(BMI270FifoGenerator::Axes{i, 0, 0}, BMI270FifoGenerator::Axes{i, 0, 0});
+    }
+    gen.sensorTime(2560);
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMU imu(transport);
+    BMI270Fifo<IMU, 4, BURST> fifo(imu);
+
+    CHECK(fifo.drain(ms(100)) == 6);
+    CHECK(fifo.skipped() == 2);
+    CHECK(fifo.dropped() == 2);
+    CHECK(fifo.size() == 4);
+
+    // the oldest samples were overwritten
+    uint32_t previous = 0;
+    IMUSample sample;
+    size_t popped = 0;
+    while (fifo.pop(sample))
+    {
+        CHECK(sample.sensor_time > previous);
+        previous = sample.sensor_time;
+        ++popped;
+    }
+    CHECK(popped == 4);
+    CHECK(previous == 2560);
+}
+
+TEST_CASE("BMI270Fifo drain of an empty FIFO reads only the length")
+{
+    BMI270FifoGenerator gen;
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMU imu(transport);
+    BMI270Fifo<IMU, 4, BURST> fifo(imu);
+
+    CHECK(fifo.drain(ms(100)) == 0);
+    CHECK(fifo.size() == 0);
+}
+
+TEST_CASE("BMI270Fifo with BMI270_MMC5983 decodes the AUX magnetometer")
+{
+    BMI270FifoGenerator gen;
+    const auto aux = BMI270FifoGenerator::mmc5983(1638, -3276, 6553);
+    gen.frame(BMI270FifoGenerator::Axes{0, 0, 16384}, BMI270FifoGenerator::Axes{0, 0, 0}, aux)
+        .frame(BMI270FifoGenerator::Axes{0, 0, 16384}, BMI270FifoGenerator::Axes{0, 0, 0})
+        .sensorTime(5120);
+    injectDrain(gen);
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    IMUCombo imu(transport);
+    BMI270Fifo<IMUCombo, 8, BURST> fifo(imu);
+
+    REQUIRE(fifo.drain(ms(2000)) == 2);
+
+    auto counts = MMC5983Core::parseMagnetometerData(aux.data());
+    CHECK(counts[0] == 1638);
+    CHECK(counts[1] == -3276);
+    CHECK(counts[2] == 6553);
+
+    IMUSample sample;
+    REQUIRE(fifo.pop(sample));
+    CHECK(sample.has(IMUSample::MAG));
+    const auto expected = imu.toMagneticField(aux.data());
+    for (size_t i = 0; i < 3; ++i)
+    {
+        CHECK(sample.magnetic_field[i].in(au::bodys * au::tesla) == doctest::Approx(expected[i].in(au::bodys * au::tesla)));
+    }
+    CHECK(sample.magnetic_field[0].in(au::bodys * au::tesla) == doctest::Approx(1638.f / (16384.f * 10000.f)));
+
+    REQUIRE(fifo.pop(sample));
+    CHECK_FALSE(sample.has(IMUSample::MAG));
+    CHECK(sample.has(IMUSample::GYR));
+}
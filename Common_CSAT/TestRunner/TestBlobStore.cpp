@@ -3,7 +3,10 @@
 #include "BlobStore.hpp"
 #include <cstdint>
 #include <array>
+#include <chrono>
 #include <span>
+#include <cstdio>
+#include <string_view>
 
 struct BlobStruct
 {
@@ -127,3 +130,281 @@ TEST_CASE("NamedBlobStore - Direct access to offsets")
                                                    blob_map[static_cast<size_t>(BlobStruct::FieldIndex::config_data)].size));
     }
 }
+
+TEST_CASE("BlobIndex - Sorted lookup built at compile time")
+{
+    static constexpr BlobIndex<BlobMemberInfo, blob_map.size()> index(blob_map);
+    static_assert(index.unique());
+    static_assert(index.find("config_data")->offset == offsetof(BlobStruct, config_data));
+    static_assert(index.find("sensor_data")->size == sizeof(BlobStruct::sensor_data));
+    static_assert(index.find("bogus") == nullptr);
+    static_assert(index.find("") == nullptr);
+
+    static constexpr std::array<BlobMemberInfo, 3> twice = {{{"a", 0, 1}, {"b", 1, 1}, {"a", 2, 1}}};
+    static_assert(!BlobIndex<BlobMemberInfo, twice.size()>(twice).unique());
+
+    NamedBlobStore<SPIBlobStoreAccess, BlobStruct, BlobMemberInfo, blob_map.size()> named_store(spi_access, index);
+    REQUIRE(named_store.find("config_data") == &blob_map[1]);
+}
+
+#if defined(__linux__)
+TEST_CASE("MmapBlobStoreAccess - Content is kept across mappings")
+{
+    constexpr const char *filename = "TestBlobStore_mmap.bin";
+    std::remove(filename);
+
+    {
+        MmapBlobStoreAccess access(filename, 256);
+        REQUIRE(access.isValid());
+        CHECK(access.get_flash_size() == 256);
+
+        uint8_t data[4] = {1, 2, 3, 4};
+        REQUIRE(access.write(100, data, sizeof(data)));
+        REQUIRE_FALSE(access.write(254, data, sizeof(data)));
+        CHECK(access.sync());
+
+        // copies share the mapping
+        MmapBlobStoreAccess copy = access;
+        uint8_t readback[4] = {};
+        REQUIRE(copy.read(100, readback, sizeof(readback)));
+        CHECK(readback[3] == 4);
+    }
+
+    MmapBlobStoreAccess reopened(filename, 256);
+    uint8_t readback[4] = {};
+    REQUIRE(reopened.read(100, readback, sizeof(readback)));
+    CHECK(readback[0] == 1);
+    CHECK(readback[3] == 4);
+    REQUIRE_FALSE(reopened.read(255, readback, sizeof(readback)));
+
+    CHECK_FALSE(MmapBlobStoreAccess("TestBlobStore_missing/none.bin", 256).isValid());
+    std::remove(filename);
+}
+#endif
+
+namespace
+{
+    // SPI backend that counts the accesses reaching the memory
+    struct CountingAccess
+    {
+        SPIBlobStoreAccess spi;
+        size_t *reads;
+        size_t *writes;
+        bool fail = false;
+
+        bool read(size_t offset, uint8_t *buffer, size_t size) const
+        {
+            ++*reads;
+            return spi.read(offset, buffer, size);
+        }
+        bool write(size_t offset, const uint8_t *data, size_t size)
+        {
+            ++*writes;
+            return !fail && spi.write(offset, data, size);
+        }
+        size_t get_flash_size() const { return spi.get_flash_size(); }
+    };
+}
+
+TEST_CASE("CachedBlobStoreAccess - Write-back with dirty tracking")
+{
+    uint8_t memory[128] = {};
+    memory[5] = 55;
+    size_t reads = 0;
+    size_t writes = 0;
+    CountingAccess backing{SPIBlobStoreAccess(sizeof(memory), memory), &reads, &writes};
+
+    using Cache = CachedBlobStoreAccess<CountingAccess, sizeof(memory), 16>;
+    Cache::Shadow shadow;
+    Cache cache(backing, shadow);
+    REQUIRE(cache.isValid());
+    CHECK(reads == 1);
+
+    uint8_t readback[8] = {};
+    REQUIRE(cache.read(0, readback, sizeof(readback)));
+    CHECK(readback[5] == 55);
+    CHECK(reads == 1);
+
+    // three writes into two adjacent blocks and one far away
+    uint8_t data[8] = {9, 9, 9, 9, 9, 9, 9, 9};
+    REQUIRE(cache.write(12, data, sizeof(data)));
+    REQUIRE(cache.write(20, data, 4));
+    REQUIRE(cache.write(100, data, 2));
+    REQUIRE_FALSE(cache.write(124, data, sizeof(data)));
+    CHECK(cache.dirtyBlocks() == 3);
+    CHECK(memory[12] == 0);
+    CHECK(writes == 0);
+
+    // a copy shares the shadow, as in TaskRegisterServer
+    Cache copy = cache;
+    REQUIRE(copy.read(20, readback, 1));
+    CHECK(readback[0] == 9);
+    CHECK(reads == 1);
+
+    REQUIRE(copy.flush());
+    CHECK(writes == 2);
+    CHECK(cache.dirtyBlocks() == 0);
+    CHECK(memory[12] == 9);
+    CHECK(memory[23] == 9);
+    CHECK(memory[101] == 9);
+
+    // storing what is already there does not touch the backend
+    REQUIRE(cache.write(12, data, sizeof(data)));
+    CHECK(cache.dirtyBlocks() == 0);
+    REQUIRE(cache.flush());
+    CHECK(writes == 2);
+
+    SUBCASE("Failed flush keeps blocks dirty")
+    {
+        uint8_t other[128] = {};
+        size_t other_reads = 0;
+        size_t other_writes = 0;
+        CountingAccess failing{SPIBlobStoreAccess(sizeof(other), other), &other_reads, &other_writes, true};
+        Cache::Shadow other_shadow;
+        Cache failing_cache(failing, other_shadow);
+
+        REQUIRE(failing_cache.write(0, data, 1));
+        CHECK_FALSE(failing_cache.flush());
+        CHECK(failing_cache.dirtyBlocks() == 1);
+        CHECK(other[0] == 0);
+    }
+
+    SUBCASE("Backend smaller than the shadow is rejected")
+    {
+        uint8_t small[64] = {};
+        Cache::Shadow small_shadow;
+        Cache small_cache(CountingAccess{SPIBlobStoreAccess(sizeof(small), small), &reads, &writes}, small_shadow);
+        CHECK_FALSE(small_cache.isValid());
+        CHECK_FALSE(small_cache.write(0, data, 1));
+    }
+}
+
+namespace
+{
+    // Register layout as served by TaskRegisterServer
+    struct RegisterStruct
+    {
+        uint8_t values[16][16];
+    };
+
+    constexpr std::array<BlobMemberInfo, 16> register_map = {{
+        {"uavcan.node.id", 0 * 16, 16},
+        {"uavcan.node.description", 1 * 16, 16},
+        {"uavcan.can.bitrate", 2 * 16, 16},
+        {"uavcan.can.mtu", 3 * 16, 16},
+        {"uavcan.udp.iface", 4 * 16, 16},
+        {"uavcan.serial.iface", 5 * 16, 16},
+        {"uavcan.pub.orientation.id", 6 * 16, 16},
+        {"uavcan.pub.orientation.type", 7 * 16, 16},
+        {"uavcan.pub.heartbeat.id", 8 * 16, 16},
+        {"uavcan.sub.command.id", 9 * 16, 16},
+        {"uavcan.sub.command.type", 10 * 16, 16},
+        {"uavcan.srv.register.id", 11 * 16, 16},
+        {"csat.imu.rate", 12 * 16, 16},
+        {"csat.imu.range", 13 * 16, 16},
+        {"csat.mag.offset", 14 * 16, 16},
+        {"csat.mag.scale", 15 * 16, 16},
+    }};
+
+    // The former NamedBlobStore lookup, kept as the reference for the benchmark
+    template <BlobStoreAccess AccessType>
+    struct LinearNamedStore
+    {
+        AccessType access;
+
+        const BlobMemberInfo *find(std::string_view name) const
+        {
+            for (const auto &entry : register_map)
+            {
+                if (entry.name == name)
+                    return &entry;
+            }
+            return nullptr;
+        }
+        bool write_blob_by_name(std::string_view name, const uint8_t *data, size_t size)
+        {
+            const BlobMemberInfo *entry = find(name);
+            return entry != nullptr && size <= entry->size && access.write(entry->offset, data, size);
+        }
+        std::span<uint8_t> read_blob_by_name(std::string_view name, uint8_t *buffer, size_t size)
+        {
+            const BlobMemberInfo *entry = find(name);
+            if (entry == nullptr || size < entry->size || !access.read(entry->offset, buffer, entry->size))
+                return std::span<uint8_t>(buffer, 0);
+            return std::span<uint8_t>(buffer, entry->size);
+        }
+    };
+
+    // One uavcan.register.Access request: store the value, then read it back
+    template <typename Store>
+    double accessNs(Store &store, int rounds)
+    {
+        using clock = std::chrono::steady_clock;
+        uint8_t value[16] = {};
+        uint8_t response[256] = {};
+        size_t answered = 0;
+        const auto start = clock::now();
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (const auto &entry : register_map)
+            {
+                value[0] = static_cast<uint8_t>(r);
+                store.write_blob_by_name(entry.name, value, sizeof(value));
+                answered += store.read_blob_by_name(entry.name, response, sizeof(response)).size();
+            }
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        CHECK(answered == static_cast<size_t>(rounds) * register_map.size() * 16);
+        return static_cast<double>(elapsed) / static_cast<double>(static_cast<size_t>(rounds) * register_map.size());
+    }
+}
+
+TEST_CASE("Register access throughput of the backends")
+{
+    constexpr size_t flash_size = sizeof(RegisterStruct);
+    constexpr int rounds = 200;
+
+    LinearNamedStore<FileBlobStoreAccess> file_store{FileBlobStoreAccess("TestBlobStore_file.bin", flash_size)};
+    REQUIRE(file_store.access.isValid());
+    const double file_ns = accessNs(file_store, rounds);
+
+    uint8_t memory[flash_size] = {};
+    LinearNamedStore<SPIBlobStoreAccess> spi_linear{SPIBlobStoreAccess(flash_size, memory)};
+    const double spi_linear_ns = accessNs(spi_linear, rounds);
+
+    NamedBlobStore<SPIBlobStoreAccess, RegisterStruct, BlobMemberInfo, register_map.size()> spi_indexed(SPIBlobStoreAccess(flash_size, memory), register_map);
+    const double spi_indexed_ns = accessNs(spi_indexed, rounds);
+
+    // on the target every backend access is an SPI transaction to the MRAM
+    size_t reads = 0;
+    size_t writes = 0;
+    NamedBlobStore<CountingAccess, RegisterStruct, BlobMemberInfo, register_map.size()> counted_store(CountingAccess{SPIBlobStoreAccess(flash_size, memory), &reads, &writes}, register_map);
+    accessNs(counted_store, rounds);
+    const size_t uncached_transactions = reads + writes;
+
+    reads = 0;
+    writes = 0;
+    using Cache = CachedBlobStoreAccess<CountingAccess, flash_size>;
+    Cache::Shadow shadow;
+    Cache cache(CountingAccess{SPIBlobStoreAccess(flash_size, memory), &reads, &writes}, shadow);
+    NamedBlobStore<Cache, RegisterStruct, BlobMemberInfo, register_map.size()> cached_store(cache, register_map);
+    const double cached_ns = accessNs(cached_store, rounds);
+    CHECK(cache.flush());
+    CHECK(memory[0] == static_cast<uint8_t>(rounds - 1));
+    CHECK(reads + writes == 2);
+
+#if defined(__linux__)
+    MmapBlobStoreAccess mmap_access("TestBlobStore_mmap.bin", flash_size);
+    REQUIRE(mmap_access.isValid());
+    NamedBlobStore<MmapBlobStoreAccess, RegisterStruct, BlobMemberInfo, register_map.size()> mmap_store(mmap_access, register_map);
+    const double mmap_ns = accessNs(mmap_store, rounds);
+    MESSAGE("File+scan " << file_ns << ", mmap+index " << mmap_ns << " ns/access");
+    CHECK(mmap_ns < file_ns);
+    std::remove("TestBlobStore_mmap.bin");
+#endif
+    MESSAGE("SPI+scan " << spi_linear_ns << ", SPI+index " << spi_indexed_ns
+            << ", cached SPI+index " << cached_ns << " ns/access");
+    MESSAGE("Backend transactions: " << uncached_transactions << " uncached, " << reads + writes << " cached with one flush");
+    CHECK(cached_ns < file_ns);
+    std::remove("TestBlobStore_file.bin");
+}
@@ -0,0 +1,208 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "cyphal.hpp"
+#include "canard_adapter.hpp"
+#include "CanTxQueueDrainer.hpp"
+
+#ifdef __x86_64__
+#include "mock_hal.h"
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+void *canardMemoryAllocate(CanardInstance * /*ins*/, size_t amount) { return static_cast<void *>(malloc(amount)); };
+void canardMemoryFree(CanardInstance * /*ins*/, void *pointer) { free(pointer); };
+
+CanardAdapter canard_adapter;
+CAN_HandleTypeDef hcan;
+CanTxQueueDrainer tx_drainer(&canard_adapter, &hcan);
+
+// the interrupt side, as wired in cppmain
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { tx_drainer.on_tx_complete(); }
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { tx_drainer.on_tx_complete(); }
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { tx_drainer.on_tx_complete(); }
+
+constexpr CyphalNodeID NODE_ID = 11;
+
+static void reset(size_t queue_capacity)
+{
+    canard_adapter.ins = canardInit(canardMemoryAllocate, canardMemoryFree);
+    canard_adapter.ins.node_id = NODE_ID;
+    canard_adapter.que = canardTxInit(queue_capacity, CANARD_MTU_CAN_CLASSIC);
+
+    HAL_SetTick(0);
+    clear_can_tx_buffer();
+    enable_can_mailbox_model(true);
+    HAL_CAN_DeactivateNotification(&hcan, CAN_IT_TX_MAILBOX_EMPTY);
+    tx_drainer.reset_statistics();
+}
+
+static CyphalTransferMetadata makeMetadata(CyphalPriority priority, CyphalPortID port_id, CyphalTransferID transfer_id)
+{
+    CyphalTransferMetadata metadata;
+    metadata.priority = priority;
+    metadata.transfer_kind = CyphalTransferKindMessage;
+    metadata.port_id = port_id;
+    metadata.remote_node_id = CYPHAL_NODE_ID_UNSET;
+    metadata.source_node_id = NODE_ID;
+    metadata.destination_node_id = CYPHAL_NODE_ID_UNSET;
+    metadata.transfer_id = transfer_id;
+    return metadata;
+}
+
+static uint8_t tailByte(const CAN_TxMessage_t &message)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(message.pData);
+    return data[message.TxHeader.DLC - 1];
+}
+
+static uint32_t priorityOf(const CAN_TxMessage_t &message)
+{
+    return (message.TxHeader.ExtId >> 26) & 0x7;
+}
+
+TEST_CASE("CanTxQueueDrainer: multi-frame transfer is refilled from the mailbox interrupt")
+{
+    reset(64);
+    Cyphal<CanardAdapter> cyphal(&canard_adapter);
+
+    std::vector<uint8_t> payload(100);
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<uint8_t>(i);
+
+    CyphalTransferMetadata metadata = makeMetadata(CyphalPriorityNominal, 123, 5);
+    int32_t frames = cyphal.cyphalTxPush(0, &metadata, payload.size(), payload.data());
+    REQUIRE(frames > 3);
+
+    // the push fills all three mailboxes and arms the interrupt for the rest
+    CHECK(get_can_tx_buffer_count() == 3);
+    CHECK(get_can_busy_mailboxes() == 3);
+    CHECK(canard_adapter.que.size == static_cast<size_t>(frames - 3));
+    CHECK((get_can_enabled_interrupts() & CAN_IT_TX_MAILBOX_EMPTY) != 0);
+
+    // no polling: every completion refills a mailbox until the queue is empty
+    CHECK(complete_can_tx_mailboxes(2 * frames) == frames);
+    CHECK(get_can_tx_buffer_count() == frames);
+    CHECK(canard_adapter.que.size == 0);
+    CHECK((get_can_enabled_interrupts() & CAN_IT_TX_MAILBOX_EMPTY) == 0);
+
+    // frames left in transfer order
+    CHECK((tailByte(get_can_tx_message(0)) & 0x80) != 0);
+    CHECK((tailByte(get_can_tx_message(frames - 1)) & 0x40) != 0);
+    for (int i = 0; i < frames; ++i)
+        CHECK((tailByte(get_can_tx_message(i)) & 0x1F) == 5);
+
+    const CanTxStatistics &statistics = tx_drainer.statistics();
+    CHECK(statistics.frames_sent == static_cast<uint32_t>(frames));
+    CHECK(statistics.frames_expired == 0);
+    // the interrupt is masked again once the last queued frame is in a mailbox
+    CHECK(statistics.irq_refills == static_cast<uint32_t>(frames - 3));
+}
+
+TEST_CASE("CanTxQueueDrainer: higher priority transfer takes the next free mailbox")
+{
+    reset(64);
+    Cyphal<CanardAdapter> cyphal(&canard_adapter);
+
+    std::vector<uint8_t> bulk(70, 0xAA);
+    CyphalTransferMetadata slow = makeMetadata(CyphalPrioritySlow, 200, 1);
+    int32_t slow_frames = cyphal.cyphalTxPush(0, &slow, bulk.size(), bulk.data());
+    REQUIRE(slow_frames > 4);
+    CHECK(get_can_tx_buffer_count() == 3);
+
+    const uint8_t urgent_payload[] = {1, 2, 3};
+    CyphalTransferMetadata urgent = makeMetadata(CyphalPriorityHigh, 100, 2);
+    CHECK(cyphal.cyphalTxPush(0, &urgent, sizeof(urgent_payload), urgent_payload) == 1);
+    CHECK(get_can_tx_buffer_count() == 3);
+    CHECK(tx_drainer.statistics().mailbox_full > 0);
+
+    CHECK(complete_can_tx_mailbox() >= 0);
+    REQUIRE(get_can_tx_buffer_count() == 4);
+    CHECK(priorityOf(get_can_tx_message(3)) == CyphalPriorityHigh);
+
+    complete_can_tx_mailboxes(2 * slow_frames);
+    CHECK(get_can_tx_buffer_count() == slow_frames + 1);
+    for (int i = 4; i < get_can_tx_buffer_count(); ++i)
+        CHECK(priorityOf(get_can_tx_message(i)) == CyphalPrioritySlow);
+}
+
+TEST_CASE("CanTxQueueDrainer: frames past their deadline are dropped")
+{
+    reset(64);
+    Cyphal<CanardAdapter> cyphal(&canard_adapter);
+
+    std::vector<uint8_t> payload(50, 0x55);
+    CyphalTransferMetadata metadata = makeMetadata(CyphalPriorityNominal, 300, 7);
+    int32_t frames = cyphal.cyphalTxPush(0, &metadata, payload.size(), payload.data());
+    REQUIRE(frames > 3);
+
+    // bus stuck for longer than the default timeout
+    HAL_SetTick(static_cast<uint32_t>(CAN_TX_TIMEOUT_USEC / 1000) + 100);
+    CHECK(complete_can_tx_mailbox() >= 0);
+
+    CHECK(canard_adapter.que.size == 0);
+    CHECK(get_can_tx_buffer_count() == 3);
+    CHECK(tx_drainer.statistics().frames_expired == static_cast<uint32_t>(frames - 3));
+    CHECK(tx_drainer.statistics().frames_sent == 3);
+}
+
+TEST_CASE("CanTxQueueDrainer: frame rate and queue latency")
+{
+    reset(64);
+    Cyphal<CanardAdapter> cyphal(&canard_adapter);
+
+    std::vector<uint8_t> payload(130, 0x33);
+    CyphalTransferMetadata metadata = makeMetadata(CyphalPriorityNominal, 400, 9);
+    int32_t frames = cyphal.cyphalTxPush(0, &metadata, payload.size(), payload.data());
+    REQUIRE(frames > 3);
+
+    // one frame leaves the bus every 10 ms
+    uint32_t tick = 0;
+    while (get_can_busy_mailboxes() > 0)
+    {
+        tick += 10;
+        HAL_SetTick(tick);
+        complete_can_tx_mailbox();
+    }
+
+    const CanTxStatistics &statistics = tx_drainer.statistics();
+    CHECK(statistics.frames_sent == static_cast<uint32_t>(frames));
+    // the last frame waited behind all but the three frames sent immediately
+    CHECK(statistics.max_latency_ms == static_cast<uint32_t>(10 * (frames - 3)));
+    CHECK(statistics.frames_per_second == 0);
+
+    HAL_SetTick(1000);
+    tx_drainer.irq_safe_drain();
+    CHECK(tx_drainer.statistics().frames_per_second == static_cast<uint32_t>(frames));
+
+    MESSAGE("frames " << frames << " sent, mean latency "
+            << statistics.total_latency_ms / statistics.frames_sent << " ms, max "
+            << statistics.max_latency_ms << " ms");
+}
+
+TEST_CASE("CanTxQueueDrainer: without the interrupt the queue waits for the next poll")
+{
+    reset(64);
+    Cyphal<CanardAdapter> cyphal(&canard_adapter);
+
+    std::vector<uint8_t> payload(40, 0x11);
+    CyphalTransferMetadata metadata = makeMetadata(CyphalPriorityNominal, 500, 3);
+    int32_t frames = cyphal.cyphalTxPush(0, &metadata, payload.size(), payload.data());
+    REQUIRE(frames > 3);
+
+    // mailboxes complete while the interrupt is masked, nothing refills them
+    HAL_CAN_DeactivateNotification(&hcan, CAN_IT_TX_MAILBOX_EMPTY);
+    complete_can_tx_mailboxes(3);
+    CHECK(get_can_tx_buffer_count() == 3);
+    CHECK(tx_drainer.statistics().irq_refills == 0);
+
+    // the TaskCheckTxQueue poll picks up the remainder and re-arms the interrupt
+    tx_drainer.irq_safe_drain();
+    CHECK(get_can_tx_buffer_count() == 6);
+    complete_can_tx_mailboxes(2 * frames);
+    CHECK(get_can_tx_buffer_count() == frames);
+    CHECK(canard_adapter.que.size == 0);
+}
@@ -0,0 +1,145 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "Checksum.hpp"
+#include "ChecksumPolicy.hpp"
+#include "HardwareChecksum.hpp"
+#include "mock_hal.h"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+static_assert(ChecksumPolicy<BitwiseChecksumPolicy>);
+static_assert(ChecksumPolicy<TableChecksumPolicy>);
+static_assert(ChecksumPolicy<Slicing8ChecksumPolicy>);
+static_assert(ChecksumPolicy<HardwareChecksumPolicy>);
+
+static std::vector<uint8_t> makeData(size_t size, uint32_t seed)
+{
+    std::vector<uint8_t> data(size);
+    uint32_t x = seed;
+    for (auto &byte : data)
+    {
+        x = x * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(x >> 24);
+    }
+    return data;
+}
+
+template <typename Policy>
+static crc_t checksumOf(const std::vector<uint8_t> &data, size_t chunk)
+{
+    Policy policy;
+    policy.reset();
+    for (size_t offset = 0; offset < data.size(); offset += chunk)
+    {
+        size_t size = std::min(chunk, data.size() - offset);
+        policy.update(data.data() + offset, size);
+    }
+    return policy.get();
+}
+
+static CRC_HandleTypeDef hcrc;
+
+TEST_CASE("Checksum: table and slicing policies match the bitwise calculator")
+{
+    const uint8_t check[] = "123456789";
+    ChecksumCalculator reference;
+    reference.update(check, 9);
+    CHECK(reference.get_checksum() == 0x0F8593EAu);
+
+    const size_t sizes[] = {0, 1, 7, 8, 9, 15, 16, 63, 100, 4096, 4099};
+    const size_t chunks[] = {1, 3, 8, 13, 64, 4096};
+    for (size_t size : sizes)
+    {
+        std::vector<uint8_t> data = makeData(size, static_cast<uint32_t>(size) + 1);
+        crc_t expected = checksumOf<BitwiseChecksumPolicy>(data, 4096);
+        for (size_t chunk : chunks)
+        {
+            CHECK(checksumOf<BitwiseChecksumPolicy>(data, chunk) == expected);
+            CHECK(checksumOf<TableChecksumPolicy>(data, chunk) == expected);
+            CHECK(checksumOf<Slicing8ChecksumPolicy>(data, chunk) == expected);
+        }
+    }
+}
+
+TEST_CASE("Checksum: hardware policy falls back to the table before configure")
+{
+    std::vector<uint8_t> data = makeData(100, 3);
+    CHECK(checksumOf<HardwareChecksumPolicy>(data, 13) == checksumOf<BitwiseChecksumPolicy>(data, 100));
+}
+
+TEST_CASE("Checksum: hardware policy matches the bitwise calculator")
+{
+    REQUIRE(HardwareChecksumPolicy::configure(&hcrc) == HAL_OK);
+
+    const uint8_t check[] = "123456789";
+    HardwareChecksumPolicy policy;
+    policy.reset();
+    policy.update(check, 9);
+    CHECK(policy.get() == 0x0F8593EAu);
+
+    const size_t sizes[] = {0, 1, 7, 9, 100, 4099};
+    const size_t chunks[] = {1, 7, 4096};
+    for (size_t size : sizes)
+    {
+        std::vector<uint8_t> data = makeData(size, static_cast<uint32_t>(size) + 1);
+        crc_t expected = checksumOf<BitwiseChecksumPolicy>(data, 4096);
+        for (size_t chunk : chunks)
+            CHECK(checksumOf<HardwareChecksumPolicy>(data, chunk) == expected);
+    }
+}
+
+TEST_CASE("Checksum: interleaved hardware policies keep their own state")
+{
+    REQUIRE(HardwareChecksumPolicy::configure(&hcrc) == HAL_OK);
+
+    std::vector<uint8_t> a = makeData(256, 1);
+    std::vector<uint8_t> b = makeData(256, 2);
+
+    HardwareChecksumPolicy pa, pb;
+    pa.reset();
+    pb.reset();
+    for (size_t offset = 0; offset < 256; offset += 32)
+    {
+        pa.update(a.data() + offset, 32);
+        pb.update(b.data() + offset, 32);
+    }
+    CHECK(pa.get() == checksumOf<BitwiseChecksumPolicy>(a, 256));
+    CHECK(pb.get() == checksumOf<BitwiseChecksumPolicy>(b, 256));
+}
+
+template <typename Policy>
+static double megabytesPerSecond(const std::vector<uint8_t> &page, size_t repeats, crc_t &result)
+{
+    Policy policy;
+    policy.reset();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < repeats; ++n)
+        policy.update(page.data(), page.size());
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    result = policy.get();
+    return static_cast<double>(page.size() * repeats) * 1e3 / static_cast<double>(ns > 0 ? ns : 1);
+}
+
+TEST_CASE("Checksum Benchmark 4 KiB Pages")
+{
+    REQUIRE(HardwareChecksumPolicy::configure(&hcrc) == HAL_OK);
+
+    constexpr size_t PAGE_SIZE = 4096;
+    constexpr size_t REPEATS = 2048; // 8 MiB
+    std::vector<uint8_t> page = makeData(PAGE_SIZE, 7);
+
+    crc_t bitwise_crc, table_crc, slicing_crc, hardware_crc;
+    double bitwise = megabytesPerSecond<BitwiseChecksumPolicy>(page, REPEATS, bitwise_crc);
+    double table = megabytesPerSecond<TableChecksumPolicy>(page, REPEATS, table_crc);
+    double slicing = megabytesPerSecond<Slicing8ChecksumPolicy>(page, REPEATS, slicing_crc);
+    double hardware = megabytesPerSecond<HardwareChecksumPolicy>(page, REPEATS / 16, hardware_crc);
+
+    CHECK(table_crc == bitwise_crc);
+    CHECK(slicing_crc == bitwise_crc);
+
+    MESSAGE("CRC MB/s: bitwise " << bitwise << ", table " << table << ", slicing-by-8 " << slicing
+            << ", hardware (mock) " << hardware);
+}
@@ -0,0 +1,376 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+
+#include "CyphalRouter.hpp"
+#include "loopard_adapter.hpp"
+
+namespace
+{
+    void *loopardAllocate(size_t amount) { return malloc(amount); }
+    void loopardFree(void *pointer) { free(pointer); }
+
+    void initAdapter(LoopardAdapter &adapter, CyphalNodeID node_id)
+    {
+        adapter.memory_allocate = loopardAllocate;
+        adapter.memory_free = loopardFree;
+        adapter.node_id = node_id;
+    }
+
+    const char PAYLOAD[] = "hello";
+
+    CyphalTransfer makeTransfer(CyphalTransferKind kind, CyphalPortID port_id, CyphalNodeID source, CyphalNodeID destination, CyphalTransferID transfer_id)
+    {
+        CyphalTransfer transfer{};
+        transfer.metadata.priority = CyphalPriorityNominal;
+        transfer.metadata.transfer_kind = kind;
+        transfer.metadata.port_id = port_id;
+        transfer.metadata.remote_node_id = source;
+        transfer.metadata.source_node_id = source;
+        transfer.metadata.destination_node_id = destination;
+        transfer.metadata.transfer_id = transfer_id;
+        transfer.payload_size = sizeof(PAYLOAD);
+        transfer.payload = const_cast<char *>(PAYLOAD);
+        return transfer;
+    }
+
+    size_t drain(LoopardAdapter &adapter)
+    {
+        size_t frames = 0;
+        while (!adapter.buffer.is_empty())
+        {
+            CyphalTransfer t = adapter.buffer.pop();
+            adapter.memory_free(t.payload);
+            ++frames;
+        }
+        return frames;
+    }
+}
+
+namespace
+{
+    // Three loopard adapters, port 100 messages go to 1, port 200 requests for nodes 10..19 to 2
+    struct Bench
+    {
+        LoopardAdapter a0, a1, a2;
+        std::tuple<Cyphal<LoopardAdapter>, Cyphal<LoopardAdapter>, Cyphal<LoopardAdapter>> adapters{&a0, &a1, &a2};
+        CyphalRouter<> router;
+
+        Bench()
+        {
+            for (LoopardAdapter *a : {&a0, &a1, &a2})
+                initAdapter(*a, 1);
+            router.addRoute(1, 100);
+            router.addRoute(2, 200, CyphalForwardRange{10, 19});
+        }
+
+        ~Bench()
+        {
+            for (LoopardAdapter *a : {&a0, &a1, &a2})
+                drain(*a);
+        }
+    };
+}
+
+TEST_CASE("CyphalRouter forwards only on adapters with a matching route")
+{
+    SUBCASE("route table")
+    {
+        Bench b;
+        CHECK(b.router.addRoute(1, 100)); // already present
+        CHECK(b.router.getRoutes().size() == 2);
+        CHECK_FALSE(b.router.addRoute(0, 300, CyphalForwardRange{20, 10}));
+        CHECK_FALSE(b.router.addRoute(CyphalRouter<>::MAX_ADAPTERS, 300));
+    }
+
+    SUBCASE("message by port")
+    {
+        Bench b;
+        CHECK(b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, 0), b.adapters));
+        CHECK(b.a0.buffer.size() == 0);
+        CHECK(b.a1.buffer.size() == 1);
+        CHECK(b.a2.buffer.size() == 0);
+        CHECK(b.router.findRoute(1, 100)->forwarded == 1);
+    }
+
+    SUBCASE("service by destination range")
+    {
+        Bench b;
+        b.router.forward(makeTransfer(CyphalTransferKindRequest, 200, 5, 12, 0), b.adapters);
+        b.router.forward(makeTransfer(CyphalTransferKindRequest, 200, 5, 42, 1), b.adapters);
+        CHECK(b.a2.buffer.size() == 1);
+        CHECK(b.router.findRoute(2, 200, CyphalForwardRange{10, 19})->forwarded == 1);
+        CHECK(b.router.unrouted() == 1);
+    }
+
+    SUBCASE("never back on the ingress adapter")
+    {
+        Bench b;
+        b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, 0), b.adapters, 1);
+        CHECK(b.a1.buffer.size() == 0);
+        CHECK(b.router.unrouted() == 1);
+    }
+
+    SUBCASE("wildcard and specific routes forward once per adapter")
+    {
+        Bench b;
+        REQUIRE(b.router.addRoute(1, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE));
+        b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, 0), b.adapters);
+        b.router.forward(makeTransfer(CyphalTransferKindMessage, 300, 5, CYPHAL_NODE_ID_UNSET, 0), b.adapters);
+        CHECK(b.a1.buffer.size() == 2);
+        CHECK(b.router.findRoute(1, 100)->forwarded == 1);
+        CHECK(b.router.findRoute(1, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE)->forwarded == 1);
+    }
+
+    SUBCASE("repeated transfer-ID from the same source is suppressed")
+    {
+        Bench b;
+        const CyphalTransfer transfer = makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, 7);
+        b.router.forward(transfer, b.adapters);
+        b.router.forward(transfer, b.adapters);
+        b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 6, CYPHAL_NODE_ID_UNSET, 7), b.adapters);
+        CHECK(b.a1.buffer.size() == 2);
+        CHECK(b.router.suppressed() == 1);
+    }
+
+    SUBCASE("anonymous transfers are not suppressed")
+    {
+        Bench b;
+        const CyphalTransfer transfer = makeTransfer(CyphalTransferKindMessage, 100, CYPHAL_NODE_ID_UNSET, CYPHAL_NODE_ID_UNSET, 7);
+        b.router.forward(transfer, b.adapters);
+        b.router.forward(transfer, b.adapters);
+        CHECK(b.a1.buffer.size() == 2);
+        CHECK(b.router.suppressed() == 0);
+    }
+
+    SUBCASE("full adapter counts as failed")
+    {
+        Bench b;
+        for (CyphalTransferID i = 0; i < LoopardAdapter::BUFFER; ++i)
+            b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, i % 31), b.adapters);
+        CHECK_FALSE(b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 6, CYPHAL_NODE_ID_UNSET, 0), b.adapters));
+        CHECK(b.router.findRoute(1, 100)->failed == 1);
+    }
+
+    SUBCASE("removeRoute")
+    {
+        Bench b;
+        CHECK(b.router.removeRoute(1, 100));
+        CHECK_FALSE(b.router.removeRoute(1, 100));
+        b.router.forward(makeTransfer(CyphalTransferKindMessage, 100, 5, CYPHAL_NODE_ID_UNSET, 0), b.adapters);
+        CHECK(b.a1.buffer.size() == 0);
+    }
+}
+
+TEST_CASE("Loopard forward leaves the node-ID and metadata untouched")
+{
+    LoopardAdapter adapter;
+    initAdapter(adapter, 11);
+    Cyphal<LoopardAdapter> cyphal(&adapter);
+
+    CyphalTransfer transfer = makeTransfer(CyphalTransferKindMessage, 100, 22, CYPHAL_NODE_ID_UNSET, 0);
+    CHECK(cyphal.cyphalTxForward(0, &transfer.metadata, transfer.payload_size, transfer.payload, 22) == 1);
+
+    CHECK(cyphal.getNodeID() == 11);
+    CHECK(transfer.metadata.remote_node_id == 22);
+
+    CyphalTransfer received;
+    CHECK(cyphal.cyphalRxReceive(nullptr, nullptr, &received) == 1);
+    CHECK(received.metadata.remote_node_id == 22);
+    CHECK(received.metadata.source_node_id == 22);
+    CHECK(std::memcmp(received.payload, PAYLOAD, sizeof(PAYLOAD)) == 0);
+    adapter.memory_free(received.payload);
+}
+
+namespace
+{
+    // The forwarding LoopManager did before the table: every adapter, every transfer
+    struct FloodForwarding
+    {
+        static constexpr uint8_t NO_ADAPTER = 0xFF;
+
+        template <typename... Adapters>
+        bool forward(const CyphalTransfer &transfer, std::tuple<Adapters...> &adapters, uint8_t /*ingress*/ = NO_ADAPTER)
+        {
+            bool all_successful = true;
+            std::apply([&](auto &...adapter)
+                       { ((all_successful = adapter.cyphalTxForward(0, &transfer.metadata, transfer.payload_size, transfer.payload, transfer.metadata.source_node_id) > 0 && all_successful), ...); },
+                       adapters);
+            return all_successful;
+        }
+    };
+
+    enum Link : size_t
+    {
+        CAN,
+        SERIAL,
+        UDP,
+        LINKS
+    };
+
+    /*
+     * Bridge X joins CAN, serial and UDP, bridge Y joins serial and UDP, so serial
+     * and UDP form a loop through the two bridges. Each attachment of a bridge is
+     * a loopard adapter holding what that bridge transmits on the link; stepping
+     * delivers those frames to the other bridge on the link and counts them.
+     */
+    template <typename RouterX, typename RouterY>
+    struct Topology
+    {
+        static constexpr int MAX_ROUNDS = 8;
+
+        LoopardAdapter x_can, x_serial, x_udp;
+        LoopardAdapter y_serial, y_udp;
+        std::tuple<Cyphal<LoopardAdapter>, Cyphal<LoopardAdapter>, Cyphal<LoopardAdapter>> x{&x_can, &x_serial, &x_udp};
+        std::tuple<Cyphal<LoopardAdapter>, Cyphal<LoopardAdapter>> y{&y_serial, &y_udp};
+        RouterX router_x;
+        RouterY router_y;
+        size_t frames[LINKS] = {};
+        bool converged = true;
+
+        Topology()
+        {
+            for (LoopardAdapter *a : {&x_can, &x_serial, &x_udp})
+                initAdapter(*a, 1);
+            for (LoopardAdapter *a : {&y_serial, &y_udp})
+                initAdapter(*a, 2);
+        }
+
+        ~Topology()
+        {
+            for (LoopardAdapter *a : {&x_can, &x_serial, &x_udp, &y_serial, &y_udp})
+                drain(*a);
+        }
+
+        // A node on link puts a transfer on the wire
+        void send(Link link, const CyphalTransfer &transfer)
+        {
+            ++frames[link];
+            deliver(link, transfer, nullptr);
+            run();
+        }
+
+        size_t total() const { return frames[CAN] + frames[SERIAL] + frames[UDP]; }
+
+    private:
+        // from is the attachment that transmitted, it does not hear itself
+        void deliver(Link link, const CyphalTransfer &transfer, const LoopardAdapter *from)
+        {
+            switch (link)
+            {
+            case CAN:
+                if (from != &x_can)
+                    router_x.forward(transfer, x, 0);
+                break;
+            case SERIAL:
+                if (from != &x_serial)
+                    router_x.forward(transfer, x, 1);
+                if (from != &y_serial)
+                    router_y.forward(transfer, y, 0);
+                break;
+            case UDP:
+                if (from != &x_udp)
+                    router_x.forward(transfer, x, 2);
+                if (from != &y_udp)
+                    router_y.forward(transfer, y, 1);
+                break;
+            default:
+                break;
+            }
+        }
+
+        void run()
+        {
+            const std::pair<LoopardAdapter *, Link> attachments[] = {{&x_can, CAN}, {&x_serial, SERIAL}, {&x_udp, UDP}, {&y_serial, SERIAL}, {&y_udp, UDP}};
+            for (int round = 0; round < MAX_ROUNDS; ++round)
+            {
+                bool moved = false;
+                for (const auto &[adapter, link] : attachments)
+                {
+                    const size_t pending = adapter->buffer.size();
+                    for (size_t i = 0; i < pending; ++i)
+                    {
+                        CyphalTransfer t = adapter->buffer.pop();
+                        ++frames[link];
+                        deliver(link, t, adapter);
+                        adapter->memory_free(t.payload);
+                        moved = true;
+                    }
+                }
+                if (!moved)
+                    return;
+            }
+            converged = false;
+        }
+    };
+
+    template <typename Topology>
+    void traffic(Topology &net)
+    {
+        for (CyphalTransferID tid = 0; tid < 10; ++tid)
+        {
+            // sensor 10 on CAN publishes, only the ground link on serial wants it
+            net.send(CAN, makeTransfer(CyphalTransferKindMessage, 100, 10, CYPHAL_NODE_ID_UNSET, tid));
+            // local CAN traffic nobody outside CAN subscribes to
+            net.send(CAN, makeTransfer(CyphalTransferKindMessage, 300, 10, CYPHAL_NODE_ID_UNSET, tid));
+            // ground 20 on UDP asks CAN node 10
+            net.send(UDP, makeTransfer(CyphalTransferKindRequest, 200, 20, 10, tid));
+        }
+    }
+}
+
+TEST_CASE("CyphalRouter loopard topology forwards only where needed")
+{
+    Topology<CyphalRouter<>, CyphalRouter<>> routed;
+    // X: port 100 to serial, requests for CAN nodes to CAN, everything for serial nodes 20..29 on serial
+    routed.router_x.addRoute(SERIAL, 100);
+    routed.router_x.addRoute(CAN, 200, CyphalForwardRange{1, 19});
+    // Y: mirrors UDP requests onto serial, the redundant path back into X
+    routed.router_y.addRoute(0, 200, CyphalRouter<>::ANY_NODE);
+    traffic(routed);
+
+    Topology<FloodForwarding, FloodForwarding> flood;
+    traffic(flood);
+
+    MESSAGE("Forwarded frames, flood: CAN " << flood.frames[CAN] << ", serial " << flood.frames[SERIAL] << ", UDP " << flood.frames[UDP]
+            << (flood.converged ? "" : " (still looping, capped)")
+            << "; table: CAN " << routed.frames[CAN] << ", serial " << routed.frames[SERIAL] << ", UDP " << routed.frames[UDP]);
+
+    CHECK(routed.converged);
+    CHECK_FALSE(flood.converged);
+    CHECK(routed.total() < flood.total());
+
+    // 20 originals on CAN plus 10 requests forwarded once, the copy via Y is suppressed
+    CHECK(routed.frames[CAN] == 30);
+    // 10 messages from X plus 10 requests from Y
+    CHECK(routed.frames[SERIAL] == 20);
+    CHECK(routed.frames[UDP] == 10);
+
+    CHECK(routed.router_x.findRoute(SERIAL, 100)->forwarded == 10);
+    CHECK(routed.router_x.findRoute(CAN, 200, CyphalForwardRange{1, 19})->forwarded == 10);
+    CHECK(routed.router_y.findRoute(0, 200, CyphalRouter<>::ANY_NODE)->forwarded == 10);
+    CHECK(routed.router_x.suppressed() == 10);
+    CHECK(routed.router_x.unrouted() == 10); // port 300 stays on CAN
+}
+
+TEST_CASE("CyphalRouter loop suppression stops a bridge loop")
+{
+    // both bridges forward everything between serial and UDP
+    Topology<CyphalRouter<>, CyphalRouter<>> net;
+    net.router_x.addRoute(SERIAL, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE);
+    net.router_x.addRoute(UDP, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE);
+    net.router_y.addRoute(0, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE);
+    net.router_y.addRoute(1, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE);
+
+    net.send(UDP, makeTransfer(CyphalTransferKindMessage, 100, 20, CYPHAL_NODE_ID_UNSET, 0));
+
+    CHECK(net.converged);
+    // original on UDP, one copy on serial from each bridge
+    CHECK(net.frames[UDP] == 1);
+    CHECK(net.frames[SERIAL] == 2);
+    CHECK(net.router_x.suppressed() == 1);
+    CHECK(net.router_y.suppressed() == 1);
+}
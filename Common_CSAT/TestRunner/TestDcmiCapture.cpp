@@ -0,0 +1,337 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "DcmiCapture.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/configurable_memory_accessor.hpp"
+
+#include <cstdio>
+#include <vector>
+
+// The IRQ handlers of the mock are plain functions, like the vector table
+static DcmiCapture *active = nullptr;
+static void dmaIrq() { active->dmaInterrupt(); }
+static void dcmiIrq() { active->dcmiInterrupt(); }
+
+// JPEG-like stream: SOI, some segments with a counting payload, EOI
+static std::vector<uint8_t> make_jpeg(size_t size)
+{
+    std::vector<uint8_t> jpeg = {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10};
+    uint32_t lcg = 12345;
+    while (jpeg.size() < size - 2)
+    {
+        lcg = lcg * 1664525U + 1013904223U;
+        const auto byte = static_cast<uint8_t>(lcg >> 24);
+        jpeg.push_back(byte == 0xFF ? 0x00 : byte);
+    }
+    jpeg.push_back(0xFF);
+    jpeg.push_back(0xD9);
+    return jpeg;
+}
+
+static std::string write_temp_file(const std::vector<uint8_t> &bytes)
+{
+    const std::string path = "dcmi_capture_test.jpg";
+    FILE *f = std::fopen(path.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    REQUIRE(std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size());
+    std::fclose(f);
+    return path;
+}
+
+struct Fixture
+{
+    DcmiCapture dcmi;
+
+    Fixture()
+    {
+        mock_dcmi_reset();
+        active = &dcmi;
+        mock_dcmi_set_irq_handlers(dmaIrq, dcmiIrq);
+        REQUIRE(dcmi.configure(PixelFormat::JPEG, 640, 480));
+    }
+
+    ~Fixture()
+    {
+        mock_dcmi_reset();
+        active = nullptr;
+    }
+};
+
+// Consumer keeping everything in RAM, optionally slow
+struct VectorConsumer
+{
+    std::vector<uint8_t> bytes;
+    size_t chunks = 0;
+    size_t largest_chunk = 0;
+    bool ended = false;
+    bool aborted = false;
+    uint32_t delay_ms = 0;
+
+    bool onData(const uint8_t *data, size_t size)
+    {
+        bytes.insert(bytes.end(), data, data + size);
+        largest_chunk = std::max(largest_chunk, size);
+        ++chunks;
+        // SysTick keeps running while a slow write is in progress
+        if (delay_ms > 0)
+            HAL_Delay(delay_ms);
+        return true;
+    }
+    bool onFrameEnd() { ended = true; return true; }
+    void onAbort() { aborted = true; }
+};
+
+static_assert(DcmiConsumer<VectorConsumer>);
+static_assert(DcmiConsumer<DcmiImageBufferConsumer<ImageBuffer<ConfigurableMemoryAccessor>>>);
+
+template <typename Consumer>
+static DcmiStreamState run(DcmiCapture &dcmi, Consumer &consumer, uint32_t timeout_ms = 1000)
+{
+    DcmiStreamState state = dcmi.poll(consumer);
+    for (uint32_t t = 0; t < timeout_ms && state == DcmiStreamState::Capturing; ++t)
+    {
+        HAL_Delay(1);
+        state = dcmi.poll(consumer);
+    }
+    return state;
+}
+
+TEST_CASE("DcmiCapture: frame is streamed through the ring in halves")
+{
+    Fixture fx;
+    // not a multiple of the half size, so the frame ends inside a half
+    const auto jpeg = make_jpeg(10 * 1024 + 37);
+    REQUIRE(mock_dcmi_load_file(write_temp_file(jpeg).c_str()));
+    mock_dcmi_set_rate(64);
+
+    std::array<uint32_t, 256> ring{};
+    VectorConsumer consumer;
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    CHECK(fx.dcmi.streamState() == DcmiStreamState::Capturing);
+
+    CHECK(run(fx.dcmi, consumer) == DcmiStreamState::FrameDone);
+    CHECK(consumer.ended);
+    CHECK_FALSE(consumer.aborted);
+    CHECK(consumer.largest_chunk == ring.size() * sizeof(uint32_t) / 2);
+
+    // the last word is zero padded
+    REQUIRE(consumer.bytes.size() == (jpeg.size() + 3) / 4 * 4);
+    CHECK(std::equal(jpeg.begin(), jpeg.end(), consumer.bytes.begin()));
+    CHECK(mock_dcmi_frames_completed() == 1);
+
+    // snapshot mode: nothing moves after the frame
+    CHECK((DCMI->CR & DCMI_CR_CAPTURE) == 0);
+    CHECK((DMA2_Channel6->CCR & DMA_CCR_EN) == 0);
+
+    std::remove("dcmi_capture_test.jpg");
+}
+
+TEST_CASE("DcmiCapture: frame ending on a half boundary has no tail")
+{
+    Fixture fx;
+    const auto jpeg = make_jpeg(4 * 512); // four halves of 512 bytes
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(32);
+
+    std::array<uint32_t, 256> ring{};
+    VectorConsumer consumer;
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    CHECK(run(fx.dcmi, consumer) == DcmiStreamState::FrameDone);
+    CHECK(consumer.chunks == 4);
+    CHECK(consumer.bytes == jpeg);
+}
+
+TEST_CASE("DcmiCapture: slow consumer is reported as overrun")
+{
+    Fixture fx;
+    const auto jpeg = make_jpeg(16 * 1024);
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(64);
+
+    std::array<uint32_t, 128> ring{};
+    VectorConsumer consumer;
+    consumer.delay_ms = 5; // half a ring arrives every 1 ms
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+
+    CHECK(run(fx.dcmi, consumer) == DcmiStreamState::Overrun);
+    CHECK(consumer.aborted);
+    CHECK_FALSE(consumer.ended);
+    CHECK((DMA2_Channel6->CCR & DMA_CCR_EN) == 0);
+
+    // a new stream can be started after the abort
+    VectorConsumer fast;
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    CHECK(run(fx.dcmi, fast) == DcmiStreamState::FrameDone);
+    CHECK(std::equal(jpeg.begin(), jpeg.end(), fast.bytes.begin()));
+}
+
+TEST_CASE("DcmiCapture: invalid rings are rejected")
+{
+    Fixture fx;
+    std::array<uint32_t, 7> odd{};
+    CHECK_FALSE(fx.dcmi.startStream(odd.data(), odd.size()));
+    CHECK_FALSE(fx.dcmi.startStream(nullptr, 8));
+    CHECK(fx.dcmi.streamState() == DcmiStreamState::Idle);
+}
+
+// Segments that fill one 4 KiB erase block each
+constexpr size_t BLOCK = 4096;
+constexpr size_t SEGMENT = BLOCK - sizeof(StorageHeader) - sizeof(ImageMetadata) - sizeof(crc_t);
+using SegmentConsumer = DcmiImageBufferConsumer<ImageBuffer<ConfigurableMemoryAccessor>>;
+
+// Pops segments up to and including the last one of a frame
+template <typename Buffer>
+static std::vector<uint8_t> read_frame(Buffer &buffer, bool &complete, size_t segment = SEGMENT)
+{
+    std::vector<uint8_t> bytes;
+    complete = false;
+    for (uint16_t index = 0; !buffer.is_empty() && !complete; ++index)
+    {
+        ImageMetadata read{};
+        REQUIRE(buffer.get_image(read) == ImageBufferError::NO_ERROR);
+        CHECK(read.format == METADATA_FORMAT::CHNK);
+        CHECK(read.dimensions.n3 == index);
+        REQUIRE(read.payload_size == segment);
+
+        std::vector<uint8_t> payload(read.payload_size);
+        size_t size = payload.size();
+        REQUIRE(buffer.get_data_chunk(payload.data(), size) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+
+        DcmiSegmentTrailer trailer{};
+        std::memcpy(&trailer, payload.data() + segment - sizeof(trailer), sizeof(trailer));
+        CHECK(trailer.index == index);
+        CHECK(trailer.format == METADATA_FORMAT::JPEG);
+        REQUIRE(trailer.bytes <= segment - sizeof(trailer));
+        bytes.insert(bytes.end(), payload.begin(), payload.begin() + trailer.bytes);
+        complete = trailer.last != 0;
+    }
+    return bytes;
+}
+
+TEST_CASE("DcmiCapture: JPEG streamed into ImageBuffer segments")
+{
+    Fixture fx;
+    const auto jpeg = make_jpeg(6000 + 3);
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(64);
+
+    ConfigurableMemoryAccessor flash(0, 64 * 1024, BLOCK);
+    ImageBuffer<ConfigurableMemoryAccessor> buffer(flash);
+    REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+
+    SegmentConsumer consumer(buffer, SEGMENT);
+    ImageMetadata meta{};
+    meta.format = METADATA_FORMAT::JPEG;
+    meta.producer = METADATA_PRODUCER::CAMERA_1;
+    meta.payload_size = 16 * 1024;
+    REQUIRE(consumer.begin(meta));
+
+    std::array<uint32_t, 256> ring{};
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    REQUIRE(run(fx.dcmi, consumer) == DcmiStreamState::FrameDone);
+
+    // the blocks the frame needs, not the ones of the largest frame
+    const size_t frame_bytes = (jpeg.size() + 3) / 4 * 4;
+    CHECK(consumer.written() == frame_bytes);
+    CHECK(consumer.segments() == 2);
+    CHECK(buffer.count() == 2);
+    CHECK(buffer.get_tail() <= 2 * BLOCK);
+
+    ImageMetadata first{};
+    REQUIRE(buffer.get_image(first) == ImageBufferError::NO_ERROR);
+    CHECK(first.producer == METADATA_PRODUCER::CAMERA_1);
+
+    bool complete = false;
+    const auto bytes = read_frame(buffer, complete);
+    CHECK(complete);
+    REQUIRE(bytes.size() == frame_bytes);
+    CHECK(std::equal(jpeg.begin(), jpeg.end(), bytes.begin()));
+    CHECK(buffer.is_empty());
+}
+
+TEST_CASE("DcmiCapture: frame filling its last segment exactly")
+{
+    Fixture fx;
+    // DCMI delivers whole words, so the segment holds a multiple of four bytes
+    constexpr size_t segment = (SEGMENT - sizeof(DcmiSegmentTrailer)) / 4 * 4 + sizeof(DcmiSegmentTrailer);
+    const auto jpeg = make_jpeg(2 * (segment - sizeof(DcmiSegmentTrailer)));
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(64);
+
+    ConfigurableMemoryAccessor flash(0, 64 * 1024, BLOCK);
+    ImageBuffer<ConfigurableMemoryAccessor> buffer(flash);
+    REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+
+    SegmentConsumer consumer(buffer, segment);
+    ImageMetadata meta{};
+    meta.format = METADATA_FORMAT::JPEG;
+    meta.payload_size = 16 * 1024;
+    REQUIRE(consumer.begin(meta));
+
+    std::array<uint32_t, 256> ring{};
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    REQUIRE(run(fx.dcmi, consumer) == DcmiStreamState::FrameDone);
+
+    // no empty segment just to carry the last flag
+    CHECK(buffer.count() == 2);
+    bool complete = false;
+    CHECK(read_frame(buffer, complete, segment) == jpeg);
+    CHECK(complete);
+}
+
+TEST_CASE("DcmiCapture: frame larger than the limit leaves no last segment")
+{
+    Fixture fx;
+    const auto jpeg = make_jpeg(6000);
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(64);
+
+    ConfigurableMemoryAccessor flash(0, 64 * 1024, BLOCK);
+    ImageBuffer<ConfigurableMemoryAccessor> buffer(flash);
+    REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+
+    SegmentConsumer consumer(buffer, SEGMENT);
+    ImageMetadata meta{};
+    meta.format = METADATA_FORMAT::JPEG;
+    meta.payload_size = 4608;
+    REQUIRE(consumer.begin(meta));
+
+    std::array<uint32_t, 256> ring{};
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    CHECK(run(fx.dcmi, consumer) == DcmiStreamState::Error);
+
+    bool complete = true;
+    read_frame(buffer, complete);
+    CHECK_FALSE(complete);
+
+    // the open segment is reused by the next frame
+    Fixture again;
+    const auto small = make_jpeg(1000);
+    mock_dcmi_load(small.data(), small.size());
+    mock_dcmi_set_rate(64);
+    REQUIRE(consumer.begin(meta));
+    REQUIRE(again.dcmi.startStream(ring.data(), ring.size()));
+    REQUIRE(run(again.dcmi, consumer) == DcmiStreamState::FrameDone);
+    const auto bytes = read_frame(buffer, complete);
+    CHECK(complete);
+    CHECK(std::equal(small.begin(), small.end(), bytes.begin()));
+}
+
+TEST_CASE("DcmiCapture: frame ending at transfer complete while a half is unread")
+{
+    Fixture fx;
+    const auto jpeg = make_jpeg(2 * 512); // exactly one ring of two 512 byte halves
+    mock_dcmi_load(jpeg.data(), jpeg.size());
+    mock_dcmi_set_rate(128);              // one half per tick
+
+    // the second half and the frame end arrive while the first is being read
+    std::array<uint32_t, 256> ring{};
+    VectorConsumer consumer;
+    consumer.delay_ms = 1;
+    REQUIRE(fx.dcmi.startStream(ring.data(), ring.size()));
+    CHECK(run(fx.dcmi, consumer) == DcmiStreamState::FrameDone);
+    CHECK_FALSE(consumer.aborted);
+    CHECK(consumer.bytes == jpeg);
+}
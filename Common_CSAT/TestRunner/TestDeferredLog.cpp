@@ -0,0 +1,325 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "DeferredLog.hpp"
+#include "TaskDrainLog.hpp"
+#include "LogDecoder.hpp"
+#include "mock_hal.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using deferred_log::Entry;
+
+static void drainAll()
+{
+    Entry entry;
+    while (deferred_log::ring.peek(entry))
+        deferred_log::ring.pop();
+}
+
+static std::string formatNext()
+{
+    Entry entry;
+    REQUIRE(deferred_log::ring.peek(entry));
+    char text[256];
+    const size_t n = deferred_log::format(entry, text, sizeof(text));
+    deferred_log::ring.pop();
+    return std::string(text, n);
+}
+
+static std::string printf_string(const char *format, ...)
+{
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return text;
+}
+
+static int side_effects = 0;
+static int count_call(int v)
+{
+    ++side_effects;
+    return v;
+}
+
+enum class Mode : uint8_t
+{
+    Idle = 3
+};
+
+TEST_CASE("DeferredLog: entries format like printf")
+{
+    drainAll();
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "plain text\r\n");
+    CHECK(formatNext() == "plain text\r\n");
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "int %d unsigned %u hex %2x %08X", -42, 4000000000U, 0xab, 0xdeadbeefU);
+    CHECK(formatNext() == printf_string("int %d unsigned %u hex %2x %08X", -42, 4000000000U, 0xab, 0xdeadbeefU));
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "%3d -> %3d (%4d %3d) at %08u", uint8_t{13}, uint8_t{7}, uint16_t{7509}, uint8_t{9}, 12345U);
+    CHECK(formatNext() == " 13 ->   7 (7509   9) at 00012345");
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "64 bit %lld %llu %lx", int64_t{-1234567890123}, uint64_t{18446744073709551615ULL}, 0x123456789aUL);
+    CHECK(formatNext() == "64 bit -1234567890123 18446744073709551615 123456789a");
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "float %f %.2f %e %g", 3.14f, 2.71828, 1.5e-7, 100.0f);
+    CHECK(formatNext() == printf_string("float %f %.2f %e %g", 3.14f, 2.71828, 1.5e-7, 100.0f));
+
+    const char *name = "camera";
+    LOG_DEFERRED(LOG_LEVEL_INFO, "%s is %-8s| %c 100%%", name, "ready", 'x');
+    CHECK(formatNext() == "camera is ready   | x 100%");
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "mode %d, negative as hex %x", Mode::Idle, -1);
+    CHECK(formatNext() == "mode 3, negative as hex ffffffff");
+
+    const uint8_t data[] = {0x00, 0x1F, 0xA5, 0xFF};
+    LOG_DEFERRED(LOG_LEVEL_DEBUG, "chunk %s", deferred_log::Bytes{data, sizeof(data)});
+    CHECK(formatNext() == "chunk 00 1F A5 FF");
+
+    // more conversions than arguments
+    LOG_DEFERRED(LOG_LEVEL_INFO, "%d %d", 1);
+    CHECK(formatNext() == "1 ?");
+}
+
+TEST_CASE("DeferredLog: calls below LOG_LEVEL are removed with their arguments")
+{
+    drainAll();
+    side_effects = 0;
+
+    LOG_DEFERRED(LOG_LEVEL_TRACE, "trace %d", count_call(1));
+    CHECK(side_effects == 0);
+    CHECK(deferred_log::ring.size() == 0);
+
+    LOG_DEFERRED(LOG_LEVEL_DEBUG, "debug %d", count_call(2));
+    CHECK(side_effects == 1);
+    CHECK(deferred_log::ring.size() == 1);
+    drainAll();
+}
+
+TEST_CASE("DeferredLog: long strings and byte dumps are truncated to the slot")
+{
+    drainAll();
+
+    std::vector<uint8_t> chunk(1024);
+    for (size_t i = 0; i < chunk.size(); ++i)
+        chunk[i] = static_cast<uint8_t>(i);
+    LOG_DEFERRED(LOG_LEVEL_DEBUG, "getChunk %u %s", static_cast<unsigned>(chunk.size()), deferred_log::Bytes{chunk.data(), chunk.size()});
+
+    Entry entry;
+    REQUIRE(deferred_log::ring.peek(entry));
+    CHECK(entry.size <= deferred_log::Ring::payloadCapacity());
+    const std::string text = formatNext();
+    CHECK(text.rfind("getChunk 1024 00 01 02 03", 0) == 0);
+
+    const std::string long_name(300, 'n');
+    LOG_DEFERRED(LOG_LEVEL_INFO, "[%s]", long_name.c_str());
+    const std::string truncated = formatNext();
+    CHECK(truncated.size() == deferred_log::Ring::payloadCapacity() - 1 + 2);
+    CHECK(truncated.front() == '[');
+    CHECK(truncated.back() == ']');
+}
+
+TEST_CASE("DeferredLog: a full ring drops new entries and keeps the old ones")
+{
+    using SmallRing = deferred_log::DeferredLogRing<4, 16>;
+    static constexpr deferred_log::Site site{deferred_log::fnv1a("n %d"), LOG_LEVEL_INFO, "n %d"};
+
+    SmallRing ring;
+    for (int i = 0; i < 6; ++i)
+        CHECK(ring.record(site, i) == (i < 4));
+    CHECK(ring.size() == 4);
+    CHECK(ring.dropped() == 2);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Entry entry;
+        REQUIRE(ring.peek(entry));
+        char text[16];
+        deferred_log::format(entry, text, sizeof(text));
+        CHECK(std::string(text) == "n " + std::to_string(i));
+        ring.pop();
+    }
+    Entry entry;
+    CHECK_FALSE(ring.peek(entry));
+
+    // wraps around
+    for (int lap = 0; lap < 10; ++lap)
+    {
+        REQUIRE(ring.record(site, lap));
+        REQUIRE(ring.peek(entry));
+        ring.pop();
+    }
+    CHECK(ring.size() == 0);
+}
+
+TEST_CASE("DeferredLog: concurrent producers lose nothing that fits")
+{
+    using Ring = deferred_log::DeferredLogRing<1024, 16>;
+    static constexpr deferred_log::Site site{deferred_log::fnv1a("%u %u"), LOG_LEVEL_INFO, "%u %u"};
+    static Ring ring;
+
+    constexpr unsigned PRODUCERS = 4;
+    constexpr unsigned PER_PRODUCER = 20000;
+    std::vector<unsigned> next(PRODUCERS, 0);
+    size_t consumed = 0;
+    bool in_order = true;
+
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < PRODUCERS; ++p)
+        producers.emplace_back([p]
+                               {
+            for (unsigned i = 0; i < PER_PRODUCER;)
+                if (ring.record(site, p, i))
+                    ++i; });
+
+    while (consumed < PRODUCERS * PER_PRODUCER)
+    {
+        Entry entry;
+        if (!ring.peek(entry))
+            continue;
+        uint32_t p, i;
+        std::memcpy(&p, entry.payload, 4);
+        std::memcpy(&i, entry.payload + 4, 4);
+        in_order = in_order && p < PRODUCERS && next[p] == i;
+        if (p < PRODUCERS)
+            next[p] = i + 1;
+        ring.pop();
+        ++consumed;
+    }
+    for (auto &t : producers)
+        t.join();
+
+    CHECK(in_order);
+    CHECK(consumed == PRODUCERS * PER_PRODUCER);
+    CHECK(ring.size() == 0);
+}
+
+TEST_CASE("DeferredLog: binary frames decode on the ground")
+{
+    drainAll();
+
+    LogDecoder decoder;
+    const size_t found = decoder.addSource(R"src(
+        LOG_DEFERRED(LOG_LEVEL_INFO, "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", HAL_GetTick(),
+                     a, b, c, d, e);
+        LOG_DEFERRED(LOG_LEVEL_DEBUG, "joined " "literal %s", name);
+        MY_LOG_DEFERRED(LOG_LEVEL_DEBUG, "not this one");
+    )src");
+    CHECK(found == 2);
+    CHECK(decoder.formats() == 2);
+    CHECK(decoder.collisions() == 0);
+
+    set_current_tick(1234);
+    LOG_DEFERRED(LOG_LEVEL_INFO, "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", 1234U, 0, 13, 255, 7509, 5);
+    LOG_DEFERRED(LOG_LEVEL_DEBUG, "joined " "literal %s", "ok");
+    LOG_DEFERRED(LOG_LEVEL_ERROR, "not in the dictionary %d", 1);
+
+    std::vector<uint8_t> stream = {0x00, 0xA5}; // garbage before the first frame
+    Entry entry;
+    while (deferred_log::ring.peek(entry))
+    {
+        uint8_t frame[128];
+        const size_t size = deferred_log::encode(entry, frame, sizeof(frame));
+        REQUIRE(size > 0);
+        stream.insert(stream.end(), frame, frame + size);
+        deferred_log::ring.pop();
+    }
+
+    const auto entries = decoder.decode(stream.data(), stream.size());
+    REQUIRE(entries.size() == 3);
+    CHECK(entries[0].text == "canardTxPush at 00001234:   0 ( 13 -> 255) (7509   5)\r\n");
+    CHECK(entries[0].tick == 1234);
+    CHECK(entries[0].level == LOG_LEVEL_INFO);
+    CHECK(entries[1].text == "joined literal ok");
+    CHECK(entries[1].level == LOG_LEVEL_DEBUG);
+    CHECK(entries[2].text.rfind("<unknown format", 0) == 0);
+    CHECK(decoder.unknown() == 1);
+    CHECK(decoder.skipped() == 2);
+}
+
+TEST_CASE("TaskDrainLog: drains a bounded number of entries per run")
+{
+    drainAll();
+    for (int i = 0; i < 10; ++i)
+        LOG_DEFERRED(LOG_LEVEL_INFO, "entry %d", i);
+
+    TaskDrainLog task(0, 0, TaskDrainLog::Output::Text, 4);
+    task.handleTask();
+    CHECK(task.drained() == 4);
+    CHECK(deferred_log::ring.size() == 6);
+    task.handleTask();
+    task.handleTask();
+    CHECK(task.drained() == 10);
+    CHECK(deferred_log::ring.size() == 0);
+}
+
+#ifdef LOGGER_OUTPUT_STDERR
+TEST_CASE("TaskDrainLog: text and binary output through the Logger")
+{
+    drainAll();
+    std::stringstream ss;
+    Logger::setLogStream(&ss);
+
+    LOG_DEFERRED(LOG_LEVEL_INFO, "drained %d", 7);
+    TaskDrainLog text(0, 0);
+    text.handleTask();
+    CHECK(ss.str() == "drained 7\n");
+
+    ss.str("");
+    LOG_DEFERRED(LOG_LEVEL_INFO, "drained %d", 8);
+    TaskDrainLog binary(0, 0, TaskDrainLog::Output::Binary);
+    binary.handleTask();
+
+    LogDecoder decoder;
+    decoder.addFormat("drained %d");
+    const std::string bytes = ss.str();
+    const auto entries = decoder.decode(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+    REQUIRE(entries.size() == 1);
+    CHECK(entries[0].text == "drained 8");
+
+    Logger::setLogStream(&std::cerr);
+}
+#endif
+
+TEST_CASE("DeferredLog: recording is cheaper than formatting")
+{
+    drainAll();
+    using clock = std::chrono::steady_clock;
+    constexpr int N = 50000;
+
+    char buffer[256];
+    int sink = 0;
+    auto start = clock::now();
+    for (int i = 0; i < N; ++i)
+        sink += snprintf(buffer, sizeof(buffer), "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", static_cast<unsigned>(i), 0, 13, 255, 7509, i & 31);
+    const auto formatted = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+    TaskDrainLog task(0, 0, TaskDrainLog::Output::Text, deferred_log::Ring::capacity());
+    start = clock::now();
+    for (int i = 0; i < N; ++i)
+    {
+        LOG_DEFERRED(LOG_LEVEL_INFO, "canardTxPush at %08u: %3d (%3d -> %3d) (%4d %3d)\r\n", static_cast<unsigned>(i), 0, 13, 255, 7509, i & 31);
+        // empty the ring without timing the formatting
+        if (deferred_log::ring.size() == deferred_log::Ring::capacity())
+        {
+            const auto paused = clock::now();
+            drainAll();
+            start += clock::now() - paused;
+        }
+    }
+    const auto recorded = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+    drainAll();
+
+    CHECK(sink > 0);
+    CHECK(deferred_log::ring.dropped() == 0);
+    MESSAGE("snprintf " << formatted << " ns per message, LOG_DEFERRED " << recorded << " ns per message");
+}
@@ -0,0 +1,374 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "Ephemeris.hpp"
+#include "TaskSGP4.hpp"
+#include "imagebuffer/configurable_memory_accessor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "au.hpp"
+#include "mock_hal.h"
+
+using namespace std::chrono_literals;
+using time_point = std::chrono::system_clock::time_point;
+using Position = std::array<au::QuantityF<au::MetersInEcefFrame>, 3>;
+using Velocity = std::array<au::QuantityF<au::MetersPerSecondInEcefFrame>, 3>;
+
+static SGP4TwoLineElement parse_tle(const char *line1, const char *line2)
+{
+    char l1[130], l2[130];
+    std::snprintf(l1, sizeof(l1), "%s", line1);
+    std::snprintf(l2, sizeof(l2), "%s", line2);
+    auto parsed = sgp4_utils::parseTLE(l1, l2);
+    REQUIRE(parsed.has_value());
+    return parsed.value();
+}
+
+static const SGP4TwoLineElement ISS = parse_tle(
+    "1 25544U 98067A   25176.73245655  .00008102  00000-0  14854-3 0  9994",
+    "2 25544  51.6390 264.7180 0001990 278.3788 217.2311 15.50240116516482");
+
+static const SGP4TwoLineElement GEO = parse_tle(
+    "1 28884U 05041A   25176.50000000 -.00000288  00000-0  00000-0 0  9995",
+    "2 28884   0.0156 250.8312 0002459 151.6412 280.8990  1.00271024 72164");
+
+static time_point at(uint8_t hour, uint8_t minute, uint8_t second = 0)
+{
+    return TimeUtils::to_timepoint(TimeUtils::DateTimeComponents{
+        .year = 2025, .month = 6, .day = 26, .hour = hour, .minute = minute, .second = second, .millisecond = 0});
+}
+
+static void set_rtc(RTC_HandleTypeDef &hrtc, time_point when)
+{
+    TimeUtils::RTCDateTimeSubseconds rtc = TimeUtils::to_rtc(TimeUtils::to_epoch_duration(when), hrtc.Init.SynchPrediv);
+    HAL_RTC_SetTime(&hrtc, &rtc.time, RTC_FORMAT_BIN);
+    HAL_RTC_SetDate(&hrtc, &rtc.date, RTC_FORMAT_BIN);
+    HAL_RTCEx_SetSynchroShift(&hrtc, RTC_SHIFTADD1S_RESET, rtc.time.SubSeconds);
+}
+
+static float distance(const Position &a, const Position &b)
+{
+    float sum = 0.0f;
+    for (size_t k = 0; k < 3; ++k)
+    {
+        const float d = a[k].in(au::meters * au::ecefs) - b[k].in(au::meters * au::ecefs);
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+static float distance(const Velocity &a, const Velocity &b)
+{
+    float sum = 0.0f;
+    for (size_t k = 0; k < 3; ++k)
+    {
+        const float d = a[k].in(au::meters * au::ecefs / au::seconds) - b[k].in(au::meters * au::ecefs / au::seconds);
+        sum += d * d;
+    }
+    return std::sqrt(sum);
+}
+
+struct Error
+{
+    float position = 0.0f;     // m, largest
+    float velocity = 0.0f;     // m/s, largest
+    float positionRms = 0.0f;  // m
+};
+
+// Difference to direct SGP4 predictions every second of the table
+template <typename Storage>
+static Error table_error(Ephemeris<Storage> &ephemeris, SGP4 &sgp4)
+{
+    Error error;
+    double sum = 0.0;
+    size_t n = 0;
+    for (time_point t = ephemeris.start(); t <= ephemeris.end(); t += 1s)
+    {
+        Position r_table, r_direct;
+        Velocity v_table, v_direct;
+        REQUIRE(ephemeris.interpolate(t, r_table, v_table));
+        REQUIRE(sgp4.predict_at(t, r_direct, v_direct));
+        const float d = distance(r_table, r_direct);
+        error.position = std::max(error.position, d);
+        error.velocity = std::max(error.velocity, distance(v_table, v_direct));
+        sum += double(d) * double(d);
+        ++n;
+    }
+    error.positionRms = float(std::sqrt(sum / double(n)));
+    return error;
+}
+
+RTC_HandleTypeDef hrtc;
+
+TEST_CASE("Ephemeris: the table answers the samples themselves")
+{
+    SGP4 sgp4(&hrtc, ISS);
+    RamEphemerisStorage<128> storage;
+    Ephemeris<RamEphemerisStorage<128>> ephemeris(storage);
+    REQUIRE(ephemeris.build(sgp4, at(18, 0), 60s, 100));
+    CHECK(ephemeris.end() == at(18, 0) + 99min);
+
+    for (time_point t = ephemeris.start(); t <= ephemeris.end(); t += 60s)
+    {
+        Position r_table, r_direct;
+        Velocity v_table, v_direct;
+        REQUIRE(ephemeris.interpolate(t, r_table, v_table));
+        REQUIRE(sgp4.predict_at(t, r_direct, v_direct));
+        CHECK(distance(r_table, r_direct) < 0.01f);
+        CHECK(distance(v_table, v_direct) < 1e-3f);
+    }
+
+    Position r;
+    Velocity v;
+    CHECK_FALSE(ephemeris.interpolate(ephemeris.start() - 1ms, r, v));
+    CHECK_FALSE(ephemeris.interpolate(ephemeris.end() + 1ms, r, v));
+
+    // too long for the storage, or a single sample
+    CHECK_FALSE(ephemeris.build(sgp4, at(18, 0), 60s, 129));
+    CHECK_FALSE(ephemeris.valid());
+    CHECK_FALSE(ephemeris.build(sgp4, at(18, 0), 60s, 1));
+
+    // no TLE, nothing to propagate
+    SGP4 empty(&hrtc);
+    CHECK_FALSE(ephemeris.build(empty, at(18, 0), 60s, 10));
+}
+
+// Noise of direct SGP4 from one second to the next: the float minutes since
+// epoch resolve ~7 ms (~55 m along track a day after the epoch), the rms of
+// the second difference over sqrt(6) is the rms of that noise
+static float sgp4_noise(SGP4 &sgp4, time_point start, std::chrono::seconds span)
+{
+    double sum = 0.0;
+    size_t n = 0;
+    Position r0, r1, r2;
+    Velocity v;
+    REQUIRE(sgp4.predict_at(start, r0, v));
+    REQUIRE(sgp4.predict_at(start + 1s, r1, v));
+    for (time_point t = start + 2s; t <= start + span; t += 1s)
+    {
+        REQUIRE(sgp4.predict_at(t, r2, v));
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const double d = double(r0[k].in(au::meters * au::ecefs)) - 2.0 * double(r1[k].in(au::meters * au::ecefs)) +
+                             double(r2[k].in(au::meters * au::ecefs));
+            sum += d * d;
+        }
+        ++n;
+        r0 = r1;
+        r1 = r2;
+    }
+    return float(std::sqrt(sum / double(n) / 6.0));
+}
+
+TEST_CASE("Ephemeris: accuracy against direct SGP4 for step sizes")
+{
+    RamEphemerisStorage<800> storage;
+    Ephemeris<RamEphemerisStorage<800>> ephemeris(storage);
+
+    SUBCASE("ISS, one orbit is ~93 minutes")
+    {
+        SGP4 sgp4(&hrtc, ISS);
+        const float noise = sgp4_noise(sgp4, at(18, 0), 95min);
+        MESSAGE("ISS direct SGP4 noise " << noise << " m rms");
+
+        for (auto step : {15s, 30s, 60s, 120s, 240s})
+        {
+            CAPTURE(step.count());
+            const auto count = static_cast<size_t>(std::chrono::seconds(95min) / step) + 1;
+            REQUIRE(ephemeris.build(sgp4, at(18, 0), step, count));
+            const Error error = table_error(ephemeris, sgp4);
+
+            MESSAGE("ISS, " << step.count() << " s step, " << count << " samples (" << count * sizeof(EphemerisSample)
+                    << " bytes): position " << error.positionRms << " m rms, " << error.position << " m max, velocity "
+                    << error.velocity << " m/s max");
+
+            // up to two minutes the interpolation error is lost in the noise of
+            // SGP4 itself, in the samples and in the reference
+            if (step <= 120s)
+                CHECK(error.positionRms < 2.0f * noise);
+            if (step >= 60s)
+                CHECK(error.velocity < 5.0f);
+        }
+    }
+
+    SUBCASE("GEO, one orbit is a day")
+    {
+        SGP4 sgp4(&hrtc, GEO);
+        const float noise = sgp4_noise(sgp4, at(0, 0), 60min);
+        MESSAGE("GEO direct SGP4 noise " << noise << " m rms");
+
+        // the error does not grow with the step, it is the SGP4 noise
+        float finest = 0.0f;
+        for (auto step : {5min, 10min, 20min})
+        {
+            CAPTURE(step.count());
+            const auto count = static_cast<size_t>(std::chrono::minutes(24h) / step) + 1;
+            REQUIRE(ephemeris.build(sgp4, at(0, 0), step, count));
+            const Error error = table_error(ephemeris, sgp4);
+
+            MESSAGE("GEO, " << step.count() << " min step, " << count << " samples: position "
+                    << error.positionRms << " m rms, " << error.position << " m max, velocity "
+                    << error.velocity << " m/s max");
+            if (finest == 0.0f)
+                finest = error.positionRms;
+            CHECK(error.positionRms < 1.2f * finest);
+        }
+    }
+}
+
+// Counts the reads that reach the accessor
+struct CountingAccessor : ConfigurableMemoryAccessor
+{
+    using ConfigurableMemoryAccessor::ConfigurableMemoryAccessor;
+
+    AccessorError read(size_t address, uint8_t *data, size_t size)
+    {
+        ++reads;
+        return ConfigurableMemoryAccessor::read(address, data, size);
+    }
+
+    size_t reads = 0;
+};
+
+TEST_CASE("Ephemeris: table in an accessor region reads two samples per step")
+{
+    CountingAccessor mram(0, 128 * 1024, 256);
+    using Storage = AccessorEphemerisStorage<CountingAccessor>;
+    Storage storage(mram, 4096, 100 * sizeof(EphemerisSample) + 5);
+    CHECK(storage.capacity() == 100);
+
+    SGP4 sgp4(&hrtc, ISS);
+    Ephemeris<Storage> ephemeris(storage);
+    REQUIRE(ephemeris.build(sgp4, at(18, 0), 60s, 100));
+    CHECK_FALSE(ephemeris.build(sgp4, at(18, 0), 60s, 101));
+    REQUIRE(ephemeris.build(sgp4, at(18, 0), 60s, 100));
+
+    RamEphemerisStorage<100> ram;
+    Ephemeris<RamEphemerisStorage<100>> reference(ram);
+    REQUIRE(reference.build(sgp4, at(18, 0), 60s, 100));
+
+    // a query a second for ten minutes
+    mram.reads = 0;
+    for (time_point t = at(18, 0); t < at(18, 10); t += 1s)
+    {
+        Position r, r_ram;
+        Velocity v, v_ram;
+        REQUIRE(ephemeris.interpolate(t, r, v));
+        REQUIRE(reference.interpolate(t, r_ram, v_ram));
+        CHECK(distance(r, r_ram) == 0.0f);
+        CHECK(distance(v, v_ram) == 0.0f);
+    }
+    CHECK(mram.reads == 2 + 9);
+
+    // backwards is one read per step too, a jump reads both samples
+    mram.reads = 0;
+    Position r;
+    Velocity v;
+    REQUIRE(ephemeris.interpolate(at(18, 8, 30), r, v));
+    CHECK(mram.reads == 1);
+    REQUIRE(ephemeris.interpolate(at(19, 0, 30), r, v));
+    CHECK(mram.reads == 3);
+}
+
+TEST_CASE("EphemerisPosition: interpolates inside the table and falls back to SGP4 outside")
+{
+    hrtc.Init.SynchPrediv = 1023;
+    SGP4 sgp4(&hrtc, ISS);
+    RamEphemerisStorage<128> storage;
+    Ephemeris<RamEphemerisStorage<128>> ephemeris(storage);
+    EphemerisPosition<SGP4, RamEphemerisStorage<128>> position(&hrtc, sgp4, ephemeris, 60s, 100, 10min);
+
+    auto check_against_sgp4 = [&](time_point when) {
+        set_rtc(hrtc, when);
+        Position r, r_direct;
+        Velocity v, v_direct;
+        au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+        REQUIRE(position.predict(r, v, timestamp));
+        CHECK(timestamp.in(au::milli(au::seconds)) == uint64_t(TimeUtils::to_epoch_duration(when).count()));
+        REQUIRE(sgp4.predict_at(when, r_direct, v_direct));
+        return distance(r, r_direct);
+    };
+
+    // no table yet: direct SGP4
+    CHECK(check_against_sgp4(at(18, 0, 30)) == 0.0f);
+
+    set_rtc(hrtc, at(18, 0, 30));
+    REQUIRE(position.refresh());
+    CHECK(ephemeris.start() == at(18, 0, 30));
+    CHECK(ephemeris.end() == at(18, 0, 30) + 99min);
+    const float inside = check_against_sgp4(at(18, 20, 10));
+    CHECK(inside > 0.0f);
+    CHECK(inside < 500.0f);
+
+    const PositionSolution solution = position.predict();
+    CHECK(solution.has_valid(PositionSolution::Validity::POSITION));
+    CHECK(solution.has_valid(PositionSolution::Validity::VELOCITY));
+
+    // nothing to do while the table lasts longer than the margin
+    set_rtc(hrtc, at(19, 0));
+    REQUIRE(position.refresh());
+    CHECK(ephemeris.start() == at(18, 0, 30));
+
+    // past the table: direct SGP4, refresh() starts a new table from now
+    CHECK(check_against_sgp4(at(20, 0)) == 0.0f);
+    set_rtc(hrtc, at(19, 35));
+    REQUIRE(position.refresh());
+    CHECK(ephemeris.start() == at(19, 35));
+
+    // a new TLE makes the table stale at once
+    sgp4.setSGP4TLE(GEO);
+    CHECK(check_against_sgp4(at(19, 40)) == 0.0f);
+    set_rtc(hrtc, at(19, 40));
+    REQUIRE(position.refresh());
+    CHECK(ephemeris.builtFrom(GEO));
+    CHECK(check_against_sgp4(at(19, 50, 17)) < 500.0f);
+}
+
+TEST_CASE("Ephemeris: lookup latency against direct SGP4")
+{
+    SGP4 sgp4(&hrtc, ISS);
+    RamEphemerisStorage<200> storage;
+    Ephemeris<RamEphemerisStorage<200>> ephemeris(storage);
+
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    REQUIRE(ephemeris.build(sgp4, at(18, 0), 30s, 191));
+    const auto build = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+    // queries 10 ms apart over the table, like a control loop would ask
+    constexpr int N = 200000;
+    std::vector<time_point> times;
+    times.reserve(N);
+    for (int i = 0; i < N; ++i)
+        times.push_back(at(18, 0) + std::chrono::milliseconds(i * 10 % (95 * 60 * 1000)));
+
+    Position r;
+    Velocity v;
+    float sink = 0.0f;
+
+    start = clock::now();
+    for (const time_point &t : times)
+    {
+        ephemeris.interpolate(t, r, v);
+        sink += r[0].in(au::meters * au::ecefs);
+    }
+    const auto table = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+    constexpr int M = 20000;
+    start = clock::now();
+    for (int i = 0; i < M; ++i)
+    {
+        sgp4.predict_at(times[size_t(i)], r, v);
+        sink += r[0].in(au::meters * au::ecefs);
+    }
+    const auto direct = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / M;
+
+    MESSAGE("ISS: build of 191 samples (30 s step) " << build << " us, lookup " << table
+            << " ns, direct SGP4 + TEME -> ECEF " << direct << " ns (" << sink << ")");
+    CHECK(table < direct);
+}
@@ -40,6 +40,27 @@ TEST_CASE("GNSS getNavPosECEF Trivial Test")
         CHECK(!navPosECEF.has_value());
     }
 
+    SUBCASE("One Checksum Byte Wrong")
+    {
+        uint8_t test_data[] = {0xB5, 0x62, 0x01, 0x01, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0xe8};
+        inject_uart_rx_data(test_data, sizeof(test_data));
+        std::optional<PositionECEF> navPosECEF = gnss.getNavPosECEF();
+        CHECK(!navPosECEF.has_value());
+    }
+
+    SUBCASE("Frame In Second Half Of Buffer")
+    {
+        clear_uart_rx_buffer();
+        std::vector<uint8_t> test_data(150, 0x00);
+        const uint8_t frame[] = {0xB5, 0x62, 0x01, 0x01, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x87};
+        test_data.insert(test_data.end(), std::begin(frame), std::end(frame));
+        inject_uart_rx_data(test_data.data(), test_data.size());
+
+        std::optional<PositionECEF> navPosECEF = gnss.getNavPosECEF();
+        REQUIRE(navPosECEF.has_value());
+        CHECK(navPosECEF.value().ecefX == 10);
+    }
+
     SUBCASE("Wrong ClassID")
     {
         uint8_t test_data[] = {0xB5, 0x62, 0x02, 0x01, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}; // Wrong ClassID
@@ -0,0 +1,302 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "ImageBuffer.hpp"
+#include "imagebuffer/checkpoint.hpp"
+#include "imagebuffer/configurable_memory_accessor.hpp"
+
+#include <chrono>
+#include <vector>
+
+// ConfigurableMemoryAccessor that counts what the mount costs
+class CountingAccessor
+{
+public:
+    CountingAccessor(size_t size, size_t erase_block_size) : mem_(0, size, erase_block_size) {}
+
+    AccessorError write(size_t address, const uint8_t *data, size_t size) { return mem_.write(address, data, size); }
+    AccessorError read(size_t address, uint8_t *data, size_t size)
+    {
+        ++reads;
+        bytes_read += size;
+        return mem_.read(address, data, size);
+    }
+    AccessorError erase(size_t address) { return mem_.erase(address); }
+
+    size_t getAlignment() const { return mem_.getAlignment(); }
+    size_t getFlashMemorySize() const { return mem_.getFlashMemorySize(); }
+    size_t getFlashStartAddress() const { return mem_.getFlashStartAddress(); }
+    size_t getEraseBlockSize() const { return mem_.getEraseBlockSize(); }
+
+    void resetCounters() { reads = 0; bytes_read = 0; }
+    std::vector<uint8_t> &raw() { return mem_.raw(); }
+
+    size_t reads = 0;
+    size_t bytes_read = 0;
+
+private:
+    ConfigurableMemoryAccessor mem_;
+};
+
+static_assert(Accessor<CountingAccessor>, "CountingAccessor must satisfy Accessor concept");
+
+using Store = AccessorCheckpointStore<ConfigurableMemoryAccessor>;
+using CheckpointedBuffer = ImageBuffer<CountingAccessor, DefaultChecksumPolicy, Store>;
+using ScanningBuffer = ImageBuffer<CountingAccessor>;
+
+static_assert(CheckpointStore<Store>);
+static_assert(CheckpointStore<NoCheckpoint>);
+
+constexpr size_t BLOCK = 128;
+// entries fill their block exactly, no alignment padding in between
+constexpr size_t PAYLOAD = BLOCK - sizeof(StorageHeader) - sizeof(ImageMetadata) - sizeof(crc_t);
+
+template <typename Buffer>
+static void push_entry(Buffer &buffer, uint8_t seed)
+{
+    ImageMetadata meta{};
+    meta.payload_size = PAYLOAD;
+    meta.timestamp = seed;
+    std::array<uint8_t, PAYLOAD> payload{};
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<uint8_t>(seed + i);
+
+    REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.add_data_chunk(payload.data(), payload.size()) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+}
+
+template <typename Buffer>
+static void pop_entry(Buffer &buffer, uint8_t expected_seed)
+{
+    ImageMetadata meta{};
+    REQUIRE(buffer.get_image(meta) == ImageBufferError::NO_ERROR);
+    CHECK(meta.timestamp == expected_seed);
+    std::array<uint8_t, PAYLOAD> payload{};
+    size_t size = payload.size();
+    REQUIRE(buffer.get_data_chunk(payload.data(), size) == ImageBufferError::NO_ERROR);
+    CHECK(payload[0] == expected_seed);
+    REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+}
+
+TEST_CASE("AccessorCheckpointStore: newest record wins across half switches")
+{
+    ConfigurableMemoryAccessor storage(0, 8 * 256, 256); // 4 slots per half
+    Store store(storage, 0, 8 * 256);
+
+    ImageBufferCheckpoint cp{};
+    CHECK_FALSE(store.load(cp));
+
+    for (uint32_t i = 1; i <= 11; ++i)
+    {
+        ImageBufferCheckpoint in{};
+        in.head = i;
+        REQUIRE(store.save(in));
+    }
+
+    Store reopened(storage, 0, 8 * 256);
+    REQUIRE(reopened.load(cp));
+    CHECK(cp.head == 11);
+    CHECK(cp.generation == 11);
+
+    // keeps appending after the newest record
+    ImageBufferCheckpoint in{};
+    in.head = 12;
+    REQUIRE(reopened.save(in));
+    Store again(storage, 0, 8 * 256);
+    REQUIRE(again.load(cp));
+    CHECK(cp.head == 12);
+}
+
+TEST_CASE("AccessorCheckpointStore: torn record falls back to the previous one")
+{
+    ConfigurableMemoryAccessor storage(0, 4 * 64, 64);
+    Store store(storage, 0, 4 * 64);
+
+    for (uint32_t i = 1; i <= 3; ++i)
+    {
+        ImageBufferCheckpoint in{};
+        in.head = i;
+        REQUIRE(store.save(in));
+    }
+
+    // a blank store starts on the second half, so the third record is the
+    // first one of the wrapped-to first half; break its CRC
+    storage.raw()[offsetof(ImageBufferCheckpoint, crc)] ^= 0xFF;
+
+    Store reopened(storage, 0, 4 * 64);
+    ImageBufferCheckpoint cp{};
+    REQUIRE(reopened.load(cp));
+    CHECK(cp.head == 2);
+
+    // next save must not land on the torn slot
+    ImageBufferCheckpoint in{};
+    in.head = 4;
+    REQUIRE(reopened.save(in));
+    Store again(storage, 0, 4 * 64);
+    REQUIRE(again.load(cp));
+    CHECK(cp.head == 4);
+}
+
+TEST_CASE("ImageBuffer: remount from checkpoint restores the ring state")
+{
+    CountingAccessor ring(64 * BLOCK, BLOCK);
+    ConfigurableMemoryAccessor cp_storage(0, 4 * 256, 256);
+
+    size_t head = 0, tail = 0, size = 0;
+    {
+        CheckpointedBuffer buffer(ring, Store(cp_storage, 0, 4 * 256));
+        REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+        for (uint8_t i = 0; i < 5; ++i)
+            push_entry(buffer, i);
+        pop_entry(buffer, 0);
+        pop_entry(buffer, 1);
+        head = buffer.get_head();
+        tail = buffer.get_tail();
+        size = buffer.size();
+    }
+
+    ring.resetCounters();
+    CheckpointedBuffer mounted(ring, Store(cp_storage, 0, 4 * 256));
+    REQUIRE(mounted.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    CHECK(mounted.count() == 3);
+    CHECK(mounted.get_head() == head);
+    CHECK(mounted.get_tail() == tail);
+    CHECK(mounted.size() == size);
+    // head header plus one probe behind the tail, not a scan of 64 blocks
+    CHECK(ring.reads <= 4);
+
+    pop_entry(mounted, 2);
+    pop_entry(mounted, 3);
+    pop_entry(mounted, 4);
+    CHECK(mounted.is_empty());
+}
+
+TEST_CASE("ImageBuffer: entries pushed after the checkpoint are rolled forward")
+{
+    CountingAccessor ring(64 * BLOCK, BLOCK);
+    ConfigurableMemoryAccessor cp_storage(0, 4 * 256, 256);
+
+    {
+        CheckpointedBuffer buffer(ring, Store(cp_storage, 0, 4 * 256));
+        REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+        buffer.set_checkpoint_interval(100);
+        for (uint8_t i = 0; i < 5; ++i)
+            push_entry(buffer, i);
+    }
+
+    CheckpointedBuffer mounted(ring, Store(cp_storage, 0, 4 * 256));
+    REQUIRE(mounted.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    REQUIRE(mounted.count() == 5);
+    for (uint8_t i = 0; i < 5; ++i)
+        pop_entry(mounted, i);
+
+    // sequence numbering continues after the rolled forward entries
+    push_entry(mounted, 9);
+    CheckpointedBuffer again(ring, Store(cp_storage, 0, 4 * 256));
+    REQUIRE(again.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    REQUIRE(again.count() == 1);
+    pop_entry(again, 9);
+}
+
+TEST_CASE("ImageBuffer: entry abandoned between checkpoints does not stop the roll forward")
+{
+    CountingAccessor ring(64 * BLOCK, BLOCK);
+    ConfigurableMemoryAccessor cp_storage(0, 4 * 256, 256);
+
+    {
+        CheckpointedBuffer buffer(ring, Store(cp_storage, 0, 4 * 256));
+        REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+        buffer.set_checkpoint_interval(100);
+        push_entry(buffer, 0);
+        push_entry(buffer, 1);
+
+        // started but never pushed, the next add_image() reuses its space
+        ImageMetadata meta{};
+        meta.payload_size = PAYLOAD;
+        std::array<uint8_t, PAYLOAD / 2> partial{};
+        REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.add_data_chunk(partial.data(), partial.size()) == ImageBufferError::NO_ERROR);
+
+        push_entry(buffer, 2);
+        push_entry(buffer, 3);
+    }
+
+    ScanningBuffer scanned(ring);
+    REQUIRE(scanned.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    CHECK(scanned.count() == 4);
+
+    CheckpointedBuffer mounted(ring, Store(cp_storage, 0, 4 * 256));
+    REQUIRE(mounted.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    REQUIRE(mounted.count() == 4);
+    for (uint8_t i = 0; i < 4; ++i)
+        pop_entry(mounted, i);
+}
+
+TEST_CASE("ImageBuffer: checkpoint that does not match the flash falls back to the scan")
+{
+    CountingAccessor ring(64 * BLOCK, BLOCK);
+    ConfigurableMemoryAccessor cp_storage(0, 4 * 256, 256);
+
+    size_t head = 0;
+    {
+        CheckpointedBuffer buffer(ring, Store(cp_storage, 0, 4 * 256));
+        REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+        for (uint8_t i = 0; i < 5; ++i)
+            push_entry(buffer, i);
+        head = buffer.get_head();
+    }
+
+    // head entry no longer carries the header the checkpoint expects
+    ring.raw()[head] ^= 0xFF;
+
+    ring.resetCounters();
+    CheckpointedBuffer mounted(ring, Store(cp_storage, 0, 4 * 256));
+    REQUIRE(mounted.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    CHECK(ring.reads > 64);
+    REQUIRE(mounted.count() == 4);
+    for (uint8_t i = 1; i < 5; ++i)
+        pop_entry(mounted, i);
+}
+
+template <typename Buffer, typename... Extra>
+static void benchmark_mount(size_t entries)
+{
+    CountingAccessor ring((entries + 16) * BLOCK, BLOCK);
+    ConfigurableMemoryAccessor cp_storage(0, 4 * 256, 256);
+
+    {
+        Buffer buffer(ring, Extra(cp_storage, 0, 4 * 256)...);
+        REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+        buffer.set_checkpoint_interval(64);
+        for (size_t i = 0; i < entries; ++i)
+            push_entry(buffer, static_cast<uint8_t>(i));
+    }
+
+    ring.resetCounters();
+    const auto start = std::chrono::steady_clock::now();
+    Buffer mounted(ring, Extra(cp_storage, 0, 4 * 256)...);
+    REQUIRE(mounted.initialize_from_flash() == ImageBufferError::NO_ERROR);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    CHECK(mounted.count() == entries);
+    MESSAGE(entries << " entries, " << (sizeof...(Extra) ? "checkpoint" : "scan")
+            << " mount: " << elapsed.count() << " us, "
+            << ring.reads << " reads, " << ring.bytes_read << " bytes");
+
+    if constexpr (sizeof...(Extra) != 0)
+    {
+        // only the entries pushed since the last checkpoint are verified
+        CHECK(ring.bytes_read < entries * BLOCK / 4);
+    }
+}
+
+TEST_CASE("ImageBuffer: mount benchmark, scan vs checkpoint")
+{
+    for (size_t entries : {size_t{1000}, size_t{10000}})
+    {
+        benchmark_mount<ScanningBuffer>(entries);
+        benchmark_mount<CheckpointedBuffer, Store>(entries);
+    }
+}
@@ -0,0 +1,259 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include <Eigen/Dense>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include "Kalman.hpp"
+
+namespace
+{
+    // Deterministic values in [-1, 1)
+    float nextValue(uint32_t &seed)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1U << 23) - 1.f;
+    }
+
+    template <int N, int M>
+    Eigen::Matrix<float, N, M> randomMatrix(uint32_t &seed)
+    {
+        Eigen::Matrix<float, N, M> m;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < M; ++j)
+                m(i, j) = nextValue(seed);
+        return m;
+    }
+
+    template <int N>
+    Eigen::Matrix<float, N, N> randomCovariance(uint32_t &seed)
+    {
+        const Eigen::Matrix<float, N, N> a = randomMatrix<N, N>(seed);
+        const Eigen::Matrix<float, N, N> p = a * a.transpose() + Eigen::Matrix<float, N, N>::Identity();
+        return 0.5f * (p + p.transpose()); // exactly symmetric
+    }
+
+    template <int M>
+    Eigen::Matrix<float, M, M> randomDiagonal(uint32_t &seed)
+    {
+        Eigen::Matrix<float, M, M> r = Eigen::Matrix<float, M, M>::Zero();
+        for (int i = 0; i < M; ++i)
+            r(i, i) = 0.1f + 0.5f * std::abs(nextValue(seed));
+        return r;
+    }
+
+    template <int N, int M>
+    Eigen::Matrix<float, M, N> selector(const std::array<int, M> &indices)
+    {
+        Eigen::Matrix<float, M, N> h = Eigen::Matrix<float, M, N>::Zero();
+        for (int i = 0; i < M; ++i)
+            h(i, indices[static_cast<size_t>(i)]) = 1.f;
+        return h;
+    }
+
+    // The update as it was written with an explicit inverse, reference and benchmark baseline
+    template <int N, int M>
+    void inverseUpdate(KalmanFilter<N, M> &kf, const Eigen::Matrix<float, M, N> &H, const Eigen::Matrix<float, M, 1> &z)
+    {
+        const Eigen::Matrix<float, M, 1> innovation = z - H * kf.stateVector;
+        const Eigen::Matrix<float, M, M> S = H * kf.stateCovarianceMatrix * H.transpose() + kf.measurementNoiseCovarianceMatrix;
+        const Eigen::Matrix<float, N, M> K = kf.stateCovarianceMatrix * H.transpose() * S.inverse();
+        kf.stateVector = kf.stateVector + K * innovation;
+        kf.stateCovarianceMatrix = (Eigen::Matrix<float, N, N>::Identity() - K * H) * kf.stateCovarianceMatrix;
+    }
+
+    template <int N, int M>
+    KalmanFilter<N, M> randomFilter(uint32_t &seed)
+    {
+        const auto P = randomCovariance<N>(seed);
+        return KalmanFilter<N, M>(randomCovariance<N>(seed) * 0.01f, randomDiagonal<M>(seed), P, randomMatrix<N, 1>(seed));
+    }
+
+    template <typename A, typename B>
+    void checkClose(const A &a, const B &b, float tolerance)
+    {
+        CHECK((a - b).cwiseAbs().maxCoeff() < tolerance);
+    }
+}
+
+TEST_CASE("Kalman update matches the explicit inverse")
+{
+    uint32_t seed = 1;
+    auto kf = randomFilter<7, 3>(seed);
+    auto reference = kf;
+    const auto H = randomMatrix<3, 7>(seed);
+    const auto z = randomMatrix<3, 1>(seed);
+
+    kf.update(H, z);
+    inverseUpdate(reference, H, z);
+
+    checkClose(kf.stateVector, reference.stateVector, 1e-4f);
+    checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-4f);
+}
+
+TEST_CASE("Kalman updateEKF with a linear model matches update")
+{
+    uint32_t seed = 2;
+    auto kf = randomFilter<7, 6>(seed);
+    auto reference = kf;
+    const auto H = randomMatrix<6, 7>(seed);
+    const auto z = randomMatrix<6, 1>(seed);
+
+    kf.updateEKF([&](const Eigen::Matrix<float, 7, 1> &x) { return (H * x).eval(); }, H, z);
+    reference.update(H, z);
+
+    checkClose(kf.stateVector, reference.stateVector, 1e-5f);
+    checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-5f);
+}
+
+TEST_CASE("Kalman sequential update matches the batch update for diagonal R")
+{
+    uint32_t seed = 3;
+    auto kf = randomFilter<9, 3>(seed);
+    auto reference = kf;
+    const auto H = randomMatrix<3, 9>(seed);
+    const auto z = randomMatrix<3, 1>(seed);
+
+    SUBCASE("Standard covariance update")
+    {
+        kf.updateSequential(H, z);
+        reference.update(H, z);
+    }
+
+    SUBCASE("Joseph covariance update")
+    {
+        kf.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+        reference.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+        kf.updateSequential(H, z);
+        reference.update(H, z);
+    }
+
+    checkClose(kf.stateVector, reference.stateVector, 1e-4f);
+    checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-4f);
+}
+
+TEST_CASE("Kalman selector update matches the dense update")
+{
+    uint32_t seed = 4;
+    const std::array<int, 3> indices{6, 7, 8};
+    const auto H = selector<9, 3>(indices);
+    auto kf = randomFilter<9, 3>(seed);
+    const auto z = randomMatrix<3, 1>(seed);
+
+    SUBCASE("Standard covariance update")
+    {
+        auto reference = kf;
+        kf.updateSelected(indices, z);
+        reference.update(H, z);
+        checkClose(kf.stateVector, reference.stateVector, 1e-5f);
+        checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-5f);
+    }
+
+    SUBCASE("Joseph covariance update")
+    {
+        kf.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+        auto reference = kf;
+        kf.updateSelected(indices, z);
+        reference.update(H, z);
+        checkClose(kf.stateVector, reference.stateVector, 1e-5f);
+        checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-5f);
+    }
+
+    SUBCASE("Sequential")
+    {
+        auto reference = kf;
+        kf.updateSequential(indices, z);
+        reference.update(H, z);
+        checkClose(kf.stateVector, reference.stateVector, 1e-5f);
+        checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-5f);
+    }
+
+    SUBCASE("Sequential Joseph")
+    {
+        kf.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+        auto reference = kf;
+        kf.updateSequential(indices, z);
+        reference.update(H, z);
+        checkClose(kf.stateVector, reference.stateVector, 1e-5f);
+        checkClose(kf.stateCovarianceMatrix, reference.stateCovarianceMatrix, 1e-5f);
+    }
+}
+
+TEST_CASE("Kalman Joseph form keeps the covariance symmetric and positive definite")
+{
+    // Very precise measurements of an uncertain state, where P - K H P loses symmetry in float
+    uint32_t seed = 5;
+    auto kf = randomFilter<9, 3>(seed);
+    kf.stateCovarianceMatrix *= 1e4f;
+    kf.measurementNoiseCovarianceMatrix = Eigen::Matrix3f::Identity() * 1e-6f;
+    kf.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto H = randomMatrix<3, 9>(seed);
+        kf.update(H, randomMatrix<3, 1>(seed));
+        kf.predict(Eigen::Matrix<float, 9, 9>::Identity());
+    }
+
+    const auto &P = kf.stateCovarianceMatrix;
+    CHECK((P - P.transpose()).cwiseAbs().maxCoeff() == 0.f);
+    CHECK(Eigen::LLT<Eigen::Matrix<float, 9, 9>>(P).info() == Eigen::Success);
+}
+
+namespace
+{
+    constexpr int BENCH_REPEATS = 20000;
+
+    // ns per call of update(kf) on a fresh copy of the filter
+    template <typename Filter, typename Update>
+    double nsPerUpdate(const Filter &initial, Update &&update)
+    {
+        using clock = std::chrono::steady_clock;
+        Filter kf = initial;
+        const auto start = clock::now();
+        for (int i = 0; i < BENCH_REPEATS; ++i)
+        {
+            kf.stateCovarianceMatrix = initial.stateCovarianceMatrix;
+            update(kf);
+        }
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        CHECK(kf.stateVector.allFinite());
+        return static_cast<double>(elapsed) / BENCH_REPEATS;
+    }
+
+    template <int N, int M>
+    void benchmark(const char *name, const std::array<int, M> &indices)
+    {
+        uint32_t seed = 6;
+        const auto kf = randomFilter<N, M>(seed);
+        const auto H = randomMatrix<M, N>(seed);
+        const auto Hs = selector<N, M>(indices);
+        const auto z = randomMatrix<M, 1>(seed);
+
+        const double inverse = nsPerUpdate(kf, [&](auto &f) { inverseUpdate(f, H, z); });
+        const double llt = nsPerUpdate(kf, [&](auto &f) { f.update(H, z); });
+        const double sequential = nsPerUpdate(kf, [&](auto &f) { f.updateSequential(H, z); });
+        const double selected = nsPerUpdate(kf, [&](auto &f) { f.updateSelected(indices, z); });
+        const double selectedSequential = nsPerUpdate(kf, [&](auto &f) { f.updateSequential(indices, z); });
+        const double selectorDense = nsPerUpdate(kf, [&](auto &f) { f.update(Hs, z); });
+
+        auto joseph = kf;
+        joseph.covarianceUpdate = KalmanCovarianceUpdate::Joseph;
+        const double josephLlt = nsPerUpdate(joseph, [&](auto &f) { f.update(H, z); });
+
+        MESSAGE("Kalman " << name << " ns/update: inverse " << inverse << ", llt " << llt
+                << ", sequential " << sequential << ", selector dense " << selectorDense << ", selector " << selected
+                << ", selector sequential " << selectedSequential
+                << ", joseph llt " << josephLlt);
+    }
+}
+
+TEST_CASE("Kalman update benchmark")
+{
+    benchmark<6, 3>("6x3", {0, 1, 2});
+    benchmark<7, 3>("7x3", {0, 1, 2});
+    benchmark<7, 6>("7x6", {0, 1, 2, 4, 5, 6});
+    benchmark<9, 9>("9x9", {0, 1, 2, 3, 4, 5, 6, 7, 8});
+}
@@ -0,0 +1,245 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+#include "OrientationTracker.hpp"
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+constexpr float m_mpif = static_cast<float>(std::numbers::pi);
+
+namespace
+{
+    // Deterministic values in [-1, 1)
+    float nextValue(uint32_t &seed)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1U << 23) - 1.f;
+    }
+
+    Eigen::Vector3f noise(uint32_t &seed, float amplitude)
+    {
+        return Eigen::Vector3f(nextValue(seed), nextValue(seed), nextValue(seed)) * amplitude;
+    }
+
+    au::QuantityU64<au::Milli<au::Seconds>> ms(uint64_t t)
+    {
+        return au::make_quantity<au::Milli<au::Seconds>>(t);
+    }
+
+    float angleBetween(const Eigen::Quaternionf &a, const Eigen::Quaternionf &b)
+    {
+        return a.angularDistance(b);
+    }
+
+    // Body rate of a slow tumble, true attitude is integrated alongside
+    Eigen::Vector3f trueRate(uint64_t t_ms)
+    {
+        const float t = 0.001f * static_cast<float>(t_ms);
+        return Eigen::Vector3f(0.2f * std::sin(0.5f * t), 0.1f * std::cos(0.3f * t), 0.15f);
+    }
+
+    struct Scenario
+    {
+        Eigen::Vector3f accel_ned{0.f, 0.f, 9.81f};
+        Eigen::Vector3f mag_ned{0.51f, 0.04f, 0.89f};
+        Eigen::Vector3f gyro_bias{0.01f, -0.02f, 0.015f};
+        float gyro_noise = 0.002f;
+        float vector_noise = 0.01f;
+        uint64_t step_ms = 10;
+        int steps = 6000;
+    };
+
+    struct Result
+    {
+        float rms_deg;
+        double ns;
+    };
+
+    // Feeds the same gyro, accelerometer and magnetometer stream to any tracker and
+    // returns the RMS attitude error over the last half of the run and the ns per update
+    template <typename Tracker, typename Update>
+    Result run(Tracker &tracker, const Scenario &s, Update &&update)
+    {
+        using clock = std::chrono::steady_clock;
+        uint32_t seed = 42;
+        Eigen::Quaternionf q_true = Eigen::Quaternionf::Identity();
+        double error_sum = 0.;
+        int error_count = 0;
+        clock::duration elapsed{};
+
+        for (int i = 1; i <= s.steps; ++i)
+        {
+            const uint64_t t = static_cast<uint64_t>(i) * s.step_ms;
+            const Eigen::Vector3f rate = trueRate(t - s.step_ms);
+            const float dt = 0.001f * static_cast<float>(s.step_ms);
+            q_true = (q_true * Eigen::Quaternionf(Eigen::AngleAxisf(rate.norm() * dt, rate.normalized()))).normalized();
+
+            const Eigen::Vector3f gyro = trueRate(t) + s.gyro_bias + noise(seed, s.gyro_noise);
+            const Eigen::Vector3f accel = q_true.conjugate() * s.accel_ned + noise(seed, s.vector_noise * 9.81f);
+            const Eigen::Vector3f mag = q_true.conjugate() * s.mag_ned + noise(seed, s.vector_noise);
+
+            const auto start = clock::now();
+            update(tracker, gyro, accel, mag, ms(t));
+            elapsed += clock::now() - start;
+
+            if (i > s.steps / 2)
+            {
+                const float e = angleBetween(tracker.getOrientation(), q_true);
+                error_sum += static_cast<double>(e * e);
+                ++error_count;
+            }
+        }
+        const float rms = static_cast<float>(std::sqrt(error_sum / error_count));
+        return Result{rms * 180.f / m_mpif, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / s.steps};
+    }
+}
+
+TEST_CASE("MEKF trackers initialize with identity quaternion and zero bias")
+{
+    GyrMagMEKFOrientationTracker gyr_mag;
+    AccGyrMagMEKFOrientationTracker acc_gyr_mag;
+    AccGyrMEKFOrientationTracker acc_gyr;
+
+    REQUIRE(gyr_mag.getOrientation().isApprox(Eigen::Quaternionf::Identity(), 1e-6f));
+    REQUIRE(acc_gyr_mag.getOrientation().isApprox(Eigen::Quaternionf::Identity(), 1e-6f));
+    REQUIRE(acc_gyr.getOrientation().isApprox(Eigen::Quaternionf::Identity(), 1e-6f));
+    REQUIRE(gyr_mag.getGyroBias().isZero());
+}
+
+TEST_CASE("MEKF predictTo integrates the bias corrected rate")
+{
+    GyrMagMEKFOrientationTracker tracker;
+    tracker.setGyroAngularRate(Eigen::Vector3f(0.f, 0.f, m_mpif / 2.f)); // 90°/s yaw
+
+    tracker.predictTo(au::make_quantity<au::Seconds>(0));
+    tracker.predictTo(au::make_quantity<au::Seconds>(1));
+
+    REQUIRE(std::abs(tracker.getYawPitchRoll()(0) - m_mpif / 2.f) < 0.01f);
+
+    // attitude uncertainty grows with time, bias uncertainty feeds into it
+    const auto &P = tracker.getCovariance();
+    CHECK(P(0, 0) > 0.3f);
+    CHECK(P(0, 3) < 0.f);
+}
+
+TEST_CASE("MEKF first timestamp only starts the clock")
+{
+    GyrMagMEKFOrientationTracker tracker;
+    tracker.setGyroAngularRate(Eigen::Vector3f(0.f, 0.f, m_mpif / 2.f));
+    const Eigen::Matrix<float, 6, 6> P0 = tracker.getCovariance();
+
+    // RTC epoch based timestamp, years after 0
+    constexpr uint64_t epoch_ms = 800'000'000'000ull;
+    tracker.predictTo(au::make_quantity<au::Milli<au::Seconds>>(epoch_ms));
+
+    CHECK(tracker.getOrientation().isApprox(Eigen::Quaternionf::Identity(), 1e-6f));
+    CHECK(tracker.getCovariance().isApprox(P0));
+
+    tracker.predictTo(au::make_quantity<au::Milli<au::Seconds>>(epoch_ms + 1000));
+    CHECK(std::abs(tracker.getYawPitchRoll()(0) - m_mpif / 2.f) < 0.01f);
+}
+
+TEST_CASE("MEKF closed form measurement Jacobian matches numerical differentiation")
+{
+    const Eigen::Quaternionf q = Eigen::Quaternionf(Eigen::AngleAxisf(0.7f, Eigen::Vector3f(0.3f, -0.5f, 0.8f).normalized()));
+    const Eigen::Vector3f v_ned = Eigen::Vector3f(0.51f, 0.04f, 0.89f).normalized();
+    const Eigen::Vector3f predicted = q.conjugate() * v_ned;
+    const Eigen::Matrix3f H = GyrMagMEKFOrientationTracker::referenceJacobian(predicted);
+
+    constexpr float eps = 1e-3f;
+    for (int i = 0; i < 3; ++i)
+    {
+        Eigen::Vector3f dtheta = Eigen::Vector3f::Zero();
+        dtheta(i) = eps;
+        const Eigen::Quaternionf plus = q * Eigen::Quaternionf(Eigen::AngleAxisf(eps, dtheta.normalized()));
+        const Eigen::Quaternionf minus = q * Eigen::Quaternionf(Eigen::AngleAxisf(-eps, dtheta.normalized()));
+        const Eigen::Vector3f column = (plus.conjugate() * v_ned - minus.conjugate() * v_ned) / (2.f * eps);
+        CHECK((column - H.col(i)).cwiseAbs().maxCoeff() < 1e-3f);
+    }
+}
+
+TEST_CASE("GyrMagMEKFOrientationTracker aligns the magnetic field after a yaw error")
+{
+    GyrMagMEKFOrientationTracker tracker;
+    const Eigen::Vector3f mag_ned(0.3f, 0.5f, 0.8f);
+    tracker.setReferenceVectors(mag_ned);
+
+    const Eigen::Quaternionf q_true(Eigen::AngleAxisf(m_mpif / 4.f, Eigen::Vector3f::UnitZ()));
+    const Eigen::Vector3f mag_body = q_true.conjugate() * mag_ned * 50.f; // scale is ignored
+
+    for (uint64_t t = 1; t <= 200; ++t)
+        tracker.updateSensorFusion(Eigen::Vector3f::Zero(), mag_body, ms(t * 10));
+
+    // rotation about the field itself is unobservable with a single reference vector
+    const Eigen::Vector3f predicted = tracker.getOrientation().conjugate() * mag_ned.normalized();
+    CHECK((predicted - mag_body.normalized()).norm() < 1e-3f);
+}
+
+TEST_CASE("AccGyrMEKFOrientationTracker stabilizes pitch and roll from accelerometer")
+{
+    AccGyrMEKFOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f));
+
+    const Eigen::Quaternionf q_true = Eigen::AngleAxisf(0.3f, Eigen::Vector3f::UnitX()) * Eigen::AngleAxisf(-0.2f, Eigen::Vector3f::UnitY());
+    const Eigen::Vector3f accel_body = q_true.conjugate() * Eigen::Vector3f(0.f, 0.f, 9.81f);
+
+    for (uint64_t t = 1; t <= 200; ++t)
+        tracker.updateSensorFusion(Eigen::Vector3f::Zero(), accel_body, ms(t * 10));
+
+    const Eigen::Vector3f ypr = tracker.getYawPitchRoll();
+    const Eigen::Vector3f ypr_true = Eigen::Vector3f(
+        std::atan2(2.f * (q_true.w() * q_true.z() + q_true.x() * q_true.y()), 1.f - 2.f * (q_true.y() * q_true.y() + q_true.z() * q_true.z())),
+        std::asin(2.f * (q_true.w() * q_true.y() - q_true.z() * q_true.x())),
+        std::atan2(2.f * (q_true.w() * q_true.x() + q_true.y() * q_true.z()), 1.f - 2.f * (q_true.x() * q_true.x() + q_true.y() * q_true.y())));
+    CHECK(std::abs(ypr(1) - ypr_true(1)) < 0.01f);
+    CHECK(std::abs(ypr(2) - ypr_true(2)) < 0.01f);
+}
+
+TEST_CASE("AccGyrMagMEKFOrientationTracker estimates the gyro bias")
+{
+    Scenario s;
+    AccGyrMagMEKFOrientationTracker tracker;
+    tracker.setReferenceVectors(s.accel_ned, s.mag_ned);
+
+    run(tracker, s, [](auto &f, const auto &gyro, const auto &accel, const auto &mag, auto t)
+        { f.updateSensorFusion(gyro, accel, mag, t); });
+
+    CHECK((tracker.getGyroBias() - s.gyro_bias).cwiseAbs().maxCoeff() < 2e-3f);
+    const auto &P = tracker.getCovariance();
+    CHECK((P - P.transpose()).cwiseAbs().maxCoeff() == 0.f);
+    CHECK(Eigen::LLT<Eigen::Matrix<float, 6, 6>>(P).info() == Eigen::Success);
+}
+
+TEST_CASE("MEKF accuracy and update time against the quaternion EKF trackers")
+{
+    Scenario s;
+    auto acc_gyr_mag = [](auto &f, const auto &gyro, const auto &accel, const auto &mag, auto t)
+    { f.updateSensorFusion(gyro, accel, mag, t); };
+    auto gyr_mag = [](auto &f, const auto &gyro, const auto &, const auto &mag, auto t)
+    { f.updateSensorFusion(gyro, mag, t); };
+
+    AccGyrMagOrientationTracker ekf9;
+    ekf9.setReferenceVectors(s.accel_ned, s.mag_ned);
+    AccGyrMagMEKFOrientationTracker mekf9;
+    mekf9.setReferenceVectors(s.accel_ned, s.mag_ned);
+    const Result r_ekf9 = run(ekf9, s, acc_gyr_mag);
+    const Result r_mekf9 = run(mekf9, s, acc_gyr_mag);
+
+    GyrMagOrientationTracker ekf6;
+    ekf6.setReferenceVectors(s.mag_ned);
+    GyrMagMEKFOrientationTracker mekf6;
+    mekf6.setReferenceVectors(s.mag_ned);
+    const Result r_ekf6 = run(ekf6, s, gyr_mag);
+    const Result r_mekf6 = run(mekf6, s, gyr_mag);
+
+    MESSAGE("AccGyrMag: EKF rms " << r_ekf9.rms_deg << " deg, " << r_ekf9.ns << " ns/update; MEKF rms "
+            << r_mekf9.rms_deg << " deg, " << r_mekf9.ns << " ns/update");
+    MESSAGE("GyrMag: EKF rms " << r_ekf6.rms_deg << " deg, " << r_ekf6.ns << " ns/update; MEKF rms "
+            << r_mekf6.rms_deg << " deg, " << r_mekf6.ns << " ns/update");
+
+    // the biased gyro is observable with two reference vectors
+    CHECK(r_mekf9.rms_deg < r_ekf9.rms_deg);
+    CHECK(r_mekf9.rms_deg < 1.f);
+}
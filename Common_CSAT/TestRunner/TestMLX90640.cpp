@@ -198,15 +198,40 @@ TEST_CASE("MLX90640 readSubpage reads RAM block and clears status" * doctest::sk
     CHECK(frame[0] ==
           le16(fake_subpage[0], fake_subpage[1]));
 
-    CHECK(frame[MLX90640_SUBPAGE_WORDS - 1] ==
-          le16(fake_subpage[MLX90640_SUBPAGE_SIZE - 2],
-               fake_subpage[MLX90640_SUBPAGE_SIZE - 1]));
+    CHECK(frame[MLX90640_RAM_WORDS - 1] ==
+          le16(fake_subpage[2 * MLX90640_RAM_WORDS - 2],
+               fake_subpage[2 * MLX90640_RAM_WORDS - 1]));
 
     CHECK(get_i2c_tx_buffer_count() == 2);
     CHECK(get_i2c_mem_address() ==
           static_cast<uint16_t>(MLX90640_REGISTERS::STATUS));
 }
 
+TEST_CASE("MLX90640 readSubpage stamps CONTROL1 and the subpage number after the RAM words")
+{
+    MLX_I2C transport;
+    MLX90640<MLX_I2C> mlx(transport);
+
+    clear_i2c_rx_data();
+    clear_i2c_tx_data();
+
+    // the mock answers every read with the injected bytes, so STATUS and
+    // CONTROL1 both read as 0x1901: subpage 1, chess mode, 18 bit ADC
+    uint8_t rx[I2C_MEM_BUFFER_SIZE] = {0x19, 0x01};
+    inject_i2c_rx_data(MLX_I2C_Config::address, rx, sizeof(rx));
+
+    uint16_t frame[MLX90640_SUBPAGE_WORDS];
+    std::memset(frame, 0xAA, sizeof(frame));
+    int sp = -1;
+    REQUIRE(mlx.readSubpage(frame, sp));
+
+    CHECK(sp == 1);
+    CHECK(frame[0] == le16(0x19, 0x01));
+    CHECK(frame[MLX90640_RAM_WORDS - 1] == 0);
+    CHECK(frame[MLX90640_RAM_WORDS] == 0x1901);
+    CHECK(frame[MLX90640_RAM_WORDS + 1] == 1);
+}
+
 // ─────────────────────────────────────────────
 // TEST: createFrame()
 // ─────────────────────────────────────────────
@@ -4,6 +4,11 @@
 #include "MLX90640Calibration.hpp"   // your constexpr parser
 #include "MLX90640EEPROM.h"
 #include "3rdParty/MLX90640_API.h"            // Melexis reference
+#include "MLX90640ImageProcessor.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
 
 TEST_CASE("MLX90640: our calibration matches Melexis ExtractParameters")
 {
@@ -96,3 +101,176 @@ TEST_CASE("MLX90640: our calibration matches Melexis ExtractParameters")
         CHECK(ours.outlierPixels[i] == ref.outlierPixels[i]);
     }
 }
+
+// Subpage frame with aux words that put the sensor at the given Ta, Vdd at
+// 3.3 V, and a scene a bit warmer than the sensor
+static std::array<uint16_t, 834> build_subpage_frame(uint16_t subPage, bool chess, float Ta)
+{
+    const auto& P = MLX90640_CAL;
+    std::array<uint16_t, 834> frame{};
+
+    for (std::size_t i = 0; i < 768; ++i)
+        frame[i] = uint16_t(P.offset[i] + 40 + int(i * 7 % 200));
+
+    const int16_t ptat     = 1600;
+    const float   ptatArt  = float(P.vPTAT25) + P.KtPTAT * (Ta - 25.0f);
+    const float   vbe      = float(ptat) * 262144.0f / ptatArt - float(ptat) * P.alphaPTAT;
+    frame[768] = uint16_t(int16_t(std::lround(vbe)));
+    frame[776] = uint16_t(P.cpOffset[0] + 3);
+    frame[778] = uint16_t(P.gainEE);
+    frame[800] = uint16_t(ptat);
+    frame[808] = uint16_t(P.cpOffset[1] + 3);
+    frame[810] = uint16_t(P.vdd25);
+    frame[832] = uint16_t((chess ? 0x1000u : 0u) | unsigned(P.resolutionEE << 10));
+    frame[833] = subPage;
+    return frame;
+}
+
+static paramsMLX90640 melexis_params()
+{
+    uint16_t ee[832];
+    for (int i = 0; i < 832; ++i)
+        ee[i] = MLX90640_EEPROM[i];
+    paramsMLX90640 ref{};
+    REQUIRE(MLX90640_ExtractParameters(ee, &ref) == MLX90640_NO_ERROR);
+    return ref;
+}
+
+TEST_CASE("MLX90640: precomputed calculateTo matches Melexis CalculateTo")
+{
+    const paramsMLX90640 ref = melexis_params();
+    MLX90640ImageProcessor proc;
+
+    for (bool chess : {true, false})
+    {
+        MLX90640ImageProcessor::TempImage ours{};
+        float theirs[768] = {};
+
+        for (uint16_t sub = 0; sub < 2; ++sub)
+        {
+            auto frame = build_subpage_frame(sub, chess, 31.0f);
+            REQUIRE(proc.calculateTo(frame.data(), 0.95f, 23.0f, ours));
+            MLX90640_CalculateTo(frame.data(), &ref, 0.95f, 23.0f, theirs);
+        }
+
+        const float ta = MLX90640_GetTa(build_subpage_frame(0, chess, 31.0f).data(), &ref);
+        CHECK(proc.calibratedTa() == doctest::Approx(ta).epsilon(1e-4));
+
+        for (std::size_t i = 0; i < 768; ++i)
+        {
+            CAPTURE(chess);
+            CAPTURE(i);
+            REQUIRE(std::isfinite(theirs[i]));
+            CHECK(std::fabs(ours[i] - theirs[i]) < 0.01f);
+        }
+    }
+}
+
+TEST_CASE("MLX90640: calculateTo rebuilds its tables when Ta drifts")
+{
+    const paramsMLX90640 ref = melexis_params();
+    MLX90640ImageProcessor proc;
+    MLX90640ImageProcessor::TempImage ours{};
+    float theirs[768] = {};
+
+    auto frame = build_subpage_frame(0, true, 30.0f);
+    REQUIRE(proc.calculateTo(frame.data(), 1.0f, 30.0f, ours));
+    const float builtFor = proc.calibratedTa();
+
+    // within the rebuild threshold: tables are reused, result still within tolerance
+    frame = build_subpage_frame(0, true, 30.05f);
+    REQUIRE(proc.calculateTo(frame.data(), 1.0f, 30.0f, ours));
+    CHECK(proc.calibratedTa() == builtFor);
+    MLX90640_CalculateTo(frame.data(), &ref, 1.0f, 30.0f, theirs);
+    for (std::size_t i = 0; i < 768; i += 2)
+    {
+        CAPTURE(i);
+        CHECK(std::fabs(ours[i] - theirs[i]) < 0.05f);
+    }
+
+    frame = build_subpage_frame(0, true, 35.0f);
+    REQUIRE(proc.calculateTo(frame.data(), 1.0f, 30.0f, ours));
+    CHECK(proc.calibratedTa() == doctest::Approx(35.0f).epsilon(1e-3));
+}
+
+TEST_CASE("MLX90640: calculateTo rejects malformed frames")
+{
+    MLX90640ImageProcessor proc;
+    MLX90640ImageProcessor::TempImage ours{};
+
+    auto frame = build_subpage_frame(2, true, 30.0f);
+    CHECK_FALSE(proc.calculateTo(frame.data(), 1.0f, 30.0f, ours));
+
+    frame = build_subpage_frame(0, true, 30.0f);
+    frame[778] = 0;
+    CHECK_FALSE(proc.calculateTo(frame.data(), 1.0f, 30.0f, ours));
+}
+
+TEST_CASE("MLX90640: frame time, Melexis CalculateTo vs precomputed tables")
+{
+    const paramsMLX90640 ref = melexis_params();
+    MLX90640ImageProcessor proc;
+    MLX90640ImageProcessor::TempImage ours{};
+    float theirs[768] = {};
+
+    std::array<std::array<uint16_t, 834>, 2> frames = {
+        build_subpage_frame(0, true, 31.0f),
+        build_subpage_frame(1, true, 31.0f),
+    };
+
+    constexpr int ROUNDS = 500;
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+        MLX90640_CalculateTo(frames[std::size_t(r & 1)].data(), &ref, 0.95f, 23.0f, theirs);
+    const auto melexis = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+
+    start = clock::now();
+    for (int r = 0; r < ROUNDS; ++r)
+        REQUIRE(proc.calculateTo(frames[std::size_t(r & 1)].data(), 0.95f, 23.0f, ours));
+    const auto tables = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+
+    MESSAGE("subpage frame: Melexis " << melexis.count() / ROUNDS << " ns, precomputed "
+            << tables.count() / ROUNDS << " ns");
+}
+
+TEST_CASE("MLX90640: thermal image is updated one subpage at a time")
+{
+    const paramsMLX90640 ref = melexis_params();
+    MLX90640ThermalImage image;
+    image.setEmissivity(0.95f);
+    image.setReflectedTemperature(23.0f);
+
+    float theirs[768] = {};
+
+    // the sink takes the subpage number from the caller, not from word 833
+    auto first = build_subpage_frame(0, true, 31.0f);
+    first[833] = 0xFFFF;
+    REQUIRE(image.processSubpage(first.data(), 1));
+    CHECK(image.updates() == 1);
+    CHECK_FALSE(image.isComplete());
+
+    MLX90640_CalculateTo(first.data(), &ref, 0.95f, 23.0f, theirs);
+    for (std::size_t i = 0; i < 768; ++i)
+    {
+        CAPTURE(i);
+        const bool subpage1 = ((i / 32 + i) & 1) != 0;
+        if (subpage1)
+            CHECK(std::fabs(image.temperatures()[i] - theirs[i]) < 0.01f);
+        else
+            CHECK(image.temperatures()[i] == 0.0f);
+    }
+
+    auto second = build_subpage_frame(0, true, 31.0f);
+    REQUIRE(image.processSubpage(second.data(), 0));
+    CHECK(image.isComplete());
+    MLX90640_CalculateTo(second.data(), &ref, 0.95f, 23.0f, theirs);
+    for (std::size_t i = 0; i < 768; ++i)
+    {
+        CAPTURE(i);
+        CHECK(std::fabs(image.temperatures()[i] - theirs[i]) < 0.01f);
+    }
+
+    CHECK_FALSE(image.processSubpage(second.data(), 2));
+}
@@ -75,3 +75,32 @@ TEST_CASE("MLX90640 computeTemperatures runs without crashing")
     // Instead, we only check that the function executed and filled the array.
     CHECK(temps.size() == MLX90640ImageProcessor::PIXELS);
 }
+
+TEST_CASE("MLX90640 demultiplexSubpage only touches its own half")
+{
+    MLX90640ImageProcessor proc;
+
+    uint16_t frame[1668];
+    build_test_frame(frame);
+
+    MLX90640ImageProcessor::RawImage raw{};
+    raw.fill(-1);
+
+    CHECK(proc.demultiplexSubpage(frame + 834, 1, raw));
+    for (size_t idx = 0; idx < MLX90640ImageProcessor::PIXELS; ++idx)
+    {
+        const size_t row = idx / 32;
+        const size_t col = idx % 32;
+        if (expected_subpage(row, col) == 1)
+            CHECK(raw[idx] == int16_t(idx + 1000));
+        else
+            CHECK(raw[idx] == -1);
+    }
+
+    CHECK(proc.demultiplexSubpage(frame, 0, raw));
+    MLX90640ImageProcessor::RawImage full{};
+    proc.demultiplexFrame(frame, full);
+    CHECK(raw == full);
+
+    CHECK_FALSE(proc.demultiplexSubpage(frame, 2, raw));
+}
@@ -42,3 +42,55 @@ TEST_CASE("MR25H10 writeStatus sends correct command and data") {
     CHECK(tx[0] == static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_WRSR));
     CHECK(tx[1] == status);
 }
+
+TEST_CASE("MR25H10 write sends WREN then WRITE with a 24 bit address") {
+    clear_spi_tx_buffer();
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    SRAM sram(transport);
+
+    const uint8_t data[3] = {0x11, 0x22, 0x33};
+    CHECK(sram.write(0x012345, data, sizeof(data)) == true);
+
+    auto tx = get_spi_tx_buffer();
+    REQUIRE(get_spi_tx_buffer_count() == 1 + 4 + 3);
+    CHECK(tx[0] == static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_WREN));
+    CHECK(tx[1] == static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_WRITE));
+    CHECK(tx[2] == 0x01);
+    CHECK(tx[3] == 0x23);
+    CHECK(tx[4] == 0x45);
+    CHECK(tx[5] == 0x11);
+    CHECK(tx[7] == 0x33);
+}
+
+TEST_CASE("MR25H10 read returns the bytes after the command frame") {
+    clear_spi_tx_buffer();
+    clear_spi_rx_buffer();
+
+    uint8_t response[6] = {0, 0, 0, 0, 0xDE, 0xAD};
+    inject_spi_rx_data(response, sizeof(response));
+
+    Config config(&mock_gpio);
+    Transport transport(config);
+    SRAM sram(transport);
+
+    uint8_t data[2] = {};
+    CHECK(sram.read(0x000100, data, sizeof(data)) == true);
+    CHECK(data[0] == 0xDE);
+    CHECK(data[1] == 0xAD);
+
+    auto tx = get_spi_tx_buffer();
+    CHECK(tx[0] == static_cast<uint8_t>(MR25H10_COMMANDS::MR25H10_READ));
+    CHECK(tx[2] == 0x01);
+}
+
+TEST_CASE("MR25H10 rejects accesses past the end of the array") {
+    Config config(&mock_gpio);
+    Transport transport(config);
+    SRAM sram(transport);
+
+    uint8_t data[4] = {};
+    CHECK_FALSE(sram.read(SRAM::SIZE - 2, data, sizeof(data)));
+    CHECK_FALSE(sram.write(SRAM::SIZE - 2, data, sizeof(data)));
+}
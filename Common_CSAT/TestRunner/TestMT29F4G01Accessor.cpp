@@ -6,6 +6,9 @@
 #include "imagebuffer/buffer_state.hpp"
 #include "imagebuffer/image.hpp"
 #include "ImageBuffer.hpp"
+#include "mock_hal.h"
+
+#include <vector>
 
 template <typename Accessor>
 using CachedImageBuffer = ImageBuffer<Accessor>;
@@ -68,7 +71,8 @@ TEST_SUITE("MT29F4G01Accessor Template")
         A acc(spi);
 
         CHECK(acc.getAlignment() == A::PAGE_SIZE);
-        CHECK(acc.getFlashMemorySize() == A::TOTAL_SIZE);
+        CHECK(acc.getFlashMemorySize() == A::DATA_SIZE);
+        CHECK(acc.getEraseBlockSize() == A::PAGE_SIZE * A::PAGES_PER_BLOCK);
         CHECK(acc.getFlashStartAddress() == 0);
 
         static_assert(Accessor<A>, "MT29F4G01Accessor must satisfy Accessor concept");
@@ -136,6 +140,272 @@ TEST_SUITE("MT29F4G01Accessor Template")
         CachedImageBuffer<A> buffer(acc);
 
         CHECK(buffer.is_empty());
-        CHECK(buffer.capacity() == A::TOTAL_SIZE);
+        CHECK(buffer.capacity() == A::DATA_SIZE);
+    }
+}
+
+// ------------------------------------------------------------
+// Against the SPI-NAND model of the mock HAL
+// ------------------------------------------------------------
+SPI_HandleTypeDef nand_spi;
+GPIO_TypeDef nand_gpio;
+
+using NandConfig = SPI_Stream_Config<nand_spi, GPIO_PIN_4, 4352>;
+using NandTransport = SPIStreamTransport<NandConfig>;
+using NandAccessor = MT29F4G01Accessor<NandTransport>;
+
+constexpr uint32_t NAND_BLOCKS = 4;
+
+static std::vector<uint8_t> pattern(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<uint8_t>(seed + i * 7);
+    return data;
+}
+
+TEST_SUITE("MT29F4G01Accessor page cache")
+{
+    TEST_CASE("Write/read round trip through the NAND model")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        auto data = pattern(3 * NandAccessor::PAGE_SIZE + 100, 0x11);
+        REQUIRE(acc.write(50, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+
+        std::vector<uint8_t> back(data.size());
+        REQUIRE(acc.read(50, back.data(), back.size()) == AccessorError::NO_ERROR);
+        CHECK(back == data);
+
+        // the model holds the data where the accessor says it is
+        CHECK(get_spi_nand_page(1)[0] == data[NandAccessor::PAGE_SIZE - 50]);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Repeated small reads of one page load it once")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        reset_spi_nand_counters();
+        std::array<uint8_t, 64> buf{};
+        for (size_t offset = 0; offset < NandAccessor::PAGE_SIZE; offset += buf.size())
+            REQUIRE(acc.read(offset, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+
+        SpiNandCounters counters = get_spi_nand_counters();
+        CHECK(counters.page_read == 1);
+        CHECK(counters.read_from_cache == 1);
+
+        // next page misses
+        REQUIRE(acc.read(NandAccessor::PAGE_SIZE, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+        CHECK(get_spi_nand_counters().page_read == 2);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Small writes within a page are programmed once")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        reset_spi_nand_counters();
+        auto data = pattern(NandAccessor::PAGE_SIZE / 2, 0x40);
+        for (size_t offset = 0; offset < data.size(); offset += 32)
+            REQUIRE(acc.write(offset, data.data() + offset, 32) == AccessorError::NO_ERROR);
+
+        CHECK(get_spi_nand_counters().program_execute == 0);
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+        CHECK(get_spi_nand_counters().program_execute == 1);
+        CHECK(get_spi_nand_counters().page_read == 0);
+
+        // flushing again has nothing to do
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+        CHECK(get_spi_nand_counters().program_execute == 1);
+
+        // untouched bytes stay erased
+        CHECK(get_spi_nand_page(0)[data.size()] == 0xFF);
+        CHECK(get_spi_nand_page(0)[31] == data[31]);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Reading a page with pending writes flushes it first")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        auto data = pattern(100, 0x22);
+        REQUIRE(acc.write(10, data.data(), data.size()) == AccessorError::NO_ERROR);
+
+        std::vector<uint8_t> back(data.size());
+        REQUIRE(acc.read(10, back.data(), back.size()) == AccessorError::NO_ERROR);
+        CHECK(back == data);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Erase drops the cached page")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        auto data = pattern(16, 0x33);
+        REQUIRE(acc.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+
+        std::array<uint8_t, 16> buf{};
+        REQUIRE(acc.read(0, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+        CHECK(buf[0] == data[0]);
+
+        REQUIRE(acc.erase(0) == AccessorError::NO_ERROR);
+        REQUIRE(acc.read(0, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+        CHECK(buf[0] == 0xFF);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Multi-page reads use the sequential cache read")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        constexpr size_t PAGES = 8;
+        auto data = pattern(PAGES * NandAccessor::PAGE_SIZE, 0x5A);
+        REQUIRE(acc.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+
+        SUBCASE("cache read")
+        {
+            acc.invalidateCache();
+            reset_spi_nand_counters();
+            std::vector<uint8_t> back(data.size());
+            REQUIRE(acc.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+            CHECK(back == data);
+
+            SpiNandCounters counters = get_spi_nand_counters();
+            CHECK(counters.page_read == 1);
+            CHECK(counters.cache_read_sequential == PAGES - 1);
+            CHECK(counters.cache_read_last == 1);
+            CHECK(counters.read_from_cache == PAGES);
+
+            // last page stays resident
+            std::array<uint8_t, 8> tail{};
+            REQUIRE(acc.read(data.size() - tail.size(), tail.data(), tail.size()) == AccessorError::NO_ERROR);
+            CHECK(get_spi_nand_counters().page_read == 1);
+            CHECK(tail[0] == data[data.size() - tail.size()]);
+        }
+
+        SUBCASE("page by page")
+        {
+            acc.setCacheReadEnabled(false);
+            acc.invalidateCache();
+            reset_spi_nand_counters();
+            std::vector<uint8_t> back(data.size());
+            REQUIRE(acc.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+            CHECK(back == data);
+
+            SpiNandCounters counters = get_spi_nand_counters();
+            CHECK(counters.page_read == PAGES);
+            CHECK(counters.cache_read_sequential == 0);
+        }
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("Cache read stops at the block boundary")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+
+        const size_t start = (NandAccessor::PAGES_PER_BLOCK - 2) * NandAccessor::PAGE_SIZE + 200;
+        auto data = pattern(4 * NandAccessor::PAGE_SIZE, 0x77);
+        REQUIRE(acc.write(start, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(acc.flush() == AccessorError::NO_ERROR);
+
+        acc.invalidateCache();
+        reset_spi_nand_counters();
+        std::vector<uint8_t> back(data.size());
+        REQUIRE(acc.read(start, back.data(), back.size()) == AccessorError::NO_ERROR);
+        CHECK(back == data);
+
+        // two pages in block 0, three in block 1
+        SpiNandCounters counters = get_spi_nand_counters();
+        CHECK(counters.page_read == 2);
+        CHECK(counters.cache_read_last == 2);
+        CHECK(counters.cache_read_sequential == 3);
+
+        spi_nand_detach();
+    }
+
+    TEST_CASE("ImageBuffer cycle on the NAND model")
+    {
+        spi_nand_attach(&nand_spi, NAND_BLOCKS);
+        NandConfig config(&nand_gpio);
+        NandTransport transport(config);
+        NandAccessor acc(transport);
+        CachedImageBuffer<NandAccessor> buffer(acc);
+
+        constexpr size_t IMAGE_SIZE = 20000;
+        constexpr size_t CHUNK = 512;
+        auto data = pattern(IMAGE_SIZE, 0x01);
+
+        reset_spi_nand_counters();
+        ImageMetadata meta{};
+        meta.payload_size = IMAGE_SIZE;
+        REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+        for (size_t offset = 0; offset < IMAGE_SIZE; offset += CHUNK)
+        {
+            size_t size = std::min(CHUNK, IMAGE_SIZE - offset);
+            REQUIRE(buffer.add_data_chunk(data.data() + offset, size) == ImageBufferError::NO_ERROR);
+        }
+        REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+
+        // one program per touched page, no read-modify-write
+        SpiNandCounters counters = get_spi_nand_counters();
+        const size_t pages = (buffer.size() + NandAccessor::PAGE_SIZE - 1) / NandAccessor::PAGE_SIZE;
+        CHECK(counters.program_execute == pages);
+        CHECK(counters.page_read == 0);
+
+        acc.invalidateCache();
+        reset_spi_nand_counters();
+        ImageMetadata read_meta{};
+        REQUIRE(buffer.get_image(read_meta) == ImageBufferError::NO_ERROR);
+        CHECK(read_meta.payload_size == IMAGE_SIZE);
+
+        std::vector<uint8_t> back;
+        std::array<uint8_t, CHUNK> chunk{};
+        while (back.size() < IMAGE_SIZE)
+        {
+            size_t size = chunk.size();
+            REQUIRE(buffer.get_data_chunk(chunk.data(), size) == ImageBufferError::NO_ERROR);
+            REQUIRE(size > 0);
+            back.insert(back.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(size));
+        }
+        CHECK(back == data);
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+
+        counters = get_spi_nand_counters();
+        MESSAGE("image of " << IMAGE_SIZE << " bytes over " << pages << " pages: "
+                << counters.page_read << " page reads, " << counters.read_from_cache << " cache reads");
+        CHECK(counters.page_read <= pages);
+
+        spi_nand_detach();
     }
 }
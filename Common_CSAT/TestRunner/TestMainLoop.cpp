@@ -160,7 +160,7 @@ TEST_CASE("TaskMainLoop: TaskSendHeartBeat TaskBlinkLED TaskCheckMemory")
 
     REQUIRE(registration_manager.getHandlers().size() == 3);
 
-    ServiceManager service_manager(registration_manager.getHandlers());
+    ServiceManager service_manager(registration_manager);
     SubscriptionManager subscription_manager;
     subscription_manager.subscribe<SubscriptionManager::MessageTag>(registration_manager.getSubscriptions(), adapters);
     subscription_manager.subscribe<SubscriptionManager::RequestTag>(registration_manager.getServers(), adapters);
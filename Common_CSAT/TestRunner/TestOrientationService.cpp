@@ -5,6 +5,8 @@
 #include "OrientationService.hpp"
 #include "mock_hal.h"
 
+#include <vector>
+
 constexpr float m_pif = static_cast<float>(std::numbers::pi);
 
 // Mock IMU class
@@ -43,6 +45,7 @@ public:
 
     std::optional<AngularVelocityInBodyFrame> readGyroscope()
     {
+        ++gyro_reads;
         if (has_gyro_data)
         {
             return gyroscope;
@@ -63,6 +66,7 @@ public:
     
     std::optional<MagneticFieldInBodyFrame> readMagnetometer()
     {
+        ++mag_reads;
         if (has_mag_data)
         {
             return magnetometer;
@@ -73,6 +77,9 @@ public:
         }
     }
 
+    int gyro_reads = 0;
+    int mag_reads = 0;
+
 private:
     AccelerationInBodyFrame acceleration;
     AngularVelocityInBodyFrame gyroscope;
@@ -83,6 +90,47 @@ static_assert(HasBodyAccelerometer<MockIMUinBodyFrame>);
 static_assert(HasBodyGyroscope<MockIMUinBodyFrame>);
 static_assert(HasBodyMagnetometer<MockIMUinBodyFrame>);
 
+// Stands in for BMI270Fifo, drain() only records the time it was called with
+class MockIMUFifo
+{
+public:
+    void push(uint64_t ms, float gyr_z_dps, std::optional<float> mag_x = std::nullopt)
+    {
+        IMUSample sample{};
+        sample.timestamp = au::make_quantity<au::Milli<au::Seconds>>(ms);
+        sample.angular_velocity = {au::make_quantity<au::DegreesPerSecondInBodyFrame>(0.f),
+                                   au::make_quantity<au::DegreesPerSecondInBodyFrame>(0.f),
+                                   au::make_quantity<au::DegreesPerSecondInBodyFrame>(gyr_z_dps)};
+        sample.flags = IMUSample::GYR;
+        if (mag_x)
+        {
+            sample.magnetic_field = {au::make_quantity<au::TeslaInBodyFrame>(*mag_x),
+                                     au::make_quantity<au::TeslaInBodyFrame>(0.f),
+                                     au::make_quantity<au::TeslaInBodyFrame>(0.f)};
+            sample.flags |= IMUSample::MAG;
+        }
+        samples.push_back(sample);
+    }
+
+    size_t drain(au::QuantityU64<au::Milli<au::Seconds>>)
+    {
+        ++drains;
+        return samples.size();
+    }
+
+    bool pop(IMUSample &sample)
+    {
+        if (samples.empty())
+            return false;
+        sample = samples.front();
+        samples.erase(samples.begin());
+        return true;
+    }
+
+    std::vector<IMUSample> samples;
+    int drains = 0;
+};
+
 TEST_CASE("GyrMagOrientation predicts identity quaternion with static inputs")
 {
     GyrMagOrientationTracker tracker;
@@ -230,3 +278,166 @@ TEST_CASE("AccGyrOrientation returns valid OrientationSolution with static input
     REQUIRE_FALSE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
     REQUIRE(std::abs(sol.q[0] - 1.f) < 1e-3f);
 }
+
+TEST_CASE("GyrMagOrientation solution reads each sensor once")
+{
+    GyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUinBodyFrame imu;
+    imu.setGyroscope(0.f, 0.f, 0.f);
+    imu.setMagnetometer(1.f, 0.f, 0.f);
+
+    GyrMagOrientation<GyrMagOrientationTracker<7,3>, MockIMUinBodyFrame, MockIMUinBodyFrame> service(&rtc, tracker, imu, imu);
+    OrientationSolution sol = service.predict();
+
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(imu.gyro_reads == 1);
+    REQUIRE(imu.mag_reads == 1);
+}
+
+TEST_CASE("FifoGyrMagOrientation integrates every queued gyro sample")
+{
+    GyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    // 11 samples 10 ms apart at 90 deg/s about z: 10 intervals of 0.9 deg
+    MockIMUFifo fifo;
+    for (uint64_t i = 0; i <= 10; ++i)
+    {
+        fifo.push(1000 + 10 * i, 90.f);
+    }
+
+    FifoGyrMagOrientation<GyrMagOrientationTracker<7,3>, MockIMUFifo> service(&rtc, tracker, fifo);
+
+    std::array<float, 4> q{};
+    au::QuantityU64<au::Milli<au::Seconds>> timestamp;
+    REQUIRE(service.predict(q, timestamp));
+
+    const float half_angle = 0.5f * 9.f * m_pif / 180.f;
+    REQUIRE(fifo.drains == 1);
+    REQUIRE(fifo.samples.empty());
+    REQUIRE(std::abs(q[0] - std::cos(half_angle)) < 1e-3f);
+    REQUIRE(std::abs(q[3] - std::sin(half_angle)) < 1e-3f);
+}
+
+TEST_CASE("FifoGyrMagOrientation returns valid OrientationSolution with static inputs")
+{
+    GyrMagOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUFifo fifo;
+    fifo.push(1000, 0.f, 1.f);
+    fifo.push(1010, 0.f);
+    fifo.push(1020, 0.f, 1.f);
+
+    FifoGyrMagOrientation<GyrMagOrientationTracker<7,3>, MockIMUFifo> service(&rtc, tracker, fifo);
+    OrientationSolution sol = service.predict();
+
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::ANGULAR_VELOCITY));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::ORIENTATIONS));
+    REQUIRE(std::abs(sol.q[0] - 1.f) < 1e-3f);
+
+    // nothing queued on the next tick
+    sol = service.predict();
+    REQUIRE_FALSE(sol.has_valid(OrientationSolution::Validity::ANGULAR_VELOCITY));
+    REQUIRE_FALSE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
+}
+
+TEST_CASE("GyrMagOrientation accepts the MEKF tracker")
+{
+    GyrMagMEKFOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUinBodyFrame imu;
+    imu.setGyroscope(0.f, 0.f, 0.f);
+    imu.setMagnetometer(1.f, 0.f, 0.f);
+
+    GyrMagOrientation<GyrMagMEKFOrientationTracker, MockIMUinBodyFrame, MockIMUinBodyFrame> service(&rtc, tracker, imu, imu);
+    OrientationSolution sol = service.predict();
+
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::MAGNETIC_FIELD));
+    REQUIRE(std::abs(sol.q[0] - 1.f) < 1e-3f);
+}
+
+TEST_CASE("GyrMagOrientation keeps the MEKF covariance bounded from an RTC epoch start")
+{
+    GyrMagMEKFOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(1.f, 0.f, 0.f));
+    const float initial_bias_variance = tracker.getCovariance()(3, 3);
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUinBodyFrame imu;
+    imu.setGyroscope(0.f, 0.f, 0.f);
+    imu.setMagnetometer(1.f, 0.f, 0.f);
+
+    GyrMagOrientation<GyrMagMEKFOrientationTracker, MockIMUinBodyFrame, MockIMUinBodyFrame> service(&rtc, tracker, imu, imu);
+    for (uint8_t second = 0; second < 50; ++second)
+    {
+        set_mocked_rtc_time({12, 0, second, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+        const OrientationSolution sol = service.predict();
+        REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    }
+
+    // the bias along the magnetic field is unobservable and only random walks
+    const Eigen::Matrix<float, 6, 6> &P = tracker.getCovariance();
+    REQUIRE(P.allFinite());
+    CHECK(P.llt().info() == Eigen::Success);
+    for (int i = 3; i < 6; ++i)
+        CHECK(P(i, i) < 2.f * initial_bias_variance);
+    CHECK(std::abs(tracker.getOrientation().w() - 1.f) < 1e-3f);
+}
+
+TEST_CASE("AccGyrMagOrientation accepts the MEKF tracker")
+{
+    AccGyrMagMEKFOrientationTracker tracker;
+    tracker.setReferenceVectors(Eigen::Vector3f(0.f, 0.f, 9.81f), Eigen::Vector3f(1.f, 0.f, 0.f));
+
+    RTC_HandleTypeDef rtc{};
+    rtc.Init.SynchPrediv = 255;
+
+    set_mocked_rtc_time({12, 0, 0, RTC_HOURFORMAT12_AM, 0, 255, RTC_DAYLIGHTSAVING_NONE, RTC_STOREOPERATION_RESET});
+    set_mocked_rtc_date({RTC_WEEKDAY_MONDAY, 1, 1, 24});
+
+    MockIMUinBodyFrame imu;
+    imu.setGyroscope(0.f, 0.f, 0.f);
+    imu.setAcceleration(0.f, 0.f, 9.81f);
+    imu.setMagnetometer(1.f, 0.f, 0.f);
+
+    AccGyrMagOrientation<AccGyrMagMEKFOrientationTracker, MockIMUinBodyFrame, MockIMUinBodyFrame> service(&rtc, tracker, imu, imu);
+    OrientationSolution sol = service.predict();
+
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::QUATERNION));
+    REQUIRE(sol.has_valid(OrientationSolution::Validity::ORIENTATIONS));
+    REQUIRE(std::abs(sol.q[0] - 1.f) < 1e-3f);
+}
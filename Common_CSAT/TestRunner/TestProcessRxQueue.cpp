@@ -152,6 +152,8 @@ TEST_CASE("processTransfer with LoopardAdapter")
     transfer.metadata.transfer_kind = CyphalTransferKindMessage;
     transfer.metadata.port_id = 123;
     transfer.metadata.remote_node_id = CYPHAL_NODE_ID_UNSET;
+    transfer.metadata.source_node_id = CYPHAL_NODE_ID_UNSET;
+    transfer.metadata.destination_node_id = CYPHAL_NODE_ID_UNSET;
     transfer.metadata.transfer_id = 0;
 
     constexpr char payload[] = "hello";
@@ -170,8 +172,16 @@ TEST_CASE("processTransfer with LoopardAdapter")
 
     bool result = loop_manager.processTransfer(transfer, &service_manager, adapters);
 
+    CHECK(result == true);
+    CHECK(adapter.buffer.size() == 0); // no route
+    CHECK(loop_manager.router().unrouted() == 1);
+
+    REQUIRE(loop_manager.router().addRoute(0, 123));
+    result = loop_manager.processTransfer(transfer, &service_manager, adapters);
+
     CHECK(result == true);
     CHECK(adapter.buffer.size() == 1);
+    CHECK(loop_manager.router().findRoute(0, 123)->forwarded == 1);
 
     CyphalTransfer received;
     size_t frame_size = 0;
@@ -226,12 +236,15 @@ TEST_CASE("processTransfer with LoopardAdapter and CanardAdapter")
 
     SafeAllocator<CyphalTransfer, Heap> alloc;
     LoopManager loop_manager(alloc);
+    REQUIRE(loop_manager.router().addRoute(0, 123));
+    REQUIRE(loop_manager.router().addRoute(1, 123));
 
     bool result = loop_manager.processTransfer(transfer, &service_manager, adapters);
 
     CHECK(result == true);
     CHECK(loopard_adapter.buffer.size() == 1);
     CHECK(canard_adapter.que.size > 0);
+    CHECK(canard_adapter.ins.node_id == 11); // forwarding leaves the local node-ID alone
 
     // Loopard receive
     CyphalTransfer received_loopard;
@@ -740,3 +753,58 @@ TEST_CASE("Full Loop Test with LoopardAdapter and MockTaskFromBuffer")
     diagnostics = Heap::getDiagnostics();
     CHECK(diagnostics.allocated == initial_allocated);
 }
+
+TEST_CASE("LoopProcessRxQueue does not forward back onto the loop adapter")
+{
+    constexpr CyphalPortID port_id = 123;
+
+    Heap::initialize();
+
+    LoopardAdapter adapter;
+    adapter.memory_allocate = Heap::loopardMemoryAllocate;
+    adapter.memory_free = Heap::loopardMemoryDeallocate;
+    Cyphal<LoopardAdapter> cyphal(&adapter);
+
+    LoopardAdapter bridged;
+    bridged.memory_allocate = Heap::loopardMemoryAllocate;
+    bridged.memory_free = Heap::loopardMemoryDeallocate;
+    Cyphal<LoopardAdapter> bridged_cyphal(&bridged);
+
+    auto adapters = std::make_tuple(cyphal, bridged_cyphal);
+
+    CyphalTransfer transfer;
+    transfer.metadata.priority = CyphalPriorityNominal;
+    transfer.metadata.transfer_kind = CyphalTransferKindMessage;
+    transfer.metadata.port_id = port_id;
+    transfer.metadata.remote_node_id = 42;
+    transfer.metadata.source_node_id = 42;
+    transfer.metadata.destination_node_id = CYPHAL_NODE_ID_UNSET;
+    transfer.metadata.transfer_id = 0;
+    constexpr char payload[] = "hello";
+    transfer.payload_size = sizeof(payload);
+    transfer.payload = Heap::heapAllocate(nullptr, sizeof(payload));
+    memcpy(transfer.payload, payload, sizeof(payload));
+
+    ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> handlers;
+    auto task = std::make_shared<MockTask>(10, 0, transfer);
+    handlers.push(TaskHandler{port_id, task});
+    ServiceManager service_manager(handlers);
+
+    SafeAllocator<CyphalTransfer, Heap> alloc;
+    LoopManager loop_manager(alloc);
+    REQUIRE(loop_manager.router().addRoute(0, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE));
+    REQUIRE(loop_manager.router().addRoute(1, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE));
+    CHECK(loop_manager.ingressIndex<LoopardAdapter>(adapters) == 0);
+
+    adapter.buffer.push(transfer);
+    loop_manager.LoopProcessRxQueue(&cyphal, &service_manager, adapters);
+
+    CHECK(adapter.buffer.size() == 0);
+    CHECK(bridged.buffer.size() == 1);
+    CHECK(loop_manager.router().findRoute(0, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE)->forwarded == 0);
+    CHECK(loop_manager.router().findRoute(1, CyphalRouter<>::ANY_PORT, CyphalRouter<>::ANY_NODE)->forwarded == 1);
+
+    CyphalTransfer received = bridged.buffer.pop();
+    CHECK(received.metadata.remote_node_id == 42);
+    bridged.memory_free(received.payload);
+}
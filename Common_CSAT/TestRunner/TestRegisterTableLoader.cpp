@@ -0,0 +1,294 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "RegisterTableLoader.hpp"
+#include "OV2640.hpp"
+#include "OV5640.hpp"
+#include "Transport.hpp"
+#include "mock_hal.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+struct DummyConfig
+{
+    using mode_tag = register_mode_tag;
+};
+
+// OV2640 register file: two banks behind 0xFF, auto-incrementing writes,
+// COM7[7] in the sensor bank resets everything
+class OV2640Model
+{
+public:
+    using config_type = DummyConfig;
+
+    bool write_reg(uint16_t reg, const uint8_t *data, size_t size)
+    {
+        ++transactions;
+        bytes += size;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto addr = static_cast<uint8_t>(reg + i);
+            if (addr == 0xFF)
+            {
+                bank = data[i] & 1U;
+                continue;
+            }
+            if (bank == 1 && addr == 0x12 && (data[i] & 0x80) != 0)
+            {
+                regs = {};
+                continue;
+            }
+            regs[bank][addr] = data[i];
+        }
+        return true;
+    }
+
+    bool read_reg(uint16_t reg, uint8_t *data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            data[i] = regs[bank][static_cast<uint8_t>(reg + i)];
+        return true;
+    }
+
+    std::array<std::array<uint8_t, 256>, 2> regs{};
+    size_t bank = 0;
+    size_t transactions = 0;
+    size_t bytes = 0;
+};
+
+// OV5640 register file: flat 16-bit addresses
+class OV5640Model
+{
+public:
+    using config_type = DummyConfig;
+
+    bool write_reg(uint16_t reg, const uint8_t *data, size_t size)
+    {
+        ++transactions;
+        for (size_t i = 0; i < size; ++i)
+            regs[static_cast<uint16_t>(reg + i)] = data[i];
+        return true;
+    }
+
+    bool read_reg(uint16_t reg, uint8_t *data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            data[i] = regs[static_cast<uint16_t>(reg + i)];
+        return true;
+    }
+
+    std::map<uint16_t, uint8_t> regs;
+    size_t transactions = 0;
+};
+
+// OV5640Model with a DMA style write that completes at write_reg_wait()
+class AsyncOV5640Model : public OV5640Model
+{
+public:
+    bool write_reg_async(uint16_t reg, const uint8_t *data, uint16_t len)
+    {
+        if (in_flight)
+            overlapped = true;
+        in_flight = true;
+        pending_reg = reg;
+        pending_data = data;
+        pending_len = len;
+        ++async_starts;
+        return true;
+    }
+
+    bool write_reg_wait()
+    {
+        if (!in_flight)
+            return true;
+        in_flight = false;
+        return write_reg(pending_reg, pending_data, pending_len);
+    }
+
+    bool in_flight = false;
+    bool overlapped = false;
+    uint16_t pending_reg = 0;
+    const uint8_t *pending_data = nullptr;
+    uint16_t pending_len = 0;
+    size_t async_starts = 0;
+};
+
+static_assert(AsyncRegisterWriteTransport<AsyncOV5640Model>);
+static_assert(!AsyncRegisterWriteTransport<OV5640Model>);
+
+using QQVGA = RegisterBurstTable<OV2640_QQVGA, OV2640TablePolicy>;
+using OV5640Init = RegisterBurstTable<cfg_init_, OV5640TablePolicy>;
+
+// Bursts are built at compile time
+static_assert(QQVGA::count < QQVGA::entries);
+static_assert(QQVGA::values[0] == OV2640_QQVGA[0].data);
+
+TEST_CASE("RegisterBurstTable: bursts cover the table in order and keep bank selects apart")
+{
+    size_t next = 0;
+    for (const RegisterBurst &burst : QQVGA::bursts)
+    {
+        CHECK(burst.first == next);
+        CHECK(burst.length >= 1);
+        CHECK(burst.length <= OV2640TablePolicy::max_burst);
+        for (size_t i = 0; i < burst.length; ++i)
+        {
+            CAPTURE(burst.first + i);
+            CHECK(OV2640_QQVGA[burst.first + i].addr == burst.addr + i);
+            CHECK(QQVGA::values[burst.first + i] == OV2640_QQVGA[burst.first + i].data);
+            if (burst.length > 1)
+                CHECK(OV2640_QQVGA[burst.first + i].addr != 0xFF);
+        }
+        next += burst.length;
+    }
+    CHECK(next == QQVGA::entries);
+}
+
+TEST_CASE("OV2640: init in bursts needs fewer transactions and gives the same registers")
+{
+    // before: reset and the table register by register
+    OV2640Model single;
+    {
+        OV2640<OV2640Model> cam(single);
+        cam.writeRegister(uint8_t{0xFF}, uint8_t{0x01});
+        cam.writeRegister(uint8_t{0x12}, uint8_t{0x80});
+        cam.apply_table(OV2640_QQVGA, std::size(OV2640_QQVGA));
+    }
+
+    OV2640Model burst;
+    OV2640<OV2640Model> cam(burst);
+    REQUIRE(cam.init());
+
+    CHECK(burst.regs == single.regs);
+    CHECK(burst.bank == single.bank);
+    CHECK(burst.transactions < single.transactions);
+    CHECK(burst.transactions == cam.registerStats().transactions);
+
+    MESSAGE("OV2640 QQVGA init: " << single.transactions << " transactions register by register, "
+            << burst.transactions << " in bursts (" << QQVGA::count << " bursts, "
+            << cam.registerStats().skipped << " registers skipped)");
+}
+
+TEST_CASE("OV5640: init in bursts needs fewer transactions and gives the same registers")
+{
+    OV5640Model single;
+    {
+        OV5640<OV5640Model> cam(single);
+        for (const auto &w : cfg_init_)
+            REQUIRE(cam.writeRegister(w.addr, w.data));
+    }
+
+    OV5640Model burst;
+    OV5640<OV5640Model> cam(burst);
+    REQUIRE(cam.init());
+
+    CHECK(burst.regs == single.regs);
+    CHECK(burst.transactions < single.transactions);
+
+    MESSAGE("OV5640 init: " << single.transactions << " transactions register by register, "
+            << burst.transactions << " in bursts (" << OV5640Init::count << " bursts)");
+}
+
+TEST_CASE("OV2640: re-applying and switching tables only writes the differences")
+{
+    OV2640Model model;
+    OV2640<OV2640Model> cam(model);
+    REQUIRE(cam.init());
+
+    // same table again: bank switches, registers the table writes more
+    // than once and AEC / AGC results still go out
+    const size_t first = model.transactions;
+    model.transactions = 0;
+    REQUIRE(cam.loadTable<OV2640_QQVGA>());
+    const size_t again = model.transactions;
+    CHECK(again < first * 2 / 3);
+
+    // QQVGA -> QVGA shares most registers with the table before
+    OV2640Model reference;
+    {
+        OV2640<OV2640Model> ref(reference);
+        ref.apply_table(OV2640_QQVGA, std::size(OV2640_QQVGA));
+        ref.apply_table(OV2640_QVGA, std::size(OV2640_QVGA));
+    }
+    OV2640Model fresh;
+    {
+        OV2640<OV2640Model> other(fresh);
+        REQUIRE(other.loadTable<OV2640_QVGA>());
+    }
+
+    model.transactions = 0;
+    REQUIRE(cam.loadTable<OV2640_QVGA>());
+    CHECK(model.regs[0] == reference.regs[0]);
+    CHECK(model.regs[1] == reference.regs[1]);
+    CHECK(model.transactions < fresh.transactions);
+
+    MESSAGE("OV2640 QQVGA again: " << again << " transactions, QQVGA -> QVGA: " << model.transactions
+            << " transactions (" << fresh.transactions << " from scratch)");
+}
+
+TEST_CASE("OV2640: single register writes keep the shadow in step")
+{
+    OV2640Model model;
+    OV2640<OV2640Model> cam(model);
+    REQUIRE(cam.init());
+
+    const uint8_t tableFormat = model.regs[0][static_cast<uint8_t>(OV2640_Register::DSP_FORMAT_CTRL)];
+    REQUIRE(cam.setFormat(PixelFormat::RGB565));
+    CHECK(model.regs[0][static_cast<uint8_t>(OV2640_Register::DSP_FORMAT_CTRL)] != tableFormat);
+
+    REQUIRE(cam.loadTable<OV2640_QQVGA>());
+    CHECK(model.regs[0][static_cast<uint8_t>(OV2640_Register::DSP_FORMAT_CTRL)] == tableFormat);
+}
+
+TEST_CASE("OV2640: init after a power cycle writes the whole table again")
+{
+    OV2640Model model;
+    OV2640<OV2640Model> cam(model);
+    REQUIRE(cam.init());
+    const auto first = model.transactions;
+
+    model = OV2640Model{}; // CAMERA_POWER cycled, the sensor is back to defaults
+    REQUIRE(cam.init());
+    CHECK(model.transactions == first);
+
+    OV2640Model reference;
+    OV2640<OV2640Model> ref(reference);
+    REQUIRE(ref.init());
+    CHECK(model.regs == reference.regs);
+}
+
+TEST_CASE("RegisterTableLoader: DMA writes are started one at a time")
+{
+    AsyncOV5640Model model;
+    RegisterTableLoader<AsyncOV5640Model, OV5640TablePolicy> loader(model);
+    REQUIRE(loader.load<cfg_init_>());
+
+    CHECK_FALSE(model.in_flight);
+    CHECK_FALSE(model.overlapped);
+    CHECK(model.async_starts == OV5640Init::count);
+
+    OV5640Model reference;
+    OV5640<OV5640Model> cam(reference);
+    REQUIRE(cam.init());
+    CHECK(model.regs == reference.regs);
+}
+
+I2C_HandleTypeDef camera_i2c;
+using CameraI2C = I2CRegisterTransport<I2C_Register_Config<camera_i2c, OV5640_ADDRESS, I2CAddressWidth::Bits16>>;
+
+TEST_CASE("RegisterTableLoader: I2CRegisterTransport bursts go through HAL_I2C_Mem_Write_DMA")
+{
+    static_assert(AsyncRegisterWriteTransport<CameraI2C>);
+
+    CameraI2C transport;
+    OV5640<CameraI2C> cam(transport);
+
+    clear_i2c_mem_write_count();
+    REQUIRE(cam.init());
+    CHECK(get_i2c_mem_write_dma_count() == OV5640Init::count);
+    CHECK(get_i2c_mem_write_count() == OV5640Init::count);
+
+    CHECK(get_i2c_mem_address() == OV5640Init::bursts[OV5640Init::count - 1].addr);
+}
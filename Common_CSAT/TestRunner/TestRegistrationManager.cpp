@@ -504,4 +504,42 @@ TEST_CASE("RegistrationManager: TaskFromBuffer")
     for (auto handler : handlers)
         handler.task->handleTask();
     CHECK(transfer_ptr.use_count() == 1);
-}
\ No newline at end of file
+}
+
+TEST_CASE("RegistrationManager: Dispatch Table follows Registrations")
+{
+    RegistrationManager manager;
+    std::shared_ptr<MockTask> task1 = std::make_shared<MockTask>(100, 0, 300);
+    std::shared_ptr<MockTask> task2 = std::make_shared<MockTask>(100, 0, 100);
+    std::shared_ptr<MockTask> task3 = std::make_shared<MockTask>(100, 0, 300);
+
+    task1->registerTask(&manager, task1);
+    task2->registerTask(&manager, task2);
+    task3->registerTask(&manager, task3);
+
+    const TaskDispatchTable<RegistrationManager::NUM_TASK_HANDLERS> &table = manager.getDispatchTable();
+    CHECK(table.size() == 3);
+
+    auto entries100 = table.find(100);
+    REQUIRE(entries100.size() == 1);
+    CHECK(entries100[0].task == task2.get());
+
+    // tasks on the same port keep their registration order
+    auto entries300 = table.find(300);
+    REQUIRE(entries300.size() == 2);
+    CHECK(entries300[0].task == task1.get());
+    CHECK(entries300[1].task == task3.get());
+
+    CHECK(table.find(200).empty());
+
+    task1->unregisterTask(&manager, task1);
+    CHECK(table.size() == 2);
+    entries300 = table.find(300);
+    REQUIRE(entries300.size() == 1);
+    CHECK(entries300[0].task == task3.get());
+
+    task2->unregisterTask(&manager, task2);
+    task3->unregisterTask(&manager, task3);
+    CHECK(table.size() == 0);
+    CHECK(table.find(300).empty());
+}
@@ -116,11 +116,12 @@ TEST_CASE("Check predict in ecef 2025 6 25 18 0 0")
 
     sgp4.predict(r_now, v_now, timestamp_now);
 
-    CHECK(r_now[0].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(2715.4f).epsilon(0.01));
-    CHECK(r_now[1].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(-4518.34f).epsilon(0.01));
+    // the sidereal time is taken from the time point, not a float jd2000 (84 s off here)
+    CHECK(r_now[0].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(2687.56f).epsilon(0.01));
+    CHECK(r_now[1].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(-4534.95f).epsilon(0.01));
     CHECK(r_now[2].in(au::kilo(au::meters * au::ecefs)) == doctest::Approx(-4291.31f).epsilon(0.01));
-    CHECK(v_now[0].in(au::kilo(au::meters * au::ecefs / au::seconds)) == doctest::Approx(3.75928f).epsilon(0.01));
-    CHECK(v_now[1].in(au::kilo(au::meters * au::ecefs / au::seconds)) == doctest::Approx(5.63901f).epsilon(0.01));
+    CHECK(v_now[0].in(au::kilo(au::meters * au::ecefs / au::seconds)) == doctest::Approx(3.79389f).epsilon(0.01));
+    CHECK(v_now[1].in(au::kilo(au::meters * au::ecefs / au::seconds)) == doctest::Approx(5.61578f).epsilon(0.01));
     CHECK(v_now[2].in(au::kilo(au::meters * au::ecefs / au::seconds)) == doctest::Approx(-3.55967f).epsilon(0.01));
 }
 
@@ -321,3 +322,122 @@ TEST_CASE("Check position and velocity 2025 6 25 18 0 0")
 
 
 }
+
+static void set_rtc(RTC_HandleTypeDef &hrtc, const TimeUtils::DateTimeComponents &when)
+{
+    TimeUtils::RTCDateTimeSubseconds rtc = TimeUtils::to_rtc(when, hrtc.Init.SynchPrediv);
+    HAL_RTC_SetTime(&hrtc, &rtc.time, RTC_FORMAT_BIN);
+    HAL_RTC_SetDate(&hrtc, &rtc.date, RTC_FORMAT_BIN);
+    HAL_RTCEx_SetSynchroShift(&hrtc, RTC_SHIFTADD1S_RESET, rtc.time.SubSeconds);
+}
+
+static SGP4TwoLineElement parse_tle(const char *line1, const char *line2)
+{
+    char l1[130], l2[130];
+    std::snprintf(l1, sizeof(l1), "%s", line1);
+    std::snprintf(l2, sizeof(l2), "%s", line2);
+    auto parsed = sgp4_utils::parseTLE(l1, l2);
+    REQUIRE(parsed.has_value());
+    return parsed.value();
+}
+
+TEST_CASE("Cached SGP4 model predicts the same as a freshly initialized one")
+{
+    RTC_HandleTypeDef hrtc;
+    hrtc.Init.SynchPrediv = 1023;
+    set_current_tick(1001);
+
+    // near earth (ISS) and deep space (GEO, resonance integrator state kept in the model)
+    const SGP4TwoLineElement tles[] = {
+        parse_tle("1 25544U 98067A   25176.73245655  .00008102  00000-0  14854-3 0  9994",
+                  "2 25544  51.6390 264.7180 0001990 278.3788 217.2311 15.50240116516482"),
+        parse_tle("1 28884U 05041A   25176.50000000 -.00000288  00000-0  00000-0 0  9995",
+                  "2 28884   0.0156 250.8312 0002459 151.6412 280.8990  1.00271024 72164")};
+
+    // forwards, then back in time
+    const uint8_t hours[] = {18, 19, 23, 20, 18};
+
+    for (const SGP4TwoLineElement &tle : tles)
+    {
+        CAPTURE(tle.satelliteNumber);
+        SGP4 cached(&hrtc, tle);
+
+        for (uint8_t hour : hours)
+        {
+            CAPTURE(hour);
+            set_rtc(hrtc, TimeUtils::DateTimeComponents{
+                              .year = 2025, .month = 6, .day = 27, .hour = hour, .minute = 10, .second = 0, .millisecond = 0});
+
+            std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> r_cached, r_fresh;
+            std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> v_cached, v_fresh;
+            au::QuantityU64<au::Milli<au::Seconds>> t_cached, t_fresh;
+
+            SGP4 fresh(&hrtc, tle);
+            REQUIRE(cached.predict_teme(r_cached, v_cached, t_cached));
+            REQUIRE(fresh.predict_teme(r_fresh, v_fresh, t_fresh));
+
+            CHECK(t_cached == t_fresh);
+            for (size_t i = 0; i < 3; ++i)
+            {
+                CHECK(r_cached[i].in(au::kilo(au::metersInTemeFrame)) == doctest::Approx(r_fresh[i].in(au::kilo(au::metersInTemeFrame))).epsilon(1e-5));
+                CHECK(v_cached[i].in(au::kilo(au::metersPerSecondInTemeFrame)) == doctest::Approx(v_fresh[i].in(au::kilo(au::metersPerSecondInTemeFrame))).epsilon(1e-5));
+            }
+        }
+    }
+
+    // a new TLE replaces the cached model
+    SGP4 sgp4(&hrtc, tles[0]);
+    set_rtc(hrtc, TimeUtils::DateTimeComponents{.year = 2025, .month = 6, .day = 27, .hour = 18, .minute = 0, .second = 0, .millisecond = 0});
+    std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> r;
+    std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> v;
+    au::QuantityU64<au::Milli<au::Seconds>> t;
+    REQUIRE(sgp4.predict_teme(r, v, t));
+    sgp4.setSGP4TLE(tles[1]);
+    REQUIRE(sgp4.predict_teme(r, v, t));
+    const float radius = std::sqrt(r[0].in(au::kilo(au::metersInTemeFrame)) * r[0].in(au::kilo(au::metersInTemeFrame)) +
+                                   r[1].in(au::kilo(au::metersInTemeFrame)) * r[1].in(au::kilo(au::metersInTemeFrame)) +
+                                   r[2].in(au::kilo(au::metersInTemeFrame)) * r[2].in(au::kilo(au::metersInTemeFrame)));
+    CHECK(radius == doctest::Approx(42164.0f).epsilon(0.01));
+}
+
+TEST_CASE("SGP4 prediction cost with and without the cached model")
+{
+    RTC_HandleTypeDef hrtc;
+    hrtc.Init.SynchPrediv = 1023;
+    set_current_tick(1001);
+    set_rtc(hrtc, TimeUtils::DateTimeComponents{.year = 2025, .month = 6, .day = 27, .hour = 18, .minute = 0, .second = 0, .millisecond = 0});
+
+    const SGP4TwoLineElement tles[] = {
+        parse_tle("1 25544U 98067A   25176.73245655  .00008102  00000-0  14854-3 0  9994",
+                  "2 25544  51.6390 264.7180 0001990 278.3788 217.2311 15.50240116516482"),
+        parse_tle("1 28884U 05041A   25176.50000000 -.00000288  00000-0  00000-0 0  9995",
+                  "2 28884   0.0156 250.8312 0002459 151.6412 280.8990  1.00271024 72164")};
+
+    constexpr int N = 2000;
+    using clock = std::chrono::steady_clock;
+
+    for (const SGP4TwoLineElement &tle : tles)
+    {
+        std::array<au::QuantityF<au::Kilo<au::MetersInTemeFrame>>, 3> r;
+        std::array<au::QuantityF<au::Kilo<au::MetersPerSecondInTemeFrame>>, 3> v;
+        au::QuantityU64<au::Milli<au::Seconds>> t;
+        SGP4 sgp4(&hrtc, tle);
+
+        // before: the model was rebuilt from the TLE on every call
+        auto start = clock::now();
+        for (int i = 0; i < N; ++i)
+        {
+            sgp4.setSGP4TLE(tle);
+            sgp4.predict_teme(r, v, t);
+        }
+        const auto rebuild = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+        start = clock::now();
+        for (int i = 0; i < N; ++i)
+            sgp4.predict_teme(r, v, t);
+        const auto cached = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+        MESSAGE("SGP4 " << tle.satelliteNumber << ": " << rebuild << " ns per prediction rebuilding the model, "
+                << cached << " ns with the cached model");
+    }
+}
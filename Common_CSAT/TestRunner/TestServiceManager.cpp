@@ -5,6 +5,8 @@
 #include "RegistrationManager.hpp"
 #include <memory>
 #include <iostream> // For cout
+#include <chrono>
+#include <vector>
 #include "Task.hpp"
 #include "cyphal.hpp"
 
@@ -182,4 +184,158 @@ TEST_CASE("ServiceManager: No tasks in handler")
     manager.initializeServices(1000);
     manager.handleServices();
     // handleMessage tested with empty handler in previous test case
-}
\ No newline at end of file
+}
+// Task that subscribes itself to one port and counts the messages it receives
+class CountingTask : public Task
+{
+public:
+    CountingTask(uint32_t interval, uint32_t tick, CyphalPortID port_id) : Task(interval, tick), port_id_(port_id), count(0) {}
+    ~CountingTask() override {}
+
+    void handleMessage(std::shared_ptr<CyphalTransfer> /*transfer*/) override { ++count; }
+    void handleTaskImpl() override {}
+
+    void registerTask(RegistrationManager *manager, std::shared_ptr<Task> task) override { manager->subscribe(port_id_, task); }
+    void unregisterTask(RegistrationManager *manager, std::shared_ptr<Task> task) override { manager->unsubscribe(port_id_, task); }
+
+private:
+    CyphalPortID port_id_;
+
+public:
+    size_t count;
+};
+
+static std::shared_ptr<CyphalTransfer> makeTransfer(CyphalPortID port_id)
+{
+    auto transfer = std::make_shared<CyphalTransfer>();
+    transfer->metadata = {CyphalPriorityNominal, CyphalTransferKindMessage, port_id, CYPHAL_NODE_ID_UNSET, CYPHAL_NODE_ID_UNSET, CYPHAL_NODE_ID_UNSET, 1};
+    return transfer;
+}
+
+TEST_CASE("ServiceManager: Shares RegistrationManager Dispatch Table")
+{
+    RegistrationManager registration_manager;
+    ServiceManager manager(registration_manager);
+
+    auto task1 = std::make_shared<CountingTask>(10, 0, 100);
+    registration_manager.add(task1);
+
+    // registered after the ServiceManager was constructed
+    auto task2 = std::make_shared<CountingTask>(10, 0, 200);
+    registration_manager.add(task2);
+
+    manager.handleMessage(makeTransfer(200));
+    CHECK(task1->count == 0);
+    CHECK(task2->count == 1);
+
+    registration_manager.remove(task2);
+    manager.handleMessage(makeTransfer(200));
+    CHECK(task2->count == 1);
+
+    manager.handleMessage(makeTransfer(100));
+    CHECK(task1->count == 1);
+}
+
+TEST_CASE("ServiceManager: Follows Changes of a Bare Handler List")
+{
+    ArrayList<TaskHandler, RegistrationManager::NUM_TASK_HANDLERS> handlers;
+    auto task1 = std::make_shared<CountingTask>(100, 0, 100);
+    handlers.push(TaskHandler{100, task1});
+
+    ServiceManager manager(handlers);
+    manager.initializeServices(0);
+    CHECK(manager.nextDeadline() == 100);
+
+    // added after construction
+    auto task2 = std::make_shared<CountingTask>(40, 0, 200);
+    task2->initialize(0);
+    handlers.push(TaskHandler{200, task2});
+    manager.handleMessage(makeTransfer(200));
+    CHECK(task2->count == 1);
+    CHECK(manager.nextDeadline() == 40);
+
+    // replaced in place, same list size
+    auto task3 = std::make_shared<CountingTask>(70, 0, 300);
+    task3->initialize(0);
+    handlers[1] = TaskHandler{300, task3};
+    task2.reset();
+    manager.handleMessage(makeTransfer(200));
+    manager.handleMessage(makeTransfer(300));
+    CHECK(task3->count == 1);
+    CHECK(manager.nextDeadline() == 70);
+
+    handlers.remove(1);
+    CHECK(manager.nextDeadline() == 100);
+}
+
+TEST_CASE("ServiceManager: Dispatch Benchmark 32 Handlers")
+{
+    constexpr size_t NUM_HANDLERS = RegistrationManager::NUM_TASK_HANDLERS;
+    constexpr size_t NUM_MESSAGES = 100000;
+
+    RegistrationManager registration_manager;
+    std::vector<std::shared_ptr<CountingTask>> tasks;
+    for (size_t i = 0; i < NUM_HANDLERS; ++i)
+    {
+        auto task = std::make_shared<CountingTask>(10, 0, static_cast<CyphalPortID>(100 + 7 * i));
+        registration_manager.add(task);
+        tasks.push_back(task);
+    }
+    REQUIRE(registration_manager.getHandlers().size() == NUM_HANDLERS);
+    ServiceManager manager(registration_manager);
+
+    std::vector<std::shared_ptr<CyphalTransfer>> transfers;
+    for (size_t i = 0; i < NUM_HANDLERS; ++i)
+        transfers.push_back(makeTransfer(static_cast<CyphalPortID>(100 + 7 * i)));
+
+    // the former dispatch: linear scan copying every TaskHandler
+    const auto &handlers = registration_manager.getHandlers();
+    auto linear_dispatch = [&](std::shared_ptr<CyphalTransfer> transfer)
+    {
+        for (auto handler : handlers)
+        {
+            if (handler.port_id == transfer->metadata.port_id)
+                handler.task->handleMessage(transfer);
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < NUM_MESSAGES; ++n)
+        linear_dispatch(transfers[n % NUM_HANDLERS]);
+    auto linear_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < NUM_MESSAGES; ++n)
+        manager.handleMessage(transfers[n % NUM_HANDLERS]);
+    auto indexed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // both paths deliver every message to exactly one task
+    for (const auto &task : tasks)
+        CHECK(task->count == 2 * NUM_MESSAGES / NUM_HANDLERS);
+
+    MESSAGE("dispatch per message: linear " << static_cast<double>(linear_ns) / NUM_MESSAGES
+            << " ns, indexed " << static_cast<double>(indexed_ns) / NUM_MESSAGES << " ns");
+}
+
+TEST_CASE("ServiceManager: Schedules Registered Tasks by Deadline")
+{
+    RegistrationManager registration_manager;
+    ServiceManager manager(registration_manager);
+
+    auto task1 = std::make_shared<CountingTask>(100, 0, 100);
+    registration_manager.add(task1);
+    manager.initializeServices(0);
+    CHECK(manager.nextDeadline() == 100);
+
+    // registered after initialization, picked up on the next call
+    auto task2 = std::make_shared<CountingTask>(40, 0, 200);
+    registration_manager.add(task2);
+    CHECK(manager.nextDeadline() == 40);
+
+    HAL_SetTick(40);
+    manager.handleServices();
+    CHECK(manager.nextDeadline() == 80);
+
+    registration_manager.remove(task2);
+    CHECK(manager.nextDeadline() == 100);
+}
@@ -90,6 +90,7 @@ struct MockImageBuffer
     int push_image_calls     = 0;   // how many frames successfully stored
     int add_chunk_calls      = 0;   // how many chunks were written
     size_t total_chunk_bytes = 0;   // total bytes written
+    ImageMetadata last_meta{};      // metadata of the latest add_image()
 
     // ------------------------------------------------------------
     // Reset between tests
@@ -133,9 +134,10 @@ struct MockImageBuffer
     // ------------------------------------------------------------
     // Producer API
     // ------------------------------------------------------------
-    ImageBufferError add_image(const ImageMetadata&)
+    ImageBufferError add_image(const ImageMetadata& meta)
     {
         ++add_image_calls;
+        last_meta = meta;
         return ImageBufferError::NO_ERROR;
     }
 
@@ -318,3 +320,123 @@ CHECK(imgBuf->add_image_calls > 1);   // multiple acquisition events happened
 CHECK(mlx->readSubpage_calls >= 2 * imgBuf->add_image_calls);
 CHECK(imgBuf->push_image_calls == 5);
 }
+
+// -----------------------------------------------------------------------------
+// Subpage sink recording what it was handed
+// -----------------------------------------------------------------------------
+struct MockSubpageSink
+{
+    int calls = 0;
+    int last_sp = -1;
+    int sp_changes = 0;
+
+    bool processSubpage(uint16_t* buf, int sp)
+    {
+        CHECK(buf[0] == 0xABCD);
+        if (last_sp >= 0 && sp != last_sp)
+            sp_changes++;
+        last_sp = sp;
+        calls++;
+        return true;
+    }
+};
+
+using SinkTask = TaskMLX90640<MockPower, MockMLX, MockImageBuffer, OnceTrigger, MockSubpageSink>;
+
+TEST_CASE("TaskMLX90640 hands every subpage to the sink as soon as it is read")
+{
+    HAL_SetTick(0);
+
+    RegistrationManager mgr;
+    MockPower pwr;
+    MockMLX mlx;
+    MockImageBuffer imgBuf;
+    OnceTrigger trig;
+
+    auto task = std::make_shared<SinkTask>(pwr, CIRCUITS::CIRCUIT_0, mlx, imgBuf, trig,
+                                           MLXMode::Burst, 3, 0, 0, 0);
+    mgr.add(task);
+
+    int sinkCallsAtFirstRead = -1;
+    for (int i = 0; i < 5000; i++) {
+        advance_time_ms(1);
+        task->handleTask();
+        if (sinkCallsAtFirstRead < 0 && mlx.readSubpage_calls == 1)
+            sinkCallsAtFirstRead = task->subpageSink().calls;
+    }
+
+    // processed on the same tick as the read, not when the frame completes
+    CHECK(sinkCallsAtFirstRead == 1);
+    CHECK(task->subpageSink().calls == mlx.readSubpage_calls);
+    CHECK(task->subpageSink().sp_changes == mlx.readSubpage_calls - 1);
+    CHECK(imgBuf.push_image_calls == 3);
+}
+
+TEST_CASE("TaskMLX90640 Continuous mode publishes a rolling frame after every subpage")
+{
+    RegistrationManager mgr;
+    MockPower pwr;
+    MockImageBuffer imgBuf;
+
+    auto run = [&](bool rolling, MockMLX &mlx) {
+        HAL_SetTick(0);
+        imgBuf.reset();
+        OnceTrigger trig;
+        auto task = std::make_shared<SinkTask>(pwr, CIRCUITS::CIRCUIT_0, mlx, imgBuf, trig,
+                                               MLXMode::Continuous, 1, 0, 0, 0);
+        task->setRollingFrames(rolling);
+        CHECK(task->getRollingFrames() == rolling);
+        mgr.add(task);
+        for (int i = 0; i < 5000; i++) {
+            advance_time_ms(1);
+            task->handleTask();
+        }
+        CHECK(task->subpageSink().calls == mlx.readSubpage_calls);
+        mgr.remove(task);
+    };
+
+    MockMLX pairs;
+    run(false, pairs);
+    const int pairFrames = imgBuf.push_image_calls;
+    CHECK(pairFrames == pairs.readSubpage_calls / 2);
+
+    MockMLX rolling;
+    run(true, rolling);
+    const int rollingFrames = imgBuf.push_image_calls;
+    // one frame per subpage once the first pair is in
+    CHECK(rollingFrames == rolling.readSubpage_calls - 1);
+    CHECK(rollingFrames >= 2 * pairFrames - 1);
+
+    HAL_SetTick(0);
+}
+
+TEST_CASE("TaskMLX90640 stores compressed frames with matching metadata")
+{
+    for (MLXCompression compression : {MLXCompression::Lossless, MLXCompression::Quantized})
+    {
+        HAL_SetTick(0);
+
+        RegistrationManager mgr;
+        MockPower pwr;
+        MockMLX mlx;
+        MockImageBuffer imgBuf;
+        OnceTrigger trig;
+
+        auto task = std::make_shared<TaskMLX90640<MockPower, MockMLX, MockImageBuffer, OnceTrigger>>(
+            pwr, CIRCUITS::CIRCUIT_0, mlx, imgBuf, trig, MLXMode::Burst, 2, 0, 0, 0);
+        task->setCompression(compression);
+        CHECK(task->getCompression() == compression);
+        mgr.add(task);
+
+        for (int i = 0; i < 5000; i++) {
+            advance_time_ms(1);
+            task->handleTask();
+        }
+
+        // without temperatures from the sink Quantized falls back to lossless
+        CHECK(imgBuf.push_image_calls == 2);
+        CHECK(imgBuf.last_meta.format == METADATA_FORMAT::MLXD);
+        CHECK(imgBuf.last_meta.payload_size < MLX90640_FRAME_SIZE);
+        CHECK(imgBuf.total_chunk_bytes == 2 * imgBuf.last_meta.payload_size);
+    }
+}
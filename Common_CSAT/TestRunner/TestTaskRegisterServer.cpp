@@ -152,4 +152,55 @@ TEST_CASE("TaskRegisterServer Tests")
     }
 
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("TaskRegisterServer flushes a write-back store when idle")
+{
+    constexpr CyphalNodeID id = 11;
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    loopard_cyphal.setNodeID(id);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    BlobStoreDirectory store {{'H', 'e', 'l', 'l', 'o', 'W', 'o', 'r', 'l', 'd'}, {'1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c'}};
+    constexpr size_t flash_size = sizeof(BlobStoreDirectory);
+    uint8_t *memory = reinterpret_cast<uint8_t*>(&store);
+
+    using Cache = CachedBlobStoreAccess<SPIBlobStoreAccess, flash_size, 8>;
+    Cache::Shadow shadow;
+    Cache cache(SPIBlobStoreAccess(flash_size, memory), shadow);
+    REQUIRE(cache.isValid());
+
+    NamedBlobStore<Cache, BlobStoreDirectory, BlobMemberInfo, blob_map.size()> named_store(cache, blob_map);
+    TaskRegisterServer<Cache, BlobStoreDirectory, blob_map.size(), Cyphal<LoopardAdapter>>
+        task_register_server(named_store, cache, 100, 0, adapters);
+
+    uint8_t payload[uavcan_register_Access_Request_1_0_EXTENT_BYTES_];
+    size_t payload_size{sizeof(payload)};
+    uavcan_register_Access_Request_1_0 access_request{
+        .name = {.name = {.elements = "blob2", .count = 5}},
+        .value = {.unstructured = {.value = {.elements = {}, .count = 12}}, ._tag_ = UAVCAN_PRIMITIVE_UNSTRUCTURED_1_0}};
+    memcpy(access_request.value.unstructured.value.elements, "AaBbCcDdEeFf", 12);
+
+    std::shared_ptr<CyphalTransfer> request = std::make_shared<CyphalTransfer>(createTransfer(payload_size, payload, &access_request,
+                                                                                              reinterpret_cast<int8_t (*)(const void *const, uint8_t *const, size_t *const)>(uavcan_register_Access_Request_1_0_serialize_),
+                                                                                              uavcan_register_Access_1_0_FIXED_PORT_ID_, CyphalTransferKindRequest, static_cast<CyphalNodeID>(11)));
+    task_register_server.handleMessage(request);
+    task_register_server.handleTaskImpl();
+    REQUIRE(loopard.buffer.size() == 1);
+
+    // the response already carries the new value, the memory is written on the next idle tick
+    CyphalTransfer response = loopard.buffer.pop();
+    uavcan_register_Access_Response_1_0 access_response;
+    unpackTransfer(&response, reinterpret_cast<int8_t (*)(uint8_t *, const uint8_t *, size_t *)>(uavcan_register_Access_Response_1_0_deserialize_), reinterpret_cast<uint8_t *>(&access_response));
+    CHECK(access_response.value.unstructured.value.count == sizeof(BlobStoreDirectory::blob2));
+    CHECK_FALSE(strncmp(reinterpret_cast<const char*>(access_response.value.unstructured.value.elements), "AaBbCcDdEeFf", 12));
+    CHECK(store.blob2[0] == '1');
+    CHECK(cache.dirtyBlocks() > 0);
+
+    task_register_server.handleTaskImpl();
+    CHECK(cache.dirtyBlocks() == 0);
+    CHECK_FALSE(strncmp(reinterpret_cast<const char*>(store.blob2), "AaBbCcDdEeFf", 12));
+}
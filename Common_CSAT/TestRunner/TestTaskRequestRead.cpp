@@ -8,6 +8,8 @@
 #include <cstring> // For std::memcpy
 #include <iostream>
 #include <numeric>
+#include <map>
+#include <deque>
 
 #include "TaskRequestRead.hpp" // Client
 #include "TaskRespondRead.hpp" // Server
@@ -580,3 +582,164 @@ TEST_CASE("TaskRespondRead: Registers and Unregisters correctly")
 
     CHECK(reg.getServers().size() == 0);
 }
+
+struct ReadTransferResult
+{
+    uint32_t ticks;
+    size_t requests;
+    size_t max_outstanding;
+};
+
+// Serves the file with TaskRespondRead. Responses reach the client after a
+// latency that varies with the offset, so with several requests in flight
+// they arrive out of order. drop_offset loses the first request for that
+// offset once.
+static ReadTransferResult runReadTransfer(size_t read_ahead, size_t file_size, uint32_t latency, uint32_t jitter,
+                                          size_t drop_offset = SIZE_MAX)
+{
+    LocalHeap::initialize();
+    HAL_SetTick(0);
+
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    loopard_cyphal.setNodeID(11);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    std::vector<uint8_t> pattern(251);
+    std::iota(pattern.begin(), pattern.end(), 0);
+    MockAccessor accessor(file_size, pattern);
+    MockFileSource file_source("", "remote.txt");
+    MockOutputStream output_stream;
+
+    TaskRequestRead request(file_source, output_stream, 1, 1, 0, 11, 7, adapters);
+    TaskRespondRead respond(accessor, 1, 0, adapters);
+    REQUIRE(request.set_read_ahead(read_ahead));
+
+    std::multimap<uint32_t, std::shared_ptr<CyphalTransfer>> in_transit;
+    std::deque<uint32_t> due;
+    ReadTransferResult result{0, 0, 0};
+
+    for (uint32_t now = 1; now < 100000; ++now)
+    {
+        HAL_SetTick(now);
+        while (!in_transit.empty() && in_transit.begin()->first <= now)
+        {
+            request.handleMessage(in_transit.begin()->second);
+            in_transit.erase(in_transit.begin());
+        }
+
+        request.handleTaskImpl();
+        if (output_stream.isFinalized())
+        {
+            result.ticks = now;
+            break;
+        }
+
+        while (!loopard.buffer.is_empty())
+        {
+            auto transfer = std::make_shared<CyphalTransfer>(loopard.buffer.pop());
+            if (transfer->metadata.transfer_kind == CyphalTransferKindRequest)
+            {
+                uavcan_file_Read_Request_1_1 request_data{};
+                size_t payload_size = transfer->payload_size;
+                REQUIRE(uavcan_file_Read_Request_1_1_deserialize_(&request_data, static_cast<const uint8_t *>(transfer->payload), &payload_size) >= 0);
+                ++result.requests;
+
+                if (request_data.offset == drop_offset)
+                {
+                    drop_offset = SIZE_MAX;
+                    continue;
+                }
+
+                due.push_back(now + latency + static_cast<uint32_t>((request_data.offset / 256) % 3) * jitter);
+                respond.handleMessage(transfer);
+                respond.handleTaskImpl();
+            }
+            else
+            {
+                in_transit.emplace(due.front(), transfer);
+                due.pop_front();
+            }
+        }
+        result.max_outstanding = std::max(result.max_outstanding, in_transit.size());
+    }
+
+    REQUIRE(result.ticks != 0);
+    const auto &received = output_stream.getReceivedData();
+    REQUIRE(received.size() == file_size);
+    for (size_t i = 0; i < file_size; ++i)
+    {
+        if (received[i] != pattern[i % pattern.size()])
+        {
+            FAIL("data mismatch at offset " << i);
+            break;
+        }
+    }
+
+    HAL_SetTick(0);
+    return result;
+}
+
+TEST_CASE("TaskRequestRead - read-ahead keeps several requests in flight")
+{
+    auto result = runReadTransfer(8, 4096, 10, 0);
+    CHECK(result.max_outstanding == 8);
+    // 16 full chunks and the empty one that ends the file
+    CHECK(result.requests >= 17);
+}
+
+TEST_CASE("TaskRequestRead - read-ahead reassembles out of order responses")
+{
+    auto result = runReadTransfer(8, 3000, 10, 7);
+    CHECK(result.max_outstanding > 1);
+}
+
+TEST_CASE("TaskRequestRead - read-ahead retries a lost request without restarting the file")
+{
+    auto result = runReadTransfer(4, 3000, 10, 3, 5 * 256);
+    // one resend on top of the twelve chunks the file needs
+    CHECK(result.requests <= 12 + 4 + 1);
+}
+
+TEST_CASE("TaskRequestRead - read-ahead handles a zero-length file")
+{
+    runReadTransfer(8, 0, 10, 0);
+}
+
+TEST_CASE("TaskRequestRead - set_read_ahead is refused during a transfer")
+{
+    LocalHeap::initialize();
+
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    loopard_cyphal.setNodeID(11);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    MockFileSource file_source("hello");
+    MockOutputStream output_stream;
+    TaskRequestRead request(file_source, output_stream, 1000, 100, 0, 11, 7, adapters);
+
+    CHECK(request.set_read_ahead(4));
+    request.handleTaskImpl();
+    CHECK(loopard.buffer.size() == 4);
+    CHECK_FALSE(request.set_read_ahead(1));
+    CHECK(request.read_ahead() == 4);
+}
+
+TEST_CASE("TaskRequestRead - transfer time with and without read-ahead")
+{
+    constexpr size_t FILE_SIZE = 16 * 1024;
+    constexpr uint32_t LATENCY = 20; // ticks (ms) per round trip
+
+    auto single = runReadTransfer(1, FILE_SIZE, LATENCY, 0);
+    auto read_ahead = runReadTransfer(8, FILE_SIZE, LATENCY, 0);
+
+    MESSAGE("read-ahead 1: " << single.ticks << " ms, " << 1000.0 * FILE_SIZE / single.ticks << " bytes/s");
+    MESSAGE("read-ahead 8: " << read_ahead.ticks << " ms, " << 1000.0 * FILE_SIZE / read_ahead.ticks << " bytes/s");
+
+    CHECK(read_ahead.ticks * 6 < single.ticks);
+}
@@ -7,6 +7,7 @@
 #include <array>
 #include <cstring> // For std::memcpy
 #include <iostream>
+#include <deque>
 
 #include "TaskRequestWrite.hpp" // Include the header for the class being tested
 #include "Task.hpp"             // Include necessary headers
@@ -212,6 +213,7 @@ public:
 
     using TaskRequestWrite<ImageInputStream, Adapters...>::handleTaskImpl;
     using TaskRequestWrite<ImageInputStream, Adapters...>::buffer_;
+    using TaskRequestWrite<ImageInputStream, Adapters...>::write_state_;
 };
 
 uavcan_file_Write_Response_1_1 unpackResponse(std::shared_ptr<CyphalTransfer> transfer)
@@ -575,4 +577,203 @@ TEST_CASE("TaskRequestWrite: Registers and Unregisters correctly")
     // Unregister the task
     task->unregisterTask(&registration_manager, task);
     CHECK(registration_manager.getClients().size() == 0);
-}
\ No newline at end of file
+}
+// Answers like a standard uavcan.file.Write server: every request is written
+// at its own offset and answered after a fixed latency. drop_offset loses the
+// first request for that offset once.
+struct SimulatedWriteServer
+{
+    CyphalNodeID client_node_id = 0;
+    CyphalNodeID server_node_id = 0;
+    uint32_t latency = 0;
+    size_t drop_offset = SIZE_MAX;
+
+    std::vector<uint8_t> file;
+    std::deque<std::pair<uint32_t, std::shared_ptr<CyphalTransfer>>> pending;
+    size_t requests = 0;
+    size_t max_outstanding = 0;
+    bool done = false;
+
+    void receive(LoopardAdapter &loopard, uint32_t now)
+    {
+        while (!loopard.buffer.is_empty())
+        {
+            CyphalTransfer transfer = loopard.buffer.pop();
+            uavcan_file_Write_Request_1_1 request = unpackRequest(transfer);
+            free(transfer.payload);
+            ++requests;
+
+            if (request.offset == drop_offset)
+            {
+                drop_offset = SIZE_MAX;
+                continue;
+            }
+
+            if (request.data.value.count == 0)
+            {
+                done = true;
+            }
+            else
+            {
+                const size_t end = request.offset + request.data.value.count;
+                if (file.size() < end)
+                    file.resize(end);
+                std::memcpy(file.data() + request.offset, request.data.value.elements, request.data.value.count);
+            }
+
+            pending.emplace_back(now + latency,
+                                 createWriteResponse(uavcan_file_Error_1_0_OK, transfer.metadata.transfer_id, client_node_id, server_node_id));
+        }
+        max_outstanding = std::max(max_outstanding, pending.size());
+    }
+
+    template <typename Task>
+    void deliver(Task &task, uint32_t now)
+    {
+        while (!pending.empty() && pending.front().first <= now)
+        {
+            task.handleMessage(pending.front().second);
+            pending.pop_front();
+        }
+    }
+};
+
+constexpr size_t FULL_WINDOW = TaskRequestWrite<MockImageInputStream<MockBuffer>, Cyphal<LoopardAdapter>>::MAX_WINDOW;
+
+struct WindowedTransferResult
+{
+    uint32_t ticks;
+    size_t requests;
+    size_t max_outstanding;
+    size_t window;
+};
+
+static WindowedTransferResult runWindowedTransfer(size_t window, size_t image_size, uint32_t latency, size_t drop_offset = SIZE_MAX)
+{
+    LocalHeap::initialize();
+    HAL_SetTick(0);
+
+    CyphalNodeID client_node_id = 11;
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    loopard_cyphal.setNodeID(client_node_id);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    MockBuffer mock_buffer;
+    MockImageInputStream<MockBuffer> mock_stream(mock_buffer, 256);
+
+    CyphalNodeID server_node_id = 42;
+    MockTaskRequestWrite task(mock_stream, 1, 1, 0, server_node_id, 7, adapters);
+    REQUIRE(task.set_window(window));
+
+    std::vector<uint8_t> image(image_size);
+    for (size_t i = 0; i < image.size(); ++i)
+        image[i] = static_cast<uint8_t>(i * 7 + 3);
+
+    ImageMetadata metadata{};
+    metadata.producer = METADATA_PRODUCER::CAMERA_1;
+    metadata.timestamp = 0x1234;
+    metadata.payload_size = static_cast<uint32_t>(image.size());
+    REQUIRE(mock_buffer.add_image(metadata) == ImageBufferError::NO_ERROR);
+    REQUIRE(mock_buffer.add_data_chunk(image.data(), image.size()) == ImageBufferError::NO_ERROR);
+    REQUIRE(mock_buffer.push_image() == ImageBufferError::NO_ERROR);
+
+    SimulatedWriteServer server;
+    server.client_node_id = client_node_id;
+    server.server_node_id = server_node_id;
+    server.latency = latency;
+    server.drop_offset = drop_offset;
+
+    WindowedTransferResult result{0, 0, 0, 0};
+    for (uint32_t now = 1; now < 100000; ++now)
+    {
+        HAL_SetTick(now);
+        server.deliver(task, now);
+        task.handleTaskImpl();
+        server.receive(loopard, now);
+
+        if (server.done && task.write_state_.state == decltype(task)::IDLE)
+        {
+            result.ticks = now;
+            break;
+        }
+    }
+
+    REQUIRE(result.ticks != 0);
+    REQUIRE(server.file.size() == sizeof(ImageMetadata) + image.size());
+    CHECK(std::memcmp(server.file.data() + sizeof(ImageMetadata), image.data(), image.size()) == 0);
+
+    result.requests = server.requests;
+    result.max_outstanding = server.max_outstanding;
+    result.window = task.window();
+    HAL_SetTick(0);
+    return result;
+}
+
+TEST_CASE("TaskRequestWrite: window of 1 keeps a single chunk in flight")
+{
+    auto result = runWindowedTransfer(1, 4096, 10);
+    CHECK(result.max_outstanding == 1);
+    CHECK(result.requests == 1 + 16 + 1);
+}
+
+TEST_CASE("TaskRequestWrite: windowed transfer keeps several chunks in flight")
+{
+    auto result = runWindowedTransfer(FULL_WINDOW, 4096, 10);
+    CHECK(result.max_outstanding == FULL_WINDOW);
+    CHECK(result.requests == 1 + 16 + 1);
+    CHECK(result.window == FULL_WINDOW);
+}
+
+TEST_CASE("TaskRequestWrite: windowed transfer retransmits a lost chunk after its timeout")
+{
+    auto result = runWindowedTransfer(FULL_WINDOW, 4096, 10, sizeof(ImageMetadata) + 3 * 256);
+    CHECK(result.requests == 1 + 16 + 1 + 1);
+    CHECK(result.window < FULL_WINDOW);
+}
+
+TEST_CASE("TaskRequestWrite: set_window is refused during a transfer")
+{
+    LocalHeap::initialize();
+
+    LoopardAdapter loopard;
+    loopard.memory_allocate = loopardMemoryAllocate;
+    loopard.memory_free = loopardMemoryFree;
+    Cyphal<LoopardAdapter> loopard_cyphal(&loopard);
+    std::tuple<Cyphal<LoopardAdapter>> adapters(loopard_cyphal);
+
+    MockBuffer mock_buffer;
+    MockImageInputStream<MockBuffer> mock_stream(mock_buffer, 16);
+    MockTaskRequestWrite task(mock_stream, 1000, 1000, 0, 42, 7, adapters);
+
+    uint8_t byte = 1;
+    ImageMetadata metadata{};
+    metadata.payload_size = 1;
+    REQUIRE(mock_buffer.add_image(metadata) == ImageBufferError::NO_ERROR);
+    REQUIRE(mock_buffer.add_data_chunk(&byte, 1) == ImageBufferError::NO_ERROR);
+    REQUIRE(mock_buffer.push_image() == ImageBufferError::NO_ERROR);
+
+    CHECK(task.set_window(4));
+    task.handleTaskImpl();
+    CHECK_FALSE(task.set_window(2));
+    CHECK(task.window() == 4);
+    free(loopard.buffer.pop().payload);
+}
+
+TEST_CASE("TaskRequestWrite: throughput with window 1 and the full window")
+{
+    constexpr size_t IMAGE_SIZE = 32 * 1024;
+    constexpr uint32_t LATENCY = 20; // ticks (ms) per round trip
+
+    auto stop_and_wait = runWindowedTransfer(1, IMAGE_SIZE, LATENCY);
+    auto windowed = runWindowedTransfer(FULL_WINDOW, IMAGE_SIZE, LATENCY);
+
+    const double bps_1 = 1000.0 * IMAGE_SIZE / stop_and_wait.ticks;
+    const double bps_n = 1000.0 * IMAGE_SIZE / windowed.ticks;
+    MESSAGE("window 1: " << stop_and_wait.ticks << " ms, " << bps_1 << " bytes/s");
+    MESSAGE("window " << FULL_WINDOW << ": " << windowed.ticks << " ms, " << bps_n << " bytes/s");
+
+    CHECK(bps_n > 4.0 * bps_1);
+}
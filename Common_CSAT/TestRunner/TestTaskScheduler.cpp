@@ -0,0 +1,196 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "TaskScheduler.hpp"
+#include "ArrayList.hpp"
+#include "Task.hpp"
+#include "cyphal.hpp"
+#include "mock_hal.h"
+
+#include <memory>
+#include <vector>
+
+class RegistrationManager;
+
+// Task that records the order it ran in and can change its own pacing
+class OrderedTask : public Task
+{
+public:
+    OrderedTask(uint32_t interval, uint32_t tick, int id, std::vector<int> &log)
+        : Task(interval, tick), id_(id), log_(log), next_interval_(0), runs(0) {}
+    ~OrderedTask() override {}
+
+    void handleTaskImpl() override
+    {
+        log_.push_back(id_);
+        ++runs;
+        if (next_interval_ != 0)
+            setInterval(next_interval_);
+    }
+
+    void registerTask(RegistrationManager * /*manager*/, std::shared_ptr<Task> /*task*/) override {}
+    void unregisterTask(RegistrationManager * /*manager*/, std::shared_ptr<Task> /*task*/) override {}
+
+    void changeIntervalOnRun(uint32_t interval) { next_interval_ = interval; }
+
+private:
+    int id_;
+    std::vector<int> &log_;
+    uint32_t next_interval_;
+
+public:
+    int runs;
+};
+
+constexpr size_t CAPACITY = 8;
+using Handlers = ArrayList<TaskHandler, CAPACITY>;
+
+TEST_CASE("TaskScheduler: empty scheduler has no deadline")
+{
+    Handlers handlers;
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+    CHECK(scheduler.size() == 0);
+    CHECK(scheduler.nextDeadline() == TaskScheduler<CAPACITY>::NO_DEADLINE);
+    scheduler.runDue(1000);
+}
+
+TEST_CASE("TaskScheduler: runs only due tasks in deadline order")
+{
+    std::vector<int> log;
+    auto task1 = std::make_shared<OrderedTask>(300, 0, 1, log);
+    auto task2 = std::make_shared<OrderedTask>(100, 0, 2, log);
+    auto task3 = std::make_shared<OrderedTask>(200, 0, 3, log);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task1});
+    handlers.push(TaskHandler{20, task2});
+    handlers.push(TaskHandler{30, task3});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+    CHECK(scheduler.size() == 3);
+    CHECK(scheduler.nextDeadline() == 100);
+
+    HAL_SetTick(50);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(log.empty());
+
+    HAL_SetTick(250);
+    scheduler.runDue(HAL_GetTick());
+    REQUIRE(log.size() == 2);
+    CHECK(log[0] == 2);
+    CHECK(log[1] == 3);
+    CHECK(task1->runs == 0);
+
+    // task2 ran at 250 with interval 100
+    CHECK(scheduler.nextDeadline() == 300);
+
+    HAL_SetTick(300);
+    log.clear();
+    scheduler.runDue(HAL_GetTick());
+    REQUIRE(log.size() == 1);
+    CHECK(log[0] == 1);
+    CHECK(scheduler.nextDeadline() == 350);
+}
+
+TEST_CASE("TaskScheduler: task on several ports is scheduled once")
+{
+    std::vector<int> log;
+    auto task = std::make_shared<OrderedTask>(100, 0, 1, log);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task});
+    handlers.push(TaskHandler{20, task});
+    handlers.push(TaskHandler{30, task});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+    CHECK(scheduler.size() == 1);
+
+    HAL_SetTick(100);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 1);
+}
+
+TEST_CASE("TaskScheduler: picks up interval changed by the task itself")
+{
+    std::vector<int> log;
+    auto task = std::make_shared<OrderedTask>(100, 0, 1, log);
+    task->changeIntervalOnRun(1000);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+
+    HAL_SetTick(100);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 1);
+    CHECK(scheduler.nextDeadline() == 1100);
+
+    HAL_SetTick(200);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 1);
+}
+
+TEST_CASE("TaskScheduler: deadline moved later is requeued without running")
+{
+    std::vector<int> log;
+    auto task = std::make_shared<OrderedTask>(100, 0, 1, log);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+
+    task->setInterval(500);
+    HAL_SetTick(100);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 0);
+    CHECK(scheduler.nextDeadline() == 500);
+}
+
+TEST_CASE("TaskScheduler: reschedule moves a deadline earlier")
+{
+    std::vector<int> log;
+    auto task1 = std::make_shared<OrderedTask>(500, 0, 1, log);
+    auto task2 = std::make_shared<OrderedTask>(300, 0, 2, log);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task1});
+    handlers.push(TaskHandler{20, task2});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+    CHECK(scheduler.nextDeadline() == 300);
+
+    task1->setInterval(50);
+    scheduler.reschedule(task1.get());
+    CHECK(scheduler.nextDeadline() == 50);
+
+    HAL_SetTick(50);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task1->runs == 1);
+    CHECK(task2->runs == 0);
+}
+
+TEST_CASE("TaskScheduler: zero interval task runs once per call")
+{
+    std::vector<int> log;
+    auto task = std::make_shared<OrderedTask>(0, 0, 1, log);
+
+    Handlers handlers;
+    handlers.push(TaskHandler{10, task});
+
+    TaskScheduler<CAPACITY> scheduler;
+    scheduler.rebuild(handlers);
+
+    HAL_SetTick(10);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 1);
+    scheduler.runDue(HAL_GetTick());
+    CHECK(task->runs == 2);
+}
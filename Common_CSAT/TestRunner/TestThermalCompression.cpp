@@ -0,0 +1,279 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "ThermalCompression.hpp"
+#include "ThermalDecoder.hpp"
+#include "MLX90640ImageProcessor.hpp"
+#include "MLX90640Calibration.hpp"
+#include "ImageBuffer.hpp"
+#include "imagebuffer/configurable_memory_accessor.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using Frame = std::array<uint16_t, 2 * MLX90640ImageProcessor::FRAME_WORDS>;
+
+// -----------------------------------------------------------------------------
+// Frames as the sensor delivers them: per-pixel offsets of the flight EEPROM,
+// a scene on top (gradient, warm blob) and a few counts of noise. Both
+// subpages carry the whole RAM, so the pixels of the other subpage are a
+// slightly older reading of the same scene.
+// -----------------------------------------------------------------------------
+static Frame build_frame(uint32_t seed, int blob_col, int blob_row, int blob_counts, bool chess = true)
+{
+    const auto &P = MLX90640_CAL;
+    Frame frame{};
+    uint32_t lcg = seed * 2654435761U + 1;
+    auto noise = [&lcg]() {
+        lcg = lcg * 1664525U + 1013904223U;
+        return int((lcg >> 24) % 7) - 3;
+    };
+
+    for (size_t sub = 0; sub < 2; ++sub)
+    {
+        uint16_t *words = frame.data() + sub * MLX90640ImageProcessor::FRAME_WORDS;
+        for (int p = 0; p < MLX90640ImageProcessor::PIXELS; ++p)
+        {
+            const int row = p / 32;
+            const int col = p % 32;
+            const int dr = row - blob_row;
+            const int dc = col - blob_col;
+            const int blob = (dr * dr + dc * dc) < 16 ? blob_counts : 0;
+            const int scene = 40 + row + col / 2 + blob;
+            words[p] = uint16_t(P.offset[p] + scene + noise());
+        }
+
+        words[768] = uint16_t(19000 + noise());
+        words[776] = uint16_t(P.cpOffset[0] + 3);
+        words[778] = uint16_t(P.gainEE + noise());
+        words[800] = uint16_t(1600 + noise());
+        words[808] = uint16_t(P.cpOffset[1] + 3);
+        words[810] = uint16_t(P.vdd25 + noise());
+        words[832] = uint16_t((chess ? 0x1000u : 0u) | unsigned(P.resolutionEE << 10));
+        words[833] = uint16_t(sub);
+    }
+    return frame;
+}
+
+// Collects the stream, remembering the largest chunk it was handed
+struct VectorSink
+{
+    std::vector<uint8_t> bytes;
+    size_t largest_chunk = 0;
+    size_t chunks = 0;
+    size_t fail_after = SIZE_MAX;
+
+    ImageBufferError add_data_chunk(const uint8_t *data, size_t size)
+    {
+        if (chunks++ >= fail_after)
+            return ImageBufferError::WRITE_ERROR;
+        bytes.insert(bytes.end(), data, data + size);
+        largest_chunk = std::max(largest_chunk, size);
+        return ImageBufferError::NO_ERROR;
+    }
+};
+
+TEST_CASE("ThermalCompression: lossless frames decode to the same pixels and aux words")
+{
+    MLX90640ImageProcessor proc;
+
+    for (uint32_t seed = 0; seed < 8; ++seed)
+    {
+        CAPTURE(seed);
+        const Frame frame = build_frame(seed, int(seed * 3 % 32), int(seed * 5 % 24), 200 + int(seed) * 50);
+
+        VectorSink sink;
+        REQUIRE(ThermalEncoder<>::encodeFrame(frame.data(), sink) == ImageBufferError::NO_ERROR);
+        CHECK(sink.bytes.size() == ThermalEncoder<>::frameSize(frame.data()));
+
+        Frame decoded{};
+        REQUIRE(ThermalDecoder::decodeFrame(sink.bytes.data(), sink.bytes.size(), decoded.data()));
+
+        MLX90640ImageProcessor::RawImage original{}, roundTrip{};
+        proc.demultiplexFrame(frame.data(), original);
+        proc.demultiplexFrame(decoded.data(), roundTrip);
+        CHECK(original == roundTrip);
+
+        for (size_t w = 768; w < 834; ++w)
+        {
+            CAPTURE(w);
+            CHECK(decoded[w] == frame[w]);
+            CHECK(decoded[834 + w] == frame[834 + w]);
+        }
+    }
+}
+
+TEST_CASE("ThermalCompression: lossless frames keep the pixels of the interleaved pattern")
+{
+    const Frame frame = build_frame(3, 10, 12, 400, false);
+
+    VectorSink sink;
+    REQUIRE(ThermalEncoder<>::encodeFrame(frame.data(), sink) == ImageBufferError::NO_ERROR);
+
+    Frame decoded{};
+    REQUIRE(ThermalDecoder::decodeFrame(sink.bytes.data(), sink.bytes.size(), decoded.data()));
+    CHECK_FALSE(thermal::chessMode(decoded.data()));
+
+    // even rows are measured in subpage 0, odd rows in subpage 1
+    for (int p = 0; p < MLX90640ImageProcessor::PIXELS; ++p)
+    {
+        CAPTURE(p);
+        const size_t sub = size_t((p / 32) & 1);
+        const size_t word = sub * MLX90640ImageProcessor::FRAME_WORDS + size_t(p);
+        CHECK(thermal::framePixel(decoded.data(), p) == int16_t(frame[word]));
+        CHECK(decoded[word] == frame[word]);
+    }
+}
+
+TEST_CASE("ThermalCompression: extreme values take the escape path and still round trip")
+{
+    Frame frame{};
+    for (size_t i = 0; i < frame.size(); ++i)
+        frame[i] = (i % 3 == 0) ? 0x8000 : (i % 3 == 1 ? 0x7FFF : 0);
+
+    VectorSink sink;
+    REQUIRE(ThermalEncoder<>::encodeFrame(frame.data(), sink) == ImageBufferError::NO_ERROR);
+
+    Frame decoded{};
+    REQUIRE(ThermalDecoder::decodeFrame(sink.bytes.data(), sink.bytes.size(), decoded.data()));
+    for (int p = 0; p < MLX90640ImageProcessor::PIXELS; ++p)
+    {
+        CAPTURE(p);
+        CHECK(thermal::framePixel(decoded.data(), p) == thermal::framePixel(frame.data(), p));
+    }
+
+    // truncated streams are detected
+    CHECK_FALSE(ThermalDecoder::decodeFrame(sink.bytes.data(), sink.bytes.size() / 2, decoded.data()));
+}
+
+TEST_CASE("ThermalCompression: quantized temperatures stay within half a step")
+{
+    MLX90640ImageProcessor proc;
+    MLX90640ImageProcessor::TempImage temps{};
+    Frame frame = build_frame(3, 10, 12, 400);
+    REQUIRE(proc.calculateTo(frame.data(), 0.95f, 23.0f, temps));
+    REQUIRE(proc.calculateTo(frame.data() + 834, 0.95f, 23.0f, temps));
+
+    for (uint16_t step_mK : {uint16_t{10}, uint16_t{50}, uint16_t{100}})
+    {
+        CAPTURE(step_mK);
+        VectorSink sink;
+        REQUIRE(ThermalEncoder<>::encodeTemperatures(temps, step_mK, sink) == ImageBufferError::NO_ERROR);
+        CHECK(sink.bytes.size() == ThermalEncoder<>::temperaturesSize(temps, step_mK));
+
+        MLX90640ImageProcessor::TempImage decoded{};
+        REQUIRE(ThermalDecoder::decodeTemperatures(sink.bytes.data(), sink.bytes.size(), decoded));
+        for (size_t i = 0; i < temps.size(); ++i)
+        {
+            CAPTURE(i);
+            CHECK(std::fabs(decoded[i] - temps[i]) <= float(step_mK) / 2000.0f + 1e-4f);
+        }
+
+        // an MLXQ stream is not an MLXD stream
+        Frame ignored{};
+        CHECK_FALSE(ThermalDecoder::decodeFrame(sink.bytes.data(), sink.bytes.size(), ignored.data()));
+    }
+}
+
+TEST_CASE("ThermalCompression: output is streamed in chunks and sink errors are reported")
+{
+    const Frame frame = build_frame(1, 16, 12, 300);
+
+    VectorSink small;
+    REQUIRE(ThermalEncoder<16>::encodeFrame(frame.data(), small) == ImageBufferError::NO_ERROR);
+    CHECK(small.largest_chunk == 16);
+    CHECK(small.chunks == (small.bytes.size() + 15) / 16);
+
+    VectorSink large;
+    REQUIRE(ThermalEncoder<256>::encodeFrame(frame.data(), large) == ImageBufferError::NO_ERROR);
+    CHECK(large.bytes == small.bytes);
+
+    VectorSink failing;
+    failing.fail_after = 2;
+    CHECK(ThermalEncoder<16>::encodeFrame(frame.data(), failing) == ImageBufferError::WRITE_ERROR);
+    CHECK(failing.bytes.size() == 32);
+}
+
+TEST_CASE("ThermalCompression: MLXD entry through ImageBuffer")
+{
+    ConfigurableMemoryAccessor flash(0, 64 * 1024, 4096);
+    ImageBuffer<ConfigurableMemoryAccessor> buffer(flash);
+    REQUIRE(buffer.initialize_from_flash() == ImageBufferError::NO_ERROR);
+
+    const Frame frame = build_frame(5, 4, 20, 600);
+
+    ImageMetadata meta{};
+    meta.format = METADATA_FORMAT::MLXD;
+    meta.producer = METADATA_PRODUCER::THERMAL;
+    meta.payload_size = static_cast<uint32_t>(ThermalEncoder<>::frameSize(frame.data()));
+    REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+    REQUIRE(ThermalEncoder<>::encodeFrame(frame.data(), buffer) == ImageBufferError::NO_ERROR);
+    REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+
+    ImageMetadata read{};
+    REQUIRE(buffer.get_image(read) == ImageBufferError::NO_ERROR);
+    CHECK(read.format == METADATA_FORMAT::MLXD);
+
+    std::vector<uint8_t> payload(read.payload_size);
+    size_t size = payload.size();
+    REQUIRE(buffer.get_data_chunk(payload.data(), size) == ImageBufferError::NO_ERROR);
+    REQUIRE(size == payload.size());
+
+    Frame decoded{};
+    REQUIRE(ThermalDecoder::decodeFrame(payload.data(), payload.size(), decoded.data()));
+    for (int p = 0; p < MLX90640ImageProcessor::PIXELS; ++p)
+        CHECK(thermal::framePixel(decoded.data(), p) == thermal::framePixel(frame.data(), p));
+}
+
+TEST_CASE("ThermalCompression: compression ratio and encode time")
+{
+    MLX90640ImageProcessor proc;
+    constexpr int FRAMES = 32;
+    constexpr size_t RAW = sizeof(Frame);
+
+    std::vector<Frame> frames;
+    std::vector<MLX90640ImageProcessor::TempImage> temps(FRAMES);
+    for (int i = 0; i < FRAMES; ++i)
+    {
+        frames.push_back(build_frame(uint32_t(i), (i * 7) % 32, (i * 3) % 24, 100 + 40 * i));
+        proc.calculateTo(frames.back().data(), 0.95f, 23.0f, temps[size_t(i)]);
+        proc.calculateTo(frames.back().data() + 834, 0.95f, 23.0f, temps[size_t(i)]);
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    size_t lossless = 0;
+    auto start = clock::now();
+    for (const Frame &f : frames)
+    {
+        ThermalSizeCounter counter;
+        REQUIRE(ThermalEncoder<>::encodeFrame(f.data(), counter) == ImageBufferError::NO_ERROR);
+        lossless += counter.bytes;
+    }
+    const auto losslessTime = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+    size_t quantized = 0;
+    start = clock::now();
+    for (const auto &t : temps)
+    {
+        ThermalSizeCounter counter;
+        REQUIRE(ThermalEncoder<>::encodeTemperatures(t, 50, counter) == ImageBufferError::NO_ERROR);
+        quantized += counter.bytes;
+    }
+    const auto quantizedTime = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+    const double losslessRatio  = double(RAW * FRAMES) / double(lossless);
+    const double quantizedRatio = double(RAW * FRAMES) / double(quantized);
+    const double floatRatio     = double(sizeof(MLX90640ImageProcessor::TempImage) * FRAMES) / double(quantized);
+
+    MESSAGE("MLXD: " << lossless / FRAMES << " of " << RAW << " bytes per frame, ratio " << losslessRatio
+            << ", " << double(losslessTime.count()) / FRAMES << " us per frame");
+    MESSAGE("MLXQ 0.05 K: " << quantized / FRAMES << " bytes per frame, ratio " << quantizedRatio
+            << " to the raw frame, " << floatRatio << " to float temperatures, "
+            << double(quantizedTime.count()) / FRAMES << " us per frame");
+
+    CHECK(losslessRatio > 2.0);
+    CHECK(quantizedRatio > losslessRatio);
+}
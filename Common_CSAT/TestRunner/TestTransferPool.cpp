@@ -0,0 +1,192 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "cyphal.hpp"
+#include "HeapAllocation.hpp"
+#include "TransferPool.hpp"
+
+#include <memory>
+#include <vector>
+
+using Heap = HeapAllocation<4096>;
+
+constexpr size_t NUM_BLOCKS = 4;
+constexpr size_t BLOCK_SIZE = 96;
+using Pool = TransferPool<NUM_BLOCKS, BLOCK_SIZE, Heap>;
+using PoolAllocator = SafeAllocator<CyphalTransfer, Pool>;
+
+static CyphalTransfer makeTransfer(CyphalPortID port_id, size_t payload_size)
+{
+    CyphalTransfer transfer{};
+    transfer.metadata.port_id = port_id;
+    transfer.payload_size = payload_size;
+    transfer.payload = Heap::heapAllocate(nullptr, payload_size);
+    return transfer;
+}
+
+TEST_CASE("TransferPool: serves blocks and tracks high water")
+{
+    Heap::initialize();
+    Pool::initialize();
+
+    void *a = Pool::heapAllocate(nullptr, 32);
+    void *b = Pool::heapAllocate(nullptr, BLOCK_SIZE);
+    REQUIRE(a != nullptr);
+    REQUIRE(b != nullptr);
+    CHECK(a != b);
+    CHECK(Pool::getDiagnostics().in_use == 2);
+    CHECK(Pool::getDiagnostics().high_water == 2);
+
+    Pool::heapFree(nullptr, a);
+    CHECK(Pool::getDiagnostics().in_use == 1);
+    CHECK(Pool::getDiagnostics().high_water == 2);
+
+    // freed block is reused
+    void *c = Pool::heapAllocate(nullptr, 16);
+    CHECK(c == a);
+
+    Pool::heapFree(nullptr, b);
+    Pool::heapFree(nullptr, c);
+    CHECK(Pool::getDiagnostics().in_use == 0);
+    CHECK(Heap::getDiagnostics().allocated == 0);
+}
+
+TEST_CASE("TransferPool: exhaustion and oversize fall back to the heap")
+{
+    Heap::initialize();
+    Pool::initialize();
+
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < NUM_BLOCKS; ++i)
+        blocks.push_back(Pool::heapAllocate(nullptr, BLOCK_SIZE));
+    CHECK(Heap::getDiagnostics().allocated == 0);
+
+    void *spill = Pool::heapAllocate(nullptr, BLOCK_SIZE);
+    REQUIRE(spill != nullptr);
+    CHECK(Pool::getDiagnostics().exhausted_count == 1);
+    CHECK(Heap::getDiagnostics().allocated > 0);
+
+    void *big = Pool::heapAllocate(nullptr, BLOCK_SIZE + 1);
+    REQUIRE(big != nullptr);
+    CHECK(Pool::getDiagnostics().oversize_count == 1);
+    CHECK(Pool::getDiagnostics().in_use == NUM_BLOCKS);
+
+    Pool::heapFree(nullptr, spill);
+    Pool::heapFree(nullptr, big);
+    for (void *block : blocks)
+        Pool::heapFree(nullptr, block);
+
+    CHECK(Pool::getDiagnostics().in_use == 0);
+    CHECK(Pool::getDiagnostics().high_water == NUM_BLOCKS);
+    CHECK(Heap::getDiagnostics().allocated == 0);
+}
+
+TEST_CASE("TransferPool: shared CyphalTransfer lives in the pool and releases its payload")
+{
+    Heap::initialize();
+    Pool::initialize();
+    PoolAllocator allocator;
+
+    CyphalTransfer transfer = makeTransfer(123, 24);
+    void *payload = transfer.payload;
+    size_t heap_before = Heap::getDiagnostics().allocated;
+
+    {
+        std::shared_ptr<CyphalTransfer> ptr = std::allocate_shared<CyphalTransfer>(allocator, transfer);
+        CHECK(ptr->payload == payload);
+        CHECK(ptr->metadata.port_id == 123);
+
+        // control block and transfer share one pool block, no heap traffic
+        CHECK(Pool::getDiagnostics().in_use == 1);
+        CHECK(Pool::getDiagnostics().oversize_count == 0);
+        CHECK(Heap::getDiagnostics().allocated == heap_before);
+
+        std::shared_ptr<CyphalTransfer> copy = ptr;
+        CHECK(copy.use_count() == 2);
+    }
+
+    CHECK(Pool::getDiagnostics().in_use == 0);
+    CHECK(Heap::getDiagnostics().allocated == 0);
+}
+
+TEST_CASE("TransferPool: steady receive loop does not touch the heap")
+{
+    Heap::initialize();
+    Pool::initialize();
+    PoolAllocator allocator;
+
+    std::vector<std::shared_ptr<CyphalTransfer>> in_flight;
+    for (int round = 0; round < 100; ++round)
+    {
+        for (size_t i = 0; i < NUM_BLOCKS; ++i)
+        {
+            CyphalTransfer transfer{};
+            transfer.metadata.port_id = static_cast<CyphalPortID>(i);
+            in_flight.push_back(std::allocate_shared<CyphalTransfer>(allocator, transfer));
+        }
+        in_flight.clear();
+    }
+
+    TransferPoolDiagnostics diagnostics = Pool::getDiagnostics();
+    CHECK(diagnostics.high_water == NUM_BLOCKS);
+    CHECK(diagnostics.exhausted_count == 0);
+    CHECK(diagnostics.oversize_count == 0);
+    CHECK(Heap::getDiagnostics().oom_count == 0);
+    CHECK(Heap::getDiagnostics().peak_allocated == 0);
+}
+
+using LargePool = TransferPool<2, 576, Heap, CanIrqPoolLock>;
+using PayloadPool = TransferPool<8, 96, LargePool, CanIrqPoolLock>;
+using ChainedPool = TransferPool<NUM_BLOCKS, BLOCK_SIZE, PayloadPool>;
+
+TEST_CASE("TransferPool: payloads from chained size classes never reach the heap")
+{
+    Heap::initialize();
+    LargePool::initialize();
+    PayloadPool::initialize();
+    ChainedPool::initialize();
+    SafeAllocator<CyphalTransfer, ChainedPool> allocator;
+
+    // what libcanard asks for while receiving: sessions, small and large payloads
+    const size_t payload_sizes[] = {7, 12, 64, 300, 515};
+    for (int round = 0; round < 100; ++round)
+    {
+        std::vector<std::shared_ptr<CyphalTransfer>> in_flight;
+        for (size_t size : payload_sizes)
+        {
+            CyphalTransfer transfer{};
+            transfer.payload_size = size;
+            transfer.payload = PayloadPool::canardMemoryAllocate(nullptr, size);
+            REQUIRE(transfer.payload != nullptr);
+            in_flight.push_back(std::allocate_shared<CyphalTransfer>(allocator, transfer));
+        }
+        void *session = PayloadPool::canardMemoryAllocate(nullptr, 40);
+        PayloadPool::canardMemoryDeallocate(nullptr, session);
+    }
+
+    CHECK(ChainedPool::getDiagnostics().in_use == 0);
+    CHECK(PayloadPool::getDiagnostics().in_use == 0);
+    // three small payloads, the session and the fifth transfer spilling out of the exhausted ChainedPool
+    CHECK(ChainedPool::getDiagnostics().exhausted_count == 100);
+    CHECK(PayloadPool::getDiagnostics().high_water == 5);
+    CHECK(LargePool::getDiagnostics().in_use == 0);
+    CHECK(LargePool::getDiagnostics().high_water == 2);
+    CHECK(LargePool::getDiagnostics().oversize_count == 0);
+    CHECK(Heap::getDiagnostics().peak_allocated == 0);
+}
+
+TEST_CASE("TransferPool: payloads above the largest class are the remaining heap allocations")
+{
+    Heap::initialize();
+    LargePool::initialize();
+    PayloadPool::initialize();
+
+    void *payload = PayloadPool::serardMemoryAllocate(nullptr, 1024);
+    REQUIRE(payload != nullptr);
+    CHECK(PayloadPool::getDiagnostics().oversize_count == 1);
+    CHECK(LargePool::getDiagnostics().oversize_count == 1);
+    CHECK(Heap::getDiagnostics().allocated > 0);
+
+    PayloadPool::serardMemoryDeallocate(nullptr, 1024, payload);
+    CHECK(Heap::getDiagnostics().allocated == 0);
+}
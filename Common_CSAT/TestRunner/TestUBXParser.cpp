@@ -0,0 +1,326 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN // Only define in one cpp file
+#include "doctest.h"
+#include "mock_hal.h"
+#include "UBXParser.hpp"
+#include "UartDmaRing.hpp"
+#include "GNSSStream.hpp"
+#include <vector>
+#include <cstring>
+
+static std::vector<uint8_t> makeFrame(uint8_t cls, uint8_t id, const std::vector<uint8_t> &payload)
+{
+    std::vector<uint8_t> frame = {0xB5, 0x62, cls, id,
+                                  static_cast<uint8_t>(payload.size()), static_cast<uint8_t>(payload.size() >> 8)};
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    frame.resize(frame.size() + 2);
+    CalculateChecksum(frame.data(), frame.size(), &frame[frame.size() - 2], &frame[frame.size() - 1]);
+    return frame;
+}
+
+static std::vector<uint8_t> posECEF(int32_t x)
+{
+    std::vector<uint8_t> payload(20, 0);
+    std::memcpy(&payload[4], &x, sizeof(x));
+    return makeFrame(0x01, 0x01, payload);
+}
+
+// NAV-PVT recorded from the receiver, see TestGNSS.cpp
+static const std::vector<uint8_t> NAV_PVT = {0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0xA0, 0x3B, 0x56, 0x0F,
+                                             0xE9, 0x07, 0x01, 0x07, 0x17, 0x1C, 0x0B, 0x37, 0x1F, 0x00,
+                                             0x00, 0x00, 0x8B, 0x1C, 0xBD, 0x23, 0x03, 0x01, 0xEA, 0x05,
+                                             0xE5, 0xF7, 0xED, 0xC6, 0x57, 0x4F, 0xB8, 0x11, 0xA2, 0x27,
+                                             0x00, 0x00, 0x6E, 0x86, 0x00, 0x00, 0x20, 0x13, 0x00, 0x00,
+                                             0x82, 0x12, 0x00, 0x00, 0xFF, 0xFD, 0xFF, 0xFF, 0xEF, 0x00,
+                                             0x00, 0x00, 0x22, 0x00, 0x00, 0x00, 0x36, 0x02, 0x00, 0x00,
+                                             0x9E, 0x5C, 0xCD, 0x00, 0x3B, 0x09, 0x00, 0x00, 0xCD, 0xE0,
+                                             0x2E, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00,
+                                             0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 234, 192};
+
+TEST_CASE("UBXParser single frame byte by byte")
+{
+    UBXParser<100> parser;
+    const auto frame = posECEF(1234);
+
+    UBXFrame out{};
+    size_t found = 0;
+    for (size_t i = 0; i < frame.size(); ++i)
+    {
+        const bool done = parser.feed(frame[i], out);
+        CHECK(done == (i == frame.size() - 1));
+        found += done;
+    }
+    REQUIRE(found == 1);
+    CHECK(out.cls == 0x01);
+    CHECK(out.id == 0x01);
+    CHECK(out.length == 20);
+    CHECK(GNSSCore::parseNavPosECEF(out.payload).ecefX == 1234);
+    CHECK(parser.frames() == 1);
+    CHECK(parser.checksumErrors() == 0);
+}
+
+TEST_CASE("UBXParser fragmented stream")
+{
+    UBXParser<100> parser;
+    std::vector<NavigationPVT> pvts;
+    auto collect = [&](const UBXFrame &frame)
+    {
+        if (frame.cls == UBXClass::NAV && frame.id == UBXMessageID::PVT)
+            pvts.push_back(GNSSCore::parseNavPVT(frame.payload));
+    };
+
+    // chunk sizes cycle through 1..7 bytes, cutting header, payload and checksum
+    size_t pos = 0;
+    for (size_t chunk = 1; pos < NAV_PVT.size(); chunk = chunk % 7 + 1)
+    {
+        const size_t size = std::min(chunk, NAV_PVT.size() - pos);
+        parser.feed(NAV_PVT.data() + pos, size, collect);
+        pos += size;
+    }
+
+    REQUIRE(pvts.size() == 1);
+    CHECK(pvts[0].utcTime.year == 2025);
+    CHECK(pvts[0].position.lon == -957483035);
+    CHECK(pvts[0].velocity.headAcc == 3072205);
+}
+
+TEST_CASE("UBXParser concatenated frames with garbage")
+{
+    UBXParser<100> parser;
+    std::vector<uint8_t> stream = {0x00, 0xB5, 0x24, 0x47, 0x50}; // partial sync and NMEA noise
+    for (int32_t x : {1, 2, 3})
+    {
+        const auto frame = posECEF(x);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    stream.insert(stream.end(), {0xB5, 0xB5}); // repeated sync byte before the last frame
+    stream.insert(stream.end(), NAV_PVT.begin(), NAV_PVT.end());
+
+    std::vector<int32_t> xs;
+    size_t pvts = 0;
+    const size_t count = parser.feed(stream.data(), stream.size(), [&](const UBXFrame &frame)
+                                     {
+        if (frame.id == UBXMessageID::POS_ECEF)
+            xs.push_back(GNSSCore::parseNavPosECEF(frame.payload).ecefX);
+        else if (frame.id == UBXMessageID::PVT)
+            ++pvts; });
+
+    CHECK(count == 4);
+    REQUIRE(xs.size() == 3);
+    CHECK(xs[0] == 1);
+    CHECK(xs[1] == 2);
+    CHECK(xs[2] == 3);
+    CHECK(pvts == 1);
+    CHECK(parser.checksumErrors() == 0);
+}
+
+TEST_CASE("UBXParser rejects bad checksums")
+{
+    auto counter = [](const UBXFrame &) {};
+
+    SUBCASE("CK_A wrong")
+    {
+        UBXParser<100> parser;
+        auto bad = posECEF(7);
+        bad[bad.size() - 2] ^= 0x01;
+        parser.feed(bad.data(), bad.size(), counter);
+        CHECK(parser.frames() == 0);
+        CHECK(parser.checksumErrors() == 1);
+    }
+
+    SUBCASE("CK_B wrong")
+    {
+        UBXParser<100> parser;
+        auto bad = posECEF(7);
+        bad[bad.size() - 1] ^= 0x01;
+        parser.feed(bad.data(), bad.size(), counter);
+        CHECK(parser.frames() == 0);
+        CHECK(parser.checksumErrors() == 1);
+    }
+
+    SUBCASE("Payload corrupted, next frame still found")
+    {
+        UBXParser<100> parser;
+        auto bad = posECEF(7);
+        bad[10] ^= 0x40;
+        const auto good = posECEF(8);
+        bad.insert(bad.end(), good.begin(), good.end());
+        parser.feed(bad.data(), bad.size(), counter);
+        CHECK(parser.frames() == 1);
+        CHECK(parser.checksumErrors() == 1);
+    }
+}
+
+TEST_CASE("UBXParser drops oversized frames")
+{
+    UBXParser<16> parser;
+    std::vector<uint8_t> stream = posECEF(5); // 20 byte payload
+    const auto small = makeFrame(0x01, 0x03, std::vector<uint8_t>(16, 0x11));
+    stream.insert(stream.end(), small.begin(), small.end());
+
+    std::vector<uint8_t> ids;
+    parser.feed(stream.data(), stream.size(), [&](const UBXFrame &frame) { ids.push_back(frame.id); });
+
+    CHECK(parser.oversized() == 1);
+    REQUIRE(ids.size() == 1);
+    CHECK(ids[0] == 0x03);
+}
+
+// Simulates the circular DMA writing data at the current position
+template <uint16_t N>
+static uint16_t dmaWrite(UartDmaRing<N> &ring, uint16_t pos, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        ring.buffer()[pos] = data[i];
+        pos = static_cast<uint16_t>((pos + 1) % N);
+    }
+    return pos;
+}
+
+TEST_CASE("UartDmaRing wrap around")
+{
+    UartDmaRing<16> ring;
+    uint8_t data[24];
+    for (uint8_t i = 0; i < sizeof(data); ++i)
+        data[i] = i;
+
+    std::vector<uint8_t> out;
+    std::vector<size_t> segments;
+    auto sink = [&](const uint8_t *p, size_t n)
+    {
+        out.insert(out.end(), p, p + n);
+        segments.push_back(n);
+    };
+
+    uint16_t pos = dmaWrite(ring, 0, data, 12);
+    ring.onRxEvent(pos);
+    CHECK(ring.consume(sink) == 12);
+
+    pos = dmaWrite(ring, pos, data + 12, 8); // 4 bytes to the end, 4 after the wrap
+    ring.onRxEvent(pos);
+    CHECK(ring.consume(sink) == 8);
+
+    REQUIRE(out.size() == 20);
+    for (uint8_t i = 0; i < 20; ++i)
+        CHECK(out[i] == i);
+    REQUIRE(segments.size() == 3);
+    CHECK(segments[1] == 4);
+    CHECK(segments[2] == 4);
+    CHECK(ring.overruns() == 0);
+
+    SUBCASE("Transfer complete reports N")
+    {
+        pos = dmaWrite(ring, pos, data, 12); // ends exactly at the buffer end
+        CHECK(pos == 0);
+        ring.onRxEvent(16);
+        CHECK(ring.consume(sink) == 12);
+        CHECK(ring.received() == 32);
+    }
+
+    SUBCASE("Reader lapped by the DMA")
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            pos = dmaWrite(ring, pos, data, 8);
+            ring.onRxEvent(pos);
+        }
+        CHECK(ring.consume(sink) == 16);
+        CHECK(ring.overruns() == 1);
+    }
+}
+
+TEST_CASE("UBXParser over UartDmaRing")
+{
+    UartDmaRing<64> ring;
+    UBXParser<100> parser;
+    std::vector<int32_t> xs;
+    auto sink = [&](const uint8_t *p, size_t n)
+    {
+        parser.feed(p, n, [&](const UBXFrame &frame)
+                    { xs.push_back(GNSSCore::parseNavPosECEF(frame.payload).ecefX); });
+    };
+
+    // 28 byte frames through a 64 byte ring, idle events in the middle of frames
+    uint16_t pos = 0;
+    for (int32_t x = 0; x < 10; ++x)
+    {
+        const auto frame = posECEF(x);
+        pos = dmaWrite(ring, pos, frame.data(), 17);
+        ring.onRxEvent(pos);
+        ring.consume(sink);
+        pos = dmaWrite(ring, pos, frame.data() + 17, frame.size() - 17);
+        ring.onRxEvent(pos);
+        ring.consume(sink);
+    }
+
+    REQUIRE(xs.size() == 10);
+    for (int32_t x = 0; x < 10; ++x)
+        CHECK(xs[static_cast<size_t>(x)] == x);
+    CHECK(parser.checksumErrors() == 0);
+}
+
+struct RecordingSubscriber : public UBXSubscriber
+{
+    void onNavPVT(const NavigationPVT &pvt) override { pvts.push_back(pvt); }
+    void onNavPosECEF(const PositionECEF &pos) override { positions.push_back(pos); }
+
+    std::vector<NavigationPVT> pvts;
+    std::vector<PositionECEF> positions;
+};
+
+TEST_CASE("GNSSStream dispatch")
+{
+    static UART_HandleTypeDef huart;
+    init_uart_handle(&huart);
+    clear_uart_rx_buffer();
+    clear_uart_tx_buffer();
+
+    using Transport = UARTTransport<UART_Config<huart>>;
+    Transport transport;
+    GNSSStream<Transport, 256> gnss(transport);
+    RecordingSubscriber subscriber;
+    REQUIRE(gnss.subscribe(&subscriber));
+
+    std::vector<uint8_t> stream = posECEF(42);
+    stream.insert(stream.end(), NAV_PVT.begin(), NAV_PVT.end());
+    const auto ack = makeFrame(0x05, 0x01, {0x06, 0x8A});
+    stream.insert(stream.end(), ack.begin(), ack.end());
+    inject_uart_rx_data(stream.data(), stream.size());
+
+    CHECK(gnss.configurePeriodic(UBXMessageID::PVT, 1));
+    CHECK(gnss.configAck() == UBXAck::Pending);
+
+    gnss.start(); // the mock copies the injected bytes into the DMA buffer
+    gnss.onRxEvent(static_cast<uint16_t>(stream.size()));
+
+    auto pos = gnss.getNavPosECEF();
+    REQUIRE(pos.has_value());
+    CHECK(pos->ecefX == 42);
+    CHECK(!gnss.getNavPosECEF().has_value()); // consumed
+
+    CHECK(gnss.frames() == 3);
+    CHECK(gnss.configAck() == UBXAck::Ack);
+    REQUIRE(subscriber.positions.size() == 1);
+    REQUIRE(subscriber.pvts.size() == 1);
+    CHECK(subscriber.pvts[0].numSV == 5);
+
+    auto utc = gnss.getNavTimeUTC();
+    REQUIRE(utc.has_value());
+    CHECK(utc->year == 2025);
+    CHECK(gnss.getNavPVT().has_value());
+}
+
+TEST_CASE("GNSSStream periodic output configuration")
+{
+    static UART_HandleTypeDef huart;
+    using Stream = GNSSStream<UARTTransport<UART_Config<huart>>>;
+
+    uint8_t frame[Stream::VALSET_SIZE];
+    Stream::buildValSet(Stream::KEY_NAV_PVT_UART1, 1, frame);
+
+    static constexpr uint8_t expected[] = {0xB5, 0x62, 0x06, 0x8A, 0x09, 0x00, 0x00, 0x01, 0x00, 0x00,
+                                           0x07, 0x00, 0x91, 0x20, 0x01, 0x53, 0x48};
+    static_assert(sizeof(expected) == Stream::VALSET_SIZE);
+    static_assert(ValidateChecksum(expected));
+    CHECK(std::memcmp(frame, expected, sizeof(expected)) == 0);
+}
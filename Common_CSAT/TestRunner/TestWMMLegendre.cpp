@@ -316,3 +316,28 @@ TEST_CASE("Derivative Associated Legendre Polynomial Tests MAG_PcupHigh: 0.5")
     }
 }
 
+TEST_CASE("Schmidt quasi-normalization table matches the recursion")
+{
+    using namespace wmm_model;
+
+    constexpr uint16_t nMax = 13;
+    constexpr auto &norm = SCHMIDT_QUASI_NORM<nMax>;
+    static_assert(norm.size() == (nMax + 1) * (nMax + 2) / 2);
+    static_assert(norm[0] == 1.0f);
+
+    std::array<float, norm.size()> expected{};
+    expected[0] = 1.0f;
+    for (size_t n = 1; n <= nMax; n++)
+    {
+        const size_t index = n * (n + 1) / 2;
+        expected[index] = expected[(n - 1) * n / 2] * static_cast<float>(2 * n - 1) / static_cast<float>(n);
+        for (size_t m = 1; m <= n; m++)
+            expected[index + m] = expected[index + m - 1] * sqrtf(static_cast<float>((n - m + 1) * (m == 1 ? 2 : 1)) / static_cast<float>(n + m));
+    }
+
+    for (size_t i = 0; i < norm.size(); ++i)
+    {
+        CAPTURE(i);
+        CHECK(norm[i] == doctest::Approx(expected[i]).epsilon(1e-6));
+    }
+}
@@ -5,6 +5,7 @@
 #undef MAX_ORDER
 #include "wmm_coefficients_2025.hpp" // Include the WMM coefficients
 
+#include <chrono>
 #include <cmath>
 
 // https://www.ngdc.noaa.gov/geomag/calculators/magcalc.shtml#igrfwmm
@@ -178,4 +179,101 @@ TEST_CASE("Magnetic Field Calculation 85N 400km cases") {
         expected.F =  48848.9f; 
         compareMagneticFields(result, expected);
     }
-}
\ No newline at end of file
+}
+
+// Per coefficient evaluation with cosf / sinf / powf, as the model was first written
+template <size_t NMAX>
+static magnetic_model::MagneticField referenceMagneticField(float latitude_deg, float longitude_deg, float radius_m,
+                                                            const std::array<magnetic_model::GaussCoefficient, (NMAX + 1) * (NMAX + 2) / 2 - 1> &coefficients)
+{
+    using namespace magnetic_model;
+    const float latitude_rad = latitude_deg * DEG_TO_RAD;
+    const float longitude_rad = longitude_deg * DEG_TO_RAD;
+    const float cos_latitude = cosf(latitude_rad);
+
+    constexpr size_t NTERMS = (NMAX + 1) * (NMAX + 2) / 2;
+    std::array<float, NTERMS> P_vector{};
+    std::array<float, NTERMS> dP_vector{};
+    (void)wmm_model::MAG_PcupLow<NMAX, NTERMS>(P_vector, dP_vector, sinf(latitude_rad));
+
+    float X = 0.0f, Y = 0.0f, Z = 0.0f;
+    for (size_t i = 0; i < coefficients.size(); ++i)
+    {
+        const GaussCoefficient &c = coefficients[i];
+        const float P = P_vector[i + 1];
+        const float dP = dP_vector[i + 1];
+        const float cos_m = cosf(static_cast<float>(c.m) * longitude_rad);
+        const float sin_m = sinf(static_cast<float>(c.m) * longitude_rad);
+        const float term = powf(R_EARTH / radius_m, static_cast<float>(c.n + 2));
+
+        X += term * (c.g * cos_m + c.h * sin_m) * dP;
+        if (c.m != 0)
+            Y += term * static_cast<float>(c.m) * (c.g * sin_m - c.h * cos_m) * P / cos_latitude;
+        Z += term * static_cast<float>(c.n + 1) * (c.g * cos_m + c.h * sin_m) * P;
+    }
+
+    MagneticField result{};
+    result.X = -X;
+    result.Y = Y;
+    result.Z = -Z;
+    return result;
+}
+
+TEST_CASE("Magnetic Field Calculation matches per coefficient evaluation")
+{
+    using namespace magnetic_model;
+
+    float worst = 0.0f;
+    for (float latitude_deg = -89.0f; latitude_deg <= 89.0f; latitude_deg += 8.9f)
+    {
+        for (float longitude_deg = -180.0f; longitude_deg <= 180.0f; longitude_deg += 15.0f)
+        {
+            for (float altitude_m : {0.0f, 400000.0f, 2000000.0f})
+            {
+                const float radius_m = RADIUS + altitude_m;
+                const MagneticField fast = calculateMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, radius_m, 2025, magneticGaussCoefficients);
+                const MagneticField ref = referenceMagneticField<MAX_ORDER>(latitude_deg, longitude_deg, radius_m, magneticGaussCoefficients);
+
+                const float F = sqrtf(ref.X * ref.X + ref.Y * ref.Y + ref.Z * ref.Z);
+                const float error = sqrtf((fast.X - ref.X) * (fast.X - ref.X) + (fast.Y - ref.Y) * (fast.Y - ref.Y) +
+                                          (fast.Z - ref.Z) * (fast.Z - ref.Z));
+                CAPTURE(latitude_deg);
+                CAPTURE(longitude_deg);
+                CAPTURE(altitude_m);
+                CHECK(error < 1e-4f * F);
+                worst = std::max(worst, error);
+            }
+        }
+    }
+    MESSAGE("largest difference to per coefficient evaluation: " << worst << " nT");
+}
+
+TEST_CASE("Magnetic Field Calculation benchmark")
+{
+    using namespace magnetic_model;
+    using clock = std::chrono::steady_clock;
+
+    constexpr int N = 20000;
+    float sink = 0.0f;
+
+    auto start = clock::now();
+    for (int i = 0; i < N; ++i)
+    {
+        const auto k = static_cast<float>(i % 360);
+        const MagneticField field = referenceMagneticField<MAX_ORDER>(k * 0.5f - 90.0f, k - 180.0f, RADIUS + 500000.0f, magneticGaussCoefficients);
+        sink += field.X;
+    }
+    const auto reference = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+    start = clock::now();
+    for (int i = 0; i < N; ++i)
+    {
+        const auto k = static_cast<float>(i % 360);
+        const MagneticField field = calculateMagneticField<MAX_ORDER>(k * 0.5f - 90.0f, k - 180.0f, RADIUS + 500000.0f, 2025, magneticGaussCoefficients);
+        sink -= field.X;
+    }
+    const auto fast = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count() / N;
+
+    CHECK(std::isfinite(sink));
+    MESSAGE("degree " << MAX_ORDER << " field: " << reference << " ns per coefficient evaluation, " << fast << " ns with recurrences");
+}
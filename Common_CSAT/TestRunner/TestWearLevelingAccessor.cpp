@@ -0,0 +1,419 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "imagebuffer/MT29F4G01Accessor.hpp"
+#include "imagebuffer/WearLevelingAccessor.hpp"
+#include "ImageBuffer.hpp"
+#include "Transport.hpp"
+#include "mock_hal.h"
+
+#include <vector>
+
+SPI_HandleTypeDef nand_spi;
+GPIO_TypeDef nand_gpio;
+
+using NandConfig = SPI_Stream_Config<nand_spi, GPIO_PIN_4, 4352>;
+using NandTransport = SPIStreamTransport<NandConfig>;
+using Nand = MT29F4G01Accessor<NandTransport>;
+
+constexpr size_t PHYSICAL_BLOCKS = 8;
+constexpr size_t SPARE_BLOCKS = 2;
+using Leveled = WearLevelingAccessor<Nand, PHYSICAL_BLOCKS, SPARE_BLOCKS>;
+
+static_assert(Accessor<Leveled>, "WearLevelingAccessor must satisfy Accessor concept");
+static_assert(BadBlockAccessor<Nand>, "MT29F4G01Accessor must expose bad block hooks");
+
+static std::vector<uint8_t> pattern(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<uint8_t>(seed + i * 13);
+    return data;
+}
+
+// one device with a fresh driver stack on top, as after a reboot
+struct Stack
+{
+    NandConfig config{&nand_gpio};
+    NandTransport transport{config};
+    Nand nand{transport};
+    Leveled leveled{nand};
+};
+
+TEST_CASE("WearLevelingAccessor: geometry and blank mount")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    // one page per block holds the header
+    CHECK(stack.leveled.getEraseBlockSize() == Nand::DATA_BLOCK_SIZE - Nand::PAGE_SIZE);
+    CHECK(stack.leveled.getFlashMemorySize() == Leveled::LOGICAL_BLOCKS * stack.leveled.getEraseBlockSize());
+    CHECK(stack.leveled.getAlignment() == Nand::PAGE_SIZE);
+
+    WearLevelingStatistics stats = stack.leveled.statistics();
+    CHECK(stats.bad_blocks == 0);
+    CHECK(stats.free_blocks == PHYSICAL_BLOCKS);
+
+    // unmapped blocks read as erased without touching the device
+    reset_spi_nand_counters();
+    std::array<uint8_t, 32> buf{};
+    REQUIRE(stack.leveled.read(0, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+    CHECK(buf[0] == 0xFF);
+    CHECK(get_spi_nand_counters().page_read == 0);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: data and mapping survive a remount")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    auto data = pattern(100000, 0x10);
+    const size_t address = 2 * 262144 - 5000; // straddles two logical blocks
+
+    uint32_t first_block = Leveled::NO_BLOCK;
+    {
+        Stack stack;
+        REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.write(address, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+        first_block = stack.leveled.physicalBlock(address / stack.leveled.getEraseBlockSize());
+        CHECK(first_block != Leveled::NO_BLOCK);
+    }
+
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+    CHECK(stack.leveled.physicalBlock(address / stack.leveled.getEraseBlockSize()) == first_block);
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(stack.leveled.read(address, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: factory bad blocks are never used")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    spi_nand_mark_factory_bad(0);
+    spi_nand_mark_factory_bad(5);
+
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+    CHECK(stack.leveled.isBad(0));
+    CHECK(stack.leveled.isBad(5));
+    CHECK(stack.leveled.statistics().bad_blocks == 2);
+
+    const size_t block_size = stack.leveled.getEraseBlockSize();
+    auto data = pattern(64, 0x20);
+    for (size_t logical = 0; logical < Leveled::LOGICAL_BLOCKS; ++logical)
+    {
+        REQUIRE(stack.leveled.write(logical * block_size, data.data(), data.size()) == AccessorError::NO_ERROR);
+        CHECK(stack.leveled.physicalBlock(logical) != 0);
+        CHECK(stack.leveled.physicalBlock(logical) != 5);
+    }
+    REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+    CHECK(get_spi_nand_erase_count(0) == 0);
+    CHECK(get_spi_nand_erase_count(5) == 0);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: erases of one logical block spread over the device")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    // fill every logical block once, then hammer logical block 0
+    const size_t block_size = stack.leveled.getEraseBlockSize();
+    auto data = pattern(256, 0x30);
+    for (size_t logical = 0; logical < Leveled::LOGICAL_BLOCKS; ++logical)
+        REQUIRE(stack.leveled.write(logical * block_size, data.data(), data.size()) == AccessorError::NO_ERROR);
+
+    constexpr int CYCLES = 40;
+    for (int i = 0; i < CYCLES; ++i)
+    {
+        REQUIRE(stack.leveled.erase(0) == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+    }
+    REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+
+    // the hot block rotates through the free blocks instead of one block taking all erases
+    uint32_t max_erases = 0;
+    for (uint32_t block = 0; block < PHYSICAL_BLOCKS; ++block)
+        max_erases = std::max(max_erases, get_spi_nand_erase_count(block));
+    CHECK(max_erases <= CYCLES / 2);
+
+    WearLevelingStatistics stats = stack.leveled.statistics();
+    CHECK(stats.max_erase_count == max_erases);
+    CHECK(stats.free_blocks == SPARE_BLOCKS);
+
+    // erase counts come back from the headers
+    Stack remounted;
+    REQUIRE(remounted.leveled.mount() == AccessorError::NO_ERROR);
+    for (uint32_t block = 0; block < PHYSICAL_BLOCKS; ++block)
+        CHECK(remounted.leveled.eraseCount(block) == get_spi_nand_erase_count(block));
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(remounted.leveled.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: erased logical block does not come back after a remount")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    auto data = pattern(512, 0x40);
+    {
+        Stack stack;
+        REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.erase(0) == AccessorError::NO_ERROR);
+    }
+
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+    std::array<uint8_t, 16> buf{};
+    REQUIRE(stack.leveled.read(0, buf.data(), buf.size()) == AccessorError::NO_ERROR);
+    CHECK(buf[0] == 0xFF);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: grown bad block during program is relocated")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    auto data = pattern(5 * Nand::PAGE_SIZE, 0x50);
+    const size_t half = 2 * Nand::PAGE_SIZE;
+    REQUIRE(stack.leveled.write(0, data.data(), half) == AccessorError::NO_ERROR);
+
+    const uint32_t failing = stack.leveled.physicalBlock(0);
+    spi_nand_fail_block(failing, true);
+
+    REQUIRE(stack.leveled.write(half, data.data() + half, data.size() - half) == AccessorError::NO_ERROR);
+    REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+
+    CHECK(stack.leveled.isBad(failing));
+    CHECK(stack.leveled.physicalBlock(0) != failing);
+    CHECK(stack.leveled.statistics().relocations == 1);
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(stack.leveled.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    // the marker makes it stick across a remount
+    Stack remounted;
+    REQUIRE(remounted.leveled.mount() == AccessorError::NO_ERROR);
+    CHECK(remounted.leveled.isBad(failing));
+    REQUIRE(remounted.leveled.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: page still buffered when the program fails is carried over")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    spi_nand_garble_failed_programs(true);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    // one page programmed, half of the next one only in the driver buffer
+    auto data = pattern(3 * Nand::PAGE_SIZE, 0x70);
+    const size_t buffered = Nand::PAGE_SIZE + Nand::PAGE_SIZE / 2;
+    REQUIRE(stack.leveled.write(0, data.data(), buffered) == AccessorError::NO_ERROR);
+
+    const uint32_t failing = stack.leveled.physicalBlock(0);
+    spi_nand_fail_block(failing, true);
+
+    REQUIRE(stack.leveled.write(buffered, data.data() + buffered, data.size() - buffered) == AccessorError::NO_ERROR);
+    REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+    CHECK(stack.leveled.isBad(failing));
+    CHECK(stack.leveled.statistics().relocations == 1);
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(stack.leveled.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: page failing in flush is carried over")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    spi_nand_garble_failed_programs(true);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    auto data = pattern(Nand::PAGE_SIZE / 4, 0x80);
+    REQUIRE(stack.leveled.write(100, data.data(), data.size()) == AccessorError::NO_ERROR);
+    spi_nand_fail_block(stack.leveled.physicalBlock(0), true);
+    REQUIRE(stack.leveled.flush() == AccessorError::NO_ERROR);
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(stack.leveled.read(100, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+// passes everything to the NAND, except that writes can be made to report an error
+struct FlakyNand
+{
+    Nand &nand;
+    AccessorError write_error = AccessorError::NO_ERROR;
+    size_t failed_writes = 0;
+
+    AccessorError write(size_t address, const uint8_t *data, size_t size)
+    {
+        if (write_error != AccessorError::NO_ERROR)
+        {
+            ++failed_writes;
+            return write_error;
+        }
+        return nand.write(address, data, size);
+    }
+    AccessorError read(size_t address, uint8_t *data, size_t size) { return nand.read(address, data, size); }
+    AccessorError erase(size_t address) { return nand.erase(address); }
+    AccessorError flush() { return nand.flush(); }
+    bool isBlockMarkedBad(uint32_t block) { return nand.isBlockMarkedBad(block); }
+    bool markBlockBad(uint32_t block) { return nand.markBlockBad(block); }
+    size_t getAlignment() const { return nand.getAlignment(); }
+    size_t getFlashMemorySize() const { return nand.getFlashMemorySize(); }
+    size_t getFlashStartAddress() const { return nand.getFlashStartAddress(); }
+    size_t getEraseBlockSize() const { return nand.getEraseBlockSize(); }
+};
+
+TEST_CASE("WearLevelingAccessor: only program failures move a block, and only a few times")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    FlakyNand flaky{stack.nand};
+    WearLevelingAccessor<FlakyNand, PHYSICAL_BLOCKS, SPARE_BLOCKS> leveled(flaky);
+    REQUIRE(leveled.mount() == AccessorError::NO_ERROR);
+
+    auto data = pattern(256, 0x90);
+    REQUIRE(leveled.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+    const uint32_t mapped = leveled.physicalBlock(0);
+
+    // errors other than a failed program are returned and cost no block
+    flaky.write_error = AccessorError::GENERIC_ERROR;
+    CHECK(leveled.write(data.size(), data.data(), data.size()) == AccessorError::GENERIC_ERROR);
+    flaky.write_error = AccessorError::OUT_OF_BOUNDS;
+    CHECK(leveled.write(data.size(), data.data(), data.size()) == AccessorError::OUT_OF_BOUNDS);
+    CHECK(leveled.physicalBlock(0) == mapped);
+    CHECK(leveled.statistics().bad_blocks == 0);
+    CHECK(leveled.statistics().relocations == 0);
+
+    // a device that fails every program gives up instead of retiring every block
+    flaky.write_error = AccessorError::WRITE_ERROR;
+    CHECK(leveled.write(data.size(), data.data(), data.size()) == AccessorError::WRITE_ERROR);
+    const WearLevelingStatistics stats = leveled.statistics();
+    CHECK(stats.bad_blocks <= 1 + Leveled::MAX_RELOCATIONS);
+    CHECK(stats.bad_blocks + stats.free_blocks > 0);
+    CHECK(flaky.failed_writes <= 1 + Leveled::MAX_RELOCATIONS * (1 + Leveled::MAX_RELOCATIONS));
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: block failing erase is skipped")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    spi_nand_fail_block(0, true);
+
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    auto data = pattern(128, 0x60);
+    REQUIRE(stack.leveled.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+    CHECK(stack.leveled.isBad(0));
+    CHECK(stack.leveled.physicalBlock(0) == 1);
+
+    std::vector<uint8_t> back(data.size());
+    REQUIRE(stack.leveled.read(0, back.data(), back.size()) == AccessorError::NO_ERROR);
+    CHECK(back == data);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: format keeps the wear history")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+
+    auto data = pattern(64, 0x70);
+    for (int i = 0; i < 10; ++i)
+    {
+        REQUIRE(stack.leveled.write(0, data.data(), data.size()) == AccessorError::NO_ERROR);
+        REQUIRE(stack.leveled.erase(0) == AccessorError::NO_ERROR);
+    }
+    stack.leveled.format();
+
+    WearLevelingStatistics stats = stack.leveled.statistics();
+    CHECK(stats.free_blocks == PHYSICAL_BLOCKS);
+
+    Stack remounted;
+    REQUIRE(remounted.leveled.mount() == AccessorError::NO_ERROR);
+    for (uint32_t block = 0; block < PHYSICAL_BLOCKS; ++block)
+    {
+        CHECK(remounted.leveled.eraseCount(block) == get_spi_nand_erase_count(block));
+        CHECK(remounted.leveled.eraseCount(block) > 0);
+    }
+    CHECK(remounted.leveled.physicalBlock(0) == Leveled::NO_BLOCK);
+
+    spi_nand_detach();
+}
+
+TEST_CASE("WearLevelingAccessor: ImageBuffer ring keeps running over a grown bad block")
+{
+    spi_nand_attach(&nand_spi, PHYSICAL_BLOCKS);
+    Stack stack;
+    REQUIRE(stack.leveled.mount() == AccessorError::NO_ERROR);
+    ImageBuffer<Leveled> buffer(stack.leveled);
+
+    constexpr size_t IMAGE_SIZE = 150000;
+    constexpr size_t CHUNK = 1024;
+    std::array<uint8_t, CHUNK> chunk{};
+
+    for (uint8_t round = 0; round < 24; ++round)
+    {
+        if (round == 9)
+            spi_nand_fail_block(stack.leveled.physicalBlock(buffer.get_tail() / stack.leveled.getEraseBlockSize()), true);
+
+        auto data = pattern(IMAGE_SIZE, round);
+        ImageMetadata meta{};
+        meta.payload_size = IMAGE_SIZE;
+        REQUIRE(buffer.add_image(meta) == ImageBufferError::NO_ERROR);
+        for (size_t offset = 0; offset < IMAGE_SIZE; offset += CHUNK)
+            REQUIRE(buffer.add_data_chunk(data.data() + offset, std::min(CHUNK, IMAGE_SIZE - offset)) == ImageBufferError::NO_ERROR);
+        REQUIRE(buffer.push_image() == ImageBufferError::NO_ERROR);
+
+        ImageMetadata read_meta{};
+        REQUIRE(buffer.get_image(read_meta) == ImageBufferError::NO_ERROR);
+        std::vector<uint8_t> back;
+        while (back.size() < IMAGE_SIZE)
+        {
+            size_t size = chunk.size();
+            REQUIRE(buffer.get_data_chunk(chunk.data(), size) == ImageBufferError::NO_ERROR);
+            REQUIRE(size > 0);
+            back.insert(back.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(size));
+        }
+        CHECK(back == data);
+        REQUIRE(buffer.pop_image() == ImageBufferError::NO_ERROR);
+    }
+
+    WearLevelingStatistics stats = stack.leveled.statistics();
+    CHECK(stats.bad_blocks == 1);
+    MESSAGE("erase counts min " << stats.min_erase_count << " max " << stats.max_erase_count
+            << ", relocations " << stats.relocations);
+    // every good block took part in the ring, spares included
+    CHECK(stats.min_erase_count > 0);
+
+    spi_nand_detach();
+}
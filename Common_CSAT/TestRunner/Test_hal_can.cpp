@@ -108,3 +108,46 @@ TEST_CASE("HAL_CAN_GetRxFifoFillLevel")
     set_current_rx_fifo_fill_level(0);
     CHECK(HAL_CAN_GetRxFifoFillLevel(NULL, 0) == 0);
 }
+
+static int mailbox_callbacks = 0;
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { ++mailbox_callbacks; }
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { ++mailbox_callbacks; }
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef * /*hcan*/) { ++mailbox_callbacks; }
+
+TEST_CASE("CAN Mailbox Model")
+{
+    CAN_HandleTypeDef hcan;
+    CAN_TxHeaderTypeDef header;
+    uint8_t data[8] = {0};
+    uint32_t mailbox;
+    header.IDE = CAN_ID_EXT;
+    header.DLC = 8;
+
+    clear_can_tx_buffer();
+    enable_can_mailbox_model(true);
+    mailbox_callbacks = 0;
+
+    const uint32_t ids[3] = {0x300, 0x100, 0x200};
+    for (int i = 0; i < 3; ++i)
+    {
+        header.ExtId = ids[i];
+        CHECK(HAL_CAN_AddTxMessage(&hcan, &header, data, &mailbox) == HAL_OK);
+        CHECK(mailbox == (CAN_TX_MAILBOX0 << i));
+    }
+    CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&hcan) == 0);
+    CHECK(HAL_CAN_AddTxMessage(&hcan, &header, data, &mailbox) != HAL_OK);
+
+    // lowest identifier wins arbitration, no callback while the interrupt is masked
+    CHECK(complete_can_tx_mailbox() == 1);
+    CHECK(mailbox_callbacks == 0);
+    CHECK(HAL_CAN_GetTxMailboxesFreeLevel(&hcan) == 1);
+
+    HAL_CAN_ActivateNotification(&hcan, CAN_IT_TX_MAILBOX_EMPTY);
+    CHECK(complete_can_tx_mailboxes(5) == 2);
+    CHECK(mailbox_callbacks == 2);
+    CHECK(get_can_busy_mailboxes() == 0);
+
+    HAL_CAN_DeactivateNotification(&hcan, CAN_IT_TX_MAILBOX_EMPTY);
+    enable_can_mailbox_model(false);
+    clear_can_tx_buffer();
+}
@@ -0,0 +1,48 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "mock_hal.h"
+#include <string.h>
+#include <stdio.h>
+
+TEST_CASE("HAL_CRC_Init Default Configuration")
+{
+    CRC_HandleTypeDef hcrc;
+    memset(&hcrc, 0, sizeof(hcrc));
+    hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_ENABLE;
+    hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_ENABLE;
+
+    CHECK(HAL_CRC_Init(&hcrc) == HAL_OK);
+    CHECK(hcrc.Instance == CRC);
+    CHECK(CRC->POL == DEFAULT_CRC32_POLY);
+    CHECK(CRC->INIT == DEFAULT_CRC_INITVALUE);
+}
+
+TEST_CASE("HAL_CRC_Calculate and Accumulate")
+{
+    CRC_HandleTypeDef hcrc;
+    memset(&hcrc, 0, sizeof(hcrc));
+    hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_BYTE;
+    hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_ENABLE;
+    hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+    CHECK(HAL_CRC_Init(&hcrc) == HAL_OK);
+
+    uint8_t data[] = "123456789";
+    reset_crc_bytes_processed();
+    CHECK((HAL_CRC_Calculate(&hcrc, (uint32_t *)data, 9) ^ 0xFFFFFFFFU) == 0xCBF43926U);
+
+    HAL_CRC_Calculate(&hcrc, (uint32_t *)data, 4);
+    CHECK((HAL_CRC_Accumulate(&hcrc, (uint32_t *)(data + 4), 5) ^ 0xFFFFFFFFU) == 0xCBF43926U);
+    CHECK(get_crc_bytes_processed() == 18);
+}
+
+TEST_CASE("CRC Initial Value Register")
+{
+    CRC_HandleTypeDef hcrc;
+    memset(&hcrc, 0, sizeof(hcrc));
+    CHECK(HAL_CRC_Init(&hcrc) == HAL_OK);
+
+    __HAL_CRC_INITIALCRCVALUE_CONFIG(&hcrc, 0x12345678U);
+    __HAL_CRC_DR_RESET(&hcrc);
+    CHECK(CRC->DR == 0x12345678U);
+    CHECK(HAL_CRC_Calculate(&hcrc, NULL, 0) == 0x12345678U);
+}
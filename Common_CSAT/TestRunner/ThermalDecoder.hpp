@@ -0,0 +1,140 @@
+#ifndef THERMAL_DECODER_HPP
+#define THERMAL_DECODER_HPP
+
+// Ground side decoder for the ThermalCompression.hpp streams (MLXD, MLXQ)
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <vector>
+
+#include "ThermalCompression.hpp"
+
+class ThermalBitReader
+{
+public:
+    ThermalBitReader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+    uint32_t get(unsigned count)
+    {
+        uint32_t v = 0;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            v = (v << 1) | bit();
+        }
+        return v;
+    }
+
+    uint32_t getRice(unsigned k)
+    {
+        uint32_t q = 0;
+        while (q < thermal::ESCAPE_QUOTIENT && bit() == 1U)
+            ++q;
+        if (q == thermal::ESCAPE_QUOTIENT)
+            return get(32);
+        return (q << k) | (k > 0 ? get(k) : 0U);
+    }
+
+    bool overrun() const { return overrun_; }
+    size_t bytesUsed() const { return (pos_ + 7) / 8; }
+
+private:
+    uint32_t bit()
+    {
+        if (pos_ >= size_ * 8)
+        {
+            overrun_ = true;
+            return 0;
+        }
+        const uint32_t b = (data_[pos_ / 8] >> (7 - pos_ % 8)) & 1U;
+        ++pos_;
+        return b;
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t pos_ = 0;
+    bool overrun_ = false;
+};
+
+class ThermalDecoder
+{
+public:
+    using RawImage  = MLX90640ImageProcessor::RawImage;
+    using TempImage = MLX90640ImageProcessor::TempImage;
+
+    // MLXD stream back to a 2 x 834 word frame. Both subpages carry the whole
+    // 32x24 image, so each one holds its own pixels and its own aux words.
+    static bool decodeFrame(const uint8_t *data, size_t size, uint16_t *frame)
+    {
+        ThermalBitReader in(data, size);
+        ThermalStreamHeader hdr{};
+        if (!getHeader(in, hdr) || hdr.step_mK != 0)
+            return false;
+
+        std::array<int32_t, thermal::PIXELS> pixels{};
+        getImage(in, pixels);
+
+        constexpr size_t WORDS = MLX90640ImageProcessor::FRAME_WORDS;
+        for (size_t p = 0; p < pixels.size(); ++p)
+        {
+            frame[p]         = static_cast<uint16_t>(pixels[p]);
+            frame[WORDS + p] = static_cast<uint16_t>(pixels[p]);
+        }
+
+        for (size_t w = thermal::AUX_FIRST; w < thermal::AUX_END; ++w)
+            frame[w] = static_cast<uint16_t>(in.get(16));
+
+        thermal::RiceContext ctx;
+        for (size_t w = thermal::AUX_FIRST; w < thermal::AUX_END; ++w)
+        {
+            const uint32_t u = in.getRice(ctx.k());
+            ctx.update(u);
+            frame[WORDS + w] = static_cast<uint16_t>(static_cast<int16_t>(frame[w]) + thermal::unzigzag(u));
+        }
+        return !in.overrun();
+    }
+
+    // MLXQ stream back to temperatures, within step_mK / 2 of the originals
+    static bool decodeTemperatures(const uint8_t *data, size_t size, TempImage &temps)
+    {
+        ThermalBitReader in(data, size);
+        ThermalStreamHeader hdr{};
+        if (!getHeader(in, hdr) || hdr.step_mK == 0)
+            return false;
+
+        std::array<int32_t, thermal::PIXELS> q{};
+        getImage(in, q);
+        for (size_t p = 0; p < q.size(); ++p)
+            temps[p] = thermal::dequantize(q[p], hdr.step_mK);
+        return !in.overrun();
+    }
+
+private:
+    static bool getHeader(ThermalBitReader &in, ThermalStreamHeader &hdr)
+    {
+        hdr.version = static_cast<uint8_t>(in.get(8));
+        hdr.width   = static_cast<uint8_t>(in.get(8));
+        hdr.height  = static_cast<uint8_t>(in.get(8));
+        hdr.flags   = static_cast<uint8_t>(in.get(8));
+        hdr.step_mK = static_cast<uint16_t>(in.get(8) | (in.get(8) << 8));
+        return hdr.version == THERMAL_STREAM_VERSION &&
+               hdr.width == thermal::WIDTH &&
+               hdr.height == thermal::HEIGHT;
+    }
+
+    static void getImage(ThermalBitReader &in, std::array<int32_t, thermal::PIXELS> &pixels)
+    {
+        thermal::RiceContext ctx;
+        auto pixel = [&pixels](int p) { return pixels[static_cast<size_t>(p)]; };
+        for (int p = 0; p < thermal::PIXELS; ++p)
+        {
+            const uint32_t u = in.getRice(ctx.k());
+            ctx.update(u);
+            pixels[static_cast<size_t>(p)] = thermal::predict(p, pixel) + thermal::unzigzag(u);
+        }
+    }
+};
+
+#endif // THERMAL_DECODER_HPP
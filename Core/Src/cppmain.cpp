@@ -9,6 +9,7 @@
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <algorithm>
 
 #include "usbd_cdc_if.h"
 
@@ -29,12 +30,14 @@
 #include <CircularBuffer.hpp>
 #include <ArrayList.hpp>
 #include "HeapAllocation.hpp"
+#include "TransferPool.hpp"
 #include "RegistrationManager.hpp"
 #include "ServiceManager.hpp"
 #include "SubscriptionManager.hpp"
 #include "ProcessRxQueue.hpp"
 #include "TaskCheckMemory.hpp"
 #include "TaskCheckTxQueue.hpp"
+#include "TaskDrainLog.hpp"
 #include "TaskBlinkLED.hpp"
 #include "TaskSendHeartBeat.hpp"
 #include "TaskProcessHeartBeat.hpp"
@@ -97,47 +100,36 @@ void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
 	}
 }
 
-//void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
-//
-//void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
-//
-//void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED5_GPIO_Port, LED5_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
-//
-//void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
-//
-//void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
-//
-//void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan)
-//{
-//	HAL_GPIO_TogglePin(LED5_GPIO_Port, LED5_Pin);
-//	__HAL_CAN_DISABLE_IT(hcan, CAN_IT_TX_MAILBOX_EMPTY);
-//	tx_drainer.drain();
-//}
+// every completed or aborted mailbox refills from the canard queue in priority order
+void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
+
+void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
+
+void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
+
+void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
+
+void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
+
+void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef */*hcan*/)
+{
+	tx_drainer.on_tx_complete();
+}
 
 constexpr uint16_t endian_swap(uint16_t num) {return (num>>8) | (num<<8); };
 constexpr int16_t endian_swap(int16_t num) {return (num>>8) | (num<<8); };
@@ -177,8 +169,15 @@ void cppmain()
 	LoopardCyphal loopard_cyphal(&loopard_adapter);
 	loopard_cyphal.setNodeID(cyphal_node_id);
 
+	// libcanard frames and reassembled payloads come from two size classes of pools,
+	// only payloads above 576 bytes still reach o1heap
+	using LargePayloadPool = TransferPool<8, 576, LocalHeap, CanIrqPoolLock>;
+	using PayloadPool = TransferPool<64, 96, LargePayloadPool, CanIrqPoolLock>;
+	LargePayloadPool::initialize();
+	PayloadPool::initialize();
+
 	using CanardCyphal = Cyphal<CanardAdapter>;
-	canard_adapter.ins = canardInit(LocalHeap::canardMemoryAllocate, LocalHeap::canardMemoryDeallocate);
+	canard_adapter.ins = canardInit(PayloadPool::canardMemoryAllocate, PayloadPool::canardMemoryDeallocate);
 	canard_adapter.que = canardTxInit(512, CANARD_MTU_CAN_CLASSIC);
 	CanardCyphal canard_cyphal(&canard_adapter);
 	canard_cyphal.setNodeID(cyphal_node_id);
@@ -276,7 +275,9 @@ void cppmain()
 	SubscriptionManager subscription_manager;
 
 	HAL_Delay(3000);
-	static SafeAllocator<CyphalTransfer, LocalHeap> allocator;
+	using RxTransferPool = TransferPool<32, 64, PayloadPool>;
+	RxTransferPool::initialize();
+	static SafeAllocator<CyphalTransfer, RxTransferPool> allocator;
 	LoopManager loop_manager(allocator);
 
 //	constexpr uint8_t uuid[] = {0x1a, 0xb7, 0x9f, 0x23, 0x7c, 0x51, 0x4e, 0x0b, 0x8d, 0x69, 0x32, 0xfa, 0x15, 0x0c, 0x6e, 0x41};
@@ -324,6 +325,9 @@ void cppmain()
 	using TCheckTxQueue = TaskCheckTxQueue;
 	register_task_with_heap<TCheckTxQueue>(registration_manager, 1000, 100, canard_adapter);
 
+	using TDrainLog = TaskDrainLog;
+	register_task_with_heap<TDrainLog>(registration_manager, 10, 0, TaskDrainLog::Output::Text, 8);
+
 	//	using PowerSwitchType = PowerSwitch<PowerSwitchTransport>;
 	//	using MLX90640Type = MLX90640<MLX90640Transport>;
 	//	using TMLX = TaskMLX90640<PowerSwitchType, MLX90640Type, NullImageBuffer, PeriodicTrigger>;
@@ -344,17 +348,18 @@ void cppmain()
 	subscription_manager.subscribe<SubscriptionManager::ResponseTag>(static_cast<CyphalPortID>(uavcan_file_Write_1_1_FIXED_PORT_ID_), canard_adapters);
 //	subscription_manager.subscribe<SubscriptionManager::ResponseTag>(static_cast<CyphalPortID>(uavcan_file_Read_1_1_FIXED_PORT_ID_), canard_adapters);
 
-	ServiceManager service_manager(registration_manager.getHandlers());
+	ServiceManager service_manager(registration_manager);
 	service_manager.initializeServices(HAL_GetTick());
 
 	if (HAL_CAN_ActivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING) != HAL_OK)
 	{
 		Error_Handler();
 	}
-//	if (HAL_CAN_ActivateNotification(&hcan1, CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK)
-//	{
-//		Error_Handler();
-//	}
+	// the drainer masks TMEIE again whenever the TX queue runs empty
+	if (HAL_CAN_ActivateNotification(&hcan1, CAN_IT_TX_MAILBOX_EMPTY) != HAL_OK)
+	{
+		Error_Handler();
+	}
 
 	uint32_t counter = 0;
 	while(1)
@@ -367,6 +372,15 @@ void cppmain()
 				service_manager.getHandlers().capacity(), service_manager.getHandlers().size());
 		log(LOG_LEVEL_TRACE, "CanProcessRxQueue: (%d %d) \r\n",
 				can_rx_buffer.capacity(), can_rx_buffer.size());
+		log(LOG_LEVEL_TRACE, "RxTransferPool: (%d %d %d) (%d %d) \r\n",
+				RxTransferPool::getDiagnostics().capacity, RxTransferPool::getDiagnostics().in_use, RxTransferPool::getDiagnostics().high_water,
+				static_cast<uint32_t>(RxTransferPool::getDiagnostics().exhausted_count), static_cast<uint32_t>(RxTransferPool::getDiagnostics().oversize_count));
+		log(LOG_LEVEL_TRACE, "PayloadPool: (%d %d) (%d %d) \r\n",
+				PayloadPool::getDiagnostics().in_use, PayloadPool::getDiagnostics().high_water,
+				LargePayloadPool::getDiagnostics().in_use, static_cast<uint32_t>(LargePayloadPool::getDiagnostics().oversize_count));
+		log(LOG_LEVEL_TRACE, "CanTxQueueDrainer: (%d %d %d) (%d fps, max %d ms) \r\n",
+				tx_drainer.statistics().frames_sent, tx_drainer.statistics().frames_expired, tx_drainer.statistics().irq_refills,
+				tx_drainer.statistics().frames_per_second, tx_drainer.statistics().max_latency_ms);
 		loop_manager.CanProcessTxQueue(&canard_adapter, &hcan1);
 		loop_manager.CanProcessRxQueue(&canard_cyphal, &service_manager, empty_adapters, can_rx_buffer);
 		loop_manager.LoopProcessRxQueue(&loopard_cyphal, &service_manager, empty_adapters);
@@ -396,7 +410,13 @@ void cppmain()
 //		CDC_Transmit_FS((uint8_t*) buffer, strlen(buffer));
 
 
-		HAL_Delay(25);
+		// sleep until the next task is due, a CAN frame arrives or the TX queue needs service
+		constexpr uint32_t MAX_IDLE_MS = 25;
+		uint32_t wake = std::min(service_manager.nextDeadline(), HAL_GetTick() + MAX_IDLE_MS);
+		while (HAL_GetTick() < wake && can_rx_buffer.is_empty())
+		{
+			__WFI();
+		}
 		++counter;
 	}
 }